@@ -4,6 +4,9 @@ setlocal enabledelayedexpansion
 
 :: assign default value to the output directory
 set LIBDIR=monitor_lib
+set COMPILED=false
+set TIMEPOLICY=DoubleTime
+set INSTRUMENTED=false
 
 :: initializing support variables
 set /a nextVar=0
@@ -20,6 +23,12 @@ for %%x in (%*) do (
 				set /a nextVar=2
 			) else if %%~x == -b (
 				set /a nextVar=3
+			) else if %%~x == -c (
+				set COMPILED=true
+			) else if %%~x == -t (
+				set /a nextVar=5
+			) else if %%~x == -i (
+				set INSTRUMENTED=true
 			) else if %%~x == -f (
 				set /a nextVar=4
 			) else ( :: case in which the input is not an option
@@ -41,6 +50,9 @@ for %%x in (%*) do (
 				set FORMULAFILE=%%~x
 				call :normalizepath FORMULAFILE !FORMULAFILE!
 			)
+			if !nextVar! == 5 (
+				set TIMEPOLICY=%%~x
+			)
 			set /a nextVar=0		
 		)
 )
@@ -81,7 +93,7 @@ if not defined FORMULAFILE (
 cd %~dp0"\src"
 
 :: executing system
-matlab -nodesktop -nosplash -nodisplay -r "bin.libgen('!FORMULAFILE!','!LIBDIR!','!LIBNAME!','!BROWNAME!');quit;"
+matlab -nodesktop -nosplash -nodisplay -r "bin.libgen('!FORMULAFILE!','!LIBDIR!','!LIBNAME!','!BROWNAME!',!COMPILED!,'!TIMEPOLICY!',!INSTRUMENTED!);quit;"
 exit /b 0
 
 
@@ -92,7 +104,7 @@ exit /b 0
 exit /b 0
 
 :printusage
-	echo Usage: %~nx0 [-h] [-d output-library] [-n library-name] [-b library-name-in-browser] -f formulae-file 
+	echo Usage: %~nx0 [-h] [-d output-library] [-n library-name] [-b library-name-in-browser] [-c] [-t time-policy] [-i] -f formulae-file 
 exit /b 0
 
 :normalizepath
@@ -8,11 +8,14 @@ get_absname() {
 
 MATLAB=`which matlab`
 OUTPUT="out.log"
-USAGE="Usage: `basename -- $0` [-h] [-d output-library] [-n library-name] [-b library-name-in-browser] -f formulae-file"
+USAGE="Usage: `basename -- $0` [-h] [-d output-library] [-n library-name] [-b library-name-in-browser] [-c] [-t time-policy] [-i] -f formulae-file"
 
 LIBDIR="monitor_lib"
+COMPILED="false"
+TIMEPOLICY="DoubleTime"
+INSTRUMENTED="false"
 
-while getopts hd:n:b:f: OPT; do
+while getopts hd:n:b:ct:if: OPT; do
   case "$OPT" in
     h)
       echo -e $USAGE
@@ -28,6 +31,15 @@ while getopts hd:n:b:f: OPT; do
     b)
       BROWNAME=$OPTARG
       ;;
+    c)
+      COMPILED="true"
+      ;;
+    t)
+      TIMEPOLICY=$OPTARG
+      ;;
+    i)
+      INSTRUMENTED="true"
+      ;;
     f)
       FORMULAFILE="$(get_absname $OPTARG)"
       ;;
@@ -70,5 +82,5 @@ fi
 cd -P -- "$(dirname -- "$0")/src"
 
 # execute system
-"$MATLAB" -nodesktop -nosplash -nodisplay -r "bin.libgen('$FORMULAFILE','$LIBDIR','$LIBNAME','$BROWNAME');quit;" 
+"$MATLAB" -nodesktop -nosplash -nodisplay -r "bin.libgen('$FORMULAFILE','$LIBDIR','$LIBNAME','$BROWNAME',$COMPILED,'$TIMEPOLICY',$INSTRUMENTED);quit;" 
 
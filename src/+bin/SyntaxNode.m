@@ -101,6 +101,26 @@ classdef SyntaxNode
             end
         end
         
+        function key = getPredicateKey(this)
+            % key identifying the predicate (or boolean constant): equal
+            % predicates, also when they appear more times in a formula,
+            % have the same key.
+            import bin.SyntaxNode;
+            
+            narginchk(1,1);
+            nargoutchk(0,1);
+            
+            if this.getNodeType == bin.SyntaxNode.BOOLEAN
+                key = ['BOOLEAN:', this.getBooleanData];
+            elseif this.getNodeType == bin.SyntaxNode.PREDICATE
+                [coefficients,variables, relop, constraint] = this.getPredicateData;
+                key = ['PREDICATE:', strjoin(coefficients,','), ';', ...
+                    strjoin(variables,','), ';', relop, ';', constraint];
+            else
+                error('Expected caller to be a predicate or a boolean');
+            end
+        end
+        
         function child = getNotData(this)
             import syntaxtree.*;
             import bin.SyntaxNode;
@@ -189,7 +209,7 @@ classdef SyntaxNode
                 child2 =  bin.SyntaxNode(this.syntaxnode.getSecondChildNode);
                 alpha = char(this.syntaxnode.getData.get(DataFields.ALPHA));
             end
-        end       
+        end
     end
 end
 
@@ -1,9 +1,16 @@
-function addmonitor(systemName, coord, syntaxTree)
-    narginchk(3,3);
+function addmonitor(systemName, coord, syntaxTree, sfunName)
+    narginchk(3,4);
     validateattributes(systemName,{'char'},{'nonempty','row'});
     validateattributes(coord,{'double'},{'size',[1,4]});
     validateattributes(syntaxTree,{'bin.SyntaxNode'},{'nonempty','vector'});
 
+    % S-function dedicata (formula compilata, vedi bin.concpp) oppure
+    % l'interprete generico
+    compiled = nargin == 4;
+    if compiled
+        validateattributes(sfunName,{'char'},{'nonempty','row'});
+    end
+
     INPORT     = 'simulink/Sources/In1';
     OUTPORT    = 'simulink/Sinks/Out1';
     CONSTANT   = 'simulink/Sources/Constant';
@@ -34,8 +41,56 @@ function addmonitor(systemName, coord, syntaxTree)
     % Aggiunta maschera
     mask = Simulink.Mask.create(subsystem);
     mask.addParameter('Evaluate','off','Tunable','off','Enabled','off','Visible','off');
+    % (il verdetto anticipato non e' disponibile per le formule compilate)
+    if compiled
+        earlyverdictvisible = 'off';
+    else
+        earlyverdictvisible = 'on';
+    end
+    mask.addParameter('Type','checkbox','Name','EarlyVerdict', ...
+        'Prompt','Report violations as soon as they are certain','Value','off', ...
+        'Evaluate','on','Tunable','off','Visible',earlyverdictvisible);
+    % Analisi delle risorse (solo formule interpretate): con MinDwell > 0 la
+    % S-function calcola la memoria necessaria nel caso peggiore e la alloca
+    % all'avvio, o segnala con un warning se supera il limite MemoryBudget.
+    mask.addParameter('Type','edit','Name','MinDwell', ...
+        'Prompt','Minimum dwell time of the predicates (s, 0 = no resource analysis)','Value','0', ...
+        'Evaluate','on','Tunable','off','Visible',earlyverdictvisible);
+    mask.addParameter('Type','edit','Name','MaxStep', ...
+        'Prompt','Maximum solver step (s, 0 = minimum dwell time)','Value','0', ...
+        'Evaluate','on','Tunable','off','Visible',earlyverdictvisible);
+    mask.addParameter('Type','edit','Name','MemoryBudget', ...
+        'Prompt','Memory preallocated at most (bytes)','Value','1048576', ...
+        'Evaluate','on','Tunable','off','Visible',earlyverdictvisible);
+    % Filtro dei glitch (solo formule interpretate): un predicato cambia valore
+    % solo se il nuovo valore dura almeno ChatterFilter secondi; uno scalare vale
+    % per tutti i predicati, un vettore da' il filtro di ogni ingresso del MUX.
+    mask.addParameter('Type','edit','Name','ChatterFilter', ...
+        'Prompt','Minimum dwell time of the predicate inputs (s, scalar or one per predicate, 0 = no filter)','Value','0', ...
+        'Evaluate','on','Tunable','off','Visible',earlyverdictvisible);
+    % Valutazione nei passi minori del solutore: l'uscita e' calcolata anche
+    % negli istanti di prova dei solutori a passo variabile, estendendo la
+    % traccia in modo provvisorio (annullato al passo successivo).
+    mask.addParameter('Type','checkbox','Name','MinorSteps', ...
+        'Prompt','Evaluate the monitor in the minor time steps of the solver','Value','off', ...
+        'Evaluate','on','Tunable','off');
+    % Valutazione asincrona: i campioni sono accodati e il monitor e' valutato
+    % da un thread separato; l'uscita e' il verdetto dell'ultimo campione
+    % valutato. A coda piena la simulazione attende, oppure (DropWhenFull) il
+    % campione viene scartato.
+    mask.addParameter('Type','checkbox','Name','Async', ...
+        'Prompt','Evaluate the monitor on a worker thread','Value','off', ...
+        'Evaluate','on','Tunable','off');
+    mask.addParameter('Type','edit','Name','QueueSize', ...
+        'Prompt','Samples queued for the worker thread at most','Value','4096', ...
+        'Evaluate','on','Tunable','off');
+    mask.addParameter('Type','checkbox','Name','DropWhenFull', ...
+        'Prompt','Drop the samples when the queue is full (otherwise wait)','Value','off', ...
+        'Evaluate','on','Tunable','off');
 
-    % Visita albero sintattico, costruzione e aggiunta dei blocchi predicati.
+    % Visita albero sintattico, costruzione e aggiunta dei blocchi predicati
+    % (un solo blocco per ogni predicato distinto, come in bin.contree).
+    predicatekeys = {};
     [predicates,yposition] = AddPredicates(0, syntaxTree,[]);
 
     % Aggiunta MUX
@@ -94,8 +149,23 @@ function addmonitor(systemName, coord, syntaxTree)
         position = [POSITION6 yposition POSITION6+WIDTH, yposition+WIDTH];
         
         sfun = strcat(MODEL_NAME,'/MG_SFUNCTION');
-        add_block(S_FUNCTION, sfun,'Position',position,'Parameters', bin.contree(syntaxtree));
-        set_param(sfun,'FunctionName',S_FUNCTION_MEXFILE);
+        if compiled
+            % la formula fa parte della S-function
+            parameters = ['[]', ', struct(''EarlyVerdict'', EarlyVerdict, ''MinorSteps'', MinorSteps, ', ...
+                '''Async'', Async, ''QueueSize'', QueueSize, ''DropWhenFull'', DropWhenFull)'];
+            add_block(S_FUNCTION, sfun,'Position',position,'Parameters', parameters);
+            set_param(sfun,'FunctionName',sfunName);
+        else
+            % formula compilata in bytecode (vedi bin.conbytecode)
+            bytecode = sprintf('%d ', bin.conbytecode(syntaxtree));
+            parameters = ['uint8([', strtrim(bytecode), '])', ...
+                ', struct(''EarlyVerdict'', EarlyVerdict, ''MinDwell'', MinDwell, ', ...
+                '''MaxStep'', MaxStep, ''MemoryBudget'', MemoryBudget, ''ChatterFilter'', ChatterFilter, ', ...
+                '''MinorSteps'', MinorSteps, ''Async'', Async, ''QueueSize'', QueueSize, ', ...
+                '''DropWhenFull'', DropWhenFull)'];
+            add_block(S_FUNCTION, sfun,'Position',position,'Parameters', parameters);
+            set_param(sfun,'FunctionName',S_FUNCTION_MEXFILE);
+        end
         
         sfunports = get_param(sfun,'PortHandles');
         add_line(MODEL_NAME, muxports.Outport(1), sfunports.Inport(1));
@@ -111,7 +181,13 @@ function addmonitor(systemName, coord, syntaxTree)
         predstr = num2str(prednum);
         
         
-        if nodetype == SyntaxNode.BOOLEAN
+        if (nodetype == SyntaxNode.BOOLEAN || nodetype == SyntaxNode.PREDICATE) && ...
+                any(strcmp(predicatekeys, syntaxnode.getPredicateKey))
+            % predicato gia' presente: il blocco esistente viene riusato
+            predicates = lpredicates;
+            newyposition = yposition;
+            
+        elseif nodetype == SyntaxNode.BOOLEAN
             bool =  syntaxnode.getBooleanData;
             position = [POSITION4, yposition, POSITION4+WIDTH, yposition+WIDTH];
             
@@ -120,6 +196,7 @@ function addmonitor(systemName, coord, syntaxTree)
             
             %output
             predicates = [lpredicates,block];
+            predicatekeys{end+1} = syntaxnode.getPredicateKey;
             newyposition = yposition +WIDTH + SPACE2;
             
         elseif nodetype == SyntaxNode.PREDICATE
@@ -127,6 +204,7 @@ function addmonitor(systemName, coord, syntaxTree)
             [block,newposition] = CreatePredicate(yposition, variables,coefficients, constraint, relation, prednum);
             
             predicates = [lpredicates,block];
+            predicatekeys{end+1} = syntaxnode.getPredicateKey;
             newyposition = newposition + SPACE2;
             
         else
@@ -0,0 +1,73 @@
+function bytecode = conbytecode( syntaxtree )
+    % compiled formula as a flat array of bytes (uint8 row vector), loaded
+    % by the S-function without visiting a MATLAB structure. The encoding
+    % (version 1) is described in +monitor_library/matlab/buildval.cpp:
+    % header 'MTSB', version byte, then the nodes in pre-order.
+    narginchk(1,1);
+    nargoutchk(0,1);
+
+    % validate classe in input
+    validateattributes(syntaxtree,{'bin.SyntaxNode'},{'scalar'});
+
+    MAGIC   = uint8('MTSB');
+    VERSION = uint8(1);
+
+    PREDICATE   = 0;
+    NOT         = 1;
+    AND         = 2;
+    OR          = 3;
+    FUTURE      = 4;
+    GLOBALLY    = 5;
+    UNTIL       = 6;
+
+    % the structure built by contree already contains the predicate indexes
+    formula = eval(bin.contree(syntaxtree));
+    bytecode = [MAGIC, VERSION, encodeRecursive(formula)];
+
+    function code = encodeRecursive(node)
+        nodetype = node.NodeType;
+        code = uint8(nodetype);
+
+        switch nodetype
+            case PREDICATE
+                code = [code, toBytes(uint32(node.PredicateIndex))];
+
+            case NOT
+                code = [code, encodeRecursive(node.ChildNode)];
+
+            case {AND, OR}
+                code = [code, encodeRecursive(node.FirstChildNode), ...
+                    encodeRecursive(node.SecondChildNode)];
+
+            case {FUTURE, GLOBALLY}
+                code = [code, toBytes(double(lowerBound(node))), ...
+                    toBytes(double(node.Alpha)), encodeRecursive(node.ChildNode)];
+
+            case UNTIL
+                code = [code, toBytes(double(lowerBound(node))), ...
+                    toBytes(double(node.Alpha)), ...
+                    encodeRecursive(node.FirstChildNode), ...
+                    encodeRecursive(node.SecondChildNode)];
+
+            otherwise
+                error('Unexpected node type %d', nodetype);
+        end
+    end
+
+    function lowerbound = lowerBound(node)
+        if isfield(node, 'LowerBound')
+            lowerbound = node.LowerBound;
+        else
+            lowerbound = 0;
+        end
+    end
+
+    % little-endian bytes of a numeric value
+    function bytes = toBytes(value)
+        bytes = typecast(value, 'uint8');
+        [~,~,endian] = computer;
+        if endian == 'B'
+            bytes = fliplr(bytes);
+        end
+    end
+end
@@ -0,0 +1,103 @@
+function code = concpp( syntaxtree, typename )
+    % C++ header declaring the monitor of the formula as a type whose
+    % syntax tree is fixed at compile time (see
+    % +monitor_library/headers/static_validators.h). The header can be
+    % compiled into a dedicated S-function (matlab/static_sfun.cpp) or
+    % included in plain C++ code. The derived operators are expanded as
+    % in +monitor_library/matlab/buildval.cpp, except AND which is
+    % computed directly.
+    narginchk(2,2);
+    nargoutchk(0,1);
+
+    % validate classe in input
+    validateattributes(syntaxtree,{'bin.SyntaxNode'},{'scalar'});
+    validateattributes(typename,{'char'},{'nonempty','row'});
+
+    PREDICATE   = 0;
+    NOT         = 1;
+    AND         = 2;
+    OR          = 3;
+    FUTURE      = 4;
+    GLOBALLY    = 5;
+    UNTIL       = 6;
+
+    TRUE_NODE = 'StaticBoolean<true>';
+
+    % the structure built by contree already contains the predicate indexes
+    formula = eval(bin.contree(syntaxtree));
+
+    % window classes of the temporal operators (one for each operator)
+    windows = '';
+    windowcount = 0;
+    formulatype = encodeRecursive(formula);
+
+    guard = [upper(typename), '_H_'];
+    code = sprintf([ ...
+        '// Monitor of the formula ''%s'', generated by bin.concpp.\n', ...
+        '#ifndef %s\n#define %s\n\n', ...
+        '#include "static_validators.h"\n\n', ...
+        '%s\n', ...
+        'typedef StaticMonitor< %s > %s;\n\n', ...
+        '#endif\n'], ...
+        char(syntaxtree.getFormulaName), guard, guard, windows, formulatype, typename);
+
+    function type = encodeRecursive(node)
+        nodetype = node.NodeType;
+
+        switch nodetype
+            case PREDICATE
+                type = sprintf('StaticPredicate<%d>', node.PredicateIndex);
+
+            case NOT
+                type = ['StaticNot< ', encodeRecursive(node.ChildNode), ' >'];
+
+            case AND
+                type = ['StaticAnd< ', encodeRecursive(node.FirstChildNode), ', ', ...
+                    encodeRecursive(node.SecondChildNode), ' >'];
+
+            case OR
+                type = ['StaticOr< ', encodeRecursive(node.FirstChildNode), ', ', ...
+                    encodeRecursive(node.SecondChildNode), ' >'];
+
+            case FUTURE
+                % F x = TRUE U x
+                type = ['StaticUntil< ', TRUE_NODE, ', ', encodeRecursive(node.ChildNode), ', ', ...
+                    addWindow(lowerBound(node), node.Alpha), ' >'];
+
+            case GLOBALLY
+                % G x = NOT (TRUE U NOT x)
+                type = ['StaticNot< StaticUntil< ', TRUE_NODE, ', StaticNot< ', ...
+                    encodeRecursive(node.ChildNode), ' >, ', ...
+                    addWindow(lowerBound(node), node.Alpha), ' > >'];
+
+            case UNTIL
+                type = ['StaticUntil< ', encodeRecursive(node.FirstChildNode), ', ', ...
+                    encodeRecursive(node.SecondChildNode), ', ', ...
+                    addWindow(lowerBound(node), node.Alpha), ' >'];
+
+            otherwise
+                error('Unexpected node type %d', nodetype);
+        end
+    end
+
+    % declares a window class with constant bounds (in seconds, converted
+    % to the time type of the monitors) and returns its name
+    function name = addWindow(lowerbound, alpha)
+        name = sprintf('%s_w%d', typename, windowcount);
+        windowcount = windowcount + 1;
+
+        windows = [windows, sprintf([ ...
+            'struct %s {\n', ...
+            '\tstatic inline TimeType lowerbound(void) {return TimePolicy::fromSeconds(%.17g);}\n', ...
+            '\tstatic inline TimeType alpha(void) {return TimePolicy::fromSeconds(%.17g);}\n', ...
+            '};\n'], name, double(lowerbound), double(alpha))];
+    end
+
+    function lowerbound = lowerBound(node)
+        if isfield(node, 'LowerBound')
+            lowerbound = node.LowerBound;
+        else
+            lowerbound = 0;
+        end
+    end
+end
@@ -20,6 +20,9 @@ function syntaxtreestr = contree( syntaxtree )
     SECOND_CHILD 	= '''SecondChildNode''';
     ALPHA 			= '''Alpha''';
 
+    % keys of the predicates already converted (equal predicates share the
+    % same index, so the monitor shares their values)
+    predicatekeys = {};
     syntaxtreestr = convertRecursive(syntaxtree,0);
 
     function [outnode,nextindex] = convertRecursive(syntaxnode, predicateindex)
@@ -27,8 +30,17 @@ function syntaxtreestr = contree( syntaxtree )
         nodetype = syntaxnode.getNodeType;
         
         if nodetype == SyntaxNode.BOOLEAN || nodetype == SyntaxNode.PREDICATE
-            outnode = addPredicateNode(num2str(predicateindex));
-            nextindex  = predicateindex + 1;
+            key = syntaxnode.getPredicateKey;
+            index = find(strcmp(predicatekeys, key), 1);
+            
+            if isempty(index)
+                predicatekeys{end+1} = key;
+                outnode = addPredicateNode(num2str(predicateindex));
+                nextindex  = predicateindex + 1;
+            else
+                outnode = addPredicateNode(num2str(index - 1));
+                nextindex  = predicateindex;
+            end
             
         elseif nodetype == SyntaxNode.NOT
             child = syntaxnode.getNotData;
@@ -1,9 +1,35 @@
-function libgen(formula_file, library_dir, library_name, library_browser)
+function libgen(formula_file, library_dir, library_name, library_browser, compiled, timepolicy, instrumented)
+
+    % optional: generate one S-function per formula, with the formula
+    % compiled ahead of time (see bin.concpp)
+    if nargin < 5
+        compiled = false;
+    end
+
+    % optional: representation of the time in the monitors (see the time
+    % policies in +monitor_library/headers/type_transl.h)
+    if nargin < 6 || isempty(timepolicy)
+        timepolicy = 'DoubleTime';
+    end
+    timepolicy = validatestring(char(timepolicy), {'DoubleTime','FloatTime','Int64Ticks','Int32Ticks'});
+
+    % optional: statistics of the nodes of the interpreted monitors (see
+    % +monitor_library/headers/instrumentation.h)
+    if nargin < 7
+        instrumented = false;
+    end
 
     % INPUT VARIABLES
     disp("-----------------------------------------------------------------");
     disp("output folder: "+library_dir);
     disp("formula file:  "+formula_file);
+    if compiled
+        disp("monitors:      compiled ahead of time");
+    end
+    disp("time policy:   "+timepolicy);
+    if instrumented
+        disp("instrumentation: enabled");
+    end
     disp("-----------------------------------------------------------------");
 
     LIB_DIR = library_dir; 
@@ -92,6 +118,11 @@ function libgen(formula_file, library_dir, library_name, library_browser)
         xposition = 0;
         width = 50;
 
+        % generated headers of the monitors compiled ahead of time
+        monitortypes = cell(1, formulacount);
+        monitorheaders = cell(1, formulacount);
+        sfunnames = cell(1, formulacount);
+
         % add monitor in library for each formula
         for i = 1:formulacount
             % Wrap of the syntax tree in a MATLAB class
@@ -108,7 +139,14 @@ function libgen(formula_file, library_dir, library_name, library_browser)
             end
 
             % add block to the sub-system
-            bin.addmonitor(LIBRARY_NAME, coords, syntaxtree );
+            if compiled
+                monitortypes{i} = sprintf('%s_monitor%d', LIBRARY_NAME, i);
+                sfunnames{i} = sprintf('%s_sfun%d', LIBRARY_NAME, i);
+                monitorheaders{i} = bin.concpp(syntaxtree, monitortypes{i});
+                bin.addmonitor(LIBRARY_NAME, coords, syntaxtree, sfunnames{i});
+            else
+                bin.addmonitor(LIBRARY_NAME, coords, syntaxtree );
+            end
         end
         
         % create output directory
@@ -122,7 +160,20 @@ function libgen(formula_file, library_dir, library_name, library_browser)
     try    
         % compile file mex
         disp('Compiling S-Function ...'); 
-        buildMEX(CSOURCE_DIR, LIB_DIR);
+        if compiled
+            for i = 1:formulacount
+                header = [monitortypes{i}, '.h'];
+                writeFile(fullfile(LIB_DIR, header), monitorheaders{i});
+                buildStaticMEX(CSOURCE_DIR, LIB_DIR, sfunnames{i}, monitortypes{i}, header, timepolicy);
+            end
+        else
+            buildMEX(CSOURCE_DIR, LIB_DIR, false, 'sfun', timepolicy, instrumented);
+        end
+
+        % MEX function evaluate_batch, to check recorded traces from MATLAB
+        % scripts (see +monitor_library/matlab/evaluate_batch.cpp)
+        disp('Compiling evaluate_batch ...');
+        buildMEX(CSOURCE_DIR, LIB_DIR, false, 'batch', timepolicy, instrumented);
 
         % create slblocks.m
         disp('S-Function compiled.');
@@ -174,43 +225,65 @@ function errorBehaviour(msg,id)
     exit(1);
 end
 
-function buildMEX(sourceDirectory, outputDirectory, debug, mexfun)
-    narginchk(2,4);
+% gateway: 'sfun' (S-function of the interpreted monitors), 'evaluate'
+% (MEX function evaluate_formula) or 'batch' (MEX function evaluate_batch)
+function buildMEX(sourceDirectory, outputDirectory, debug, gateway, timepolicy, instrumented)
+    narginchk(2,6);
     nargoutchk(0,0);
 
     switch nargin
         case 2
             debug = false;
-            mexfun = false;
+            gateway = 'sfun';
+            timepolicy = 'DoubleTime';
+            instrumented = false;
         case 3
-            mexfun = false;
+            gateway = 'sfun';
+            timepolicy = 'DoubleTime';
+            instrumented = false;
+        case 4
+            timepolicy = 'DoubleTime';
+            instrumented = false;
+        case 5
+            instrumented = false;
     end
 
     validateattributes(sourceDirectory, {'char'},{'row','nonempty'},1);
     validateattributes(outputDirectory, {'char'},{'row','nonempty'},2);
     validateattributes(debug, {'logical'},{'scalar','nonempty'},3);
-    validateattributes(mexfun, {'logical'},{'scalar','nonempty'},4);
+    gateway = validatestring(gateway, {'sfun','evaluate','batch'}, 4);
+    validateattributes(timepolicy, {'char'},{'row','nonempty'},5);
+    validateattributes(instrumented, {'logical'},{'scalar','nonempty'},6);
 
     COMP_DIR = sourceDirectory;
     OUTPUT_DIR = outputDirectory;
     HEADERS = ['-I',fullfile(COMP_DIR,'headers')];
 
     MEX_GATEWAY =       fullfile(COMP_DIR,'matlab','evaluate_formula.cpp');
+    BATCH_GATEWAY =     fullfile(COMP_DIR,'matlab','evaluate_batch.cpp');
     S_FUNCTION =        fullfile(COMP_DIR,'matlab','monitor_sfun.cpp');
     VALIDATOR_BUILDER = fullfile(COMP_DIR,'matlab','buildval.cpp');
     VALIDATOR =         fullfile(COMP_DIR,'validators','monitor.cpp');
     SIGNAL =            fullfile(COMP_DIR,'misc','Signal.cpp');
     INTERVAL =          fullfile(COMP_DIR,'misc','Interval.cpp');
+    STATE =             fullfile(COMP_DIR,'misc','state.cpp');
     BOOL =              fullfile(COMP_DIR,'validators','boolvalidator.cpp');
     PREDICATE =         fullfile(COMP_DIR,'validators','predicatevalidator.cpp');
     NOT =               fullfile(COMP_DIR,'validators','notvalidator.cpp');
     OR =                fullfile(COMP_DIR,'validators','orvalidator.cpp');
     UNTIL =             fullfile(COMP_DIR,'validators','untilvalidator.cpp');
-
-    if mexfun 
-        main = MEX_GATEWAY;
-    else
-        main = S_FUNCTION;
+    SINCE =             fullfile(COMP_DIR,'validators','sincevalidator.cpp');
+    BUFFER =            fullfile(COMP_DIR,'validators','signalbuffer.cpp');
+    RESOURCES =         fullfile(COMP_DIR,'validators','resources.cpp');
+    INSTRUMENTATION =   fullfile(COMP_DIR,'validators','instrumentation.cpp');
+
+    switch gateway
+        case 'evaluate'
+            main = MEX_GATEWAY;
+        case 'batch'
+            main = BATCH_GATEWAY;
+        otherwise
+            main = S_FUNCTION;
     end
 
     if debug
@@ -219,8 +292,63 @@ function buildMEX(sourceDirectory, outputDirectory, debug, mexfun)
         debugstr='';
     end
 
-    mex( debugstr, '-outdir',OUTPUT_DIR ,HEADERS,  ...
+    if instrumented
+        instrumentstr='-DMTS_INSTRUMENTATION';
+    else
+        instrumentstr='';
+    end
+
+    mex( debugstr, instrumentstr, '-outdir',OUTPUT_DIR ,HEADERS,  ...
+                        ['-DMTS_TIME_POLICY=', timepolicy], ...
                         main, VALIDATOR_BUILDER, ...
-                        VALIDATOR, SIGNAL, INTERVAL,BOOL, ...
-                        PREDICATE, NOT, OR, UNTIL);
-end
\ No newline at end of file
+                        VALIDATOR, SIGNAL, INTERVAL, STATE, BOOL, ...
+                        PREDICATE, NOT, OR, UNTIL, SINCE, BUFFER, RESOURCES, ...
+                        INSTRUMENTATION);
+end
+
+% S-function of a monitor generated ahead of time: only the kernels of the
+% engine are needed, the nodes are defined in static_validators.h
+function buildStaticMEX(sourceDirectory, outputDirectory, sfunname, typename, header, timepolicy)
+    narginchk(6,6);
+    nargoutchk(0,0);
+
+    validateattributes(sourceDirectory, {'char'},{'row','nonempty'},1);
+    validateattributes(outputDirectory, {'char'},{'row','nonempty'},2);
+    validateattributes(sfunname, {'char'},{'row','nonempty'},3);
+    validateattributes(typename, {'char'},{'row','nonempty'},4);
+    validateattributes(header, {'char'},{'row','nonempty'},5);
+    validateattributes(timepolicy, {'char'},{'row','nonempty'},6);
+
+    COMP_DIR = sourceDirectory;
+    OUTPUT_DIR = outputDirectory;
+    HEADERS = ['-I',fullfile(COMP_DIR,'headers')];
+    GENERATED_HEADERS = ['-I',OUTPUT_DIR];
+
+    S_FUNCTION =        fullfile(COMP_DIR,'matlab','static_sfun.cpp');
+    SIGNAL =            fullfile(COMP_DIR,'misc','Signal.cpp');
+    INTERVAL =          fullfile(COMP_DIR,'misc','Interval.cpp');
+    STATE =             fullfile(COMP_DIR,'misc','state.cpp');
+    UNTIL =             fullfile(COMP_DIR,'validators','untilvalidator.cpp');
+    SINCE =             fullfile(COMP_DIR,'validators','sincevalidator.cpp');
+    BUFFER =            fullfile(COMP_DIR,'validators','signalbuffer.cpp');
+    RESOURCES =         fullfile(COMP_DIR,'validators','resources.cpp');
+    INSTRUMENTATION =   fullfile(COMP_DIR,'validators','instrumentation.cpp');
+
+    mex('-outdir',OUTPUT_DIR, HEADERS, GENERATED_HEADERS, ...
+                        ['-DS_FUNCTION_NAME=', sfunname], ...
+                        ['-DMTS_FORMULA_TYPE=', typename], ...
+                        ['-DMTS_FORMULA_HEADER=', header], ...
+                        ['-DMTS_TIME_POLICY=', timepolicy], ...
+                        '-output', sfunname, ...
+                        S_FUNCTION, SIGNAL, INTERVAL, STATE, UNTIL, SINCE, BUFFER, RESOURCES, INSTRUMENTATION);
+end
+
+function writeFile(filename, content)
+    fid = fopen(filename, 'wt');
+    if fid == -1
+        error('Unable to create the file %s', filename);
+    end
+
+    fprintf(fid, '%s', content);
+    fclose(fid);
+end
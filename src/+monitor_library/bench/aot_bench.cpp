@@ -0,0 +1,125 @@
+// Benchmark of a monitor generated ahead of time (see static_validators.h) against the interpreter (Monitor built from the
+// bytecode of the same formula).
+//
+// The benchmark is a plain C++ program (no MATLAB needed), e.g. from the +monitor_library folder:
+//
+//	g++ -O2 -Iheaders bench/aot_bench.cpp matlab/buildval.cpp misc/*.cpp validators/*.cpp -o aot_bench
+//	./aot_bench [steps] [toggle probability]
+//
+// The formula is
+//
+//	GLOBALLY[0,10] (p0 OR p1 UNTIL[0,5] p2) AND FUTURE[1,4] p3
+//
+// and BenchMonitor is its type as generated by bin.concpp. The two monitors are fed the same random trace (each predicate
+// changes value at each step with the given probability) and their evaluations are compared at the end.
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "static_validators.h"
+#include "validators.h"
+#include "bytecode.h"
+
+// generated by bin.concpp ----------------------------------------------------------------------------------
+struct BenchMonitor_w0 {
+	static inline TimeType lowerbound(void) {return TimePolicy::fromSeconds(0);}
+	static inline TimeType alpha(void) {return TimePolicy::fromSeconds(10);}
+};
+struct BenchMonitor_w1 {
+	static inline TimeType lowerbound(void) {return TimePolicy::fromSeconds(0);}
+	static inline TimeType alpha(void) {return TimePolicy::fromSeconds(5);}
+};
+struct BenchMonitor_w2 {
+	static inline TimeType lowerbound(void) {return TimePolicy::fromSeconds(1);}
+	static inline TimeType alpha(void) {return TimePolicy::fromSeconds(4);}
+};
+
+typedef StaticMonitor< StaticAnd< StaticNot< StaticUntil< StaticBoolean<true>, StaticNot< StaticOr< StaticPredicate<0>,
+		StaticUntil< StaticPredicate<1>, StaticPredicate<2>, BenchMonitor_w1 > > >, BenchMonitor_w0 > >,
+		StaticUntil< StaticBoolean<true>, StaticPredicate<3>, BenchMonitor_w2 > > > BenchMonitor;
+// ----------------------------------------------------------------------------------------------------------
+
+// bytecode of the same formula (see bytecode.h)
+static std::vector<unsigned char> benchBytecode(void)
+{
+	std::vector<unsigned char> code;
+	writeBytecodeHeader(code);
+
+	writeOperatorNode(code, MTS_AND);
+	writeFutureNode(code, MTS_GLOBALLY, 0, 10);
+	writeOperatorNode(code, MTS_OR);
+	writePredicateNode(code, 0);
+	writeFutureNode(code, MTS_UNTIL, 0, 5);
+	writePredicateNode(code, 1);
+	writePredicateNode(code, 2);
+	writeFutureNode(code, MTS_FUTURE, 1, 4);
+	writePredicateNode(code, 3);
+	return code;
+}
+
+// runs a monitor on the trace and returns the seconds spent
+template <class MonitorType>
+static double run(MonitorType &monitor, const std::vector< std::vector<BooleanType> > &trace, double step)
+{
+	std::clock_t begin = std::clock();
+
+	monitor.initialConditions(0, trace[0]);
+	for (std::vector< std::vector<BooleanType> >::size_type i = 1; i < trace.size(); i++)
+		monitor.extendTrace(TimePolicy::fromSeconds(i*step), trace[i]);
+
+	return double(std::clock() - begin) / CLOCKS_PER_SEC;
+}
+
+static bool equalSignals(const Signal &s1, const Signal &s2)
+{
+	if (s1.getFirst() != s2.getFirst() || s1.getLast() != s2.getLast() || s1.getIntervalCount() != s2.getIntervalCount())
+		return false;
+
+	for (Signal::const_iterator it1 = s1.getBegin(), it2 = s2.getBegin(); it1 != s1.getEnd(); it1++, it2++)
+		if (it1->leftLimit != it2->leftLimit || it1->rightLimit != it2->rightLimit)
+			return false;
+
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	const long steps = argc > 1 ? std::atol(argv[1]) : 200000;
+	const double toggle = argc > 2 ? std::atof(argv[2]) : 0.05;
+	const double step = 0.01;
+
+	if (steps < 2 || toggle < 0 || toggle > 1)
+	{
+		std::cerr << "usage: aot_bench [steps >= 2] [toggle probability in [0,1]]" << std::endl;
+		return 1;
+	}
+
+	// random trace, the same for both monitors
+	std::srand(42);
+	std::vector< std::vector<BooleanType> > trace(steps, std::vector<BooleanType>(BenchMonitor::predicates));
+	for (long i = 0; i < steps; i++)
+		for (int p = 0; p < BenchMonitor::predicates; p++)
+		{
+			BooleanType previous = i > 0 ? trace[i-1][p] : 1;
+			trace[i][p] = (std::rand() < toggle * RAND_MAX) ? !previous : previous;
+		}
+
+	std::vector<unsigned char> code = benchBytecode();
+	Monitor interpreted(&code[0], code.size());
+	BenchMonitor compiled;
+
+	double interpretedtime = run(interpreted, trace, step);
+	double compiledtime = run(compiled, trace, step);
+
+	bool equal = equalSignals(interpreted.formulaEvaluation(), compiled.formulaEvaluation());
+
+	std::cout << "steps: " << steps << ", toggle probability: " << toggle << std::endl;
+	std::cout << "interpreter:    " << interpretedtime * 1e9 / steps << " ns/step" << std::endl;
+	std::cout << "ahead of time:  " << compiledtime * 1e9 / steps << " ns/step" << std::endl;
+	std::cout << "speedup:        " << (compiledtime > 0 ? interpretedtime / compiledtime : 0) << "x" << std::endl;
+	std::cout << "same verdicts:  " << (equal ? "yes" : "NO") << std::endl;
+
+	return equal ? 0 : 2;
+}
@@ -0,0 +1,318 @@
+// Load generator of the monitor daemon (see tools/monitor_daemon.cpp): synthetic clients stream samples at a fixed rate over
+// concurrent sessions, and the throughput and the latency of the daemon are measured.
+//
+// The generator is a plain C++11 program for Linux, e.g. from the +monitor_library folder:
+//
+//	g++ -std=c++11 -O2 -pthread -Iheaders bench/daemon_bench.cpp -o daemon_bench
+//	./daemon_bench -f bench.mtsb
+//	./monitor_daemon -u /tmp/mts.sock bench.mtsb &
+//	./daemon_bench unix:/tmp/mts.sock [sessions] [samples per second] [seconds] [predicates] > results.csv
+//
+// -f writes the bytecode of the formula G[0,0.5] (p0 OR F[0,0.01] p1) AND H[0,0.5] (p2 OR p3), which is false now and then on the
+// generated traces. The address is either unix:<socket path> or tcp:<host>:<port>. The defaults are 4 sessions of 100000
+// samples per second for 5 seconds, with 4 predicates. Each session sends its samples in batches of one millisecond, at
+// instants 1/rate seconds apart, with predicates changing value with probability 0.01 at each sample (a fixed seed per session).
+//
+// The output is CSV (a header line, then one line per session and a line "total") with the columns:
+//
+//	session, samples			the session and the number of samples sent.
+//	sent_per_second				samples sent per second (lower than the target rate if the daemon slows down the client).
+//	done_per_second				samples monitored per second, from the first sample to the reply DONE.
+//	drain_ms					time from the end of the trace (END) to the reply DONE, the lag of the monitors.
+//	violations, errors			frames VIOLATION and ERROR received.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "stream_protocol.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct SessionResult
+{
+	unsigned long long samples;
+	double sendSeconds;
+	double doneSeconds;
+	double drainSeconds;
+	unsigned long violations;
+	unsigned long errors;
+	std::string failure;
+
+	SessionResult(void): samples(0), sendSeconds(0), doneSeconds(0), drainSeconds(0), violations(0), errors(0), failure() {}
+};
+
+static void writeFormula(const char *path)
+{
+	std::vector<unsigned char> code;
+	code.push_back('M'); code.push_back('T'); code.push_back('S'); code.push_back('B');
+	code.push_back(1);
+
+	code.push_back(2);	// AND
+	code.push_back(5);	// GLOBALLY [0,0.5]
+	streamPutReal(code, 0);
+	streamPutReal(code, 0.5);
+	code.push_back(3);	// OR
+	code.push_back(0);	// p0
+	streamPutInteger(code, 0, 4);
+	code.push_back(4);	// FUTURE [0,0.01]
+	streamPutReal(code, 0);
+	streamPutReal(code, 0.01);
+	code.push_back(0);	// p1
+	streamPutInteger(code, 1, 4);
+	code.push_back(8);	// HISTORICALLY [0,0.5]
+	streamPutReal(code, 0.5);
+	code.push_back(3);	// OR
+	code.push_back(0);	// p2
+	streamPutInteger(code, 2, 4);
+	code.push_back(0);	// p3
+	streamPutInteger(code, 3, 4);
+
+	std::ofstream file(path, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(&code[0]), code.size());
+	if (!file)
+		throw std::runtime_error(std::string("unable to write ") + path);
+}
+
+static int connectTo(const std::string &address)
+{
+	if (address.compare(0, 5, "unix:") == 0)
+	{
+		sockaddr_un name;
+		std::memset(&name, 0, sizeof(name));
+		name.sun_family = AF_UNIX;
+		std::strncpy(name.sun_path, address.c_str() + 5, sizeof(name.sun_path) - 1);
+
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&name), sizeof(name)) == 0)
+			return fd;
+		if (fd >= 0)
+			close(fd);
+		throw std::runtime_error("unable to connect to " + address);
+	}
+
+	if (address.compare(0, 4, "tcp:") == 0)
+	{
+		std::string hostport = address.substr(4);
+		size_t colon = hostport.rfind(':');
+		if (colon == std::string::npos)
+			throw std::invalid_argument("Invalid address: " + address);
+
+		addrinfo hints, *result = NULL;
+		std::memset(&hints, 0, sizeof(hints));
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = SOCK_STREAM;
+		if (getaddrinfo(hostport.substr(0, colon).c_str(), hostport.substr(colon + 1).c_str(), &hints, &result) != 0)
+			throw std::runtime_error("unable to resolve " + address);
+
+		int fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+		bool connected = fd >= 0 && connect(fd, result->ai_addr, result->ai_addrlen) == 0;
+		freeaddrinfo(result);
+		if (!connected)
+		{
+			if (fd >= 0)
+				close(fd);
+			throw std::runtime_error("unable to connect to " + address);
+		}
+
+		int nodelay = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+		return fd;
+	}
+
+	throw std::invalid_argument("Invalid address (unix:<path> or tcp:<host>:<port>): " + address);
+}
+
+static void sendAll(int fd, const std::vector<unsigned char> &bytes)
+{
+	size_t sent = 0;
+	while (sent < bytes.size())
+	{
+		ssize_t n = send(fd, &bytes[sent], bytes.size() - sent, MSG_NOSIGNAL);
+		if (n <= 0)
+			throw std::runtime_error("connection closed by the daemon");
+		sent += n;
+	}
+}
+
+static void receiveAll(int fd, unsigned char *out, size_t length)
+{
+	size_t received = 0;
+	while (received < length)
+	{
+		ssize_t n = recv(fd, out + received, length - received, 0);
+		if (n <= 0)
+			throw std::runtime_error("connection closed by the daemon");
+		received += n;
+	}
+}
+
+// reads a frame of the daemon, returns its kind
+static unsigned char receiveFrame(int fd, SessionResult &result)
+{
+	unsigned char kind, payload[18];
+	receiveAll(fd, &kind, 1);
+
+	if (kind == MTS_STREAM_READY)
+		receiveAll(fd, payload, 2);
+	else if (kind == MTS_STREAM_VIOLATION)
+	{
+		receiveAll(fd, payload, 18);
+		result.violations++;
+	}
+	else if (kind == MTS_STREAM_DONE)
+		receiveAll(fd, payload, 8);
+	else if (kind == MTS_STREAM_ERROR)
+	{
+		receiveAll(fd, payload, 2);
+		std::vector<unsigned char> message(streamGetInteger(payload, 2) + 1, 0);
+		receiveAll(fd, &message[0], message.size() - 1);
+		result.failure = reinterpret_cast<const char*>(&message[0]);
+		result.errors++;
+	}
+	else
+		throw std::runtime_error("invalid frame from the daemon");
+	return kind;
+}
+
+static void runSession(const std::string &address, int session, double rate, double seconds, int predicates,
+		SessionResult &result)
+{
+	int fd = -1;
+	try
+	{
+		fd = connectTo(address);
+
+		std::vector<unsigned char> frames;
+		frames.push_back(MTS_STREAM_HELLO);
+		streamPutInteger(frames, predicates, 2);
+		sendAll(fd, frames);
+		if (receiveFrame(fd, result) != MTS_STREAM_READY)
+			throw std::runtime_error("no reply to HELLO: " + result.failure);
+
+		const unsigned long long total = static_cast<unsigned long long>(rate * seconds);
+		const unsigned long long batch = static_cast<unsigned long long>(rate / 1000) > 0 ? static_cast<unsigned long long>(rate / 1000) : 1;
+		std::vector<unsigned char> preds(predicates, 1);
+		unsigned long long seed = 1000 + session; // linear congruential generator of the session (rand is shared by the threads)
+
+		const Clock::time_point start = Clock::now();
+		for (unsigned long long k = 0; k < total; k += batch)
+		{
+			// the batch is sent at its instant on the wall clock
+			std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(k / rate)));
+
+			frames.clear();
+			for (unsigned long long j = k; j < k + batch && j < total; j++)
+			{
+				for (int p = 0; p < predicates; p++)
+				{
+					seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+					if ((seed >> 33) % 100 == 0)
+						preds[p] = !preds[p];
+				}
+				streamPutSample(frames, j / rate, preds, predicates);
+			}
+			sendAll(fd, frames);
+		}
+		const Clock::time_point sent = Clock::now();
+
+		frames.assign(1, MTS_STREAM_END);
+		sendAll(fd, frames);
+		unsigned char kind;
+		do
+			kind = receiveFrame(fd, result);
+		while (kind != MTS_STREAM_DONE && kind != MTS_STREAM_ERROR);
+		const Clock::time_point done = Clock::now();
+
+		result.samples = total;
+		result.sendSeconds = std::chrono::duration<double>(sent - start).count();
+		result.doneSeconds = std::chrono::duration<double>(done - start).count();
+		result.drainSeconds = std::chrono::duration<double>(done - sent).count();
+	}
+	catch (std::exception &e)
+	{
+		result.failure = e.what();
+		result.errors++;
+	}
+	if (fd >= 0)
+		close(fd);
+}
+
+static void printResult(const std::string &name, const SessionResult &result)
+{
+	std::printf("%s,%llu,%.0f,%.0f,%.3f,%lu,%lu\n", name.c_str(), result.samples,
+			result.sendSeconds > 0 ? result.samples / result.sendSeconds : 0,
+			result.doneSeconds > 0 ? result.samples / result.doneSeconds : 0, result.drainSeconds * 1000,
+			result.violations, result.errors);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc == 3 && std::strcmp(argv[1], "-f") == 0)
+	{
+		try {
+			writeFormula(argv[2]);
+		}
+		catch (std::exception &e)
+		{
+			std::cerr << "error: " << e.what() << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	if (argc < 2 || argc > 6)
+	{
+		std::cerr << "usage: daemon_bench -f <bytecode file>" << std::endl
+				  << "       daemon_bench <unix:path | tcp:host:port> [sessions] [samples per second] [seconds] [predicates]" << std::endl;
+		return 1;
+	}
+
+	const std::string address = argv[1];
+	const int sessions = argc > 2 ? std::atoi(argv[2]) : 4;
+	const double rate = argc > 3 ? std::atof(argv[3]) : 100000;
+	const double seconds = argc > 4 ? std::atof(argv[4]) : 5;
+	const int predicates = argc > 5 ? std::atoi(argv[5]) : 4;
+
+	std::vector<SessionResult> results(sessions > 0 ? sessions : 0);
+	std::vector<std::thread> clients;
+	for (int i = 0; i < sessions; i++)
+		clients.push_back(std::thread(runSession, address, i, rate, seconds, predicates, std::ref(results[i])));
+	for (size_t i = 0; i < clients.size(); i++)
+		clients[i].join();
+
+	std::printf("session,samples,sent_per_second,done_per_second,drain_ms,violations,errors\n");
+	SessionResult total;
+	for (int i = 0; i < sessions; i++)
+	{
+		printResult(std::to_string(i), results[i]);
+		if (!results[i].failure.empty())
+			std::cerr << "session " << i << ": " << results[i].failure << std::endl;
+
+		total.samples += results[i].samples;
+		total.violations += results[i].violations;
+		total.errors += results[i].errors;
+		total.sendSeconds = std::max(total.sendSeconds, results[i].sendSeconds);
+		total.doneSeconds = std::max(total.doneSeconds, results[i].doneSeconds);
+		total.drainSeconds = std::max(total.drainSeconds, results[i].drainSeconds);
+	}
+	printResult("total", total);
+
+	return total.errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+// Heap accounting of the benchmarks (see heap_counter.h): replaces the global allocation functions.
+
+#include <cstdlib>
+#include <new>
+
+#include "heap_counter.h"
+
+static const std::size_t headersize = 16; // room for the size of the block, keeping the alignment of malloc
+static std::size_t allocatedbytes = 0;
+static std::size_t peakbytes = 0;
+static unsigned long allocationcount = 0;
+
+void* operator new(std::size_t size)
+{
+	// the size is stored before the block, to be subtracted by delete
+	std::size_t *block = static_cast<std::size_t*>(std::malloc(size + headersize));
+	if (block == NULL)
+		throw std::bad_alloc();
+
+	*block = size;
+	allocatedbytes += size;
+	allocationcount++;
+	if (allocatedbytes > peakbytes)
+		peakbytes = allocatedbytes;
+
+	return reinterpret_cast<char*>(block) + headersize;
+}
+
+void operator delete(void *p) throw()
+{
+	if (p == NULL)
+		return;
+
+	std::size_t *block = reinterpret_cast<std::size_t*>(static_cast<char*>(p) - headersize);
+	allocatedbytes -= *block;
+	std::free(block);
+}
+
+void* operator new[](std::size_t size) {return operator new(size);}
+void operator delete[](void *p) throw() {operator delete(p);}
+
+#ifdef __cpp_sized_deallocation
+// the size given by the caller is the one stored in the block
+void operator delete(void *p, std::size_t) throw() {operator delete(p);}
+void operator delete[](void *p, std::size_t) throw() {operator delete(p);}
+#endif
+
+std::size_t heapAllocatedBytes(void)
+{
+	return allocatedbytes;
+}
+
+std::size_t heapPeakBytes(void)
+{
+	return peakbytes;
+}
+
+void resetHeapPeak(void)
+{
+	peakbytes = allocatedbytes;
+}
+
+unsigned long heapAllocationCount(void)
+{
+	return allocationcount;
+}
@@ -0,0 +1,26 @@
+#ifndef HEAP_COUNTER_H_
+#define HEAP_COUNTER_H_
+
+#include <cstddef>
+
+/*
+ Heap accounting of the benchmarks: heap_counter.cpp replaces the global allocation functions (operator new and delete, single
+ and array forms) with ones that count the blocks and the bytes allocated through them, so it must be linked with the benchmark.
+
+ The replacement functions are in a translation unit of their own, so that they are not inlined in their callers: once inlined,
+ the compiler sees the malloc of operator new reach operator delete and warns of mismatched allocation functions.
+ */
+
+/// \brief Bytes currently allocated through operator new (the size requested, without the bookkeeping).
+std::size_t heapAllocatedBytes(void);
+
+/// \brief Greatest value of heapAllocatedBytes since the start of the program or the last call to resetHeapPeak.
+std::size_t heapPeakBytes(void);
+
+/// \brief Restarts the peak from the bytes currently allocated.
+void resetHeapPeak(void);
+
+/// \brief Number of calls to operator new since the start of the program.
+unsigned long heapAllocationCount(void);
+
+#endif /* HEAP_COUNTER_H_ */
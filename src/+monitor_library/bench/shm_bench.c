@@ -0,0 +1,80 @@
+/*
+ Producer of a synthetic trace in shared memory (see shm_ring.h), for the throughput of tools/shm_monitor.cpp and as an example of
+ the producer API.
+
+ The producer is a plain C program for Linux or any POSIX system, e.g. from the +monitor_library folder:
+
+	gcc -O2 -Iheaders bench/shm_bench.c misc/shm_ring.c -o shm_bench
+	./shm_bench /mts_bench [samples] [predicates] [slots] & ./shm_monitor /mts_bench formula.mtsb
+
+ It writes the given number of samples (default 10000000) of the given number of predicates (default 4), at instants 0.001
+ seconds apart, into a ring of the given number of slots (default 65536), with predicates changing value with probability 0.01
+ at each sample. When the ring is full the producer yields the processor and retries (it never drops a sample). It prints the samples written per second
+ and how many times it found the ring full.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "shm_ring.h"
+
+static double now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long long samples, k, full = 0, seed = 1;
+	unsigned predicates, slots, p;
+	unsigned char *preds;
+	mts_ring *ring;
+	double start, seconds;
+
+	if (argc < 2 || argc > 5)
+	{
+		fprintf(stderr, "usage: shm_bench <shared memory name> [samples] [predicates] [slots]\n");
+		return 1;
+	}
+	samples = argc > 2 ? strtoull(argv[2], NULL, 10) : 10000000ULL;
+	predicates = argc > 3 ? (unsigned)atoi(argv[3]) : 4;
+	slots = argc > 4 ? (unsigned)atoi(argv[4]) : 65536;
+
+	ring = mts_ring_create(argv[1], predicates, slots);
+	preds = (unsigned char*)calloc(predicates + 1, 1);
+	if (ring == NULL || preds == NULL)
+	{
+		perror("shm_bench");
+		return 1;
+	}
+	for (p = 0; p < predicates; p++)
+		preds[p] = 1;
+
+	start = now();
+	for (k = 0; k < samples; k++)
+	{
+		for (p = 0; p < predicates; p++)
+		{
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			if ((seed >> 33) % 100 == 0)
+				preds[p] = !preds[p];
+		}
+		while (mts_ring_push(ring, k * 0.001, preds) == MTS_RING_FULL)
+		{
+			full++;
+			sched_yield();
+		}
+	}
+	mts_ring_finish(ring);
+	seconds = now() - start;
+
+	printf("%llu samples in %.3f s (%.0f samples per second), ring full %llu times\n", samples, seconds, samples / seconds, full);
+	mts_ring_close(ring);
+	free(preds);
+	return 0;
+}
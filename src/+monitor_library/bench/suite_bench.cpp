@@ -0,0 +1,285 @@
+// Benchmark suite of the interpreter (Monitor) on synthetic workloads, for regression tracking of the engine.
+//
+// The suite is a plain C++ program (no MATLAB needed), e.g. from the +monitor_library folder:
+//
+//	g++ -O2 -Iheaders bench/suite_bench.cpp bench/heap_counter.cpp matlab/buildval.cpp misc/*.cpp validators/*.cpp -o suite_bench
+//	./suite_bench [steps] [workload name filter] > results.csv
+//
+// Each workload is a formula family (with its depth or width and its window length alpha) monitored on a generated trace of
+// the given number of steps (fixed step 0.01 seconds, default 100000 steps). The traces are generated before the monitor is
+// created, with a fixed seed, according to a pattern:
+//
+//	uniform		each predicate changes value at each step with the toggle probability.
+//	bursty		as uniform, but the toggle probability is multiplied by 10 during bursts of 2 seconds every 20 seconds.
+//	chatter		as uniform, but during a window of 0.5 seconds every 5 seconds the predicates change value at every step.
+//
+// The formula families are (pI is the predicate I modulo the number of predicates):
+//
+//	until		p0 U[0,alpha] (p1 U[0,alpha] (... U[0,alpha] pD)), with D the depth.
+//	orbank		F[0,alpha/W] p0 OR F[0,2*alpha/W] p1 OR ... OR F[0,alpha] pW-1, with W the width.
+//	balanced	complete tree of the given depth alternating G[0,alpha] (x AND y) and F[0,alpha] (x OR y), predicates as leaves.
+//	since		p0 S[0,alpha] (p1 S[0,alpha] (... S[0,alpha] pD)), with D the depth.
+//	mixed		G[0,alpha] (p0 OR F[0,alpha/2] p1) AND H[0,alpha] (p2 OR O[0,alpha/2] p3).
+//
+// The output is CSV (a header line, then one line per workload) with the columns:
+//
+//	workload, family, size, alpha, predicates, pattern, toggle, steps, nodes	the parameters of the workload.
+//	ns_per_step, samples_per_second												time of initialConditions and extendTrace.
+//	allocations_per_step, peak_heap_bytes										heap allocations of the monitor (operator new).
+//	peak_intervals		sum over the nodes of the largest number of intervals stored (empty unless the suite is compiled with
+//						-DMTS_INSTRUMENTATION, in which case the time includes the probes, see instrumentation.h).
+//	peak_rss_kb			peak resident memory of the process so far (it never decreases from a workload to the next one).
+//	violated_seconds	measure of the instants where the formula is false (a check that the work was not optimized away).
+//
+// The worst cases known for the engine are included: nested untils with a large window and wide banks of disjunctions, on
+// chattering traces.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include "validators.h"
+#include "bytecode.h"
+#include "heap_counter.h"
+
+
+static long peakResidentKilobytes(void)
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return -1;
+	return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+#else
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return -1;
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+// bytecode of the formulas (see bytecode.h) -----------------------------------------------------------
+static void pushPredicate(std::vector<unsigned char> &code, unsigned long index, int predicates)
+{
+	writePredicateNode(code, index % predicates);
+}
+
+static void pushBalanced(std::vector<unsigned char> &code, int depth, double alpha, int predicates, unsigned long &leaf)
+{
+	if (depth == 0)
+	{
+		pushPredicate(code, leaf++, predicates);
+		return;
+	}
+
+	if (depth % 2 == 0)
+	{
+		writeFutureNode(code, MTS_GLOBALLY, 0, alpha);
+		writeOperatorNode(code, MTS_AND);
+	}
+	else
+	{
+		writeFutureNode(code, MTS_FUTURE, 0, alpha);
+		writeOperatorNode(code, MTS_OR);
+	}
+	pushBalanced(code, depth - 1, alpha, predicates, leaf);
+	pushBalanced(code, depth - 1, alpha, predicates, leaf);
+}
+
+static std::vector<unsigned char> formulaBytecode(const std::string &family, int size, double alpha, int predicates)
+{
+	std::vector<unsigned char> code;
+	writeBytecodeHeader(code);
+
+	if (family == "until" || family == "since")
+	{
+		for (int i = 0; i < size; i++)
+		{
+			if (family == "until")
+				writeFutureNode(code, MTS_UNTIL, 0, alpha);
+			else
+				writePastNode(code, MTS_SINCE, alpha);
+			pushPredicate(code, i, predicates);
+		}
+		pushPredicate(code, size, predicates);
+	}
+	else if (family == "orbank")
+	{
+		for (int i = 0; i < size; i++)
+		{
+			if (i < size - 1)
+				writeOperatorNode(code, MTS_OR);
+			writeFutureNode(code, MTS_FUTURE, 0, alpha * (i + 1) / size);
+			pushPredicate(code, i, predicates);
+		}
+	}
+	else if (family == "balanced")
+	{
+		unsigned long leaf = 0;
+		pushBalanced(code, size, alpha, predicates, leaf);
+	}
+	else // mixed
+	{
+		writeOperatorNode(code, MTS_AND);
+		writeFutureNode(code, MTS_GLOBALLY, 0, alpha);
+		writeOperatorNode(code, MTS_OR);
+		pushPredicate(code, 0, predicates);
+		writeFutureNode(code, MTS_FUTURE, 0, alpha / 2);
+		pushPredicate(code, 1, predicates);
+		writePastNode(code, MTS_HISTORICALLY, alpha);
+		writeOperatorNode(code, MTS_OR);
+		pushPredicate(code, 2, predicates);
+		writePastNode(code, MTS_ONCE, alpha / 2);
+		pushPredicate(code, 3, predicates);
+	}
+	return code;
+}
+
+// traces ---------------------------------------------------------------------------------------------------
+static const double step = 0.01;
+
+static bool toggles(const std::string &pattern, double toggle, long i)
+{
+	const double t = i * step;
+
+	if (pattern == "bursty" && std::fmod(t, 20.0) < 2.0)
+		toggle = std::min(1.0, 10 * toggle);
+	else if (pattern == "chatter" && std::fmod(t, 5.0) < 0.5)
+		return true;
+
+	return std::rand() < toggle * RAND_MAX;
+}
+
+static void generateTrace(std::vector< std::vector<BooleanType> > &trace, const std::string &pattern, double toggle, int predicates)
+{
+	std::srand(42);
+	for (long i = 0; i < long(trace.size()); i++)
+	{
+		trace[i].resize(predicates);
+		for (int p = 0; p < predicates; p++)
+		{
+			BooleanType previous = i > 0 ? trace[i-1][p] : BooleanType(p % 2);
+			trace[i][p] = toggles(pattern, toggle, i) ? !previous : previous;
+		}
+	}
+}
+
+// workloads ------------------------------------------------------------------------------------------------
+struct Workload
+{
+	const char *name;
+	const char *family;
+	int size; // depth or width of the formula
+	double alpha;
+	int predicates;
+	const char *pattern;
+	double toggle;
+};
+
+static const Workload workloads[] = {
+	// formula depth
+	{"until-depth-2",		"until",	2,	10,		4,	"uniform",	0.05},
+	{"until-depth-4",		"until",	4,	10,		4,	"uniform",	0.05},
+	{"until-depth-8",		"until",	8,	10,		4,	"uniform",	0.05},
+	{"since-depth-4",		"since",	4,	10,		4,	"uniform",	0.05},
+	{"balanced-depth-2",	"balanced",	2,	5,		4,	"uniform",	0.05},
+	{"balanced-depth-4",	"balanced",	4,	5,		8,	"uniform",	0.05},
+	{"balanced-depth-6",	"balanced",	6,	5,		16,	"uniform",	0.05},
+	// formula width and number of predicates
+	{"orbank-4",			"orbank",	4,	5,		4,	"uniform",	0.05},
+	{"orbank-16",			"orbank",	16,	5,		16,	"uniform",	0.05},
+	{"orbank-64",			"orbank",	64,	5,		64,	"uniform",	0.05},
+	// window length
+	{"until-alpha-1",		"until",	3,	1,		4,	"uniform",	0.05},
+	{"until-alpha-10",		"until",	3,	10,		4,	"uniform",	0.05},
+	{"until-alpha-100",		"until",	3,	100,	4,	"uniform",	0.05},
+	// toggle rate and patterns
+	{"mixed-toggle-0.001",	"mixed",	0,	10,		4,	"uniform",	0.001},
+	{"mixed-toggle-0.05",	"mixed",	0,	10,		4,	"uniform",	0.05},
+	{"mixed-toggle-0.5",	"mixed",	0,	10,		4,	"uniform",	0.5},
+	{"mixed-bursty",		"mixed",	0,	10,		4,	"bursty",	0.05},
+	{"mixed-chatter",		"mixed",	0,	10,		4,	"chatter",	0.01},
+	// known worst cases
+	{"worst-until-nested",	"until",	6,	100,	4,	"chatter",	0.05},
+	{"worst-orbank",		"orbank",	64,	50,		64,	"chatter",	0.05},
+};
+
+static void runWorkload(const Workload &w, long steps)
+{
+	std::vector< std::vector<BooleanType> > trace(steps);
+	generateTrace(trace, w.pattern, w.toggle, w.predicates);
+	std::vector<unsigned char> code = formulaBytecode(w.family, w.size, w.alpha, w.predicates);
+
+	const std::size_t basebytes = heapAllocatedBytes();
+	resetHeapPeak();
+	const unsigned long baseallocations = heapAllocationCount();
+
+	std::size_t nodes = 0, peakintervals = 0;
+	double seconds = 0, violated = 0;
+	{
+		std::clock_t begin = std::clock();
+		Monitor monitor(&code[0], code.size());
+		monitor.initialConditions(TimePolicy::fromSeconds(0), trace[0]);
+
+		for (long i = 1; i < steps; i++)
+			monitor.extendTrace(TimePolicy::fromSeconds(i*step), trace[i]);
+
+		seconds = double(std::clock() - begin) / CLOCKS_PER_SEC;
+
+		const Signal &evaluation = monitor.formulaEvaluation();
+		for (Signal::const_iterator it = evaluation.getBegin(); it != evaluation.getEnd(); it++)
+			violated += TimePolicy::toSeconds(it->rightLimit - it->leftLimit);
+
+		std::vector<NodeStats> stats = monitor.statistics();
+		nodes = stats.size();
+		for (std::vector<NodeStats>::const_iterator it = stats.begin(); it != stats.end(); it++)
+			peakintervals += it->peakIntervals;
+	}
+	const unsigned long allocations = heapAllocationCount() - baseallocations;
+
+	std::cout << w.name << ',' << w.family << ',' << w.size << ',' << w.alpha << ',' << w.predicates << ','
+			  << w.pattern << ',' << w.toggle << ',' << steps << ',' << nodes << ','
+			  << seconds * 1e9 / steps << ',' << (seconds > 0 ? steps / seconds : 0) << ','
+			  << double(allocations) / steps << ',' << heapPeakBytes() - basebytes << ',';
+	if (Monitor::isInstrumented())
+		std::cout << peakintervals;
+	std::cout << ',' << peakResidentKilobytes() << ',' << violated << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+	const long steps = argc > 1 ? std::atol(argv[1]) : 100000;
+	const std::string filter = argc > 2 ? argv[2] : "";
+
+	if (steps < 2)
+	{
+		std::cerr << "usage: suite_bench [steps >= 2] [workload name filter]" << std::endl;
+		return 1;
+	}
+
+	std::cout << "workload,family,size,alpha,predicates,pattern,toggle,steps,nodes,ns_per_step,samples_per_second,"
+			  << "allocations_per_step,peak_heap_bytes,peak_intervals,peak_rss_kb,violated_seconds" << std::endl;
+
+	for (std::size_t i = 0; i < sizeof(workloads) / sizeof(workloads[0]); i++)
+		if (std::string(workloads[i].name).find(filter) != std::string::npos)
+			runWorkload(workloads[i], steps);
+
+	return 0;
+}
@@ -0,0 +1,106 @@
+// Benchmark of the time representations of the monitors (see the time policies in type_transl.h): the same program is compiled
+// once for each policy, e.g. from the +monitor_library folder:
+//
+//	for policy in DoubleTime FloatTime Int64Ticks Int32Ticks; do
+//		g++ -O2 -DMTS_TIME_POLICY=$policy -Iheaders bench/time_bench.cpp bench/heap_counter.cpp matlab/buildval.cpp misc/*.cpp validators/*.cpp -o time_bench_$policy
+//		./time_bench_$policy [steps] [toggle probability]
+//	done
+//
+// The interpreter monitors the formula
+//
+//	GLOBALLY[0,10] (p0 OR p1 UNTIL[0,5] p2) AND FUTURE[1,4] p3 AND HISTORICALLY[0,2] p4
+//
+// on a random trace with fixed step 0.01 seconds (each predicate changes value at each step with the given probability; the trace
+// does not depend on the policy). The program reports the size of an interval, the peak of the heap memory allocated by the
+// monitor (including its evaluation), the time per step and the measure (in seconds) of the instants where the formula is false.
+// The latter must be the same for every policy whose resolution divides the step (FloatTime only approximates it).
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "validators.h"
+#include "bytecode.h"
+#include "heap_counter.h"
+
+
+static const char* policyName(void)
+{
+#define MTS_STRINGIFY2(x) #x
+#define MTS_STRINGIFY(x) MTS_STRINGIFY2(x)
+	return MTS_STRINGIFY(MTS_TIME_POLICY);
+}
+
+// bytecode of the formula (see bytecode.h)
+static std::vector<unsigned char> benchBytecode(void)
+{
+	std::vector<unsigned char> code;
+	writeBytecodeHeader(code);
+
+	writeOperatorNode(code, MTS_AND);
+	writeFutureNode(code, MTS_GLOBALLY, 0, 10);
+	writeOperatorNode(code, MTS_OR);
+	writePredicateNode(code, 0);
+	writeFutureNode(code, MTS_UNTIL, 0, 5);
+	writePredicateNode(code, 1);
+	writePredicateNode(code, 2);
+	writeOperatorNode(code, MTS_AND);
+	writeFutureNode(code, MTS_FUTURE, 1, 4);
+	writePredicateNode(code, 3);
+	writePastNode(code, MTS_HISTORICALLY, 2);
+	writePredicateNode(code, 4);
+	return code;
+}
+
+int main(int argc, char **argv)
+{
+	const long steps = argc > 1 ? std::atol(argv[1]) : 200000;
+	const double toggle = argc > 2 ? std::atof(argv[2]) : 0.05;
+	const double step = 0.01;
+	const int predicates = 5;
+
+	if (steps < 2 || toggle < 0 || toggle > 1)
+	{
+		std::cerr << "usage: time_bench [steps >= 2] [toggle probability in [0,1]]" << std::endl;
+		return 1;
+	}
+
+	// random trace (generated before the monitor, so that its memory is not accounted)
+	std::srand(42);
+	std::vector< std::vector<BooleanType> > trace(steps, std::vector<BooleanType>(predicates));
+	for (long i = 0; i < steps; i++)
+		for (int p = 0; p < predicates; p++)
+		{
+			BooleanType previous = i > 0 ? trace[i-1][p] : 1;
+			trace[i][p] = (std::rand() < toggle * RAND_MAX) ? !previous : previous;
+		}
+
+	std::vector<unsigned char> code = benchBytecode();
+	const std::size_t basebytes = heapAllocatedBytes();
+	resetHeapPeak();
+
+	std::clock_t begin = std::clock();
+	double violated = 0;
+	{
+		Monitor monitor(&code[0], code.size());
+		monitor.initialConditions(TimePolicy::fromSeconds(0), trace[0]);
+
+		for (long i = 1; i < steps; i++)
+			monitor.extendTrace(TimePolicy::fromSeconds(i*step), trace[i]);
+
+		const Signal &evaluation = monitor.formulaEvaluation();
+		for (Signal::const_iterator it = evaluation.getBegin(); it != evaluation.getEnd(); it++)
+			violated += TimePolicy::toSeconds(it->rightLimit - it->leftLimit);
+	}
+	double seconds = double(std::clock() - begin) / CLOCKS_PER_SEC;
+
+	std::cout << "policy:          " << policyName() << std::endl;
+	std::cout << "steps:           " << steps << ", toggle probability: " << toggle << std::endl;
+	std::cout << "interval size:   " << sizeof(Interval) << " bytes" << std::endl;
+	std::cout << "peak heap:       " << heapPeakBytes() - basebytes << " bytes" << std::endl;
+	std::cout << "time per step:   " << seconds * 1e9 / steps << " ns" << std::endl;
+	std::cout << "violated:        " << violated << " s" << std::endl;
+
+	return 0;
+}
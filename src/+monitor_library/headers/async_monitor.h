@@ -0,0 +1,343 @@
+#ifndef ASYNC_MONITOR_H_
+#define ASYNC_MONITOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "type_transl.h"
+
+/*
+ Evaluation of a monitor on a worker thread (requires C++11).
+
+ The thread of the simulation queues the samples of the trace (instant and predicate values) in a lock-free single-producer
+ single-consumer queue, and a worker thread extends the trace of the monitor with them. The verdict is the one of the last
+ sample evaluated by the worker, so it can lag behind the trace: this suits the monitors whose output is only logged, and whose
+ evaluation would otherwise add to the time of every simulation step.
+ */
+
+/**
+ \brief Statistics of the queue of an AsyncMonitor.
+ */
+struct AsyncStats
+{
+	size_t capacity; /**< number of samples the queue can hold*/
+	size_t depth; /**< samples in the queue, not yet evaluated*/
+	size_t maxdepth; /**< largest number of samples in the queue*/
+	unsigned long pushed; /**< samples queued*/
+	unsigned long dropped; /**< samples dropped because the queue was full (policy DROP)*/
+	unsigned long waits; /**< samples that waited for the worker because the queue was full (policy BLOCK)*/
+
+	AsyncStats(void): capacity(0), depth(0), maxdepth(0), pushed(0), dropped(0), waits(0) {}
+};
+
+/**
+ \brief Lock-free queue of samples between one producer and one consumer thread.
+ Each sample is an instant and the values of *width* predicates, packed one bit per predicate. The storage is allocated by the
+ constructor.
+ */
+class SampleQueue
+{
+private:
+	std::vector<TimeType> times;
+	std::vector<unsigned char> bits; /**< predicate values of each sample, *stride* bytes per sample*/
+	size_t width;
+	size_t stride;
+	size_t mask; /**< capacity minus one (the capacity is a power of two)*/
+	std::atomic<size_t> head; /**< number of samples popped (written by the consumer only)*/
+	std::atomic<size_t> tail; /**< number of samples pushed (written by the producer only)*/
+
+public:
+	/**
+	 \brief Create a queue of at least *capacity* samples (rounded up to a power of two) of *width* predicates.
+	 \exception std::invalid_argument if *capacity* is zero.
+	 */
+	SampleQueue(size_t capacity, size_t w): times(), bits(), width(w), stride((w + 7) / 8), mask(0), head(0), tail(0)
+	{
+		if (capacity == 0)
+			throw std::invalid_argument("SampleQueue: The capacity must be greater than zero.");
+
+		size_t size = 1;
+		while (size < capacity)
+			size *= 2;
+
+		times.resize(size);
+		bits.resize(size * stride);
+		mask = size - 1;
+	}
+
+	/**
+	 \brief Append a sample, unless the queue is full (producer thread only).
+	 \returns false if the queue is full.
+	 */
+	template <class Preds> bool push(TimeType t, const Preds &preds)
+	{
+		size_t end = tail.load(std::memory_order_relaxed);
+		if (end - head.load(std::memory_order_acquire) > mask)
+			return false;
+
+		size_t slot = end & mask;
+		unsigned char *packed = &bits[slot * stride];
+		for (size_t i = 0; i < stride; i++)
+			packed[i] = 0;
+		for (size_t i = 0; i < width; i++)
+			if (preds[i])
+				packed[i / 8] |= static_cast<unsigned char>(1 << (i % 8));
+
+		times[slot] = t;
+		tail.store(end + 1, std::memory_order_seq_cst);
+		return true;
+	}
+
+	/**
+	 \brief Remove the oldest sample, if any (consumer thread only).
+	 \param t, preds the instant and the predicate values of the sample (*preds* must hold *width* values).
+	 \returns false if the queue is empty.
+	 */
+	bool pop(TimeType &t, std::vector<BooleanType> &preds)
+	{
+		size_t begin = head.load(std::memory_order_relaxed);
+		if (begin == tail.load(std::memory_order_seq_cst))
+			return false;
+
+		size_t slot = begin & mask;
+		const unsigned char *packed = &bits[slot * stride];
+		for (size_t i = 0; i < width; i++)
+			preds[i] = (packed[i / 8] >> (i % 8)) & 1;
+
+		t = times[slot];
+		head.store(begin + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 \brief returns the number of samples in the queue (exact only in the producer or in the consumer thread).
+	 */
+	inline size_t size(void) const {return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);}
+
+	inline size_t capacity(void) const {return mask + 1;}
+};
+
+/**
+ \brief Monitor evaluated on a worker thread.
+
+ The monitor *M* is any type with the interface of Monitor (e.g. Monitor or StaticMonitor): it is extended only by the worker,
+ and the other threads must not use it until stop is invoked (saveState and restoreState wait for the worker and access it
+ safely). Every method must be invoked by the same thread, the producer of the samples.
+
+ When the queue is full, step either waits for the worker to evaluate a sample (policy BLOCK), so that the verdict is exact but
+ the simulation is slowed down, or drops the sample (policy DROP): the monitor then assumes that the predicates keep the values
+ of the previous sample until the next queued one.
+ */
+template <class M>
+class AsyncMonitor
+{
+public:
+	enum Policy {BLOCK, DROP};
+
+private:
+	M &monitor;
+	SampleQueue queue;
+	Policy policy;
+	size_t width;
+
+	std::atomic<bool> violated; /**< verdict after the last sample evaluated*/
+	std::atomic<unsigned long> evaluated; /**< number of samples evaluated by the worker*/
+	std::atomic<bool> failed; /**< whether or not the monitor threw an exception (the following samples are discarded)*/
+	std::string error; /**< message of the exception, written by the worker before failed*/
+	std::atomic<bool> stopping;
+	std::atomic<bool> idle; /**< whether or not the worker is waiting for samples*/
+	std::mutex mutex;
+	std::condition_variable wakeup;
+	AsyncStats stats; /**< statistics of the producer (see statistics)*/
+	std::thread worker;
+
+	AsyncMonitor(const AsyncMonitor &);
+	AsyncMonitor& operator=(const AsyncMonitor &);
+
+	void run(void)
+	{
+		std::vector<BooleanType> preds(width);
+		TimeType t;
+
+		while (true)
+		{
+			if (queue.pop(t, preds))
+			{
+				if (!failed.load(std::memory_order_relaxed))
+				{
+					try {
+						if (monitor.isStarted())
+							monitor.extendTrace(t, preds);
+						else
+							monitor.initialConditions(t, preds);
+						violated.store(!monitor.checkSafety(), std::memory_order_release);
+					}
+					catch (std::exception &e)
+					{
+						error = e.what();
+						failed.store(true, std::memory_order_release);
+					}
+				}
+				evaluated.fetch_add(1, std::memory_order_release);
+				continue;
+			}
+
+			if (stopping.load(std::memory_order_acquire) && queue.size() == 0)
+				return;
+
+			// no sample: the worker sleeps until a push (the timeout only bounds the delay of a missed notification)
+			std::unique_lock<std::mutex> lock(mutex);
+			idle.store(true);
+			if (queue.size() == 0 && !stopping.load())
+				wakeup.wait_for(lock, std::chrono::milliseconds(1));
+			idle.store(false);
+		}
+	}
+
+	void notify(void)
+	{
+		if (idle.load())
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			wakeup.notify_one();
+		}
+	}
+
+	void checkFailure(void)
+	{
+		if (failed.load(std::memory_order_acquire))
+			throw std::invalid_argument(error);
+	}
+
+public:
+	/**
+	 \brief Start the worker thread of a monitor.
+	 \param m monitor evaluated by the worker (not yet started, or restored from a snapshot).
+	 \param capacity number of samples the queue holds at least.
+	 \param w number of predicates of each sample.
+	 \param p behaviour of step when the queue is full.
+	 */
+	AsyncMonitor(M &m, size_t capacity, size_t w, Policy p = BLOCK)
+	: monitor(m), queue(capacity, w), policy(p), width(w),
+	  violated(!m.checkSafety()), evaluated(0), failed(false), error(), stopping(false), idle(false),
+	  mutex(), wakeup(), stats(), worker()
+	{
+		stats.capacity = queue.capacity();
+		worker = std::thread(&AsyncMonitor::run, this);
+	}
+
+	~AsyncMonitor(void)
+	{
+		try {
+			stop();
+		}
+		catch (std::exception &) {}
+	}
+
+	/**
+	 \brief Queue the predicate values of an instant (the first sample starts the monitor).
+	 \exception std::invalid_argument if the monitor threw an exception on a previous sample (e.g. an instant less than the
+	 previous one), with its message.
+	 \exception std::logic_error if the monitor is stopped.
+	 */
+	template <class Preds> void step(TimeType t, const Preds &preds)
+	{
+		checkFailure();
+		if (stopping.load())
+			throw std::logic_error("step: The asynchronous monitor is stopped.");
+
+		if (!queue.push(t, preds))
+		{
+			if (policy == DROP)
+			{
+				stats.dropped++;
+				return;
+			}
+
+			stats.waits++;
+			while (!queue.push(t, preds))
+			{
+				notify();
+				std::this_thread::yield();
+			}
+		}
+
+		stats.pushed++;
+		size_t depth = queue.size();
+		if (depth > stats.maxdepth)
+			stats.maxdepth = depth;
+		notify();
+	}
+
+	/**
+	 \brief Check if the formula is ever false, in the samples evaluated so far (see Monitor::checkSafety).
+	 */
+	inline bool checkSafety(void) const {return !violated.load(std::memory_order_acquire);}
+
+	/**
+	 \brief Wait until the worker has evaluated every queued sample.
+	 \exception std::invalid_argument if the monitor threw an exception on a sample.
+	 */
+	void drain(void)
+	{
+		while (evaluated.load(std::memory_order_acquire) != stats.pushed)
+		{
+			notify();
+			std::this_thread::yield();
+		}
+		checkFailure();
+	}
+
+	/**
+	 \brief Evaluate the queued samples and terminate the worker thread, after which the monitor can be used directly.
+	 \exception std::invalid_argument if the monitor threw an exception on a sample.
+	 */
+	void stop(void)
+	{
+		if (worker.joinable())
+		{
+			stopping.store(true);
+			notify();
+			worker.join();
+		}
+		checkFailure();
+	}
+
+	/**
+	 \brief returns a snapshot of the state of the monitor after every queued sample (see Monitor::saveState).
+	 */
+	std::vector<unsigned char> saveState(void)
+	{
+		drain();
+		return monitor.saveState();
+	}
+
+	/**
+	 \brief restores the state of the monitor, after every queued sample is evaluated (see Monitor::restoreState).
+	 */
+	void restoreState(const unsigned char *data, size_t length)
+	{
+		drain();
+		monitor.restoreState(data, length);
+		violated.store(!monitor.checkSafety(), std::memory_order_release);
+	}
+
+	/**
+	 \brief returns the statistics of the queue.
+	 */
+	AsyncStats statistics(void) const
+	{
+		AsyncStats current = stats;
+		current.depth = queue.size();
+		return current;
+	}
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef BYTECODE_H_
+#define BYTECODE_H_
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "validators.h"
+
+// defining the values of nodetype
+#define MTS_PREDICATE 	0
+#define	MTS_NOT 		1
+#define	MTS_AND 		2
+#define	MTS_OR 			3
+#define	MTS_FUTURE  	4
+#define	MTS_GLOBALLY  	5
+#define	MTS_UNTIL 		6
+#define	MTS_ONCE 		7
+#define	MTS_HISTORICALLY 	8
+#define	MTS_SINCE 		9
+
+/*
+ Bytecode of a syntax tree (version 1).
+
+ The bytecode is a flat array of bytes: the header "MTSB" followed by the version number (1 byte), followed by the nodes of the
+ syntax tree in pre-order. Each node is encoded as its node type (1 byte, same values of the field 'NodeType') followed by:
+ 	 * PREDICATE: the predicate index (unsigned, 4 bytes).
+ 	 * NOT, AND, OR: nothing.
+ 	 * FUTURE, GLOBALLY, UNTIL: the lower bound and the upper bound (alpha) of the window in seconds (IEEE 754 double, 8 bytes each).
+ 	 * ONCE, HISTORICALLY, SINCE: the upper bound (alpha) of the window in seconds (IEEE 754 double, 8 bytes).
+ and then by the encoding of its children (if any). Multi-byte values are little-endian.
+ */
+#define MTS_BYTECODE_MAGIC 		"MTSB"
+#define MTS_BYTECODE_VERSION 	1
+
+/*
+ Greatest depth of the syntax tree of a bytecode (the root has depth 1): the parser, the builders and the nodes of the monitors
+ recurse once per level, so a deeper bytecode is rejected rather than allowed to exhaust the stack.
+ */
+#define MTS_BYTECODE_MAX_DEPTH 	256
+
+// node of a parsed bytecode (the children and the bytes of the node are owned by the parser)
+struct BytecodeNode {
+	int nodetype;
+	PredicateValidatorNode::predicate_index predicateindex;
+	RealType lowerbound;
+	RealType alpha;
+	const BytecodeNode *firstchild;
+	const BytecodeNode *secondchild;
+	const unsigned char *begin; 	// first byte of the encoding of the node
+	const unsigned char *end; 		// byte after the encoding of the node (and of its children)
+};
+
+// parser of the bytecode (see matlab/buildval.cpp)
+const BytecodeNode* parseBytecode(const unsigned char *code, size_t length, std::deque<BytecodeNode> &nodes);
+
+/*
+ Writer of the bytecode (see matlab/buildval.cpp), the counterpart of parseBytecode: writeBytecodeHeader starts the bytecode, then
+ each node is appended before its children, in pre-order. The functions throw std::invalid_argument if the node type does not
+ match the function.
+ 	 * writePredicateNode: PREDICATE.
+ 	 * writeOperatorNode: NOT, AND, OR.
+ 	 * writeFutureNode: FUTURE, GLOBALLY, UNTIL, with the window [lowerbound, alpha].
+ 	 * writePastNode: ONCE, HISTORICALLY, SINCE, with the window [0, alpha].
+ */
+void writeBytecodeHeader(std::vector<unsigned char> &code);
+void writePredicateNode(std::vector<unsigned char> &code, unsigned long index);
+void writeOperatorNode(std::vector<unsigned char> &code, int nodetype);
+void writeFutureNode(std::vector<unsigned char> &code, int nodetype, double lowerbound, double alpha);
+void writePastNode(std::vector<unsigned char> &code, int nodetype, double alpha);
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef INGEST_H_
+#define INGEST_H_
+
+#include <cstddef>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "type_transl.h"
+
+/*
+ Ingestion of the updates of single predicates, received out of order and at different rates (e.g. from different sources of a
+ distributed rig), into the trace of a monitor.
+
+ Each predicate is a signal of its own, with sample-and-hold semantics: its value at an instant t is the value of its update with
+ the greatest instant not greater than t (the last one received, among the updates with that instant), and it is held until its
+ next update, however long the source is silent. The trace of the monitor is the combination of these signals: it changes at the
+ instants of the updates, and the monitor is extended once per distinct instant with the values of all the predicates.
+
+ The updates are buffered in a reorder window: the watermark trails the greatest instant received by *window*, and the trace is
+ final before the watermark. When the watermark moves, the buffered updates before it are given to the monitor in the order of
+ their instants, and the trace is also extended up to the previous watermark (with the values held), so that the verdicts follow
+ the watermark even if no predicate changes. An update with an instant less than the watermark, or not greater than an instant
+ already given to the monitor, is late: it is dropped and counted (see IngestStats). The buffer also holds at most *capacity*
+ updates: when it is full, the updates with the oldest instant are given to the monitor at once.
+
+ The merger guarantees that the instants given to the monitor are strictly increasing, and that every instant is given once, with
+ the values of all the updates of that instant (the last one received for each predicate): the monitor sees the sample-and-hold
+ trace only, not the intermediate values of an instant that a later update of the same instant overrides.
+
+ The trace starts at the first instant where every predicate has a value: the updates before it only set the values held at the
+ start. Otherwise the initial values can be given to the constructor, and the trace starts with the first update.
+ */
+
+/**
+ \brief Counters of a SampleMerger.
+ */
+struct IngestStats
+{
+	unsigned long accepted; /**< updates buffered*/
+	unsigned long late; /**< late updates, dropped*/
+	unsigned long forced; /**< times the buffer was full (the updates of its oldest instant were given to the monitor)*/
+	size_t pending; /**< updates buffered, not yet given to the monitor*/
+	size_t maxpending; /**< largest number of updates buffered*/
+
+	IngestStats(void): accepted(0), late(0), forced(0), pending(0), maxpending(0) {}
+};
+
+/**
+ \brief Merges the out-of-order updates of single predicates into the trace of a monitor (see ingest.h).
+ The monitor *M* is any type with the interface of Monitor (e.g. Monitor or StaticMonitor). It must not be started, and it must
+ be extended only by the merger.
+ */
+template <class M>
+class SampleMerger
+{
+private:
+	typedef std::pair<size_t, BooleanType> Update;
+	typedef std::multimap<TimeType, Update> UpdateMap;
+
+	M &monitor;
+	TimeType window;
+	size_t capacity;
+	UpdateMap pending; /**< updates not yet given to the monitor, in order of instant*/
+	std::vector<BooleanType> values; /**< values of the predicates held after the updates given to the monitor*/
+	std::vector<bool> known; /**< whether or not each predicate has a value*/
+	size_t unknown; /**< number of predicates without a value*/
+	bool received; /**< whether or not an update was received*/
+	TimeType horizon; /**< greatest instant received*/
+	bool bounded; /**< whether or not the watermark was set*/
+	TimeType watermark; /**< the trace is final before this instant*/
+	bool started; /**< whether or not the monitor was started*/
+	TimeType last; /**< last instant given to the monitor*/
+	IngestStats stats;
+
+	/*
+	 POST-CONDITIONS:
+	 	 The monitor is started in *t* if every predicate has a value, or extended up to *t* with the values held (unless it was
+	 	 already extended up to *t*).
+	 */
+	void extendTo(TimeType t)
+	{
+		if (started)
+		{
+			if (t > last)
+				monitor.extendTrace(t, values);
+			else
+				return;
+		}
+		else if (unknown == 0)
+		{
+			monitor.initialConditions(t, values);
+			started = true;
+		}
+		else
+			return;
+		last = t;
+	}
+
+	/*
+	 POST-CONDITIONS:
+	 	 The values held are set by the updates of the oldest instant buffered, which are removed from the buffer.
+	 */
+	void applyOldest(void)
+	{
+		const TimeType instant = pending.begin()->first;
+		while (!pending.empty() && pending.begin()->first == instant)
+		{
+			const Update &u = pending.begin()->second;
+			values[u.first] = u.second;
+			if (!known[u.first])
+			{
+				known[u.first] = true;
+				unknown--;
+			}
+			pending.erase(pending.begin());
+		}
+	}
+
+	/*
+	 PRE-CONDITIONS:
+	 	 Every update before the watermark was given to the monitor.
+
+	 POST-CONDITIONS:
+	 	 The updates before *t* (or up to *t* if *inclusive*) are given to the monitor, which is extended in the instant of each of
+	 	 them and in the watermark, in order. The watermark is not changed.
+	 */
+	void release(TimeType t, bool inclusive)
+	{
+		bool hold = bounded;
+		while (!pending.empty() && (pending.begin()->first < t || (inclusive && pending.begin()->first == t)))
+		{
+			const TimeType instant = pending.begin()->first;
+			if (hold && watermark < instant)
+				extendTo(watermark);
+			hold = hold && watermark > instant;
+			applyOldest();
+			extendTo(instant);
+		}
+		if (hold)
+			extendTo(watermark);
+	}
+
+	void checkPredicate(size_t predicate) const
+	{
+		if (predicate >= values.size())
+			throw std::invalid_argument("SampleMerger: The predicate index is not less than the number of predicates.");
+	}
+
+	void checkArguments(void) const
+	{
+		if (window < TimeType() || capacity == 0)
+			throw std::invalid_argument("SampleMerger: The window must be non negative and the capacity positive.");
+	}
+
+public:
+	/**
+	 \brief Create a merger of *predicates* predicates without initial values (the trace starts when every predicate has a value).
+	 \param w length of the reorder window (non negative).
+	 \param c updates buffered at most (positive).
+	 */
+	SampleMerger(M &m, size_t predicates, TimeType w, size_t c = 65536)
+	: monitor(m), window(w), capacity(c), pending(), values(predicates, 0), known(predicates, false), unknown(predicates),
+	  received(false), horizon(), bounded(false), watermark(), started(false), last(), stats()
+	{
+		checkArguments();
+	}
+
+	/**
+	 \brief Create a merger with the initial values of the predicates (the trace starts with the first update given to the monitor).
+	 */
+	SampleMerger(M &m, const std::vector<BooleanType> &initial, TimeType w, size_t c = 65536)
+	: monitor(m), window(w), capacity(c), pending(), values(initial), known(initial.size(), true), unknown(0),
+	  received(false), horizon(), bounded(false), watermark(), started(false), last(), stats()
+	{
+		checkArguments();
+	}
+
+	/**
+	 \brief Buffer the update of a predicate, and move the watermark if the update extends the greatest instant received.
+	 \returns false if the update is late and it was dropped.
+	 \exception std::invalid_argument if *predicate* is not less than the number of predicates, or if the monitor throws.
+	 */
+	bool update(size_t predicate, TimeType t, bool value)
+	{
+		checkPredicate(predicate);
+		if ((bounded && t < watermark) || (started && t <= last))
+		{
+			stats.late++;
+			return false;
+		}
+
+		pending.insert(std::make_pair(t, Update(predicate, value ? 1 : 0)));
+		stats.accepted++;
+		if (pending.size() > stats.maxpending)
+			stats.maxpending = pending.size();
+		if (!received || t > horizon)
+			horizon = t;
+		received = true;
+
+		advance(horizon - window);
+		if (pending.size() > capacity)
+		{
+			stats.forced++;
+			const TimeType oldest = pending.begin()->first;
+			release(oldest, true);
+			if (!bounded || oldest > watermark)
+				watermark = oldest;
+			bounded = true;
+		}
+		return true;
+	}
+
+	/**
+	 \brief Move the watermark to *t* if *t* is greater (e.g. when every source reported the instant *t*): the trace is final before
+	 *t*, and the updates buffered before *t* are given to the monitor.
+	 */
+	void advance(TimeType t)
+	{
+		if (bounded && t <= watermark)
+			return;
+		release(t, false);
+		watermark = t;
+		bounded = true;
+	}
+
+	/**
+	 \brief Give every buffered update to the monitor (e.g. at the end of the trace): the trace is final up to the greatest instant
+	 received, and the updates not greater than it are late.
+	 */
+	void flush(void)
+	{
+		if (!received)
+			return;
+		advance(horizon);
+		release(horizon, true);
+	}
+
+	/**
+	 \brief returns the instant before which the trace is final (meaningful after the first update).
+	 */
+	inline TimeType getWatermark(void) const {return watermark;}
+
+	/**
+	 \brief returns the counters of the merger.
+	 */
+	IngestStats statistics(void) const
+	{
+		IngestStats current = stats;
+		current.pending = pending.size();
+		return current;
+	}
+};
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef INSTRUMENTATION_H_
+#define INSTRUMENTATION_H_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "misc.h"
+
+/*
+ Instrumentation of the nodes of the interpreted monitors (see Monitor::statistics), compiled in with the macro
+ MTS_INSTRUMENTATION (e.g. -DMTS_INSTRUMENTATION). Each node derives from NodeCounters and opens an UpdateProbe in update, after
+ the update of its children, so that the time and the allocations of a node do not include the ones of its descendants.
+
+ Without the macro NodeCounters is an empty base class and UpdateProbe an empty class, whose inline methods do nothing: the nodes
+ have the same size and the compiler removes every call, hence the instrumentation costs nothing.
+ */
+
+/**
+ \brief Statistics of a node of the monitor, collected since its creation.
+ */
+struct NodeStats
+{
+	std::string label; /**< operator of the node*/
+	unsigned depth; /**< depth of the node in the tree (0 for the root)*/
+	unsigned long updates; /**< number of calls of update*/
+	unsigned long intervalsIn; /**< intervals of the values of the operands read by update*/
+	unsigned long intervalsOut; /**< intervals of the values computed by update*/
+	size_t peakIntervals; /**< largest number of intervals stored by the signals of the node after an update*/
+	double updateSeconds; /**< time spent in update, excluding the update of the children*/
+	unsigned long allocations; /**< allocations of interval storage performed by update, excluding the children*/
+
+	NodeStats(const std::string &l, unsigned d)
+	: label(l), depth(d), updates(0), intervalsIn(0), intervalsOut(0), peakIntervals(0), updateSeconds(0), allocations(0) {}
+};
+
+void printStatistics(std::ostream &, const std::vector<NodeStats> &);
+
+#ifdef MTS_INSTRUMENTATION
+
+double instrumentationClock(void);
+
+/**
+ \brief Counters of the statistics of a node (see NodeStats).
+ */
+class NodeCounters
+{
+private:
+	unsigned long updates;
+	unsigned long intervalsIn;
+	unsigned long intervalsOut;
+	size_t peakIntervals;
+	double updateSeconds;
+	unsigned long allocations;
+
+	friend class UpdateProbe;
+
+protected:
+	NodeCounters(void): updates(0), intervalsIn(0), intervalsOut(0), peakIntervals(0), updateSeconds(0), allocations(0) {}
+
+	inline void countInput(const Signal &s) {intervalsIn += s.getIntervalCount();}
+	inline void countOutput(const Signal &s) {intervalsOut += s.getIntervalCount();}
+	inline void countOutput(size_t n) {intervalsOut += n;}
+	inline void countStored(size_t n) {if (n > peakIntervals) peakIntervals = n;}
+
+public:
+	void exportStats(NodeStats &) const;
+};
+
+/**
+ \brief Accounts an update of a node: the time and the interval allocations from its construction to its destruction.
+ */
+class UpdateProbe
+{
+private:
+	NodeCounters &counters;
+	double begin;
+	unsigned long allocations;
+
+public:
+	explicit UpdateProbe(NodeCounters &c)
+	: counters(c), begin(instrumentationClock()), allocations(IntervalQueue::allocations)
+	{
+		counters.updates++;
+	}
+
+	~UpdateProbe(void)
+	{
+		counters.updateSeconds += instrumentationClock() - begin;
+		counters.allocations += IntervalQueue::allocations - allocations;
+	}
+};
+
+#else
+
+class NodeCounters
+{
+protected:
+	inline void countInput(const Signal &) {}
+	inline void countOutput(const Signal &) {}
+	inline void countOutput(size_t) {}
+	inline void countStored(size_t) {}
+
+public:
+	inline void exportStats(NodeStats &) const {}
+};
+
+class UpdateProbe
+{
+public:
+	explicit UpdateProbe(NodeCounters &) {}
+};
+
+#endif
+
+#endif
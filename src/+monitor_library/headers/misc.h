@@ -1,7 +1,9 @@
 #ifndef MISC_H_
 #define MISC_H_
 
-#include <deque>
+#include <cstddef>
+#include <iterator>
+#include <new>
 #include "type_transl.h"
 #include <iostream>
 
@@ -11,19 +13,157 @@
 \brief structure representing an half closed interval [a,b), with a < b.
  */
 struct Interval {
-	RealType leftLimit;	/**< left limit of the interval*/
-	RealType rightLimit; 	/**< right limit of the interval*/
+	TimeType leftLimit;	/**< left limit of the interval*/
+	TimeType rightLimit; 	/**< right limit of the interval*/
 
-	Interval(RealType, RealType);
+	Interval(TimeType, TimeType);
 };
 
 bool isMergeable(const Interval &,const Interval &);
-bool contains(const Interval &, RealType);
+bool contains(const Interval &, TimeType);
 Interval merge(const Interval &, const Interval &);
 
 
+// IntervalQueue class definitions------------------------------------------------------------
+
+/**
+\brief double-ended queue of intervals stored in a circular array.
+
+The queue offers the operations of std::deque used by Signal, but its storage is only allocated when the queue is full (doubling
+its capacity) and it is not released by pop_front or clear: once a Signal has held its largest number of intervals, adding and
+removing intervals does not allocate memory. The iterators are random access, and are invalidated by any insertion.
+ */
+class IntervalQueue {
+public:
+	typedef std::size_t size_type;
+
+	/**
+	\brief random access iterator over the intervals of the queue, from the front to the back.*/
+	class const_iterator {
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef Interval value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const Interval* pointer;
+		typedef const Interval& reference;
+
+	private:
+		const IntervalQueue *queue;
+		size_type index; ///< position of the interval from the front of the queue
+
+	public:
+		const_iterator(void): queue(NULL), index(0) {}
+		const_iterator(const IntervalQueue *q, size_type i): queue(q), index(i) {}
+
+		inline reference operator*(void) const {return queue->at(index);}
+		inline pointer operator->(void) const {return &queue->at(index);}
+
+		inline const_iterator& operator++(void) {index++; return *this;}
+		inline const_iterator operator++(int) {const_iterator old(*this); index++; return old;}
+		inline const_iterator& operator--(void) {index--; return *this;}
+		inline const_iterator operator--(int) {const_iterator old(*this); index--; return old;}
+
+		inline const_iterator operator+(difference_type n) const {return const_iterator(queue, index + n);}
+		inline const_iterator operator-(difference_type n) const {return const_iterator(queue, index - n);}
+		inline difference_type operator-(const const_iterator &other) const {return difference_type(index) - difference_type(other.index);}
+
+		inline bool operator==(const const_iterator &other) const {return index == other.index && queue == other.queue;}
+		inline bool operator!=(const const_iterator &other) const {return !(*this == other);}
+		inline bool operator<(const const_iterator &other) const {return index < other.index;}
+	};
+
+private:
+	Interval *data; ///< circular array (its capacity is zero or a power of two)
+	size_type capacity;
+	size_type head; ///< position in data of the front of the queue
+	size_type count;
+
+	friend class const_iterator;
+
+	void grow(size_type);
+	inline Interval& at(size_type i) {return data[(head + i) & (capacity - 1)];}
+	inline const Interval& at(size_type i) const {return data[(head + i) & (capacity - 1)];}
+
+public:
+	IntervalQueue(void);
+	IntervalQueue(const IntervalQueue &);
+	IntervalQueue& operator=(const IntervalQueue &);
+	~IntervalQueue(void);
+
+#ifdef MTS_INSTRUMENTATION
+	static unsigned long allocations; ///< number of allocations of the storage of every queue (see instrumentation.h)
+#endif
+
+	void reserve(size_type);
+
+	inline bool empty(void) const {return count == 0;}
+	inline size_type size(void) const {return count;}
+	inline size_type getCapacity(void) const {return capacity;}
+
+	inline Interval& front(void) {return at(0);}
+	inline Interval& back(void) {return at(count - 1);}
+
+	inline const_iterator begin(void) const {return const_iterator(this, 0);}
+	inline const_iterator end(void) const {return const_iterator(this, count);}
+
+	inline void push_back(const Interval &h)
+	{
+		if (count == capacity)
+			grow(count + 1);
+		new (&at(count)) Interval(h);
+		count++;
+	}
+
+	inline void push_front(const Interval &h)
+	{
+		if (count == capacity)
+			grow(count + 1);
+		head = (head + capacity - 1) & (capacity - 1);
+		new (&at(0)) Interval(h);
+		count++;
+	}
+
+	inline void pop_front(void)
+	{
+		head = (head + 1) & (capacity - 1);
+		count--;
+	}
+
+	inline void pop_back(void)
+	{
+		count--;
+	}
+
+	inline void clear(void)
+	{
+		head = 0;
+		count = 0;
+	}
+};
+
+
 // Signal class definitions------------------------------------------------------------------
 
+/**
+\brief state of a Signal at its last checkpoint, and the changes needed to restore it (see Signal::checkpoint).
+
+After the checkpoint the intervals of the signal are a copy of a checkpoint interval cut by Signal::increaseFirst (if *cutfront* is
+true), followed by the *kept* checkpoint intervals still stored, followed by the intervals added after the checkpoint. The checkpoint
+intervals removed from the front are moved to *removed*, and the only change to a stored checkpoint interval is the extension of
+the last one by Signal::addInterval.
+*/
+struct SignalJournal {
+	bool active; ///< whether or not the signal records its changes
+	TimeType first; ///< left limit of the domain at the checkpoint
+	TimeType last; ///< right limit of the domain at the checkpoint
+	TimeType backright; ///< right limit of the last interval at the checkpoint
+	IntervalQueue::size_type kept; ///< number of checkpoint intervals still stored
+	bool cutfront; ///< whether or not the front interval is a cut copy of a checkpoint interval
+	IntervalQueue removed; ///< checkpoint intervals removed from the front, in order
+
+	SignalJournal(void): active(false), first(), last(), backright(), kept(0), cutfront(false), removed() {}
+};
+
 /**
 class representing a function \f$f:[a,b)->\{1,0\}\f$, with \f$a \le b\f$ (if \f$a=b\f$ then *f* is the empty function), such as:
 	- The preimage of \f${1}\f$ is an union of finite intervals *[x,y)*, with *x < y*.
@@ -48,32 +188,48 @@ Then the pair \f$(D, I)\f$ representing it is:
 class Signal {
 
 public:
-	typedef  std::deque<Interval>::size_type size_type;
-	typedef std::deque<Interval>::const_iterator const_iterator;
+	typedef IntervalQueue::size_type size_type;
+	typedef IntervalQueue::const_iterator const_iterator;
 
 private:
-	RealType first; ///< smallest element in the signal domain
-	RealType last; ///< greatest element in the signal domain
-	std::deque<Interval> intervals; ///< queue that contains the intervals representing the preimage of {1}
+	TimeType first; ///< smallest element in the signal domain
+	TimeType last; ///< greatest element in the signal domain
+	IntervalQueue intervals; ///< queue that contains the intervals representing the preimage of {1}
+	SignalJournal *journal; ///< changes since the last checkpoint (allocated by the first checkpoint)
+
+	inline bool isJournaling(void) const {return journal != NULL && journal->active;}
+	void popFront(void);
+	void removeAll(void);
 
 public:
-	Signal(RealType, RealType);
-	void increaseFirst(const RealType);
-	void increaseLast(const RealType);
-	void addInterval(const RealType, const RealType);
-	void reset(RealType, RealType);
+	Signal(TimeType, TimeType);
+	Signal(const Signal &);
+	Signal& operator=(const Signal &);
+	~Signal(void);
+	void increaseFirst(const TimeType);
+	void increaseLast(const TimeType);
+	void addInterval(const TimeType, const TimeType);
+	void reset(TimeType, TimeType);
 	void append(const Signal&);
+	Signal::const_iterator getIntervalFrom(const TimeType) const;
+	void checkpoint(void);
+	void commit(void);
+	void rollback(void);
+
+	/**
+	\brief allocate the storage for a given number of intervals (see IntervalQueue::reserve).*/
+	inline void reserve(Signal::size_type n) {intervals.reserve(n);};
 
 
 	/**
 	\brief return the left limit of the domain.
 	\return the smallest element in the caller Signal domain (i.e. the left limit of the domain).*/
-	inline RealType getFirst(void)const{return first;};
+	inline TimeType getFirst(void)const{return first;};
 
 	/**
 	\brief return the right limit of the domain.
 	\return the greatest element in the caller Signal domain (i.e. the right limit of the domain).*/
-	inline RealType getLast(void)const{return last;};
+	inline TimeType getLast(void)const{return last;};
 
 	/**
 	\brief return the number of disjunct intervals in the preimage of *{1}*.*/
@@ -91,4 +247,17 @@ public:
 
 };
 
+void computeComplement(const Signal &, Signal &);
+void computeUnion(const Signal &, const Signal &, Signal &);
+void computeIntersection(const Signal &, const Signal &, Signal &);
+void computeDifference(const Signal &, const Signal &, Signal &);
+void appendComplement(Signal &, const Signal &, TimeType);
+void computeKnownValues(const Signal &, const Signal &, const Signal &, Signal &, Signal &);
+
+// kernels of the temporal operators (defined with the validator nodes that use them, see untilvalidator.cpp, sincevalidator.cpp
+// and signalbuffer.cpp), shared with the monitors generated ahead of time (see static_validators.h)
+void computeUntil(const Signal &, const Signal &, TimeType, Signal &, TimeType, TimeType);
+void computeSince(const Signal &, const Signal &, TimeType, Signal &, TimeType, TimeType &);
+void appendCoalescing(Signal &, const Signal &, TimeType);
+
 #endif
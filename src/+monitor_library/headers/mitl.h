@@ -0,0 +1,222 @@
+#ifndef MITL_H_
+#define MITL_H_
+
+#include "static_validators.h"
+
+/*
+ Front end to write monitors in C++ code, e.g.
+
+ 	 using namespace mitl;
+ 	 StaticMonitor<...> m = monitor(globally(10.0, pred<0>() || until(5.0, pred<1>(), pred<2>())));
+ 	 (or, in C++11, auto m = monitor(...))
+
+ 	 // in the control loop, with preds an array (or vector) of BooleanType
+ 	 bool safe = m.step(t, preds);
+
+ Each function returns an Expression whose type is the syntax tree of the formula (the nodes of static_validators.h), so the
+ evaluation graph is resolved at compile time: the monitor is a single object (no pointers between the nodes, no virtual call)
+ that can be declared on the stack or as a static variable. The derived operators are expanded as by buildValidator, except the
+ conjunction which is computed directly. The interval storage of the nodes grows during the first steps and is then reused,
+ so a monitor whose signals have reached their largest size performs no memory allocation. To allocate nothing from the first
+ step on, the storage is reserved up front by StaticMonitor::analyzeResources with preallocate equal to true, given the minimum
+ dwell time of the predicates and the longest step.
+
+ The time bounds are either given as arguments (e.g. globally(10.0, x), globally(1.0, 10.0, x) for the window [1,10]) or as a
+ window class with static bounds, as the ones generated by bin.concpp (e.g. globally<Window10>(x)), in which case they are
+ constants known to the compiler. The bounds given as arguments and the instants passed to the monitor are values of TimeType
+ (e.g. ticks with the policy Int64Ticks, see type_transl.h).
+ */
+namespace mitl
+{
+	/**
+	 \brief Formula whose syntax tree is the type Node.
+	 */
+	template <class Node>
+	struct Expression
+	{
+		Node node;
+		explicit Expression(const Node &n): node(n) {}
+	};
+
+	typedef StaticBoolean<true> True;
+
+	// atoms ---------------------------------------------------------------------------------------------------
+
+	template <Signal::size_type Index>
+	inline Expression< StaticPredicate<Index> > pred(void)
+	{
+		return Expression< StaticPredicate<Index> >(StaticPredicate<Index>());
+	}
+
+	template <bool Value>
+	inline Expression< StaticBoolean<Value> > constant(void)
+	{
+		return Expression< StaticBoolean<Value> >(StaticBoolean<Value>());
+	}
+
+	// boolean operators ---------------------------------------------------------------------------------------
+
+	template <class N>
+	inline Expression< StaticNot<N> > operator!(const Expression<N> &x)
+	{
+		return Expression< StaticNot<N> >(StaticNot<N>(x.node));
+	}
+
+	template <class N1, class N2>
+	inline Expression< StaticOr<N1,N2> > operator||(const Expression<N1> &x, const Expression<N2> &y)
+	{
+		return Expression< StaticOr<N1,N2> >(StaticOr<N1,N2>(x.node, y.node));
+	}
+
+	template <class N1, class N2>
+	inline Expression< StaticAnd<N1,N2> > operator&&(const Expression<N1> &x, const Expression<N2> &y)
+	{
+		return Expression< StaticAnd<N1,N2> >(StaticAnd<N1,N2>(x.node, y.node));
+	}
+
+	// future operators ----------------------------------------------------------------------------------------
+
+	template <class N1, class N2, class W>
+	inline Expression< StaticUntil<N1,N2,W> > makeUntil(const W &window, const Expression<N1> &x, const Expression<N2> &y)
+	{
+		return Expression< StaticUntil<N1,N2,W> >(StaticUntil<N1,N2,W>(x.node, y.node, window));
+	}
+
+	/** \brief x U[lowerbound,alpha] y*/
+	template <class N1, class N2>
+	inline Expression< StaticUntil<N1,N2,RuntimeWindow> > until(TimeType lowerbound, TimeType alpha, const Expression<N1> &x, const Expression<N2> &y)
+	{
+		return makeUntil(RuntimeWindow(lowerbound, alpha), x, y);
+	}
+
+	/** \brief x U[0,alpha] y*/
+	template <class N1, class N2>
+	inline Expression< StaticUntil<N1,N2,RuntimeWindow> > until(TimeType alpha, const Expression<N1> &x, const Expression<N2> &y)
+	{
+		return makeUntil(RuntimeWindow(0, alpha), x, y);
+	}
+
+	/** \brief x U[W::lowerbound(),W::alpha()] y*/
+	template <class W, class N1, class N2>
+	inline Expression< StaticUntil<N1,N2,W> > until(const Expression<N1> &x, const Expression<N2> &y)
+	{
+		return makeUntil(W(), x, y);
+	}
+
+	template <class N, class W>
+	inline Expression< StaticUntil<True,N,W> > makeFuture(const W &window, const Expression<N> &x)
+	{
+		return makeUntil(window, constant<true>(), x);
+	}
+
+	/** \brief F[lowerbound,alpha] x = TRUE U[lowerbound,alpha] x*/
+	template <class N>
+	inline Expression< StaticUntil<True,N,RuntimeWindow> > future(TimeType lowerbound, TimeType alpha, const Expression<N> &x)
+	{
+		return makeFuture(RuntimeWindow(lowerbound, alpha), x);
+	}
+
+	/** \brief F[0,alpha] x*/
+	template <class N>
+	inline Expression< StaticUntil<True,N,RuntimeWindow> > future(TimeType alpha, const Expression<N> &x)
+	{
+		return makeFuture(RuntimeWindow(0, alpha), x);
+	}
+
+	/** \brief F[W::lowerbound(),W::alpha()] x*/
+	template <class W, class N>
+	inline Expression< StaticUntil<True,N,W> > future(const Expression<N> &x)
+	{
+		return makeFuture(W(), x);
+	}
+
+	template <class N, class W>
+	inline Expression< StaticNot< StaticUntil<True,StaticNot<N>,W> > > makeGlobally(const W &window, const Expression<N> &x)
+	{
+		return !makeFuture(window, !x);
+	}
+
+	/** \brief G[lowerbound,alpha] x = NOT F[lowerbound,alpha] NOT x*/
+	template <class N>
+	inline Expression< StaticNot< StaticUntil<True,StaticNot<N>,RuntimeWindow> > > globally(TimeType lowerbound, TimeType alpha, const Expression<N> &x)
+	{
+		return makeGlobally(RuntimeWindow(lowerbound, alpha), x);
+	}
+
+	/** \brief G[0,alpha] x*/
+	template <class N>
+	inline Expression< StaticNot< StaticUntil<True,StaticNot<N>,RuntimeWindow> > > globally(TimeType alpha, const Expression<N> &x)
+	{
+		return makeGlobally(RuntimeWindow(0, alpha), x);
+	}
+
+	/** \brief G[W::lowerbound(),W::alpha()] x*/
+	template <class W, class N>
+	inline Expression< StaticNot< StaticUntil<True,StaticNot<N>,W> > > globally(const Expression<N> &x)
+	{
+		return makeGlobally(W(), x);
+	}
+
+	// past operators (the window is always [0,alpha]) ---------------------------------------------------------
+
+	template <class N1, class N2, class W>
+	inline Expression< StaticSince<N1,N2,W> > makeSince(const W &window, const Expression<N1> &x, const Expression<N2> &y)
+	{
+		return Expression< StaticSince<N1,N2,W> >(StaticSince<N1,N2,W>(x.node, y.node, window));
+	}
+
+	/** \brief x S[0,alpha] y*/
+	template <class N1, class N2>
+	inline Expression< StaticSince<N1,N2,RuntimeWindow> > since(TimeType alpha, const Expression<N1> &x, const Expression<N2> &y)
+	{
+		return makeSince(RuntimeWindow(0, alpha), x, y);
+	}
+
+	/** \brief x S[0,W::alpha()] y*/
+	template <class W, class N1, class N2>
+	inline Expression< StaticSince<N1,N2,W> > since(const Expression<N1> &x, const Expression<N2> &y)
+	{
+		return makeSince(W(), x, y);
+	}
+
+	/** \brief O[0,alpha] x = TRUE S[0,alpha] x*/
+	template <class N>
+	inline Expression< StaticSince<True,N,RuntimeWindow> > once(TimeType alpha, const Expression<N> &x)
+	{
+		return makeSince(RuntimeWindow(0, alpha), constant<true>(), x);
+	}
+
+	/** \brief O[0,W::alpha()] x*/
+	template <class W, class N>
+	inline Expression< StaticSince<True,N,W> > once(const Expression<N> &x)
+	{
+		return makeSince(W(), constant<true>(), x);
+	}
+
+	/** \brief H[0,alpha] x = NOT O[0,alpha] NOT x*/
+	template <class N>
+	inline Expression< StaticNot< StaticSince<True,StaticNot<N>,RuntimeWindow> > > historically(TimeType alpha, const Expression<N> &x)
+	{
+		return !once(alpha, !x);
+	}
+
+	/** \brief H[0,W::alpha()] x*/
+	template <class W, class N>
+	inline Expression< StaticNot< StaticSince<True,StaticNot<N>,W> > > historically(const Expression<N> &x)
+	{
+		return !once<W>(!x);
+	}
+
+	// monitor -------------------------------------------------------------------------------------------------
+
+	/**
+	 \brief Monitor checking that the formula is never false (see StaticMonitor).
+	 */
+	template <class N>
+	inline StaticMonitor<N> monitor(const Expression<N> &x)
+	{
+		return StaticMonitor<N>(x.node);
+	}
+}
+
+#endif
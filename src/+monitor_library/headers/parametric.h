@@ -0,0 +1,95 @@
+#ifndef PARAMETRIC_H_
+#define PARAMETRIC_H_
+
+#include <vector>
+
+#include "validators.h"
+
+/**
+ \brief Result of a parametric evaluation (see ParametricMonitor::evaluate): the upper bounds of the designated operator for which
+ the formula is never false on the trace.
+
+ The set of bounds is the interval between *lower* and *upper*. Whether its end points belong to it depends on the end points of
+ the intervals of the signals (which are right-open), so they are given as limits: e.g. the tightest bound of F[0,alpha] is
+ *lower*, and every bound greater than it satisfies the formula. If the formula holds for the bounds up to *upper*, *lower* is the
+ smallest bound of the operator and may be equal to *upper*: then this bound is the only one.
+ */
+struct ParametricResult
+{
+	bool increasing; /**< whether the formula holds for the bounds from *lower* on (true), or from *lower* up to *upper* (false)*/
+	bool satisfiable; /**< false if no bound satisfies the formula (then lower and upper are meaningless)*/
+	bool decided; /**< false if instants whose value the trace does not decide yet can still make the tightest bound worse*/
+	double lower, upper; /**< limits (seconds) of the set of bounds, upper is infinite if *increasing* or if nothing constrains it*/
+
+	ParametricResult(void): increasing(true), satisfiable(true), decided(true), lower(0), upper(0) {}
+
+	/**
+	 \brief returns the tightest bound: the smallest one if the formula holds for the larger bounds, the largest one otherwise.
+	 */
+	inline double tightest(void) const {return increasing ? lower : upper;}
+};
+
+/**
+ \brief Monitor computing, in one pass over the trace, the set of upper bounds of one temporal operator of a formula for which the
+ formula is never false (e.g. the smallest alpha such that G[0,10](request -> F[0,alpha] grant) holds on the trace).
+
+ The designated operator is a FUTURE, GLOBALLY, ONCE or HISTORICALLY operator, given by its position among the temporal operators
+ of the formula in pre-order (i.e. in the order of the text of the formula): its upper bound in the bytecode is ignored, its lower
+ bound is kept. The operators between the root and the designated one must make the formula monotone in the bound, hence they are
+ NOT, AND, OR and the operators requiring their operand in every instant of a window (GLOBALLY and HISTORICALLY, or FUTURE and ONCE
+ under an odd number of NOT); the other sub-formulas are unrestricted.
+
+ The sub-formulas off the path to the designated operator, and its operand, are evaluated by the ordinary nodes while the trace is
+ extended; their values are kept for the whole trace, and evaluate derives the answer from them, so the trace is read once
+ whatever the number of bounds of interest. Each instant where the formula must hold gives, through the next (or the last) instant
+ where the operand changes, the tightest bound that satisfies the formula in that instant; the answer is the worst of them.
+ */
+class ParametricMonitor
+{
+private:
+	/*
+	 operator on the path from the root to the designated operator: NOT, AND, OR with the node of the other operand (side), or a
+	 window [lower, upper] (relative to the instant) on which the operand is required
+	 */
+	struct Step
+	{
+		int kind;
+		ValidatorNode *side;
+		Signal values; /**< values of side so far*/
+		bool holds; /**< whether the step must be true (or false) where its operand is required (AND, OR)*/
+		TimeType lower, upper;
+
+		Step(int k): kind(k), side(NULL), values(0, 0), holds(true), lower(0), upper(0) {}
+	};
+
+	std::vector<Step*> steps; /**< path from the root to the designated operator*/
+	ValidatorNode *operand; /**< operand of the designated operator*/
+	Signal operandValues; /**< values of operand so far*/
+	int designated; /**< node type of the designated operator*/
+	TimeType lowerbound; /**< lower bound of the window of the designated operator (future operators)*/
+	bool required; /**< whether the designated operator must be true (or false) where the formula must be true*/
+	bool isstarted;
+	TimeType startTime, lastTime;
+
+	void scan(const Signal &, const Signal &, ParametricResult &) const;
+
+	ParametricMonitor(const ParametricMonitor &);
+	ParametricMonitor& operator=(const ParametricMonitor &);
+
+public:
+	ParametricMonitor(const unsigned char *, size_t, size_t designated, const std::vector<TimeType> &dwell = std::vector<TimeType>());
+	~ParametricMonitor(void);
+
+	void initialConditions(TimeType, const std::vector<BooleanType>&);
+	void extendTrace(TimeType, const std::vector<BooleanType>&);
+	ParametricResult evaluate(void) const;
+	ParametricResult evaluate(TimeType end) const;
+
+	/**
+	 \brief check if the monitor is started
+	 \returns true if and only if initialConditions was already called on the monitor.
+	 */
+	inline bool isStarted(void) const {return isstarted;}
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef RESOURCES_H_
+#define RESOURCES_H_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ Types of the resource analysis of the monitors, shared by the interpreted monitors (see ValidatorNode::analyzeResources) and the
+ monitors generated ahead of time (see static_validators.h). The functions are defined in validators/resources.cpp.
+ */
+
+/**
+ \brief Assumptions on the trace used by the resource analysis (see Monitor::analyzeResources and StaticMonitor::analyzeResources).
+ */
+struct ResourceAssumptions
+{
+	double dwell; /**< minimum time (seconds) a predicate keeps its value*/
+	double step; /**< longest simulation step (seconds)*/
+	bool partial; /**< whether or not the signals of the partial evaluation (early verdict) are accounted*/
+
+	ResourceAssumptions(double d, double s, bool p = false): dwell(d), step(s), partial(p) {}
+};
+
+/**
+ \brief Worst-case resources of a node of the monitor, as computed by ValidatorNode::analyzeResources.
+ */
+struct NodeResources
+{
+	std::string label; /**< operator of the node*/
+	unsigned depth; /**< depth of the node in the tree (0 for the root)*/
+	double rate; /**< maximum number of intervals per second in the values of the node*/
+	double span; /**< longest stretch of time (seconds) whose values are stored by the node*/
+	size_t intervals; /**< maximum number of intervals stored by the signals of the node*/
+	size_t operations; /**< maximum number of intervals visited by the node in a step*/
+
+	NodeResources(const std::string &l, unsigned d): label(l), depth(d), rate(0), span(0), intervals(0), operations(0) {}
+};
+
+/**
+ \brief Result of the resource analysis of a monitor: the worst-case resources of its nodes (in pre-order) and their totals.
+ */
+class ResourceReport
+{
+public:
+	std::vector<NodeResources> nodes;
+	double latency; /**< verdict latency (seconds): the formula is evaluated in t when the trace reaches t + latency*/
+
+	ResourceReport(void): nodes(), latency(0) {}
+	size_t totalIntervals(void) const;
+	size_t totalBytes(void) const;
+	size_t totalOperations(void) const;
+	std::string summary(void) const;
+	void print(std::ostream &) const;
+};
+
+size_t worstCaseIntervals(double rate, double length);
+
+#endif
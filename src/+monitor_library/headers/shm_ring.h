@@ -0,0 +1,128 @@
+#ifndef SHM_RING_H_
+#define SHM_RING_H_
+
+/*
+ Shared-memory transport of the samples of a trace between two processes on the same machine (C API, POSIX shared memory).
+
+ A producer (e.g. a simulator) creates a ring of slots in a shared memory object and writes into it the samples of its trace,
+ each made of an instant and of the values of the predicates packed one bit per predicate. A consumer (e.g. tools/shm_monitor.cpp)
+ opens the ring and reads the samples in place, in batches. The ring is lock-free, with a single producer and a single consumer:
+ in steady state neither side copies the samples through the kernel or makes system calls, they only exchange the indexes of the
+ slots written and read.
+
+ The implementation is misc/shm_ring.c, a C99 file (GCC or Clang atomic builtins) that the producer compiles and links with its
+ own code, e.g. gcc -c -O2 -Iheaders misc/shm_ring.c (and -lrt with glibc older than 2.17).
+
+ The layout of the shared memory is a header of 192 bytes followed by the slots: the header holds the magic "MTSR", the version
+ of the layout, the number of predicates, the size of a slot, the number of slots (a power of two) and the flag of the end of the
+ trace, then the index of the next slot written and the index of the next slot read, each on its own cache line. A slot is the
+ instant (double) followed by the values of the predicates (the bit i%8 of the byte i/8 is the predicate i), padded to a multiple
+ of 8 bytes. The values are in the byte order of the machine.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MTS_RING_OK 	0
+#define MTS_RING_FULL 	1
+
+/* values of mts_ring_finished*/
+#define MTS_RING_RUNNING 	0
+#define MTS_RING_FINISHED 	1
+#define MTS_RING_REPLACED 	2 	/* a new ring was created with the same name (e.g. after a crash of the producer)*/
+
+typedef struct mts_ring mts_ring;
+
+/* Producer -------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ \brief Create the shared memory object *name* (e.g. "/mts_rig1"), replacing an existing one, with a ring of at least *slots*
+ samples (rounded up to a power of two) of *predicates* predicates. A ring replaced is marked MTS_RING_REPLACED, so that a consumer
+ waiting on it can open the new one.
+ \returns the ring, or NULL if the object cannot be created (errno is set).
+ */
+mts_ring* mts_ring_create(const char *name, unsigned predicates, unsigned slots);
+
+/**
+ \brief Append a sample, with the value of the predicate i in preds[i] (nonzero is true).
+ \returns MTS_RING_OK, or MTS_RING_FULL if the consumer has not yet read the oldest slot (the sample is not written).
+ */
+int mts_ring_push(mts_ring *ring, double t, const unsigned char *preds);
+
+/**
+ \brief Append a sample, with the values of the predicates already packed (predicate i is the bit i%8 of mask[i/8]).
+ \returns MTS_RING_OK, or MTS_RING_FULL if the consumer has not yet read the oldest slot (the sample is not written).
+ */
+int mts_ring_push_mask(mts_ring *ring, double t, const unsigned char *mask);
+
+/**
+ \brief Mark the end of the trace: the consumer stops after the samples already written.
+ */
+void mts_ring_finish(mts_ring *ring);
+
+/* Consumer -------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ \brief Open the ring in the shared memory object *name*, created by mts_ring_create.
+ \returns the ring, or NULL if the object does not exist or it is not a ring of this version (errno is set).
+ */
+mts_ring* mts_ring_open(const char *name);
+
+/**
+ \brief returns the number of samples written and not yet released by the consumer (they are read with mts_ring_slot).
+ */
+size_t mts_ring_available(mts_ring *ring);
+
+/**
+ \brief returns the i-th sample not yet released (i < mts_ring_available), in place in the shared memory: the instant is
+ mts_ring_slot_time(slot) and the predicate p is mts_ring_slot_value(slot, p).
+ */
+const unsigned char* mts_ring_slot(const mts_ring *ring, size_t i);
+
+/**
+ \brief Release the *count* oldest samples, whose slots can then be written again by the producer.
+ */
+void mts_ring_release(mts_ring *ring, size_t count);
+
+/**
+ \brief returns MTS_RING_FINISHED if the producer marked the end of the trace, MTS_RING_REPLACED if the ring was replaced by a
+ new one with the same name (in both cases the samples still available are the last ones), MTS_RING_RUNNING otherwise.
+ */
+int mts_ring_finished(mts_ring *ring);
+
+/* Both sides -----------------------------------------------------------------------------------------------------------------*/
+
+/**
+ \brief returns the number of predicates of the samples of the ring.
+ */
+unsigned mts_ring_predicates(const mts_ring *ring);
+
+/**
+ \brief Unmap the ring (the shared memory object persists, see mts_ring_unlink).
+ */
+void mts_ring_close(mts_ring *ring);
+
+/**
+ \brief Remove the shared memory object *name* (the rings already open stay mapped), e.g. by the consumer at the end of the trace.
+ \returns 0, or -1 if the object cannot be removed (errno is set).
+ */
+int mts_ring_unlink(const char *name);
+
+static inline double mts_ring_slot_time(const unsigned char *slot)
+{
+	return *(const double*)slot;
+}
+
+static inline int mts_ring_slot_value(const unsigned char *slot, unsigned p)
+{
+	return (slot[sizeof(double) + p / 8] >> (p % 8)) & 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef STATE_H_
+#define STATE_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "type_transl.h"
+#include "misc.h"
+
+/*
+ Snapshot of the state of a monitor (see Monitor::saveState and StaticMonitor::saveState).
+
+ The snapshot is a flat array of bytes: the header "MTSS" followed by the version number (1 byte) and by the size of TimeType
+ (1 byte), followed by the state of the monitor and by the state of its nodes in pre-order. The state of a node begins with its
+ tag (1 byte, see StateTag) and its parameters (predicate index, window bounds), which are checked when the snapshot is restored,
+ followed by its timestamps and its signals. A signal is encoded as the limits of its domain, the number of its intervals
+ (8 bytes) and their limits.
+
+ The values are written with the byte order of the machine: a snapshot is meant to be restored by a monitor of the same formula
+ in a program built for the same machine and with the same time representation (e.g. to branch many simulations from a single
+ warmed-up one), not to be stored as an exchange format.
+ */
+#define MTS_STATE_MAGIC 	"MTSS"
+#define MTS_STATE_VERSION 	3
+
+/**
+ \brief Tags of the nodes in a snapshot.
+ */
+enum StateTag
+{
+	STATE_BOOLEAN = 0,
+	STATE_PREDICATE = 1,
+	STATE_NOT = 2,
+	STATE_OR = 3,
+	STATE_AND = 4,
+	STATE_UNTIL = 5,
+	STATE_SINCE = 6,
+	STATE_BUFFER = 7
+};
+
+/**
+ \brief Appends the state of a monitor to an array of bytes (see state.h).
+ The constructor writes the header of the snapshot.
+ */
+class StateWriter
+{
+private:
+	std::vector<unsigned char> &bytes;
+
+	void writeBytes(const void *data, size_t length);
+
+public:
+	explicit StateWriter(std::vector<unsigned char> &out);
+
+	void writeTag(StateTag tag);
+	void writeBool(bool value);
+	void writeSize(size_t value);
+	void writeTime(TimeType value);
+	void writeTimes(const std::vector<TimeType> &values);
+	void writeSignal(const Signal &signal);
+};
+
+/**
+ \brief Reads the state of a monitor from an array of bytes written by StateWriter.
+ The constructor checks the header of the snapshot. Every method throws std::invalid_argument if the snapshot is truncated, or if
+ it does not match the monitor that reads it.
+ */
+class StateReader
+{
+private:
+	const unsigned char *data;
+	size_t length;
+	size_t pos;
+
+	void readBytes(void *out, size_t count);
+
+public:
+	StateReader(const unsigned char *data, size_t length);
+
+	void checkTag(StateTag tag);
+	void checkSize(size_t expected);
+	void checkTime(TimeType expected);
+	bool readBool(void);
+	size_t readSize(void);
+	TimeType readTime(void);
+	void readTimes(std::vector<TimeType> &values);
+	void readSignal(Signal &signal);
+	void finish(void) const;
+};
+
+#endif
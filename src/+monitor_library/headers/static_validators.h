@@ -0,0 +1,967 @@
+#ifndef STATIC_VALIDATORS_H_
+#define STATIC_VALIDATORS_H_
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "type_transl.h"
+#include "misc.h"
+#include "state.h"
+#include "resources.h"
+
+/*
+ Nodes of the monitors generated ahead of time (see bin.concpp).
+
+ Each class corresponds to a ValidatorNode realization and computes the same values with the same kernels, but the syntax tree
+ is fixed at compile time: the children are members of their parent (a formula is a single object, whose type is the syntax
+ tree) and none of the methods is virtual, so the compiler can inline the whole update of the formula.
+
+ The bounds of a temporal operator are given by a window object, whose methods lowerbound() and alpha() return the bounds: the
+ generated windows are empty classes with constant (static inline) bounds, while RuntimeWindow holds bounds known only at run
+ time (see mitl.h). Each node can be default constructed (if its window can) or built from its children and its window.
+
+ Each node provides the enum values *predicates* (number of predicates read by the node, i.e. the greatest predicate index plus
+ one) and *istrue* (whether the node is the constant true, used to let the temporal operators coalesce their operands).
+
+ The methods start and update are templates on the container of the predicate values, which can be any type with operator[]
+ (e.g. std::vector<BooleanType>, whose size is checked by StaticMonitor, or a plain array). The methods saveState and
+ restoreState write and read the state of the node and of its children, in pre-order (see state.h), while checkpoint, commit and
+ rollback record and restore it in place (see ValidatorNode::checkpoint). The method analyzeResources bounds the intervals of the
+ node as ValidatorNode::analyzeResources (the buffers of the operands of a temporal operator are accounted in its entry), and
+ reserves their storage if asked to.
+ */
+
+/**
+ \brief Constant node, the static counterpart of BooleanValidatorNode.
+ */
+template <bool Value>
+class StaticBoolean
+{
+private:
+	TimeType currentUpdateTime;
+	Signal computedValues;
+	TimeType savedUpdateTime; /**< currentUpdateTime at the last checkpoint*/
+
+public:
+	enum {predicates = 0, istrue = Value};
+
+	StaticBoolean(void): currentUpdateTime(), computedValues(0.0,0.0), savedUpdateTime() {}
+
+	template <class Preds> inline void start(TimeType ts, const Preds &)
+	{
+		currentUpdateTime = ts;
+		computedValues.reset(ts,ts);
+	}
+
+	template <class Preds> inline void update(TimeType t, const Preds &)
+	{
+		if(t < currentUpdateTime)
+			throw std::invalid_argument("Input time-step must be greater then or equal to the last input time-step.");
+
+		computedValues.reset(currentUpdateTime,t);
+		if (Value)
+			computedValues.addInterval(currentUpdateTime,t);
+
+		currentUpdateTime = t;
+	}
+
+	inline void saveState(StateWriter &writer) const
+	{
+		writer.writeTag(STATE_BOOLEAN);
+		writer.writeSize(Value);
+		writer.writeTime(currentUpdateTime);
+		writer.writeSignal(computedValues);
+	}
+
+	inline void restoreState(StateReader &reader)
+	{
+		reader.checkTag(STATE_BOOLEAN);
+		reader.checkSize(Value);
+		currentUpdateTime = reader.readTime();
+		reader.readSignal(computedValues);
+	}
+
+	inline void checkpoint(void)
+	{
+		savedUpdateTime = currentUpdateTime;
+		computedValues.checkpoint();
+	}
+
+	inline void commit(void) {computedValues.commit();}
+
+	inline void rollback(void)
+	{
+		currentUpdateTime = savedUpdateTime;
+		computedValues.rollback();
+	}
+
+	inline double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate)
+	{
+		// the values of a step are a single interval (or none)
+		NodeResources node(Value ? "TRUE" : "FALSE", depth);
+		node.span = assumptions.step;
+		node.intervals = 1;
+		node.operations = 1;
+		report.nodes.push_back(node);
+
+		if (preallocate)
+			computedValues.reserve(1);
+		return 0;
+	}
+
+	inline const Signal& getValues(void) const {return computedValues;}
+	inline TimeType minTime(void) const {return RT_ZERO;}
+};
+
+/**
+ \brief Predicate node, the static counterpart of PredicateValidatorNode.
+ The node reads the predicate value preds[Index].
+ */
+template <Signal::size_type Index>
+class StaticPredicate
+{
+private:
+	TimeType currentUpdateTime;
+	BooleanType currentValue;
+	Signal computedValues;
+	TimeType savedUpdateTime; /**< currentUpdateTime at the last checkpoint*/
+	BooleanType savedValue; /**< currentValue at the last checkpoint*/
+
+public:
+	enum {predicates = Index + 1, istrue = false};
+
+	StaticPredicate(void): currentUpdateTime(), currentValue(), computedValues(0.0,0.0), savedUpdateTime(), savedValue() {}
+
+	template <class Preds> inline void start(TimeType ts, const Preds &preds)
+	{
+		currentUpdateTime = ts;
+		currentValue = preds[Index];
+		computedValues.reset(ts,ts);
+	}
+
+	template <class Preds> inline void update(TimeType t, const Preds &preds)
+	{
+		if(t < currentUpdateTime)
+			throw std::invalid_argument("Input time-step must be greater then or equal to the last input time-step.");
+
+		computedValues.reset(currentUpdateTime,t);
+		if (currentValue)
+			computedValues.addInterval(currentUpdateTime,t);
+
+		currentUpdateTime = t;
+		currentValue = preds[Index];
+	}
+
+	inline void saveState(StateWriter &writer) const
+	{
+		writer.writeTag(STATE_PREDICATE);
+		writer.writeSize(Index);
+		writer.writeTime(currentUpdateTime);
+		writer.writeBool(currentValue);
+		writer.writeSignal(computedValues);
+	}
+
+	inline void restoreState(StateReader &reader)
+	{
+		reader.checkTag(STATE_PREDICATE);
+		reader.checkSize(Index);
+		currentUpdateTime = reader.readTime();
+		currentValue = reader.readBool();
+		reader.readSignal(computedValues);
+	}
+
+	inline void checkpoint(void)
+	{
+		savedUpdateTime = currentUpdateTime;
+		savedValue = currentValue;
+		computedValues.checkpoint();
+	}
+
+	inline void commit(void) {computedValues.commit();}
+
+	inline void rollback(void)
+	{
+		currentUpdateTime = savedUpdateTime;
+		currentValue = savedValue;
+		computedValues.rollback();
+	}
+
+	inline double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate)
+	{
+		// the predicate changes at most once every dwell seconds, the values of a step are a single interval (or none)
+		std::ostringstream label;
+		label << "PREDICATE " << Index;
+		NodeResources node(label.str(), depth);
+		node.rate = 1 / (2 * assumptions.dwell);
+		node.span = assumptions.step;
+		node.intervals = 1;
+		node.operations = 1;
+		report.nodes.push_back(node);
+
+		if (preallocate)
+			computedValues.reserve(1);
+		return node.rate;
+	}
+
+	inline const Signal& getValues(void) const {return computedValues;}
+	inline TimeType minTime(void) const {return RT_ZERO;}
+};
+
+/**
+ \brief Negation node, the static counterpart of NotValidatorNode.
+ */
+template <class Child>
+class StaticNot
+{
+private:
+	Child child;
+	Signal computedValues;
+
+public:
+	enum {predicates = Child::predicates, istrue = false};
+
+	explicit StaticNot(const Child &c = Child()): child(c), computedValues(0.0,0.0) {}
+
+	template <class Preds> inline void start(TimeType ts, const Preds &preds)
+	{
+		computedValues.reset(ts,ts);
+		child.start(ts,preds);
+	}
+
+	template <class Preds> inline void update(TimeType t, const Preds &preds)
+	{
+		child.update(t,preds);
+		computeComplement(child.getValues(), computedValues);
+	}
+
+	inline void saveState(StateWriter &writer) const
+	{
+		writer.writeTag(STATE_NOT);
+		writer.writeSignal(computedValues);
+		child.saveState(writer);
+	}
+
+	inline void restoreState(StateReader &reader)
+	{
+		reader.checkTag(STATE_NOT);
+		reader.readSignal(computedValues);
+		child.restoreState(reader);
+	}
+
+	inline void checkpoint(void)
+	{
+		computedValues.checkpoint();
+		child.checkpoint();
+	}
+
+	inline void commit(void)
+	{
+		computedValues.commit();
+		child.commit();
+	}
+
+	inline void rollback(void)
+	{
+		computedValues.rollback();
+		child.rollback();
+	}
+
+	inline double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate)
+	{
+		std::vector<NodeResources>::size_type entry = report.nodes.size();
+		report.nodes.push_back(NodeResources("NOT", depth));
+
+		// the negation has the same changes of the child, and it stores the complement of the values of a step of the child
+		double rate = child.analyzeResources(assumptions, report, depth + 1, preallocate);
+		size_t computedintervals = worstCaseIntervals(rate, assumptions.step);
+
+		NodeResources &node = report.nodes[entry];
+		node.rate = rate;
+		node.span = assumptions.step;
+		node.intervals = computedintervals;
+		node.operations = computedintervals;
+
+		if (preallocate)
+			computedValues.reserve(computedintervals);
+		return rate;
+	}
+
+	inline const Signal& getValues(void) const {return computedValues;}
+	inline TimeType minTime(void) const {return child.minTime();}
+};
+
+/**
+ \brief Binary boolean node, the static counterpart of OrValidatorNode.
+
+ The values of the child with the smaller minTime are buffered until the other child computes the values of the same instants,
+ then the two signals are combined by Combine (computeUnion for the disjunction, computeIntersection for the conjunction, which
+ the interpreter computes as a negated disjunction of negations).
+ */
+template <class Child1, class Child2, void (*Combine)(const Signal &, const Signal &, Signal &)>
+class StaticBinary
+{
+private:
+	Child1 firstchild;
+	Child2 secondchild;
+	bool firstisbuffered; /**< whether the first child is the one with the smaller minTime*/
+	Signal buffer;
+	Signal computedValues;
+
+public:
+	enum {
+		predicates = (int(Child1::predicates) > int(Child2::predicates) ? int(Child1::predicates) : int(Child2::predicates)),
+		istrue = false
+	};
+
+	StaticBinary(const Child1 &c1 = Child1(), const Child2 &c2 = Child2())
+	: firstchild(c1), secondchild(c2),
+	  firstisbuffered(c1.minTime() <= c2.minTime()),
+	  buffer(0.0,0.0), computedValues(0.0,0.0)
+	{}
+
+	template <class Preds> inline void start(TimeType ts, const Preds &preds)
+	{
+		buffer.reset(ts,ts);
+		computedValues.reset(ts,ts);
+
+		firstchild.start(ts,preds);
+		secondchild.start(ts,preds);
+	}
+
+	template <class Preds> inline void update(TimeType t, const Preds &preds)
+	{
+		firstchild.update(t,preds);
+		secondchild.update(t,preds);
+
+		if (firstisbuffered)
+		{
+			buffer.append(firstchild.getValues());
+			Combine(buffer, secondchild.getValues(), computedValues);
+		}
+		else
+		{
+			buffer.append(secondchild.getValues());
+			Combine(firstchild.getValues(), buffer, computedValues);
+		}
+
+		buffer.increaseFirst(computedValues.getLast());
+	}
+
+	inline void saveState(StateWriter &writer) const
+	{
+		writer.writeTag(Combine == computeUnion ? STATE_OR : STATE_AND);
+		writer.writeSignal(buffer);
+		writer.writeSignal(computedValues);
+		firstchild.saveState(writer);
+		secondchild.saveState(writer);
+	}
+
+	inline void restoreState(StateReader &reader)
+	{
+		reader.checkTag(Combine == computeUnion ? STATE_OR : STATE_AND);
+		reader.readSignal(buffer);
+		reader.readSignal(computedValues);
+		firstchild.restoreState(reader);
+		secondchild.restoreState(reader);
+	}
+
+	inline void checkpoint(void)
+	{
+		buffer.checkpoint();
+		computedValues.checkpoint();
+		firstchild.checkpoint();
+		secondchild.checkpoint();
+	}
+
+	inline void commit(void)
+	{
+		buffer.commit();
+		computedValues.commit();
+		firstchild.commit();
+		secondchild.commit();
+	}
+
+	inline void rollback(void)
+	{
+		buffer.rollback();
+		computedValues.rollback();
+		firstchild.rollback();
+		secondchild.rollback();
+	}
+
+	inline double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate)
+	{
+		std::vector<NodeResources>::size_type entry = report.nodes.size();
+		report.nodes.push_back(NodeResources(Combine == computeUnion ? "OR" : "AND", depth));
+
+		double rate1 = firstchild.analyzeResources(assumptions, report, depth + 1, preallocate);
+		double rate2 = secondchild.analyzeResources(assumptions, report, depth + 1, preallocate);
+		double rate = rate1 + rate2;
+
+		// the buffer keeps the values of the child with the smaller delay not yet available for the other one
+		TimeType buffereddelay = firstisbuffered ? firstchild.minTime() : secondchild.minTime();
+		double bufferlength = TimePolicy::toSeconds(minTime() - buffereddelay) + assumptions.step;
+
+		size_t bufferintervals = worstCaseIntervals(firstisbuffered ? rate1 : rate2, bufferlength);
+		size_t computedintervals = worstCaseIntervals(rate, assumptions.step);
+
+		NodeResources &node = report.nodes[entry];
+		node.rate = rate;
+		node.span = bufferlength;
+		node.intervals = bufferintervals + computedintervals;
+		node.operations = bufferintervals + worstCaseIntervals(firstisbuffered ? rate2 : rate1, assumptions.step) + computedintervals;
+
+		if (preallocate)
+		{
+			buffer.reserve(bufferintervals);
+			computedValues.reserve(computedintervals);
+		}
+		return rate;
+	}
+
+	inline const Signal& getValues(void) const {return computedValues;}
+	inline TimeType minTime(void) const
+	{
+		TimeType fmt = firstchild.minTime(), smt = secondchild.minTime();
+		return fmt < smt ? smt : fmt;
+	}
+};
+
+/**
+ \brief Disjunction node.
+ */
+template <class Child1, class Child2>
+class StaticOr: public StaticBinary<Child1, Child2, computeUnion>
+{
+public:
+	StaticOr(const Child1 &c1 = Child1(), const Child2 &c2 = Child2()): StaticBinary<Child1, Child2, computeUnion>(c1,c2) {}
+};
+
+/**
+ \brief Conjunction node (computed directly, instead of as a negated disjunction of negations).
+ */
+template <class Child1, class Child2>
+class StaticAnd: public StaticBinary<Child1, Child2, computeIntersection>
+{
+public:
+	StaticAnd(const Child1 &c1 = Child1(), const Child2 &c2 = Child2()): StaticBinary<Child1, Child2, computeIntersection>(c1,c2) {}
+};
+
+/**
+ \brief Node computing \f$\varphi_1 U_{[a,\alpha]} \varphi_2\f$, the static counterpart of UntilValidatorNode.
+ The window is given by window.lowerbound() and window.alpha(). If the first operand is the constant true, the gaps of the
+ second operand not longer than \f$\alpha-a\f$ are filled (as done by SignalBuffer).
+ */
+template <class Child1, class Child2, class Window>
+class StaticUntil
+{
+private:
+	Child1 firstchild;
+	Child2 secondchild;
+	Window window;
+	Signal buffer1;
+	Signal buffer2;
+	Signal computedValues;
+
+public:
+	enum {
+		predicates = (int(Child1::predicates) > int(Child2::predicates) ? int(Child1::predicates) : int(Child2::predicates)),
+		istrue = false
+	};
+
+	StaticUntil(const Child1 &c1 = Child1(), const Child2 &c2 = Child2(), const Window &w = Window())
+	: firstchild(c1), secondchild(c2), window(w),
+	  buffer1(0.0,0.0), buffer2(0.0,0.0), computedValues(0.0,0.0)
+	{
+		if (window.alpha() <= 0)
+			throw std::invalid_argument("StaticUntil: alpha parameter must be greater than zero.");
+
+		if (window.lowerbound() < 0 || window.lowerbound() > window.alpha())
+			throw std::invalid_argument("StaticUntil: lower bound parameter must be non-negative and not greater than alpha.");
+	}
+
+	template <class Preds> inline void start(TimeType ts, const Preds &preds)
+	{
+		buffer1.reset(ts,ts);
+		buffer2.reset(ts,ts);
+		computedValues.reset(ts,ts);
+
+		firstchild.start(ts,preds);
+		secondchild.start(ts,preds);
+	}
+
+	template <class Preds> inline void update(TimeType t, const Preds &preds)
+	{
+		firstchild.update(t,preds);
+		secondchild.update(t,preds);
+
+		buffer1.append(firstchild.getValues());
+		if (Child1::istrue)
+			appendCoalescing(buffer2, secondchild.getValues(), window.alpha() - window.lowerbound());
+		else
+			buffer2.append(secondchild.getValues());
+
+		computeUntil(buffer1, buffer2, computedValues.getLast(), computedValues, window.alpha(), window.lowerbound());
+
+		TimeType buffstart = computedValues.getLast();
+		buffer1.increaseFirst(buffstart);
+		buffer2.increaseFirst(buffstart);
+	}
+
+	inline void saveState(StateWriter &writer) const
+	{
+		writer.writeTag(STATE_UNTIL);
+		writer.writeTime(window.lowerbound());
+		writer.writeTime(window.alpha());
+		writer.writeSignal(buffer1);
+		writer.writeSignal(buffer2);
+		writer.writeSignal(computedValues);
+		firstchild.saveState(writer);
+		secondchild.saveState(writer);
+	}
+
+	inline void restoreState(StateReader &reader)
+	{
+		reader.checkTag(STATE_UNTIL);
+		reader.checkTime(window.lowerbound());
+		reader.checkTime(window.alpha());
+		reader.readSignal(buffer1);
+		reader.readSignal(buffer2);
+		reader.readSignal(computedValues);
+		firstchild.restoreState(reader);
+		secondchild.restoreState(reader);
+	}
+
+	inline void checkpoint(void)
+	{
+		buffer1.checkpoint();
+		buffer2.checkpoint();
+		computedValues.checkpoint();
+		firstchild.checkpoint();
+		secondchild.checkpoint();
+	}
+
+	inline void commit(void)
+	{
+		buffer1.commit();
+		buffer2.commit();
+		computedValues.commit();
+		firstchild.commit();
+		secondchild.commit();
+	}
+
+	inline void rollback(void)
+	{
+		buffer1.rollback();
+		buffer2.rollback();
+		computedValues.rollback();
+		firstchild.rollback();
+		secondchild.rollback();
+	}
+
+	inline double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate)
+	{
+		std::vector<NodeResources>::size_type entry = report.nodes.size();
+		std::ostringstream label;
+		label << "UNTIL[" << TimePolicy::toSeconds(window.lowerbound()) << "," << TimePolicy::toSeconds(window.alpha()) << "]";
+		report.nodes.push_back(NodeResources(label.str(), depth));
+
+		// each buffer keeps the values of a window of length alpha, plus the values not yet available for the other operand
+		const TimeType max = std::max(firstchild.minTime(), secondchild.minTime());
+		const double step = assumptions.step, alpha = TimePolicy::toSeconds(window.alpha());
+		double length1 = TimePolicy::toSeconds(max - firstchild.minTime()) + alpha + step;
+		double length2 = TimePolicy::toSeconds(max - secondchild.minTime()) + alpha + step;
+		double rate1 = firstchild.analyzeResources(assumptions, report, depth + 1, preallocate);
+		double rate2 = secondchild.analyzeResources(assumptions, report, depth + 1, preallocate);
+
+		// after coalescing, every gap of the second operand is longer than the tolerance
+		const TimeType tolerance = window.alpha() - window.lowerbound();
+		if (Child1::istrue && tolerance > RT_ZERO)
+			rate2 = std::min(rate2, 1 / TimePolicy::toSeconds(tolerance));
+
+		// every change of the until is a change of an operand, shifted by a time bound
+		double rate = rate1 + rate2;
+		size_t buffer1intervals = worstCaseIntervals(rate1, length1);
+		size_t buffer2intervals = worstCaseIntervals(rate2, length2);
+		size_t computedintervals = worstCaseIntervals(rate, step);
+
+		NodeResources &node = report.nodes[entry];
+		node.rate = rate;
+		node.span = std::max(length1, length2);
+		node.intervals = buffer1intervals + buffer2intervals + computedintervals;
+		node.operations = buffer1intervals + buffer2intervals + computedintervals;
+
+		if (preallocate)
+		{
+			buffer1.reserve(buffer1intervals);
+			buffer2.reserve(buffer2intervals);
+			computedValues.reserve(computedintervals);
+		}
+		return rate;
+	}
+
+	inline const Signal& getValues(void) const {return computedValues;}
+	inline TimeType minTime(void) const
+	{
+		TimeType fmt = firstchild.minTime(), smt = secondchild.minTime();
+		return (fmt < smt ? smt : fmt) + window.alpha();
+	}
+};
+
+/**
+ \brief Node computing \f$\varphi_1 S_{[0,\alpha]} \varphi_2\f$, the static counterpart of SinceValidatorNode.
+ The window is given by window.alpha(). If the first operand is the constant true, the gaps of the second operand not longer
+ than \f$\alpha\f$ are filled (as done by SignalBuffer).
+ */
+template <class Child1, class Child2, class Window>
+class StaticSince
+{
+private:
+	Child1 firstchild;
+	Child2 secondchild;
+	Window window;
+	TimeType deadline;
+	Signal buffer1;
+	Signal buffer2;
+	Signal computedValues;
+	TimeType saveddeadline; /**< deadline at the last checkpoint*/
+
+public:
+	enum {
+		predicates = (int(Child1::predicates) > int(Child2::predicates) ? int(Child1::predicates) : int(Child2::predicates)),
+		istrue = false
+	};
+
+	StaticSince(const Child1 &c1 = Child1(), const Child2 &c2 = Child2(), const Window &w = Window())
+	: firstchild(c1), secondchild(c2), window(w), deadline(0.0),
+	  buffer1(0.0,0.0), buffer2(0.0,0.0), computedValues(0.0,0.0), saveddeadline(0.0)
+	{
+		if (window.alpha() <= 0)
+			throw std::invalid_argument("StaticSince: alpha parameter must be greater than zero.");
+	}
+
+	template <class Preds> inline void start(TimeType ts, const Preds &preds)
+	{
+		deadline = ts;
+		buffer1.reset(ts,ts);
+		buffer2.reset(ts,ts);
+		computedValues.reset(ts,ts);
+
+		firstchild.start(ts,preds);
+		secondchild.start(ts,preds);
+	}
+
+	template <class Preds> inline void update(TimeType t, const Preds &preds)
+	{
+		firstchild.update(t,preds);
+		secondchild.update(t,preds);
+
+		buffer1.append(firstchild.getValues());
+		if (Child1::istrue)
+			appendCoalescing(buffer2, secondchild.getValues(), window.alpha());
+		else
+			buffer2.append(secondchild.getValues());
+
+		computeSince(buffer1, buffer2, computedValues.getLast(), computedValues, window.alpha(), deadline);
+
+		TimeType buffstart = computedValues.getLast();
+		buffer1.increaseFirst(buffstart);
+		buffer2.increaseFirst(buffstart);
+	}
+
+	inline void saveState(StateWriter &writer) const
+	{
+		writer.writeTag(STATE_SINCE);
+		writer.writeTime(window.alpha());
+		writer.writeTime(deadline);
+		writer.writeSignal(buffer1);
+		writer.writeSignal(buffer2);
+		writer.writeSignal(computedValues);
+		firstchild.saveState(writer);
+		secondchild.saveState(writer);
+	}
+
+	inline void restoreState(StateReader &reader)
+	{
+		reader.checkTag(STATE_SINCE);
+		reader.checkTime(window.alpha());
+		deadline = reader.readTime();
+		reader.readSignal(buffer1);
+		reader.readSignal(buffer2);
+		reader.readSignal(computedValues);
+		firstchild.restoreState(reader);
+		secondchild.restoreState(reader);
+	}
+
+	inline void checkpoint(void)
+	{
+		saveddeadline = deadline;
+		buffer1.checkpoint();
+		buffer2.checkpoint();
+		computedValues.checkpoint();
+		firstchild.checkpoint();
+		secondchild.checkpoint();
+	}
+
+	inline void commit(void)
+	{
+		buffer1.commit();
+		buffer2.commit();
+		computedValues.commit();
+		firstchild.commit();
+		secondchild.commit();
+	}
+
+	inline void rollback(void)
+	{
+		deadline = saveddeadline;
+		buffer1.rollback();
+		buffer2.rollback();
+		computedValues.rollback();
+		firstchild.rollback();
+		secondchild.rollback();
+	}
+
+	inline double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate)
+	{
+		std::vector<NodeResources>::size_type entry = report.nodes.size();
+		std::ostringstream label;
+		label << "SINCE[0," << TimePolicy::toSeconds(window.alpha()) << "]";
+		report.nodes.push_back(NodeResources(label.str(), depth));
+
+		// the past is summarized by the deadline: each buffer only keeps the values not yet available for the other operand
+		const TimeType max = std::max(firstchild.minTime(), secondchild.minTime());
+		const double step = assumptions.step;
+		double length1 = TimePolicy::toSeconds(max - firstchild.minTime()) + step;
+		double length2 = TimePolicy::toSeconds(max - secondchild.minTime()) + step;
+		double rate1 = firstchild.analyzeResources(assumptions, report, depth + 1, preallocate);
+		double rate2 = secondchild.analyzeResources(assumptions, report, depth + 1, preallocate);
+
+		// after coalescing, every gap of the second operand is longer than the tolerance
+		if (Child1::istrue)
+			rate2 = std::min(rate2, 1 / TimePolicy::toSeconds(window.alpha()));
+
+		// every change of the since is a change of an operand, possibly shifted by alpha
+		double rate = rate1 + rate2;
+		size_t buffer1intervals = worstCaseIntervals(rate1, length1);
+		size_t buffer2intervals = worstCaseIntervals(rate2, length2);
+		size_t computedintervals = worstCaseIntervals(rate, step);
+
+		NodeResources &node = report.nodes[entry];
+		node.rate = rate;
+		node.span = std::max(length1, length2);
+		node.intervals = buffer1intervals + buffer2intervals + computedintervals;
+		node.operations = buffer1intervals + buffer2intervals + computedintervals;
+
+		if (preallocate)
+		{
+			buffer1.reserve(buffer1intervals);
+			buffer2.reserve(buffer2intervals);
+			computedValues.reserve(computedintervals);
+		}
+		return rate;
+	}
+
+	inline const Signal& getValues(void) const {return computedValues;}
+	inline TimeType minTime(void) const
+	{
+		TimeType fmt = firstchild.minTime(), smt = secondchild.minTime();
+		return fmt < smt ? smt : fmt;
+	}
+};
+
+/**
+ \brief Window of a temporal operator whose bounds are known only at run time.
+ */
+class RuntimeWindow
+{
+private:
+	TimeType lb;
+	TimeType a;
+
+public:
+	RuntimeWindow(TimeType lowerbound, TimeType alpha): lb(lowerbound), a(alpha) {}
+
+	inline TimeType lowerbound(void) const {return lb;}
+	inline TimeType alpha(void) const {return a;}
+};
+
+/**
+ \brief Monitor of a formula whose syntax tree is fixed at compile time, the static counterpart of Monitor.
+
+ The interface is the one of Monitor, except that early verdicts are not supported: the monitor checks the instants between
+ the first trace instant and the last trace instant - Formula::minTime().
+ */
+template <class Formula>
+class StaticMonitor
+{
+private:
+	StaticNot<Formula> formula; /**< negative of the formula to be validated*/
+	Signal evaluation; /**< values of the formula so far*/
+	bool isstarted;	/**< whether or not the monitor has an been started*/
+	bool speculating; /**< whether or not the trace is extended tentatively (see speculate)*/
+	bool savedstarted; /**< isstarted when speculate was invoked*/
+
+	// the size of the predicate vectors is checked, the other containers must hold at least *predicates* values
+	static inline void checkPredicates(const std::vector<BooleanType> &preds)
+	{
+		if (preds.size() < std::vector<BooleanType>::size_type(Formula::predicates))
+			throw std::invalid_argument("StaticMonitor: The input predicate vector is smaller than the number of predicates of the formula.");
+	}
+	template <class Preds> static inline void checkPredicates(const Preds &) {}
+
+public:
+	enum {predicates = Formula::predicates};
+
+	explicit StaticMonitor(const Formula &f = Formula())
+	: formula(f), evaluation(0.0,0.0), isstarted(false), speculating(false), savedstarted(false) {}
+
+	template <class Preds> inline void initialConditions(TimeType ts, const Preds &preds)
+	{
+		checkPredicates(preds);
+		formula.start(ts,preds);
+		evaluation.reset(ts,ts);
+		isstarted = true;
+	}
+
+	template <class Preds> inline void extendTrace(TimeType t, const Preds &preds)
+	{
+		checkPredicates(preds);
+		formula.update(t,preds);
+		evaluation.append(formula.getValues());
+	}
+
+	/**
+	 \brief Extend the trace with the predicate values of an instant (the first call starts the monitor).
+	 \returns the value of checkSafety after the step.
+	 */
+	template <class Preds> inline bool step(TimeType t, const Preds &preds)
+	{
+		if (isstarted)
+			extendTrace(t,preds);
+		else
+			initialConditions(t,preds);
+
+		return checkSafety();
+	}
+
+	/**
+	 \brief Bound the resources used by the monitor, as Monitor::analyzeResources (without the partial evaluation).
+	 \param assumptions minimum dwell time of the predicates and longest step of the trace.
+	 \param preallocate if true, the signals of the nodes reserve the storage for their worst-case number of intervals: on a trace
+	 that respects the assumptions the monitor then allocates no memory, except for the violations kept by formulaEvaluation.
+	 \returns the worst-case resources of each node, and the verdict latency of the formula.
+	 \exception std::invalid_argument if the dwell time or the step is not greater than zero.
+	 */
+	ResourceReport analyzeResources(const ResourceAssumptions &assumptions, bool preallocate = false)
+	{
+		if (!(assumptions.dwell > 0) || !(assumptions.step > 0))
+			throw std::invalid_argument("analyzeResources: The dwell time and the step must be greater than zero.");
+
+		ResourceReport report;
+		formula.analyzeResources(ResourceAssumptions(assumptions.dwell, assumptions.step), report, 0, preallocate);
+		report.latency = TimePolicy::toSeconds(formula.minTime());
+		return report;
+	}
+
+	/**
+	 \brief returns a snapshot of the state of the monitor (see Monitor::saveState).
+	 */
+	std::vector<unsigned char> saveState(void) const
+	{
+		if (speculating)
+			throw std::logic_error("saveState: The monitor has a tentative extension, commit or rollback it first.");
+
+		std::vector<unsigned char> bytes;
+		StateWriter writer(bytes);
+
+		writer.writeBool(isstarted);
+		writer.writeSignal(evaluation);
+		formula.saveState(writer);
+		return bytes;
+	}
+
+	/**
+	 \brief restores the state of the monitor from a snapshot returned by saveState (see Monitor::restoreState).
+	 */
+	void restoreState(const unsigned char *data, size_t length)
+	{
+		if (speculating)
+			rollback();
+
+		StateReader reader(data, length);
+
+		isstarted = reader.readBool();
+		reader.readSignal(evaluation);
+		formula.restoreState(reader);
+		reader.finish();
+	}
+
+	/**
+	 \brief Begin a tentative extension of the trace (see Monitor::speculate).
+	 */
+	void speculate(void)
+	{
+		if (speculating)
+			throw std::logic_error("speculate: The monitor has already a tentative extension.");
+
+		savedstarted = isstarted;
+		evaluation.checkpoint();
+		formula.checkpoint();
+		speculating = true;
+	}
+
+	/**
+	 \brief Make definitive the extension of the trace after the last call of speculate (see Monitor::commit).
+	 */
+	void commit(void)
+	{
+		if (!speculating)
+			throw std::logic_error("commit: The monitor has no tentative extension.");
+
+		evaluation.commit();
+		formula.commit();
+		speculating = false;
+	}
+
+	/**
+	 \brief Undo the extension of the trace after the last call of speculate (see Monitor::rollback).
+	 */
+	void rollback(void)
+	{
+		if (!speculating)
+			throw std::logic_error("rollback: The monitor has no tentative extension.");
+
+		isstarted = savedstarted;
+		evaluation.rollback();
+		formula.rollback();
+		speculating = false;
+	}
+
+	/**
+	 \brief returns the value where the formula is false.
+	 */
+	inline const Signal& formulaEvaluation(void) const {return evaluation;}
+
+	/**
+	 \brief Check if the formula is ever false (see Monitor::checkSafety).
+	 */
+	inline bool checkSafety(void) const {return evaluation.getIntervalCount() == 0;}
+
+	/**
+	 \brief check if the monitor is started
+	 */
+	inline bool isStarted(void) const {return isstarted;}
+
+	/**
+	 \brief check if the monitor is extended tentatively
+	 */
+	inline bool isSpeculating(void) const {return speculating;}
+
+	inline TimeType minTime(void) const {return formula.minTime();}
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef STREAM_PROTOCOL_H_
+#define STREAM_PROTOCOL_H_
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "type_transl.h"
+
+/*
+ Binary framing of the sample streams of the monitor daemon (see tools/monitor_daemon.cpp).
+
+ A client opens a session on a stream socket (Unix-domain or TCP) and sends frames, each made of its kind (1 byte) and of its
+ payload. Multi-byte values are little-endian, the reals are IEEE 754 doubles.
+
+ Client frames:
+ 	 * HELLO 'H': the number of predicates of the samples (2 bytes). It is the first frame of the session.
+ 	 * SAMPLE 'S': the instant in seconds (8 bytes) and the values of the predicates, packed one bit per predicate (predicate i is
+ 	   the bit i%8 of the byte i/8, (predicates+7)/8 bytes). The instants must be increasing.
+ 	 * END 'E': the end of the trace, after which the daemon sends DONE and closes the session.
+
+ Daemon frames:
+ 	 * READY 'R': the number of formulas monitored in the session (2 bytes), in reply to HELLO.
+ 	 * VIOLATION 'V': the index of the formula (2 bytes, the order of the formula files), the instant of the sample after which the
+ 	   violation was found and the first instant where the formula is false (8 bytes each). It is sent once per formula.
+ 	 * DONE 'D': the number of samples received (8 bytes), in reply to END.
+ 	 * ERROR 'X': the length (2 bytes) and the text of a message, after which the daemon closes the session (e.g. after a
+ 	   malformed frame, or a sample with an instant not greater than the previous one).
+ */
+#define MTS_STREAM_HELLO 		'H'
+#define MTS_STREAM_SAMPLE 		'S'
+#define MTS_STREAM_END 			'E'
+#define MTS_STREAM_READY 		'R'
+#define MTS_STREAM_VIOLATION 	'V'
+#define MTS_STREAM_DONE 		'D'
+#define MTS_STREAM_ERROR 		'X'
+
+/**
+ \brief returns the size in bytes of a SAMPLE frame with *predicates* predicates.
+ */
+inline size_t streamSampleSize(size_t predicates) {return 1 + 8 + (predicates + 7) / 8;}
+
+inline void streamPutInteger(std::vector<unsigned char> &out, UInt64Type value, int bytes)
+{
+	for (int i = 0; i < bytes; i++)
+		out.push_back(static_cast<unsigned char>((value >> (8*i)) & 0xFF));
+}
+
+inline void streamPutReal(std::vector<unsigned char> &out, double value)
+{
+	UInt64Type bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	streamPutInteger(out, bits, 8);
+}
+
+inline UInt64Type streamGetInteger(const unsigned char *in, int bytes)
+{
+	UInt64Type value = 0;
+	for (int i = 0; i < bytes; i++)
+		value |= static_cast<UInt64Type>(in[i]) << (8*i);
+	return value;
+}
+
+inline double streamGetReal(const unsigned char *in)
+{
+	UInt64Type bits = streamGetInteger(in, 8);
+	double value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/**
+ \brief Append a SAMPLE frame to *out*.
+ \param preds the values of the predicates (any container with operator[], holding *predicates* values).
+ */
+template <class Preds>
+inline void streamPutSample(std::vector<unsigned char> &out, double t, const Preds &preds, size_t predicates)
+{
+	out.push_back(MTS_STREAM_SAMPLE);
+	streamPutReal(out, t);
+
+	size_t mask = out.size();
+	out.resize(mask + (predicates + 7) / 8, 0);
+	for (size_t i = 0; i < predicates; i++)
+		if (preds[i])
+			out[mask + i / 8] |= static_cast<unsigned char>(1 << (i % 8));
+}
+
+/**
+ \brief Append an ERROR frame to *out* (the message is truncated to 65535 bytes).
+ */
+inline void streamPutError(std::vector<unsigned char> &out, const std::string &message)
+{
+	size_t length = message.size() < 0xFFFF ? message.size() : 0xFFFF;
+	out.push_back(MTS_STREAM_ERROR);
+	streamPutInteger(out, length, 2);
+	out.insert(out.end(), message.begin(), message.begin() + length);
+}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef TRACE_FILE_H_
+#define TRACE_FILE_H_
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "type_transl.h"
+
+/*
+ Columnar binary file of a trace (.mtst), read in place through a memory map (see misc/trace_file.cpp, POSIX).
+
+ A trace is a column of instants (seconds, non decreasing) and named columns of values: boolean columns (e.g. the predicates of the
+ monitors) packed one bit per sample, and real columns. The samples are stored in chunks of consecutive samples, each with its own
+ header, so that a range of instants can be read without the rest of the file and the chunks can be decoded in parallel. The file
+ ends with an index of the chunks (their first and last instant and their offset), by which a reader finds the chunks of a range of
+ instants with a binary search. The samples of an instant are never split between two chunks: the instants of a chunk are greater
+ than those of the previous one.
+
+ Layout (little-endian, every section starts at a multiple of 8 bytes, so that the columns can be used in place):
+ 	 * header (48 bytes): the magic "MTST", the version (4 bytes), the number of columns (4 bytes), the number of chunks (4 bytes),
+ 	   the number of samples (8 bytes), the offset of the index (8 bytes, zero while the file is written), the first and the last
+ 	   instant (double each).
+ 	 * columns: for each column its type (1 byte, MTS_TRACE_BOOLEAN or MTS_TRACE_REAL), a reserved byte, the length of its name
+ 	   (2 bytes) and its name; padded to a multiple of 8 bytes.
+ 	 * chunks: the magic "MTSC", the number of samples n (4 bytes), the first and the last instant (double each), the size of the
+ 	   chunk with its header (8 bytes); then the instants (n doubles) and each column in order: a boolean column is (n+63)/64 words
+ 	   of 8 bytes (sample i is the bit i%64 of the word i/64), a real column is n doubles.
+ 	 * index: for each chunk its first and its last instant (double each) and its offset in the file (8 bytes).
+ */
+
+#define MTS_TRACE_BOOLEAN 	0
+#define MTS_TRACE_REAL 		1
+
+/**
+ \brief Column of a trace file: its name and its type (MTS_TRACE_BOOLEAN or MTS_TRACE_REAL).
+ */
+struct TraceColumn
+{
+	std::string name;
+	int type;
+
+	TraceColumn(void): name(), type(MTS_TRACE_BOOLEAN) {}
+	TraceColumn(const std::string &n, int t): name(n), type(t) {}
+};
+
+/**
+ \brief Chunk of a trace file, in place in the memory map.
+ */
+struct TraceChunk
+{
+	size_t samples;
+	double first, last; /**< first and last instant of the chunk*/
+	const double *time; /**< instants of the samples*/
+	std::vector<const void*> columns; /**< data of each column (see value and real)*/
+
+	/**
+	 \brief returns the value of the boolean column *c* in the sample *i*.
+	 */
+	inline bool value(size_t c, size_t i) const
+	{
+		return ((static_cast<const UInt64Type*>(columns[c])[i / 64] >> (i % 64)) & 1) != 0;
+	}
+
+	/**
+	 \brief returns the words of the boolean column *c* (sample i is the bit i%64 of the word i/64).
+	 */
+	inline const UInt64Type* bits(size_t c) const {return static_cast<const UInt64Type*>(columns[c]);}
+
+	/**
+	 \brief returns the values of the real column *c*.
+	 */
+	inline const double* real(size_t c) const {return static_cast<const double*>(columns[c]);}
+};
+
+/**
+ \brief Writer of a trace file: the samples are appended one at a time, and written one chunk at a time.
+ */
+class TraceWriter
+{
+private:
+	std::vector<TraceColumn> columns;
+	size_t chunkSamples;
+	FILE *file; /**< file being written (NULL once closed)*/
+	UInt64Type offset; /**< size of the file written so far*/
+	UInt64Type samples;
+	double first, last;
+	std::vector<double> time; /**< instants of the current chunk*/
+	std::vector<std::vector<double> > values; /**< values of the current chunk, by column*/
+	std::vector<double> chunkFirst, chunkLast; /**< first and last instant of each chunk written*/
+	std::vector<UInt64Type> chunkOffset; /**< offset of each chunk written*/
+
+	void writeChunk(void);
+	void write(const void *, size_t);
+	void writeHeader(UInt64Type);
+
+	TraceWriter(const TraceWriter &);
+	TraceWriter& operator=(const TraceWriter &);
+
+public:
+	TraceWriter(const std::string &, const std::vector<TraceColumn> &, size_t chunkSamples = 65536);
+	~TraceWriter(void);
+
+	void append(double, const double *);
+	void close(void);
+};
+
+/**
+ \brief Trace file opened for reading through a read-only memory map.
+ */
+class TraceFile
+{
+private:
+	void *memory;
+	size_t size;
+	std::vector<TraceColumn> columnList;
+	std::vector<TraceChunk> chunkList;
+	UInt64Type sampleCount;
+	double firstTime, lastTime;
+
+	TraceFile(const TraceFile &);
+	TraceFile& operator=(const TraceFile &);
+
+public:
+	explicit TraceFile(const std::string &);
+	~TraceFile(void);
+
+	inline size_t columnCount(void) const {return columnList.size();}
+	inline const TraceColumn& column(size_t c) const {return columnList[c];}
+	inline size_t chunkCount(void) const {return chunkList.size();}
+	inline const TraceChunk& chunk(size_t k) const {return chunkList[k];}
+	inline UInt64Type samples(void) const {return sampleCount;}
+	inline double first(void) const {return firstTime;}
+	inline double last(void) const {return lastTime;}
+
+	size_t findColumn(const std::string &) const;
+	size_t findChunk(double) const;
+};
+
+#endif
@@ -1,10 +1,100 @@
 #ifndef TYPE_TRANSL_H_
 #define TYPE_TRANSL_H_
 
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <stdint.h>
+
+#ifdef MATLAB_MEX_FILE
+
 #include "simstruc.h"
 
 typedef  real_T RealType;
 typedef boolean_T BooleanType;
-const RealType RT_ZERO = 0.0;
+
+#else
+
+// plain C++ builds (e.g. the monitors generated ahead of time for embedded targets) use the same types of Simulink
+typedef double RealType;
+typedef unsigned char BooleanType;
+
+#endif
+
+// 64-bit integers (sizes and offsets of the binary formats, ticks of Int64Ticks): C++98 has no long long, <stdint.h> comes from C99
+typedef int64_t Int64Type;
+typedef uint64_t UInt64Type;
+
+// Time representation---------------------------------------------------------------------
+
+/*
+ The monitors (intervals, signals and validator nodes) represent the instants with the type TimeType of a time policy, chosen at
+ compile time with the macro MTS_TIME_POLICY (e.g. -DMTS_TIME_POLICY=Int64Ticks). A policy defines:
+ 	 * TimeType: the type of the instants and of the time bounds of the operators.
+ 	 * fromSeconds: the conversion of the simulation time (and of the time bounds of the formulas) to TimeType.
+ 	 * toSeconds: the inverse conversion.
+
+ The available policies are:
+ 	 * DoubleTime (default): seconds as double.
+ 	 * FloatTime: seconds as float (half the memory, about 7 significant digits).
+ 	 * Int64Ticks, Int32Ticks: integer number of ticks of 1/MTS_TICKS_PER_SECOND seconds (default 1000). The instants are exact if
+ 	   the simulation has a fixed step multiple of the tick, otherwise they are rounded to the nearest tick. With 32 bits the
+ 	   simulation time (plus the longest window of the formula) must be less than 2^31 ticks (about 24 days with 1000 ticks).
+ */
+
+/**
+\brief time policy representing the instants as seconds of type double.*/
+struct DoubleTime {
+	typedef double TimeType;
+	static inline TimeType fromSeconds(double seconds) {return seconds;}
+	static inline double toSeconds(TimeType t) {return t;}
+};
+
+/**
+\brief time policy representing the instants as seconds of type float.*/
+struct FloatTime {
+	typedef float TimeType;
+	static inline TimeType fromSeconds(double seconds) {return static_cast<float>(seconds);}
+	static inline double toSeconds(TimeType t) {return t;}
+};
+
+/**
+\brief time policy representing the instants as an integer number of ticks of 1/TicksPerSecond seconds.*/
+template <class Integer, long TicksPerSecond>
+struct TickTime {
+	typedef Integer TimeType;
+
+	/**
+	\brief number of ticks nearest to *seconds*.
+	\exception std::out_of_range if the number of ticks is not representable by Integer.*/
+	static inline TimeType fromSeconds(double seconds)
+	{
+		const double ticks = std::floor(seconds * TicksPerSecond + 0.5);
+
+		if (!(ticks >= static_cast<double>(std::numeric_limits<Integer>::min()) &&
+			  ticks <= static_cast<double>(std::numeric_limits<Integer>::max())))
+			throw std::out_of_range("TickTime: The time is not representable with the number of bits of the ticks.");
+
+		return static_cast<Integer>(ticks);
+	}
+
+	static inline double toSeconds(TimeType t) {return static_cast<double>(t) / TicksPerSecond;}
+};
+
+#ifndef MTS_TICKS_PER_SECOND
+#define MTS_TICKS_PER_SECOND 1000
+#endif
+
+typedef TickTime<Int64Type, MTS_TICKS_PER_SECOND> Int64Ticks;
+typedef TickTime<int, MTS_TICKS_PER_SECOND> Int32Ticks;
+
+#ifndef MTS_TIME_POLICY
+#define MTS_TIME_POLICY DoubleTime
+#endif
+
+typedef MTS_TIME_POLICY TimePolicy;
+typedef TimePolicy::TimeType TimeType;
+
+const TimeType RT_ZERO = 0;
 
 #endif
@@ -1,16 +1,27 @@
 #ifndef VALIDATORS_H_
 #define VALIDATORS_H_
 
+#include <ostream>
+#include <string>
 #include <vector>
 
 #include "type_transl.h"
 #include "misc.h"
+#include "instrumentation.h"
+#include "state.h"
+#include "resources.h"
+
+#ifdef MATLAB_MEX_FILE
 #include "mex.h"
+#endif
 
 // forward declarations
  class Monitor;
  class ValidatorNode;
- ValidatorNode* buildValidator(const mxArray*);
+#ifdef MATLAB_MEX_FILE
+ ValidatorNode* buildValidator(const mxArray*, const std::vector<TimeType> &dwell = std::vector<TimeType>());
+#endif
+ ValidatorNode* buildValidator(const unsigned char*, size_t, const std::vector<TimeType> &dwell = std::vector<TimeType>());
 
  /**
   \brief Class used to validate a Bounded LTL formula.
@@ -24,13 +35,40 @@
  	ValidatorNode *formula; /**< negative of the formula to be validated*/
  	Signal evaluation; /**< values of the formula so far*/
  	bool isstarted;	/**< whether or not the monitor has an been started*/
+ 	bool earlyverdict; /**< whether or not the instants not yet evaluated are checked using ValidatorNode::evaluatePartial*/
+ 	bool earlyviolation; /**< whether or not the formula was found false in an instant not yet evaluated*/
+ 	bool speculating; /**< whether or not the trace is extended tentatively (see speculate)*/
+ 	bool savedstarted, savedearlyviolation; /**< isstarted and earlyviolation when speculate was invoked*/
 
  public:
- 	Monitor(const mxArray *);
+#ifdef MATLAB_MEX_FILE
+ 	Monitor(const mxArray *, bool earlyverdict = false, const std::vector<TimeType> &dwell = std::vector<TimeType>());
+#endif
+ 	Monitor(const unsigned char *, size_t, bool earlyverdict = false, const std::vector<TimeType> &dwell = std::vector<TimeType>());
  	~Monitor(void);
 
- 	void initialConditions(RealType, const std::vector<BooleanType>&);
- 	void extendTrace(RealType, const std::vector<BooleanType>&);
+ 	void initialConditions(TimeType, const std::vector<BooleanType>&);
+ 	void extendTrace(TimeType, const std::vector<BooleanType>&);
+ 	ResourceReport analyzeResources(const ResourceAssumptions &, bool preallocate = false);
+ 	std::vector<NodeStats> statistics(void);
+ 	std::vector<unsigned char> saveState(void);
+ 	void restoreState(const unsigned char *, size_t);
+ 	void speculate(void);
+ 	void commit(void);
+ 	void rollback(void);
+
+ 	/**
+ 	 \brief check if the monitors collect statistics
+ 	 \returns true if and only if the library was compiled with the macro MTS_INSTRUMENTATION (see instrumentation.h).
+ 	 */
+ 	static inline bool isInstrumented(void)
+ 	{
+#ifdef MTS_INSTRUMENTATION
+ 		return true;
+#else
+ 		return false;
+#endif
+ 	}
 
  	/**
  	 \brief returns the value where the formula is false.
@@ -38,18 +76,34 @@
  	 */
  	inline const Signal& formulaEvaluation(void) {return evaluation;}
 
+ 	/**
+ 	 \brief returns the instants not yet evaluated where the formula is already known to be false.
+ 	 The returned value is meaningful only if the monitor was created with *earlyverdict* equal to true, and it refers
+ 	 to the instants between last trace instant - formula.mintime() and last trace instant.
+ 	 \returns the instants after the domain of formulaEvaluation where the formula is false for every extension of the trace.
+ 	 */
+ 	const Signal& partialEvaluation(void) const;
+
  	/**
  	 \brief Check if the formula is ever false
  	 More precisely it is checked if for the instants between first trace instant and last trace instant - formula.mintime() the formula is ever false.
- 	 \returns true if and only if the formula is true for all the instant between the first trace instant and last trace instant - formula.mintime().
+ 	 If the monitor was created with *earlyverdict* equal to true, then also the instants up to the last trace instant are checked (an instant is
+ 	 considered false if the formula is false in it for every extension of the trace).
+ 	 \returns true if and only if the formula is never false in the checked instants.
  	 */
- 	inline bool checkSafety(void) const {return evaluation.getIntervalCount() == 0;}
+ 	inline bool checkSafety(void) const {return evaluation.getIntervalCount() == 0 && !earlyviolation;}
 
  	/**
  	 \brief check if the monitor is started
  	 \returns true if and only if initialConditions was already called on the monitor.
  	 */
  	inline bool isStarted(void) const {return isstarted;}
+
+ 	/**
+ 	 \brief check if the monitor is extended tentatively
+ 	 \returns true if and only if speculate was invoked after the last commit or rollback.
+ 	 */
+ 	inline bool isSpeculating(void) const {return speculating;}
  };
 
 /**
@@ -61,7 +115,7 @@
 
  Using the methods of the class is possible to compute the values of the implicit formula for a certain range of instants.
  */
- class ValidatorNode
+ class ValidatorNode: public NodeCounters
  {
  public:
 	 /**
@@ -79,7 +133,7 @@
 	This method is used to define the value of the formula predicates descendant of *this*. Particularly  if *this* is of type PredicateValidatorNode
 	then it will assume for the instant *ts* the value in preds[index of *this*].
   */
-	 virtual void start(RealType ts, const std::vector<BooleanType> &preds) = 0;
+	 virtual void start(TimeType ts, const std::vector<BooleanType> &preds) = 0;
 
 	 /**
 	\brief Method that update the instants where the formula is true.
@@ -108,7 +162,7 @@
 	 \big[\max(ts, t_{i-1} - \delta),\max(ts, t_i - \delta)\big)
 	 \f]
 	 */
-	 virtual void update(RealType t, const std::vector<BooleanType> &preds) = 0;
+	 virtual void update(TimeType t, const std::vector<BooleanType> &preds) = 0;
 
 	 /**
 	\brief This methods returns the instants between the last two calls at update (offset by a certain value) where the implicit formula is valid.
@@ -124,9 +178,24 @@
 	\big[\max(ts, t_{i-1} - \delta),\max(ts, t_i - \delta)\big)
 	\f]
 	\returns the instants in \f$\big[\max(ts, t_{i-1} - \delta),\max(ts, t_i - \delta)\big)\f$ where the formula is valid. (the instants are returned as a Signal)
+
+	\note If isNegated returns true the intervals of the Signal are instead the instants where the formula is false.
 	*/
 	 virtual const Signal& getValues(void) const = 0;
 
+	 /**
+	 \brief returns the polarity of the values of *this*.
+	 \returns true if the intervals returned by getValues are the instants where the formula is false, false if they are the
+	 instants where it is true.
+
+	 A negation does not compute the complement of the values of its operand: it returns them, with the opposite polarity (and an
+	 OR of negated operands computes the intersection of their false instants). The complement is computed only by the nodes that
+	 need the true instants (see SignalBuffer and Monitor), while appending the values to their own signals (see appendComplement).
+	 The polarity of a node depends only on the syntax tree, it is fixed when the node is created. The partial values
+	 (getPartialTrue and getPartialFalse) are not affected.
+	 */
+	 virtual bool isNegated(void) const = 0;
+
 	 /**
 	\brief This method return the minimum time that we need to "wait" in order to evaluate a certain instant.
 	More precisely if we want to evaluate the implicit formula for a certain instant \f$t\f$ then we must  have the value of the predicates
@@ -138,7 +207,106 @@
 
 	\returns the minimum time in order to be sure to be able to evaluate a certain instant.
 	 */
-	 virtual RealType minTime(void) const = 0;
+	 virtual TimeType minTime(void) const = 0;
+
+	 /**
+	 \brief Method that computes the instants, not yet evaluated by update, whose value is already decided.
+
+	\warning
+	start must have been already invoked on *this* and all of its descendants.
+
+	- Let \f$t_i\f$ be the value of *t* in the last invocation of update on *this* (or *ts* if update was never invoked).
+	- Let \f$l\f$ be the right limit of the domain of the Signal returned by getValues.
+
+	The values of the implicit formula in \f$[l,t_i)\f$ depend on predicate values that are not known yet, nonetheless some of them are
+	the same for every possible extension of the trace (e.g. \f$\Box_{[0,\alpha]}\varphi\f$ is false in *t* as soon as \f$\varphi\f$ is false in
+	an instant of \f$[t,t+\alpha]\f$). After the method execution getPartialTrue (respectively getPartialFalse) returns the instants in
+	\f$[l,t_i)\f$ where the formula is true (respectively false) for every extension of the trace.
+
+	The method does not modify the state used by update: it can be invoked after any call of update, and not invoking it has no cost.
+	 */
+	 virtual void evaluatePartial(void) = 0;
+
+	 /**
+	 \brief returns the instants where the implicit formula is known to be true, as computed by the last call of evaluatePartial.
+	 */
+	 virtual const Signal& getPartialTrue(void) const = 0;
+
+	 /**
+	 \brief returns the instants where the implicit formula is known to be false, as computed by the last call of evaluatePartial.
+	 */
+	 virtual const Signal& getPartialFalse(void) const = 0;
+
+	 /**
+	 \brief Method that declares that the values of the implicit formula before a given instant are not needed.
+
+	\param t first instant whose value is still needed (a value less than the one of a previous call has no effect).
+
+	After the call getValues, getPartialTrue and getPartialFalse may return arbitrary values for the instants before *t* (their
+	domains do not change), while the values from *t* on are not affected. The nodes pass the instants whose values they still
+	need to their operands, so that the evaluation of a sub-formula is skipped where it can not change the values of the formula
+	(e.g. the second operand of an OR where the first one is already true).
+	 */
+	 virtual void skipBefore(TimeType t) = 0;
+
+	 /**
+	 \brief Method that bounds the resources used by *this* and its descendants.
+
+	\param assumptions minimum dwell time of the predicates and longest step of the trace.
+	\param report the entries of *this* and of its descendants are appended to report.nodes, in pre-order.
+	\param depth depth of *this* in the tree.
+	\param preallocate if true, the signals of *this* and of its descendants reserve the storage for their worst-case number of intervals.
+
+	If every predicate keeps its value for at least assumptions.dwell seconds and no step is longer than assumptions.step, then no
+	signal of the nodes holds more intervals than the bound in the node entry.
+	\returns the maximum number of intervals per second in the values of *this*.
+	 */
+	 virtual double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate) = 0;
+
+	 /**
+	 \brief returns the operator of *this* (e.g. UNTIL[0,5]), as shown by the resource analysis and by the statistics.
+	 */
+	 virtual std::string label(void) const = 0;
+
+	 /**
+	 \brief Method that appends the statistics of *this* and of its descendants to *stats*, in pre-order.
+	 \param depth depth of *this* in the tree.
+	 Without the macro MTS_INSTRUMENTATION the counters of the entries are zero (see instrumentation.h).
+	 */
+	 virtual void collectStats(std::vector<NodeStats> &stats, unsigned depth) = 0;
+
+	 /**
+	 \brief Method that appends the state of *this* and of its descendants to a snapshot (see state.h), in pre-order.
+	 The state is restored by restoreState on a node of the same formula, after which the node computes the same values.
+	 */
+	 virtual void saveState(StateWriter &writer) = 0;
+
+	 /**
+	 \brief Method that restores the state of *this* and of its descendants from a snapshot written by saveState.
+	 \exception std::invalid_argument if the snapshot is truncated or it does not match the formula of *this*.
+	 */
+	 virtual void restoreState(StateReader &reader) = 0;
+
+	 /**
+	 \brief Method that records the state of *this* and of its descendants, so that it can be restored by rollback.
+
+	The following calls of start, update and evaluatePartial are tentative until the next call of commit or rollback: the signals of
+	the nodes record the intervals that the calls remove (see Signal::checkpoint), hence the cost of the calls grows by a constant
+	factor, while the cost of the checkpoint itself does not depend on the length of the stored signals.
+	 */
+	 virtual void checkpoint(void) = 0;
+
+	 /**
+	 \brief Method that makes definitive the calls after the last checkpoint of *this* and of its descendants.
+	 */
+	 virtual void commit(void) = 0;
+
+	 /**
+	 \brief Method that restores *this* and its descendants to their state at the last checkpoint.
+	 The cost is proportional to the number of intervals added or removed after the checkpoint (see Signal::rollback).
+	 \exception std::logic_error if checkpoint was not invoked after the last commit or rollback.
+	 */
+	 virtual void rollback(void) = 0;
 
 	 /**
 	  \brief Class destructor.
@@ -150,16 +318,34 @@
  class BooleanValidatorNode : public ValidatorNode{
  private:
 	 bool state;
-	 RealType lastUpdateTime;
-	 RealType currentUpdateTime;
+	 TimeType lastUpdateTime;
+	 TimeType currentUpdateTime;
 	 Signal computedValues;
+	 Signal partialValues;
+
+	 // state at the last checkpoint
+	 TimeType savedLastUpdateTime;
+	 TimeType savedCurrentUpdateTime;
  public:
 	 BooleanValidatorNode(bool);
-	 void start(RealType ts, const std::vector<BooleanType> &preds);
-	 void update(RealType t, const  std::vector<BooleanType> &preds);
+	 void start(TimeType ts, const std::vector<BooleanType> &preds);
+	 void update(TimeType t, const  std::vector<BooleanType> &preds);
+	 void evaluatePartial(void);
+	 double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate);
+	 std::string label(void) const;
+	 void collectStats(std::vector<NodeStats> &stats, unsigned depth);
+	 void saveState(StateWriter &writer);
+	 void restoreState(StateReader &reader);
+	 void checkpoint(void);
+	 void commit(void);
+	 void rollback(void);
 
 	 inline const Signal& getValues(void) const {return computedValues;}
-	 inline RealType minTime(void) const {return RT_ZERO;}
+	 inline TimeType minTime(void) const {return RT_ZERO;}
+	 inline bool isNegated(void) const {return false;}
+	 inline const Signal& getPartialTrue(void) const {return partialValues;}
+	 inline const Signal& getPartialFalse(void) const {return partialValues;}
+	 inline void skipBefore(TimeType) {}
  };
 
  class PredicateValidatorNode:public ValidatorNode
@@ -169,41 +355,97 @@
 
   private:
 	 predicate_index index;	/*index used to get the node predicate value in the input vector*/
-	 RealType lastUpdateTime;
-	 RealType currentUpdateTime;
+	 TimeType lastUpdateTime;
+	 TimeType currentUpdateTime;
 	 BooleanType lastvalue;
 	 BooleanType currentValue;
 
+	 // chatter filter (see the constructor)
+	 TimeType dwell;	/*minimum duration of a change of the filtered value (zero if the predicate is not filtered)*/
+	 BooleanType filteredValue;	/*filtered value at the right limit of the computed values*/
+	 TimeType runStart;	/*instant since when the input has the value currentValue*/
+	 TimeType previousRunStart;	/*instant since when the input had the value !currentValue before runStart*/
+
   	// optimization fields
   	Signal computedValues;
+  	Signal partialTrue;
+  	Signal partialFalse;
+
+  	// state at the last checkpoint
+  	TimeType savedLastUpdateTime;
+  	TimeType savedCurrentUpdateTime;
+  	BooleanType savedLastValue;
+  	BooleanType savedCurrentValue;
+  	BooleanType savedFilteredValue;
+  	TimeType savedRunStart;
+  	TimeType savedPreviousRunStart;
+
+  	void filterUpdate(void);
 
   public:
-  	PredicateValidatorNode(PredicateValidatorNode::predicate_index i);
-  	void start(RealType ts, const std::vector<BooleanType> &preds);
-  	void update(RealType t, const std::vector<BooleanType> &preds);
+  	/**
+  	 \brief builds the node of the predicate of index i.
+  	 \param dwell minimum dwell time of the chatter filter, zero for no filter.
+
+  	 With a positive dwell the node evaluates the filtered input: the filtered value starts as the input value and it changes to the
+  	 value v in an instant c only if the input changes to v in c and then keeps v for at least dwell; the shorter runs of the input
+  	 (glitches) are absorbed. Each value of the filtered input, but the last, lasts at least dwell, and the node is evaluated with a
+  	 delay of dwell (minTime).
+  	 */
+  	PredicateValidatorNode(PredicateValidatorNode::predicate_index i, TimeType dwell = RT_ZERO);
+  	void start(TimeType ts, const std::vector<BooleanType> &preds);
+  	void update(TimeType t, const std::vector<BooleanType> &preds);
+  	void evaluatePartial(void);
+  	double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate);
+  	std::string label(void) const;
+  	void collectStats(std::vector<NodeStats> &stats, unsigned depth);
+  	void saveState(StateWriter &writer);
+  	void restoreState(StateReader &reader);
+  	void checkpoint(void);
+  	void commit(void);
+  	void rollback(void);
 
   	inline const Signal& getValues(void) const{return computedValues;};
-  	inline RealType minTime(void) const {return RT_ZERO;};
+  	inline TimeType minTime(void) const {return dwell;};
+  	inline bool isNegated(void) const {return false;};
+  	inline const Signal& getPartialTrue(void) const {return partialTrue;};
+  	inline const Signal& getPartialFalse(void) const {return partialFalse;};
+  	inline void skipBefore(TimeType) {};
 
   };
 
+ /**
+ \brief Negation node: its values are the ones of its operand, with the opposite polarity (see ValidatorNode::isNegated).
+ */
  class NotValidatorNode:public ValidatorNode
  {
  private:
  	ValidatorNode *child;
 
  	// optimization fields
- 	double mintime;
- 	Signal computedValues;
+ 	TimeType mintime;
 
  public:
  	NotValidatorNode(ValidatorNode &c);
- 	void start(RealType ts, const std::vector<BooleanType> &preds);
- 	void update(RealType t, const std::vector<BooleanType> &preds);
+ 	void start(TimeType ts, const std::vector<BooleanType> &preds);
+ 	void update(TimeType t, const std::vector<BooleanType> &preds);
   	~NotValidatorNode(void);
-
- 	inline const Signal& getValues(void) const {return computedValues;};
- 	inline RealType minTime(void) const {return mintime;};
+ 	void evaluatePartial(void);
+ 	double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate);
+ 	std::string label(void) const;
+ 	void collectStats(std::vector<NodeStats> &stats, unsigned depth);
+ 	void saveState(StateWriter &writer);
+ 	void restoreState(StateReader &reader);
+ 	void checkpoint(void);
+ 	void commit(void);
+ 	void rollback(void);
+
+  	inline const Signal& getValues(void) const {return child->getValues();};
+ 	inline bool isNegated(void) const {return !child->isNegated();};
+ 	inline TimeType minTime(void) const {return mintime;};
+ 	inline const Signal& getPartialTrue(void) const {return child->getPartialFalse();};
+ 	inline const Signal& getPartialFalse(void) const {return child->getPartialTrue();};
+ 	inline void skipBefore(TimeType t) {child->skipBefore(t);};
 
  };
 
@@ -212,44 +454,228 @@ class OrValidatorNode:public ValidatorNode
 private:
 	ValidatorNode *firstchild;
 	ValidatorNode *secondchild;
-	Signal buffer;
+	Signal buffer; /**< values of firstchild (with its polarity) not yet combined with the ones of secondchild*/
+	TimeType horizon; /**< first instant whose value is needed (see skipBefore)*/
+	TimeType savedhorizon; /**< horizon at the last checkpoint*/
+	bool negated; /**< whether computedValues are the instants where the OR is false (i.e. a child is negated)*/
 
 	// optimization fields
-	RealType mintime;
+	TimeType mintime;
 	Signal computedValues;
+	Signal partialTrue;
+	Signal partialFalse;
 
 public:
 	OrValidatorNode (ValidatorNode &child1, ValidatorNode &child2);
-	void start(RealType ts, const std::vector<BooleanType> &preds);
-	void update(RealType t, const std::vector<BooleanType> &preds);
+	void start(TimeType ts, const std::vector<BooleanType> &preds);
+	void update(TimeType t, const std::vector<BooleanType> &preds);
+	void evaluatePartial(void);
+	void skipBefore(TimeType t);
+	double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate);
+	std::string label(void) const;
+	void collectStats(std::vector<NodeStats> &stats, unsigned depth);
+	void saveState(StateWriter &writer);
+	void restoreState(StateReader &reader);
+	void checkpoint(void);
+	void commit(void);
+	void rollback(void);
 
 	inline const Signal& getValues(void)  const {return computedValues;};
-	inline RealType minTime(void) const {return mintime;};
+	inline bool isNegated(void) const {return negated;};
+	inline TimeType minTime(void) const {return mintime;};
+	inline const Signal& getPartialTrue(void) const {return partialTrue;};
+	inline const Signal& getPartialFalse(void) const {return partialFalse;};
 
   	~OrValidatorNode(void);
 };
 
+/**
+ \brief Values of a sub-formula shared between the temporal operators that read it.
+
+ Temporal operators need the values of their operands over a window of time. When more operators (possibly with different
+ windows) have the same operand, they read one SignalBuffer instead of keeping their own copy: the buffer owns the node of the
+ operand, updates it once per step and keeps its values until every reader (identified by the value returned by addReader)
+ has consumed them. The buffer keeps the instants where the operand is true: the values of a negated operand (see
+ ValidatorNode::isNegated) are complemented while they are appended.
+
+ A reader can declare a coalescing tolerance: if every reader of a buffer declares a tolerance greater than zero, then the gaps
+ between the intervals of the operand not longer than the smallest tolerance are filled. This is used by the operators that
+ can not distinguish such values (e.g. \f$F_{[a,b]} \varphi\f$ is not changed by filling the gaps of \f$\varphi\f$ not longer
+ than \f$b-a\f$), so that their buffers contain a number of intervals bounded by the window length instead of one interval for
+ each change of the operand.
+
+ A reader can also declare with skipBefore the instants before which the operand can not change its own values: the node of
+ the operand skips the instants that no reader needs (see ValidatorNode::skipBefore).
+
+ Each reader must call start, update and evaluatePartial exactly once per step (the buffer performs the operation on the first
+ call of each step). The buffer is deleted when every reference obtained with acquire is given back with release.
+ */
+class SignalBuffer: public NodeCounters
+{
+public:
+	typedef std::vector<TimeType>::size_type reader_id;
+
+private:
+	ValidatorNode *child;
+	Signal values; /**< values of child (the instants where it is true) that are still needed by at least one reader*/
+	std::vector<TimeType> cursors; /**< for each reader, the first instant whose value is still needed*/
+	std::vector<TimeType> horizons; /**< for each reader, the first instant whose value can change the values of the reader*/
+	TimeType tolerance; /**< length of the longest gap between two intervals of the operand that is filled*/
+	reader_id references; /**< number of readers that did not call release*/
+	reader_id startcalls, updatecalls, partialcalls; /**< number of readers that already performed the current step*/
+	reader_id analysiscalls; /**< number of readers that already performed the current resource analysis*/
+	std::vector<NodeResources>::size_type analysisentry; /**< entry of the buffer in the report of the current analysis*/
+	reader_id statscalls; /**< number of readers that already collected the current statistics*/
+	reader_id statecalls; /**< number of readers that already saved (or restored) the current snapshot*/
+	reader_id journalcalls; /**< number of readers that already performed the current checkpoint, commit or rollback*/
+	std::vector<TimeType> savedcursors, savedhorizons; /**< cursors and horizons at the last checkpoint*/
+
+	~SignalBuffer(void);
+
+public:
+	SignalBuffer(ValidatorNode &child);
+	SignalBuffer* acquire(void);
+	void release(void);
+	reader_id addReader(TimeType tolerance = 0);
+
+	void start(TimeType ts, const std::vector<BooleanType> &preds);
+	void update(TimeType t, const std::vector<BooleanType> &preds);
+	void evaluatePartial(void);
+	void consume(reader_id reader, TimeType t);
+	void skipBefore(reader_id reader, TimeType t);
+	double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate, double length);
+	std::string label(void) const;
+	void collectStats(std::vector<NodeStats> &stats, unsigned depth);
+	void saveState(StateWriter &writer);
+	void restoreState(StateReader &reader);
+	void checkpoint(void);
+	void commit(void);
+	void rollback(void);
+
+	/**
+	 \brief returns the values of the operand.
+	 \returns the values of the operand, from the smallest cursor of the readers to the last update time.
+	 */
+	inline const Signal& getValues(void) const {return values;};
+
+	/**
+	 \brief returns the first instant whose value is needed by a reader.
+	 \returns the instant passed to the last call of consume by *reader* (or the start time).
+	 */
+	inline TimeType getCursor(reader_id reader) const {return cursors[reader];};
+
+	/**
+	 \brief returns the coalescing tolerance of the buffer.
+	 \returns the smallest tolerance declared by the readers (the gaps of the operand not longer than it are filled).
+	 */
+	inline TimeType getTolerance(void) const {return tolerance;};
+
+	inline TimeType minTime(void) const {return child->minTime();};
+	inline const Signal& getPartialTrue(void) const {return child->getPartialTrue();};
+	inline const Signal& getPartialFalse(void) const {return child->getPartialFalse();};
+};
+
+/**
+ \brief Node computing the operator \f$\varphi_1 U_{[a,\alpha]} \varphi_2\f$.
+
+ The formula is true in *t* if and only if \f$\varphi_2\f$ is true in an instant \f$t' \in [t+a,t+\alpha]\f$ and \f$\varphi_1\f$ is
+ true in \f$[t,t')\f$, also if \f$a > 0\f$ (\f$\varphi_1\f$ can become false in \f$t'\f$). The lower bound *a* is handled by the
+ same kernel of the upper bound, so the node only retains the values of its children in a window of length \f$\alpha\f$.
+
+ If the first operand is the constant true (i.e. the node computes \f$F_{[a,\alpha]} \varphi_2\f$), the node lets the buffer of
+ the second operand fill its gaps not longer than \f$\alpha-a\f$.
+ */
 class UntilValidatorNode:public ValidatorNode
 {
 private:
-	ValidatorNode *firstchild;
-	ValidatorNode *secondchild;
-	RealType alpha;
-	Signal buffer1;
-	Signal buffer2;
+	SignalBuffer *firstbuffer;
+	SignalBuffer *secondbuffer;
+	SignalBuffer::reader_id firstreader;
+	SignalBuffer::reader_id secondreader;
+	TimeType alpha;
+	TimeType lowerbound;
+	TimeType horizon; /**< first instant whose value is needed (see skipBefore)*/
+	TimeType savedhorizon; /**< horizon at the last checkpoint*/
 
 	// optimization fields
-	RealType max;
+	TimeType max;
 	Signal computedValues;
+	Signal partialTrue;
+	Signal partialFalse;
 
 public:
-	UntilValidatorNode (ValidatorNode &child1, ValidatorNode &child2, RealType alpha);
-	void start(RealType ts, const std::vector<BooleanType> &preds);
-	void update(RealType t, const std::vector<BooleanType> &preds);
+	UntilValidatorNode (SignalBuffer &buffer1, SignalBuffer &buffer2, TimeType alpha, TimeType lowerbound = 0, bool firstistrue = false);
+	void start(TimeType ts, const std::vector<BooleanType> &preds);
+	void update(TimeType t, const std::vector<BooleanType> &preds);
+	void evaluatePartial(void);
+	void skipBefore(TimeType t);
+	double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate);
+	std::string label(void) const;
+	void collectStats(std::vector<NodeStats> &stats, unsigned depth);
+	void saveState(StateWriter &writer);
+	void restoreState(StateReader &reader);
+	void checkpoint(void);
+	void commit(void);
+	void rollback(void);
   	~UntilValidatorNode(void);
 
 	inline const Signal& getValues(void)  const {return computedValues;};
-	inline RealType minTime(void) const {return max + alpha;};
+	inline bool isNegated(void) const {return false;};
+	inline TimeType minTime(void) const {return max + alpha;};
+	inline const Signal& getPartialTrue(void) const {return partialTrue;};
+	inline const Signal& getPartialFalse(void) const {return partialFalse;};
+
+};
+
+/**
+ \brief Node computing the past-time operator \f$\varphi_1 S_{[0,\alpha]} \varphi_2\f$.
+
+ The formula is true in *t* if and only if \f$\varphi_2\f$ was true in an instant \f$t' \in [t-\alpha,t]\f$ and \f$\varphi_1\f$ has been true
+ in \f$(t',t]\f$ (instants before the trace start are not considered). Since the operator only looks at the past, the node does not
+ add any delay to the evaluation: its minTime is the one of its children.
+
+ If the first operand is the constant true (i.e. the node computes \f$O_{[0,\alpha]} \varphi_2\f$), the node lets the buffer of
+ the second operand fill its gaps not longer than \f$\alpha\f$.
+ */
+class SinceValidatorNode:public ValidatorNode
+{
+private:
+	SignalBuffer *firstbuffer;
+	SignalBuffer *secondbuffer;
+	SignalBuffer::reader_id firstreader;
+	SignalBuffer::reader_id secondreader;
+	TimeType alpha;
+	TimeType deadline; /**< end of the extension of the last interval of the second child that could still continue*/
+	TimeType horizon; /**< first instant whose value is needed (see skipBefore)*/
+	TimeType saveddeadline, savedhorizon; /**< deadline and horizon at the last checkpoint*/
+
+	// optimization fields
+	TimeType max;
+	Signal computedValues;
+	Signal partialTrue;
+	Signal partialFalse;
+
+public:
+	SinceValidatorNode (SignalBuffer &buffer1, SignalBuffer &buffer2, TimeType alpha, bool firstistrue = false);
+	void start(TimeType ts, const std::vector<BooleanType> &preds);
+	void update(TimeType t, const std::vector<BooleanType> &preds);
+	void evaluatePartial(void);
+	void skipBefore(TimeType t);
+	double analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate);
+	std::string label(void) const;
+	void collectStats(std::vector<NodeStats> &stats, unsigned depth);
+	void saveState(StateWriter &writer);
+	void restoreState(StateReader &reader);
+	void checkpoint(void);
+	void commit(void);
+	void rollback(void);
+  	~SinceValidatorNode(void);
+
+	inline const Signal& getValues(void)  const {return computedValues;};
+	inline bool isNegated(void) const {return false;};
+	inline TimeType minTime(void) const {return max;};
+	inline const Signal& getPartialTrue(void) const {return partialTrue;};
+	inline const Signal& getPartialFalse(void) const {return partialFalse;};
 
 };
 #endif
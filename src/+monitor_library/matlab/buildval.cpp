@@ -1,21 +1,19 @@
+#include <cstring>
+#include <deque>
 #include <limits>
+#include <map>
 #include <string>
 #include <sstream>
 #include <stdexcept>
 
-#include "mex.h"
 #include "validators.h"
+#include "bytecode.h"
 
-using std::string; using std::exception;
+#ifdef MATLAB_MEX_FILE
+#include "mex.h"
+#endif
 
-// defining the values of nodetype
-#define MTS_PREDICATE 	0
-#define	MTS_NOT 		1
-#define	MTS_AND 		2
-#define	MTS_OR 			3
-#define	MTS_FUTURE  	4
-#define	MTS_GLOBALLY  	5
-#define	MTS_UNTIL 		6
+using std::string; using std::exception;
 
 //defining the fields of the syntax tree node
 #define MTS_NODETYPE 		"NodeType"
@@ -24,21 +22,60 @@ using std::string; using std::exception;
 #define	MTS_FIRST_CHILD  	"FirstChildNode"
 #define	MTS_SECOND_CHILD 	"SecondChildNode"
 #define	MTS_ALPHA 			"Alpha"
+#define	MTS_LOWER_BOUND 	"LowerBound"
 
-static ValidatorNode* predicateBehaviour( const mxArray*);
-static ValidatorNode* notBehaviour( const mxArray*);
-static ValidatorNode* andBehaviour(const mxArray *formulatree);
-static ValidatorNode* orBehaviour( const mxArray*);
-static ValidatorNode* futureBehaviour(const mxArray *formulatree);
-static ValidatorNode* globallyBehaviour(const mxArray *formulatree);
-static ValidatorNode* untilBehaviour( const mxArray*);
+// state shared by the builders of the nodes of a monitor
+struct BuildContext
+{
+	std::map<std::string, SignalBuffer*> buffers; // buffers of the operands of the temporal operators, indexed by the key of the operand (see formulaKey)
+	std::vector<TimeType> dwell; // minimum dwell time of each predicate (see PredicateValidatorNode), zero for the missing indexes
+};
+
+// the builders are templates on the representation of the syntax tree (either const mxArray* or const BytecodeNode*)
+template <class Formula> static ValidatorNode* buildNode(Formula formulatree, BuildContext &context);
+template <class Formula> static ValidatorNode* predicateBehaviour(Formula formulatree, BuildContext &context);
+template <class Formula> static ValidatorNode* notBehaviour(Formula formulatree, BuildContext &context);
+template <class Formula> static ValidatorNode* andBehaviour(Formula formulatree, BuildContext &context);
+template <class Formula> static ValidatorNode* orBehaviour(Formula formulatree, BuildContext &context);
+template <class Formula> static ValidatorNode* futureBehaviour(Formula formulatree, BuildContext &context);
+template <class Formula> static ValidatorNode* globallyBehaviour(Formula formulatree, BuildContext &context);
+template <class Formula> static ValidatorNode* untilBehaviour(Formula formulatree, BuildContext &context);
+template <class Formula> static ValidatorNode* onceBehaviour(Formula formulatree, BuildContext &context);
+template <class Formula> static ValidatorNode* historicallyBehaviour(Formula formulatree, BuildContext &context);
+template <class Formula> static ValidatorNode* sinceBehaviour(Formula formulatree, BuildContext &context);
+
+template <class Formula> static SignalBuffer* sharedBuffer(Formula formula, BuildContext &context);
+template <class Formula> static SignalBuffer* sharedNotBuffer(Formula formula, BuildContext &context);
+static SignalBuffer* sharedTrueBuffer(BuildContext &context);
+static SignalBuffer* cacheBuffer(const string &key, ValidatorNode *node, BuildContext &context);
 
 static void checkError(bool, std::string);
+
+// syntax tree access (MATLAB structure, available only in the MEX build)
+#ifdef MATLAB_MEX_FILE
+static string formulaKey(const mxArray *formula);
+static string notFormulaKey(const mxArray *formula);
 static void getChildren(const mxArray * const formula, const mxArray **firstchild, const mxArray **secondchild);
 static void getOnlyChild(const mxArray * const formula, const mxArray **const child);
-static RealType getAlpha(const mxArray * const formula);
-
-
+static TimeType getAlpha(const mxArray * const formula);
+static TimeType getLowerBound(const mxArray * const formula);
+static int getNodeType(const mxArray * const formula);
+static PredicateValidatorNode::predicate_index getPredicateIndex(const mxArray * const formula);
+#endif
+
+// syntax tree access (bytecode)
+static const BytecodeNode* parseNode(const unsigned char *code, size_t length, size_t &pos, std::deque<BytecodeNode> &nodes, size_t depth);
+static string formulaKey(const BytecodeNode *formula);
+static string notFormulaKey(const BytecodeNode *formula);
+static void getChildren(const BytecodeNode * const formula, const BytecodeNode **firstchild, const BytecodeNode **secondchild);
+static void getOnlyChild(const BytecodeNode * const formula, const BytecodeNode **const child);
+static TimeType getAlpha(const BytecodeNode * const formula);
+static TimeType getLowerBound(const BytecodeNode * const formula);
+static int getNodeType(const BytecodeNode * const formula);
+static PredicateValidatorNode::predicate_index getPredicateIndex(const BytecodeNode * const formula);
+
+
+#ifdef MATLAB_MEX_FILE
 /*
  PRE-CONDITIONS buildValidator:
 	error (pointer to char array) must not be NULL
@@ -46,21 +83,51 @@ static RealType getAlpha(const mxArray * const formula);
 POST-CONDITIONS buildValidator:
 	Let val be the returned value, then:
 		* val correctly simulates the input syntax tree.
+		* the temporal operators of val with equal operands read the same buffer (see SignalBuffer).
+		* the predicate of index i filters the glitches shorter than dwell[i] (no filter if i >= dwell.size() or dwell[i] is zero).
  */
-ValidatorNode *buildValidator( const  mxArray *formulatree)
+ValidatorNode *buildValidator( const  mxArray *formulatree, const std::vector<TimeType> &dwell)
 {
+	BuildContext context;
+	context.dwell = dwell;
+	return buildNode(formulatree, context);
+}
+#endif
+
+/*
+ PRE-CONDITIONS buildValidator:
+	code must point to an array of at least length bytes.
 
-	checkError(formulatree == NULL, "Null pointer exception.");
-	checkError(!mxIsStruct(formulatree), "Input MATLAB object must be a structure.");
-	checkError(!mxIsScalar(formulatree), "Input MATLAB object must be a scalar.");
+POST-CONDITIONS buildValidator:
+	Let val be the returned value, then:
+		* val correctly simulates the syntax tree encoded in code (see MTS_BYTECODE_VERSION).
+		* the temporal operators of val with equal operands read the same buffer (see SignalBuffer).
+		* the predicate of index i filters the glitches shorter than dwell[i] (no filter if i >= dwell.size() or dwell[i] is zero).
+		* std::invalid_argument is thrown if code is not a valid bytecode.
+ */
+ValidatorNode *buildValidator(const unsigned char *code, size_t length, const std::vector<TimeType> &dwell)
+{
+	std::deque<BytecodeNode> nodes;
+	const BytecodeNode *root = parseBytecode(code, length, nodes);
 
-	const mxArray *nodetypearr = mxGetField(formulatree, 0 ,MTS_NODETYPE);
+	BuildContext context;
+	context.dwell = dwell;
+	return buildNode(root, context);
+}
 
-	checkError(nodetypearr == NULL,"The field " MTS_NODETYPE " is not defined in the input structure.");
-	checkError(!mxIsNumeric(nodetypearr),"The field " MTS_NODETYPE " must be a numeric type.");
-	checkError(!mxIsScalar(nodetypearr), "The field " MTS_NODETYPE " must be a scalar.");
+/*
+ PRE-CONDITIONS buildNode:
+	context must contain only buffers built by previous calls for the same syntax tree.
 
-	int nodetype = int(mxGetScalar(nodetypearr));
+POST-CONDITIONS buildNode:
+	Let val be the returned value, then:
+		* val correctly simulates the input syntax tree.
+		* the operands of the temporal operators of val are read from the buffers in context (the new buffers are added to context).
+ */
+template <class Formula>
+static ValidatorNode* buildNode(Formula formulatree, BuildContext &context)
+{
+	int nodetype = getNodeType(formulatree);
 
 	// variable that will point to the new allocated object that will be returned from the method call.
 	ValidatorNode *val = NULL;
@@ -68,31 +135,43 @@ ValidatorNode *buildValidator( const  mxArray *formulatree)
 	switch(nodetype)
 	{
 	case MTS_PREDICATE:
-		val = predicateBehaviour( formulatree);
+		val = predicateBehaviour(formulatree, context);
 		break;
 
 	case MTS_NOT:
-		val = notBehaviour( formulatree);
+		val = notBehaviour(formulatree, context);
 		break;
 
 	case MTS_FUTURE:
-		val = futureBehaviour(formulatree);
+		val = futureBehaviour(formulatree, context);
 		break;
 
 	case MTS_GLOBALLY:
-		val = globallyBehaviour(formulatree);
+		val = globallyBehaviour(formulatree, context);
 		break;
 
 	case MTS_AND:
-		val = andBehaviour(formulatree);
+		val = andBehaviour(formulatree, context);
 		break;
 
 	case MTS_OR:
-		val = orBehaviour( formulatree);
+		val = orBehaviour(formulatree, context);
 		break;
 
 	case MTS_UNTIL:
-		val = untilBehaviour( formulatree);
+		val = untilBehaviour(formulatree, context);
+		break;
+
+	case MTS_ONCE:
+		val = onceBehaviour(formulatree, context);
+		break;
+
+	case MTS_HISTORICALLY:
+		val = historicallyBehaviour(formulatree, context);
+		break;
+
+	case MTS_SINCE:
+		val = sinceBehaviour(formulatree, context);
 		break;
 
 	default:
@@ -101,39 +180,37 @@ ValidatorNode *buildValidator( const  mxArray *formulatree)
 	return val;
 }
 
-static ValidatorNode* predicateBehaviour(const mxArray *formulatree)
+template <class Formula>
+static ValidatorNode* predicateBehaviour(Formula formulatree, BuildContext &context)
 {
 	checkError(formulatree == NULL,"The input pointer must not point to null.");
-
-	const mxArray *pred_arr = mxGetField(formulatree, 0 ,MTS_PREDICATE_INDEX);
-
-	checkError(pred_arr == NULL,"The field " MTS_PREDICATE_INDEX " is not defined in the input structure.");
-	checkError(!mxIsNumeric(pred_arr),"The field " MTS_PREDICATE_INDEX " must be a numeric type.");
-	checkError(!mxIsScalar(pred_arr),"The field " MTS_PREDICATE_INDEX " must be a scalar.");
-
-	PredicateValidatorNode::predicate_index predindex = static_cast<PredicateValidatorNode::predicate_index>(mxGetScalar(pred_arr));
-	return new PredicateValidatorNode(predindex);
+	PredicateValidatorNode::predicate_index index = getPredicateIndex(formulatree);
+	TimeType dwell = index < context.dwell.size() ? context.dwell[index] : RT_ZERO;
+	checkError(dwell < RT_ZERO,"The minimum dwell time of a predicate must not be negative.");
+	return new PredicateValidatorNode(index, dwell);
 }
 
-static ValidatorNode* notBehaviour(const mxArray *formulatree)
+template <class Formula>
+static ValidatorNode* notBehaviour(Formula formulatree, BuildContext &context)
 {
 	checkError(formulatree == NULL,"The input pointer must not point to null.");
-	const mxArray * child = NULL;
+	Formula child = NULL;
 
 	getOnlyChild(formulatree, &child);
 
-	ValidatorNode *childval = buildValidator(child);
+	ValidatorNode *childval = buildNode(child, context);
 	ValidatorNode *out = NULL;
 	out = new NotValidatorNode(*childval);
 
 	return out;
 }
 
-static ValidatorNode* orBehaviour(const mxArray *formulatree)
+template <class Formula>
+static ValidatorNode* orBehaviour(Formula formulatree, BuildContext &context)
 {
 	checkError(formulatree == NULL,"The input pointer must not point to null.");
-	const mxArray * firstchild = NULL;
-	const mxArray * secondchild = NULL;
+	Formula firstchild = NULL;
+	Formula secondchild = NULL;
 
 	getChildren(formulatree, &firstchild, &secondchild);
 
@@ -144,8 +221,8 @@ static ValidatorNode* orBehaviour(const mxArray *formulatree)
 	// trying to build the output validator
 	try
 	{
-		firstchildval = buildValidator(firstchild);
-		secondchildval =  buildValidator(secondchild);
+		firstchildval = buildNode(firstchild, context);
+		secondchildval =  buildNode(secondchild, context);
 		out = new OrValidatorNode(*firstchildval, *secondchildval);
 	}
 	catch (exception &e) 	// de-allocating allocated resources
@@ -166,11 +243,12 @@ static ValidatorNode* orBehaviour(const mxArray *formulatree)
 	return  out;
 }
 
-static ValidatorNode* andBehaviour(const mxArray *formulatree)
+template <class Formula>
+static ValidatorNode* andBehaviour(Formula formulatree, BuildContext &context)
 {
 	checkError(formulatree == NULL,"The input pointer must not point to null.");
-	const mxArray * firstchild = NULL;
-	const mxArray * secondchild = NULL;
+	Formula firstchild = NULL;
+	Formula secondchild = NULL;
 
 	getChildren(formulatree, &firstchild, &secondchild);
 
@@ -181,10 +259,10 @@ static ValidatorNode* andBehaviour(const mxArray *formulatree)
 	// trying to build the output validator
 	try
 	{
-		firstchildval = buildValidator(firstchild);
+		firstchildval = buildNode(firstchild, context);
 		firstchildval = new NotValidatorNode(*firstchildval);
 
-		secondchildval =  buildValidator(secondchild);
+		secondchildval =  buildNode(secondchild, context);
 		secondchildval =  new NotValidatorNode(*secondchildval);
 
 		out = new OrValidatorNode(*firstchildval,*secondchildval);
@@ -208,25 +286,26 @@ static ValidatorNode* andBehaviour(const mxArray *formulatree)
 	return  out;
 }
 
-static ValidatorNode* untilBehaviour(const mxArray *formulatree)
+template <class Formula>
+static ValidatorNode* untilBehaviour(Formula formulatree, BuildContext &context)
 {
 	checkError(formulatree == NULL,"The input pointer must not point to null.");
-	const mxArray * firstchild = NULL;
-	const mxArray * secondchild = NULL;
+	Formula firstchild = NULL;
+	Formula secondchild = NULL;
 
 	getChildren(formulatree, &firstchild, &secondchild);
 
-	ValidatorNode* firstchildval = NULL;
-	ValidatorNode* secondchildval = NULL;
+	SignalBuffer* firstbuffer = NULL;
+	SignalBuffer* secondbuffer = NULL;
 	ValidatorNode* out =  NULL;
 
 	// trying to build the output validator
 	try
 	{
-		firstchildval = buildValidator(firstchild);
-		secondchildval =  buildValidator(secondchild);
+		firstbuffer = sharedBuffer(firstchild, context);
+		secondbuffer =  sharedBuffer(secondchild, context);
 
-		out = new UntilValidatorNode(*firstchildval,*secondchildval,getAlpha(formulatree));
+		out = new UntilValidatorNode(*firstbuffer,*secondbuffer,getAlpha(formulatree),getLowerBound(formulatree));
 	}
 	catch (exception &e) 	// de-allocating allocated resources
 	{
@@ -234,35 +313,36 @@ static ValidatorNode* untilBehaviour(const mxArray *formulatree)
 			delete out;
 		else
 		{
-			if (firstchildval != NULL)
-				delete firstchildval;
+			if (firstbuffer != NULL)
+				firstbuffer->release();
 
-			if (secondchildval != NULL)
-				delete secondchildval;
+			if (secondbuffer != NULL)
+				secondbuffer->release();
 		}
 		throw;
 	}
 	return out;
 }
 
-static ValidatorNode* futureBehaviour(const mxArray *formulatree)
+template <class Formula>
+static ValidatorNode* futureBehaviour(Formula formulatree, BuildContext &context)
 {
 	checkError(formulatree == NULL,"The input pointer must not point to null.");
-	const mxArray * secondchild = NULL;
+	Formula secondchild = NULL;
 
 	getOnlyChild(formulatree, &secondchild);
 
-	ValidatorNode* firstchildval = NULL;
-	ValidatorNode* secondchildval = NULL;
+	SignalBuffer* firstbuffer = NULL;
+	SignalBuffer* secondbuffer = NULL;
 	ValidatorNode* out =  NULL;
 
 	// trying to build the output validator
 	try
 	{
-		firstchildval = new BooleanValidatorNode(true);
-		secondchildval =  buildValidator(secondchild);
+		firstbuffer = sharedTrueBuffer(context);
+		secondbuffer =  sharedBuffer(secondchild, context);
 
-		out = new UntilValidatorNode(*firstchildval,*secondchildval,getAlpha(formulatree));
+		out = new UntilValidatorNode(*firstbuffer,*secondbuffer,getAlpha(formulatree),getLowerBound(formulatree),true);
 	}
 	catch (exception &e) 	// de-allocating allocated resources
 	{
@@ -270,36 +350,36 @@ static ValidatorNode* futureBehaviour(const mxArray *formulatree)
 			delete out;
 		else
 		{
-			if (firstchildval != NULL)
-				delete firstchildval;
+			if (firstbuffer != NULL)
+				firstbuffer->release();
 
-			if (secondchildval != NULL)
-				delete secondchildval;
+			if (secondbuffer != NULL)
+				secondbuffer->release();
 		}
 		throw;
 	}
 	return out;
 }
 
-static ValidatorNode* globallyBehaviour(const mxArray *formulatree)
+template <class Formula>
+static ValidatorNode* globallyBehaviour(Formula formulatree, BuildContext &context)
 {
 	checkError(formulatree == NULL,"The input pointer must not point to null.");
-	const mxArray * secondchild = NULL;
+	Formula secondchild = NULL;
 
 	getOnlyChild(formulatree, &secondchild);
 
-	ValidatorNode* firstchildval = NULL;
-	ValidatorNode* secondchildval = NULL;
+	SignalBuffer* firstbuffer = NULL;
+	SignalBuffer* secondbuffer = NULL;
 	ValidatorNode* out =  NULL;
 
 	// trying to build the output validatorNode
 	try
 	{
-		firstchildval = new BooleanValidatorNode(true);
-		secondchildval =  buildValidator(secondchild);
-		secondchildval = new NotValidatorNode(*secondchildval);
+		firstbuffer = sharedTrueBuffer(context);
+		secondbuffer =  sharedNotBuffer(secondchild, context);
 
-		out = new UntilValidatorNode(*firstchildval,*secondchildval,getAlpha(formulatree));
+		out = new UntilValidatorNode(*firstbuffer,*secondbuffer,getAlpha(formulatree),getLowerBound(formulatree),true);
 		out = new NotValidatorNode(*out);
 	}
 	catch (exception &e) 	// de-allocating allocated resources
@@ -308,17 +388,304 @@ static ValidatorNode* globallyBehaviour(const mxArray *formulatree)
 			delete out;
 		else
 		{
-			if (firstchildval != NULL)
-				delete firstchildval;
+			if (firstbuffer != NULL)
+				firstbuffer->release();
 
-			if (secondchildval != NULL)
-				delete secondchildval;
+			if (secondbuffer != NULL)
+				secondbuffer->release();
+		}
+		throw;
+	}
+	return out;
+}
+
+
+template <class Formula>
+static ValidatorNode* sinceBehaviour(Formula formulatree, BuildContext &context)
+{
+	checkError(formulatree == NULL,"The input pointer must not point to null.");
+	Formula firstchild = NULL;
+	Formula secondchild = NULL;
+
+	getChildren(formulatree, &firstchild, &secondchild);
+
+	SignalBuffer* firstbuffer = NULL;
+	SignalBuffer* secondbuffer = NULL;
+	ValidatorNode* out =  NULL;
+
+	// trying to build the output validator
+	try
+	{
+		firstbuffer = sharedBuffer(firstchild, context);
+		secondbuffer =  sharedBuffer(secondchild, context);
+
+		out = new SinceValidatorNode(*firstbuffer,*secondbuffer,getAlpha(formulatree));
+	}
+	catch (exception &e) 	// de-allocating allocated resources
+	{
+		if (out != NULL)
+			delete out;
+		else
+		{
+			if (firstbuffer != NULL)
+				firstbuffer->release();
+
+			if (secondbuffer != NULL)
+				secondbuffer->release();
+		}
+		throw;
+	}
+	return out;
+}
+
+template <class Formula>
+static ValidatorNode* onceBehaviour(Formula formulatree, BuildContext &context)
+{
+	checkError(formulatree == NULL,"The input pointer must not point to null.");
+	Formula secondchild = NULL;
+
+	getOnlyChild(formulatree, &secondchild);
+
+	SignalBuffer* firstbuffer = NULL;
+	SignalBuffer* secondbuffer = NULL;
+	ValidatorNode* out =  NULL;
+
+	// trying to build the output validator
+	try
+	{
+		firstbuffer = sharedTrueBuffer(context);
+		secondbuffer =  sharedBuffer(secondchild, context);
+
+		out = new SinceValidatorNode(*firstbuffer,*secondbuffer,getAlpha(formulatree),true);
+	}
+	catch (exception &e) 	// de-allocating allocated resources
+	{
+		if (out != NULL)
+			delete out;
+		else
+		{
+			if (firstbuffer != NULL)
+				firstbuffer->release();
+
+			if (secondbuffer != NULL)
+				secondbuffer->release();
+		}
+		throw;
+	}
+	return out;
+}
+
+template <class Formula>
+static ValidatorNode* historicallyBehaviour(Formula formulatree, BuildContext &context)
+{
+	checkError(formulatree == NULL,"The input pointer must not point to null.");
+	Formula secondchild = NULL;
+
+	getOnlyChild(formulatree, &secondchild);
+
+	SignalBuffer* firstbuffer = NULL;
+	SignalBuffer* secondbuffer = NULL;
+	ValidatorNode* out =  NULL;
+
+	// trying to build the output validatorNode
+	try
+	{
+		firstbuffer = sharedTrueBuffer(context);
+		secondbuffer =  sharedNotBuffer(secondchild, context);
+
+		out = new SinceValidatorNode(*firstbuffer,*secondbuffer,getAlpha(formulatree),true);
+		out = new NotValidatorNode(*out);
+	}
+	catch (exception &e) 	// de-allocating allocated resources
+	{
+		if (out != NULL)
+			delete out;
+		else
+		{
+			if (firstbuffer != NULL)
+				firstbuffer->release();
+
+			if (secondbuffer != NULL)
+				secondbuffer->release();
 		}
 		throw;
 	}
 	return out;
 }
 
+/*
+ PRE-CONDITIONS sharedBuffer:
+	 * formula must be a valid syntax tree.
+
+ POST-CONDITIONS sharedBuffer:
+ 	 The following must be true after the function execution:
+
+ 	 	 * the returned buffer contains the values of the formula represented by formula, and a reference to it was acquired for the caller.
+ 	 	 * if a buffer of the same formula was already in context, then it is returned (and no node is built), otherwise the new buffer is
+ 	 	   added to context.
+ */
+template <class Formula>
+static SignalBuffer* sharedBuffer(Formula formula, BuildContext &context)
+{
+	string key = formulaKey(formula);
+
+	std::map<std::string, SignalBuffer*>::iterator it = context.buffers.find(key);
+	if (it != context.buffers.end())
+		return it->second->acquire();
+
+	return cacheBuffer(key, buildNode(formula, context), context);
+}
+
+/*
+ POST-CONDITIONS sharedTrueBuffer:
+ 	 The following must be true after the function execution:
+
+ 	 	 * the returned buffer contains the values of the constant true, and a reference to it was acquired for the caller.
+ 	 	 * the buffer is shared as in sharedBuffer.
+ */
+static SignalBuffer* sharedTrueBuffer(BuildContext &context)
+{
+	string key = "TRUE";
+
+	std::map<std::string, SignalBuffer*>::iterator it = context.buffers.find(key);
+	if (it != context.buffers.end())
+		return it->second->acquire();
+
+	return cacheBuffer(key, new BooleanValidatorNode(true), context);
+}
+
+/*
+ PRE-CONDITIONS sharedNotBuffer:
+	 * formula must be a valid syntax tree.
+
+ POST-CONDITIONS sharedNotBuffer:
+ 	 The following must be true after the function execution:
+
+ 	 	 * the returned buffer contains the values of the negation of the formula represented by formula, and a reference to it was
+ 	 	   acquired for the caller.
+ 	 	 * the buffer is shared as in sharedBuffer.
+ */
+template <class Formula>
+static SignalBuffer* sharedNotBuffer(Formula formula, BuildContext &context)
+{
+	string key = notFormulaKey(formula);
+
+	std::map<std::string, SignalBuffer*>::iterator it = context.buffers.find(key);
+	if (it != context.buffers.end())
+		return it->second->acquire();
+
+	return cacheBuffer(key, new NotValidatorNode(*buildNode(formula, context)), context);
+}
+
+/*
+ PRE-CONDITIONS cacheBuffer:
+	 * node must not be null.
+	 * key must not be in context.
+
+ POST-CONDITIONS cacheBuffer:
+ 	 The following must be true after the function execution:
+
+ 	 	 * the returned buffer owns node, it is in context with key as key and a reference to it was acquired for the caller.
+ */
+static SignalBuffer* cacheBuffer(const string &key, ValidatorNode *node, BuildContext &context)
+{
+	SignalBuffer *buffer = NULL;
+
+	try
+	{
+		buffer = new SignalBuffer(*node);
+	}
+	catch (exception &e)
+	{
+		delete node;
+		throw;
+	}
+
+	context.buffers[key] = buffer;
+	return buffer->acquire();
+}
+
+#ifdef MATLAB_MEX_FILE
+/*
+ PRE-CONDITIONS formulaKey:
+	 * formula must be a valid syntax tree.
+
+ POST-CONDITIONS formulaKey:
+ 	 The following must be true after the function execution:
+
+ 	 	 the returned string identifies the formula represented by formula: two syntax trees have the same key if and only if they
+ 	 	 are equal (same node types, predicate indexes and time bounds).
+ */
+static string formulaKey(const mxArray *formula)
+{
+	const mxArray * firstchild = NULL;
+	const mxArray * secondchild = NULL;
+
+	std::ostringstream key;
+	key.precision(std::numeric_limits<TimeType>::digits10 + 2);
+
+	int nodetype = getNodeType(formula);
+	key << nodetype;
+
+	switch(nodetype)
+	{
+	case MTS_PREDICATE:
+		key << "[" << getPredicateIndex(formula) << "]";
+		break;
+
+	case MTS_NOT:
+		getOnlyChild(formula, &firstchild);
+		return notFormulaKey(firstchild);
+
+	case MTS_AND:
+	case MTS_OR:
+		getChildren(formula, &firstchild, &secondchild);
+		key << "(" << formulaKey(firstchild) << "," << formulaKey(secondchild) << ")";
+		break;
+
+	case MTS_FUTURE:
+	case MTS_GLOBALLY:
+		getOnlyChild(formula, &firstchild);
+		key << "[" << getLowerBound(formula) << "," << getAlpha(formula) << "](" << formulaKey(firstchild) << ")";
+		break;
+
+	case MTS_ONCE:
+	case MTS_HISTORICALLY:
+		getOnlyChild(formula, &firstchild);
+		key << "[" << getAlpha(formula) << "](" << formulaKey(firstchild) << ")";
+		break;
+
+	case MTS_UNTIL:
+		getChildren(formula, &firstchild, &secondchild);
+		key << "[" << getLowerBound(formula) << "," << getAlpha(formula) << "](" << formulaKey(firstchild) << "," << formulaKey(secondchild) << ")";
+		break;
+
+	case MTS_SINCE:
+		getChildren(formula, &firstchild, &secondchild);
+		key << "[" << getAlpha(formula) << "](" << formulaKey(firstchild) << "," << formulaKey(secondchild) << ")";
+		break;
+
+	default:
+			checkError(true,"Input node type is not valid.");
+	}
+	return key.str();
+}
+
+/*
+ PRE-CONDITIONS notFormulaKey:
+	 * formula must be a valid syntax tree.
+
+ POST-CONDITIONS notFormulaKey:
+ 	 The following must be true after the function execution:
+
+ 	 	 the returned string is the key (see formulaKey) of the NOT node whose child is formula.
+ */
+static string notFormulaKey(const mxArray *formula)
+{
+	std::ostringstream key;
+	key << MTS_NOT << "(" << formulaKey(formula) << ")";
+	return key.str();
+}
 
 /*
  PRE-CONDITIONS getChildren:
@@ -383,9 +750,9 @@ static void getOnlyChild(const mxArray * const formula, const mxArray **const ch
  POST-CONDITIONS getAlpha:
  	 The following must be true after the function execution:
 
- 	 	 the returned value is equal to the value in the field 'Alpha'.
+ 	 	 the returned value is equal to the value in the field 'Alpha' (seconds), converted with TimePolicy::fromSeconds.
  */
-static RealType getAlpha(const mxArray * const formula)
+static TimeType getAlpha(const mxArray * const formula)
 {
 	checkError(formula == NULL,"The first input pointer must not point to null.");
 	checkError(!mxIsStruct(formula), "The first input pointer must point to a structure.");
@@ -398,9 +765,327 @@ static RealType getAlpha(const mxArray * const formula)
 	checkError(!mxIsScalar(alpha_arr),"The field " MTS_ALPHA " must be a scalar.");
 
 	RealType alpha = static_cast<RealType> (mxGetScalar(alpha_arr));
-	return alpha;
+	return TimePolicy::fromSeconds(alpha);
+}
+
+/*
+ PRE-CONDITIONS getLowerBound:
+	 * formula must not be to null.
+ 	 * formula must point to a structure.
+ 	 * formula must point to a scalar structure.
+
+ POST-CONDITIONS getLowerBound:
+ 	 The following must be true after the function execution:
+
+ 	 	 the returned value is equal to the value in the field 'LowerBound' (seconds) converted with TimePolicy::fromSeconds, or zero if the field is not defined.
+ */
+static TimeType getLowerBound(const mxArray * const formula)
+{
+	checkError(formula == NULL,"The first input pointer must not point to null.");
+	checkError(!mxIsStruct(formula), "The first input pointer must point to a structure.");
+	checkError(!mxIsScalar(formula),"The first input pointer must point to a scalar structure.");
+
+	const mxArray *lowerbound_arr = mxGetField(formula, 0 ,MTS_LOWER_BOUND);
+
+	// the field is optional: windows of the form [0,alpha] do not need it
+	if (lowerbound_arr == NULL)
+		return 0;
+
+	checkError(!mxIsNumeric(lowerbound_arr),"The field " MTS_LOWER_BOUND " must be a numeric type.");
+	checkError(!mxIsScalar(lowerbound_arr),"The field " MTS_LOWER_BOUND " must be a scalar.");
+
+	RealType lowerbound = static_cast<RealType> (mxGetScalar(lowerbound_arr));
+	return TimePolicy::fromSeconds(lowerbound);
+}
+
+/*
+ PRE-CONDITIONS getNodeType:
+	 * formula must not be to null.
+ 	 * formula must point to a structure.
+ 	 * formula must point to a scalar structure.
+ 	 * formula must have the field 'NodeType'.
+
+ POST-CONDITIONS getNodeType:
+ 	 The following must be true after the function execution:
+
+ 	 	 the returned value is equal to the value in the field 'NodeType'.
+ */
+static int getNodeType(const mxArray * const formula)
+{
+	checkError(formula == NULL, "Null pointer exception.");
+	checkError(!mxIsStruct(formula), "Input MATLAB object must be a structure.");
+	checkError(!mxIsScalar(formula), "Input MATLAB object must be a scalar.");
+
+	const mxArray *nodetypearr = mxGetField(formula, 0 ,MTS_NODETYPE);
+
+	checkError(nodetypearr == NULL,"The field " MTS_NODETYPE " is not defined in the input structure.");
+	checkError(!mxIsNumeric(nodetypearr),"The field " MTS_NODETYPE " must be a numeric type.");
+	checkError(!mxIsScalar(nodetypearr), "The field " MTS_NODETYPE " must be a scalar.");
+
+	return int(mxGetScalar(nodetypearr));
+}
+
+/*
+ PRE-CONDITIONS getPredicateIndex:
+	 * formula must not be to null.
+ 	 * formula must point to a structure.
+ 	 * formula must point to a scalar structure.
+ 	 * formula must have the field 'PredicateIndex'.
+
+ POST-CONDITIONS getPredicateIndex:
+ 	 The following must be true after the function execution:
+
+ 	 	 the returned value is equal to the value in the field 'PredicateIndex'.
+ */
+static PredicateValidatorNode::predicate_index getPredicateIndex(const mxArray * const formula)
+{
+	const mxArray *pred_arr = mxGetField(formula, 0 ,MTS_PREDICATE_INDEX);
+
+	checkError(pred_arr == NULL,"The field " MTS_PREDICATE_INDEX " is not defined in the input structure.");
+	checkError(!mxIsNumeric(pred_arr),"The field " MTS_PREDICATE_INDEX " must be a numeric type.");
+	checkError(!mxIsScalar(pred_arr),"The field " MTS_PREDICATE_INDEX " must be a scalar.");
+
+	return static_cast<PredicateValidatorNode::predicate_index>(mxGetScalar(pred_arr));
+}
+#endif
+
+/*
+ PRE-CONDITIONS parseBytecode:
+	 * code must point to an array of at least length bytes.
+
+ POST-CONDITIONS parseBytecode:
+ 	 The following must be true after the function execution:
+
+ 	 	 * nodes contains the nodes encoded in code and the returned value is the root node (the nodes point to code, hence code
+ 	 	   must not be deallocated while they are used).
+ 	 	 * std::invalid_argument is thrown if code is not a valid bytecode (every read is checked against length, in a single pass),
+ 	 	   or if its syntax tree is deeper than MTS_BYTECODE_MAX_DEPTH.
+ */
+const BytecodeNode* parseBytecode(const unsigned char *code, size_t length, std::deque<BytecodeNode> &nodes)
+{
+	const size_t magiclength = std::strlen(MTS_BYTECODE_MAGIC);
+
+	checkError(code == NULL, "The bytecode must not point to null.");
+	checkError(length < magiclength + 1 || std::memcmp(code, MTS_BYTECODE_MAGIC, magiclength) != 0, "The bytecode header is not valid.");
+	checkError(code[magiclength] != MTS_BYTECODE_VERSION, "The bytecode version is not supported.");
+
+	size_t pos = magiclength + 1;
+	const BytecodeNode *root = parseNode(code, length, pos, nodes, 1);
+
+	checkError(pos != length, "The bytecode contains data after the syntax tree.");
+	return root;
+}
+
+// reads an unsigned little-endian integer of size bytes (size at most 8), checking the bounds of code
+static UInt64Type readUnsigned(const unsigned char *code, size_t length, size_t &pos, size_t size)
+{
+	checkError(length - pos < size, "The bytecode is truncated.");
+
+	UInt64Type value = 0;
+	for (size_t i = 0; i < size; i++)
+		value |= static_cast<UInt64Type>(code[pos + i]) << (8*i);
+
+	pos += size;
+	return value;
 }
 
+// reads a little-endian IEEE 754 double, checking the bounds of code
+static RealType readReal(const unsigned char *code, size_t length, size_t &pos)
+{
+	UInt64Type bits = readUnsigned(code, length, pos, 8);
+
+	double value;
+	std::memcpy(&value, &bits, sizeof(value));
+
+	const double maxvalue = std::numeric_limits<double>::max();
+	checkError(!(value >= -maxvalue && value <= maxvalue), "The bytecode contains a time bound that is not a finite number.");
+
+	return static_cast<RealType>(value);
+}
+
+/*
+ PRE-CONDITIONS parseNode:
+	 * code must point to an array of at least length bytes.
+	 * pos must be less than or equal to length.
+	 * depth is the depth of the node in the syntax tree (1 for the root).
+
+ POST-CONDITIONS parseNode:
+ 	 The following must be true after the function execution:
+
+ 	 	 * the returned node (added to nodes, as its children) is the node encoded in code starting from pos.
+ 	 	 * pos is the position of the first byte after the node encoding.
+ 	 	 * std::invalid_argument is thrown if a node of the tree is deeper than MTS_BYTECODE_MAX_DEPTH.
+ */
+static const BytecodeNode* parseNode(const unsigned char *code, size_t length, size_t &pos, std::deque<BytecodeNode> &nodes, size_t depth)
+{
+	checkError(depth > MTS_BYTECODE_MAX_DEPTH, "The bytecode nests the nodes too deeply (see MTS_BYTECODE_MAX_DEPTH).");
+
+	BytecodeNode node;
+	node.begin = code + pos;
+	node.nodetype = static_cast<int>(readUnsigned(code, length, pos, 1));
+	node.predicateindex = 0;
+	node.lowerbound = 0;
+	node.alpha = 0;
+	node.firstchild = NULL;
+	node.secondchild = NULL;
+
+	switch(node.nodetype)
+	{
+	case MTS_PREDICATE:
+		node.predicateindex = static_cast<PredicateValidatorNode::predicate_index>(readUnsigned(code, length, pos, 4));
+		break;
+
+	case MTS_NOT:
+		node.firstchild = parseNode(code, length, pos, nodes, depth + 1);
+		break;
+
+	case MTS_AND:
+	case MTS_OR:
+		node.firstchild = parseNode(code, length, pos, nodes, depth + 1);
+		node.secondchild = parseNode(code, length, pos, nodes, depth + 1);
+		break;
+
+	case MTS_FUTURE:
+	case MTS_GLOBALLY:
+		node.lowerbound = readReal(code, length, pos);
+		node.alpha = readReal(code, length, pos);
+		node.firstchild = parseNode(code, length, pos, nodes, depth + 1);
+		break;
+
+	case MTS_UNTIL:
+		node.lowerbound = readReal(code, length, pos);
+		node.alpha = readReal(code, length, pos);
+		node.firstchild = parseNode(code, length, pos, nodes, depth + 1);
+		node.secondchild = parseNode(code, length, pos, nodes, depth + 1);
+		break;
+
+	case MTS_ONCE:
+	case MTS_HISTORICALLY:
+		node.alpha = readReal(code, length, pos);
+		node.firstchild = parseNode(code, length, pos, nodes, depth + 1);
+		break;
+
+	case MTS_SINCE:
+		node.alpha = readReal(code, length, pos);
+		node.firstchild = parseNode(code, length, pos, nodes, depth + 1);
+		node.secondchild = parseNode(code, length, pos, nodes, depth + 1);
+		break;
+
+	default:
+		checkError(true, "The bytecode contains a node type that is not valid.");
+	}
+
+	node.end = code + pos;
+	nodes.push_back(node);
+	return &nodes.back();
+}
+
+
+// writes an unsigned little-endian integer of size bytes (size at most 8)
+static void writeUnsigned(std::vector<unsigned char> &code, UInt64Type value, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+		code.push_back(static_cast<unsigned char>((value >> (8*i)) & 0xFF));
+}
+
+// writes a little-endian IEEE 754 double
+static void writeReal(std::vector<unsigned char> &code, double value)
+{
+	UInt64Type bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	writeUnsigned(code, bits, 8);
+}
+
+/**
+ \brief Append the header of the bytecode (magic and version) to code.
+ */
+void writeBytecodeHeader(std::vector<unsigned char> &code)
+{
+	code.insert(code.end(), MTS_BYTECODE_MAGIC, MTS_BYTECODE_MAGIC + std::strlen(MTS_BYTECODE_MAGIC));
+	code.push_back(MTS_BYTECODE_VERSION);
+}
+
+/**
+ \brief Append a predicate node to code.
+ \exception std::invalid_argument if index does not fit in 4 bytes.
+ */
+void writePredicateNode(std::vector<unsigned char> &code, unsigned long index)
+{
+	checkError(static_cast<UInt64Type>(index) > 0xFFFFFFFFUL, "The predicate index does not fit in the bytecode.");
+
+	code.push_back(MTS_PREDICATE);
+	writeUnsigned(code, index, 4);
+}
+
+/**
+ \brief Append a NOT, AND or OR node to code (its operands follow).
+ \exception std::invalid_argument if nodetype is not one of them.
+ */
+void writeOperatorNode(std::vector<unsigned char> &code, int nodetype)
+{
+	checkError(nodetype != MTS_NOT && nodetype != MTS_AND && nodetype != MTS_OR, "The node type is not NOT, AND or OR.");
+
+	code.push_back(static_cast<unsigned char>(nodetype));
+}
+
+/**
+ \brief Append a FUTURE, GLOBALLY or UNTIL node with the window [lowerbound, alpha] to code (its operands follow).
+ \exception std::invalid_argument if nodetype is not one of them.
+ */
+void writeFutureNode(std::vector<unsigned char> &code, int nodetype, double lowerbound, double alpha)
+{
+	checkError(nodetype != MTS_FUTURE && nodetype != MTS_GLOBALLY && nodetype != MTS_UNTIL,
+			"The node type is not FUTURE, GLOBALLY or UNTIL.");
+
+	code.push_back(static_cast<unsigned char>(nodetype));
+	writeReal(code, lowerbound);
+	writeReal(code, alpha);
+}
+
+/**
+ \brief Append a ONCE, HISTORICALLY or SINCE node with the window [0, alpha] to code (its operands follow).
+ \exception std::invalid_argument if nodetype is not one of them.
+ */
+void writePastNode(std::vector<unsigned char> &code, int nodetype, double alpha)
+{
+	checkError(nodetype != MTS_ONCE && nodetype != MTS_HISTORICALLY && nodetype != MTS_SINCE,
+			"The node type is not ONCE, HISTORICALLY or SINCE.");
+
+	code.push_back(static_cast<unsigned char>(nodetype));
+	writeReal(code, alpha);
+}
+
+// accessors of the parsed bytecode (the nodes are already checked by parseNode)
+static string formulaKey(const BytecodeNode *formula)
+{
+	// the encoding of equal syntax trees is the same
+	return string(formula->begin, formula->end);
+}
+
+static string notFormulaKey(const BytecodeNode *formula)
+{
+	// the encoding of the NOT node is its type followed by the encoding of its child
+	return string(1, static_cast<char>(MTS_NOT)) + formulaKey(formula);
+}
+
+static void getChildren(const BytecodeNode * const formula, const BytecodeNode **firstchild, const BytecodeNode **secondchild)
+{
+	checkError(formula->firstchild == NULL || formula->secondchild == NULL, "The bytecode node has not two children.");
+	*firstchild = formula->firstchild;
+	*secondchild = formula->secondchild;
+}
+
+static void getOnlyChild(const BytecodeNode * const formula, const BytecodeNode **const child)
+{
+	checkError(formula->firstchild == NULL, "The bytecode node has no child.");
+	*child = formula->firstchild;
+}
+
+static TimeType getAlpha(const BytecodeNode * const formula) {return TimePolicy::fromSeconds(formula->alpha);}
+static TimeType getLowerBound(const BytecodeNode * const formula) {return TimePolicy::fromSeconds(formula->lowerbound);}
+static int getNodeType(const BytecodeNode * const formula) {return formula->nodetype;}
+static PredicateValidatorNode::predicate_index getPredicateIndex(const BytecodeNode * const formula) {return formula->predicateindex;}
+
 static void checkError(const bool condition, std::string errstring)
 {
 	if(condition)
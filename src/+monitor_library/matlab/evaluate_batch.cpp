@@ -0,0 +1,166 @@
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+#include "mex.h"
+#include "validators.h"
+
+/*
+ PRE-CONDITIONS:
+ 	 *formula* is a syntax tree (struct, see bin.contree) or a bytecode (uint8 vector, see bin.conbytecode).
+
+ POST-CONDITIONS:
+ 	 Returns a new monitor of the formula.
+ */
+static Monitor* createMonitor(const mxArray *formula)
+{
+	if (mxIsStruct(formula))
+		return new Monitor(formula);
+	if (mxIsUint8(formula) && mxGetNumberOfElements(formula) > 0)
+		return new Monitor(static_cast<const unsigned char*>(mxGetData(formula)), mxGetNumberOfElements(formula));
+	throw std::invalid_argument("every formula must be a syntax tree (struct) or a bytecode (uint8 vector)");
+}
+
+/* returns the intervals of *values* as a new N-by-2 matrix, with the left limits in the first column and the right ones in the second*/
+static mxArray* intervalMatrix(const Signal &values)
+{
+	const size_t count = values.getIntervalCount();
+	mxArray *result = mxCreateDoubleMatrix(count, 2, mxREAL);
+	double *left = mxGetPr(result), *right = left + count;
+
+	for (Signal::const_iterator it = values.getBegin(); it != values.getEnd(); it++)
+	{
+		*left++ = TimePolicy::toSeconds(it->leftLimit);
+		*right++ = TimePolicy::toSeconds(it->rightLimit);
+	}
+	return result;
+}
+
+/*
+ PRE-CONDITIONS:
+ 	 *samples* has *count* rows (one per sample) and preds.size() columns, stored by column.
+
+ POST-CONDITIONS:
+ 	 changed[i] is true if and only if the row i differs from the row i-1 (changed[0] is true). The columns are read one at a
+ 	 time, in the order of the memory.
+ */
+static void findChanges(const mxLogical *samples, size_t count, size_t columns, std::vector<bool> &changed)
+{
+	changed.assign(count, false);
+	if (count > 0)
+		changed[0] = true;
+
+	for (size_t p = 0; p < columns; p++)
+	{
+		const mxLogical *column = samples + p * count;
+		for (size_t i = 1; i < count; i++)
+			if (column[i] != column[i - 1])
+				changed[i] = true;
+	}
+}
+
+/*
+ [intervals, evaluated] = evaluate_batch(formulas, time, samples) evaluates several formulas on one trace.
+
+ 	 * formulas: cell array of syntax trees (see bin.contree) or bytecodes (see bin.conbytecode); a single formula can also be
+ 	   given without the cell.
+ 	 * time: vector of the N instants of the samples (seconds, non decreasing).
+ 	 * samples: N-by-P logical matrix, the column p holds the values of the predicate with index p-1.
+
+ intervals is a cell array of the same size as formulas (a matrix if a single formula was given without the cell): each element is
+ a K-by-2 double matrix whose rows are the intervals [start, end) where the formula is false. evaluated holds, for each formula,
+ the instant up to which the formula was evaluated (the last instant minus the latency of the formula).
+
+ The predicates hold their values from the instant of a sample until the next one. Only the samples where some predicate changes
+ (and the last one) are given to the monitors, so long constant runs cost no updates; of several samples with the same instant,
+ the last one counts.
+ */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	if (nrhs != 3) mexErrMsgTxt("must have three inputs");
+	if (nlhs > 2) mexErrMsgTxt("must have at most two outputs");
+
+	const mxArray *formulas = prhs[0];
+	const bool single = !mxIsCell(formulas);
+	const size_t formulacount = single ? 1 : mxGetNumberOfElements(formulas);
+
+	if (!mxIsDouble(prhs[1]) || mxIsComplex(prhs[1])) mexErrMsgTxt("second input must be a real double vector");
+	if (!mxIsLogical(prhs[2])) mexErrMsgTxt("third input must be a logical matrix");
+
+	const double *time = mxGetPr(prhs[1]);
+	const size_t len = mxGetNumberOfElements(prhs[1]);
+	const mxLogical *samples = mxGetLogicals(prhs[2]);
+	const size_t columns = mxGetN(prhs[2]);
+
+	if (len == 0) mexErrMsgTxt("second input must have at least one element");
+	if (mxGetM(prhs[2]) != len) mexErrMsgTxt("third input must have one row per element of the second input");
+	for (size_t i = 1; i < len; i++)
+		if (!(time[i] >= time[i - 1])) mexErrMsgTxt("second input must be non decreasing");
+
+	std::vector<Monitor*> monitors;
+	std::string error;
+
+	try
+	{
+		for (size_t f = 0; f < formulacount; f++)
+		{
+			const mxArray *formula = single ? formulas : mxGetCell(formulas, f);
+			if (formula == NULL)
+				throw std::invalid_argument("every formula must be a syntax tree (struct) or a bytecode (uint8 vector)");
+			monitors.push_back(createMonitor(formula));
+		}
+
+		std::vector<bool> changed;
+		findChanges(samples, len, columns, changed);
+
+		// a sample is given to the monitors when it is the last of its instant and some predicate changed since the last one given
+		std::vector<BooleanType> preds(columns);
+		bool dirty = false;
+		for (size_t i = 0; i < len; i++)
+		{
+			dirty = dirty || changed[i];
+			const bool last = i + 1 == len || time[i + 1] > time[i];
+			if (!last || (!dirty && i + 1 < len))
+				continue;
+
+			for (size_t p = 0; p < columns; p++)
+				preds[p] = samples[p * len + i];
+			const TimeType t = TimePolicy::fromSeconds(time[i]);
+
+			for (size_t f = 0; f < formulacount; f++)
+			{
+				if (monitors[f]->isStarted())
+					monitors[f]->extendTrace(t, preds);
+				else
+					monitors[f]->initialConditions(t, preds);
+			}
+			dirty = false;
+		}
+
+		if (single)
+			plhs[0] = intervalMatrix(monitors[0]->formulaEvaluation());
+		else
+		{
+			plhs[0] = mxCreateCellArray(mxGetNumberOfDimensions(formulas), mxGetDimensions(formulas));
+			for (size_t f = 0; f < formulacount; f++)
+				mxSetCell(plhs[0], f, intervalMatrix(monitors[f]->formulaEvaluation()));
+		}
+
+		if (nlhs > 1)
+		{
+			plhs[1] = mxCreateDoubleMatrix(1, formulacount, mxREAL);
+			for (size_t f = 0; f < formulacount; f++)
+				mxGetPr(plhs[1])[f] = TimePolicy::toSeconds(monitors[f]->formulaEvaluation().getLast());
+		}
+	}
+	catch (std::exception &e)
+	{
+		error = std::string("Error during execution:") + e.what();
+	}
+
+	// the monitors are deleted before reporting an error, since mexErrMsgTxt does not return
+	for (size_t f = 0; f < monitors.size(); f++)
+		delete monitors[f];
+	if (!error.empty())
+		mexErrMsgTxt(error.c_str());
+}
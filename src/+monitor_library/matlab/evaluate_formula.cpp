@@ -5,7 +5,12 @@
 #include "mex.h"
 #include "validators.h"
 
-std::stringstream& operator<<(std::ostream& stream, const Signal& s){
+std::ostream& operator<<(std::ostream& stream, const Interval& h)
+{
+	return stream << "["<<h.leftLimit <<", "<<h.rightLimit<<")";
+}
+
+std::ostream& operator<<(std::ostream& stream, const Signal& s){
 	Signal::const_iterator it = s.getBegin();
 
 	stream<<"function:["<<s.getFirst() <<", "<< s.getLast()<<") -> {0,1}"<<"\n";
@@ -18,16 +23,38 @@ std::stringstream& operator<<(std::ostream& stream, const Signal& s){
 	return stream;
 }
 
-std::stringstream& operator<<(std::ostream& stream, const Interval& h)
-{
-	return stream << "["<<h.leftLimit <<", "<<h.rightLimit<<")";
-}
 
 
 
+/* returns the statistics of the nodes of a monitor as a struct array, with one element per node (see NodeStats)*/
+mxArray* statisticsStruct(const std::vector<NodeStats> &stats)
+{
+	const char *fields[] = {"label", "depth", "updates", "intervalsIn", "intervalsOut", "peakIntervals", "updateSeconds", "allocations"};
+	mxArray *result = mxCreateStructMatrix(stats.size(), 1, 8, fields);
+
+	for (size_t i = 0; i < stats.size(); i++)
+	{
+		mxSetField(result, i, "label", mxCreateString(stats[i].label.c_str()));
+		mxSetField(result, i, "depth", mxCreateDoubleScalar(stats[i].depth));
+		mxSetField(result, i, "updates", mxCreateDoubleScalar(stats[i].updates));
+		mxSetField(result, i, "intervalsIn", mxCreateDoubleScalar(stats[i].intervalsIn));
+		mxSetField(result, i, "intervalsOut", mxCreateDoubleScalar(stats[i].intervalsOut));
+		mxSetField(result, i, "peakIntervals", mxCreateDoubleScalar(stats[i].peakIntervals));
+		mxSetField(result, i, "updateSeconds", mxCreateDoubleScalar(stats[i].updateSeconds));
+		mxSetField(result, i, "allocations", mxCreateDoubleScalar(stats[i].allocations));
+	}
+	return result;
+}
+
+/*
+ evaluate_formula(formula, time, p1, p2, ...) prints the instants where the formula is false on the trace. The optional output
+ is the struct array of the statistics of the nodes of the monitor (the counters are zero if the library was not compiled with
+ the macro MTS_INSTRUMENTATION).
+ */
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
 	if(nrhs<2) mexErrMsgTxt("must have at least two inputs");
+	if(nlhs>1) mexErrMsgTxt("must have at most one output");
 
     try
     {
@@ -61,6 +88,8 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         std::stringstream s;
         s << formula.formulaEvaluation() << std::endl << std::endl;
         mexPrintf(s.str().c_str());
+
+        if(nlhs>0) plhs[0] = statisticsStruct(formula.statistics());
     }
     catch (std::exception &e)
     {
@@ -23,9 +23,13 @@
  */
 #include "simstruc.h"
 #include "validators.h"
+#include "async_monitor.h"
 
+#include <algorithm>
 #include <vector>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 using std::vector;using std::exception;
 
 /* Error handling
@@ -320,8 +324,26 @@ using std::vector;using std::exception;
  *=====================================*/
 
 static const int_T formulaParamIdx = 0;
+static const int_T optionsParamIdx = 1;
 static const int_T formulaPtrIdx = 0;
 static const int_T vectorPtrIdx = 1;
+static const int_T asyncPtrIdx = 2;
+
+typedef AsyncMonitor<Monitor> AsyncMonitorType;
+
+/* fields of the options parameter*/
+#define MTS_EARLY_VERDICT "EarlyVerdict"
+#define MTS_MIN_DWELL "MinDwell"			/* seconds a predicate keeps its value at least (0 = no resource analysis)*/
+#define MTS_MAX_STEP "MaxStep"				/* longest step of the solver in seconds (0 = MinDwell)*/
+#define MTS_MEMORY_BUDGET "MemoryBudget"	/* bytes of interval storage preallocated at most (default 1 MiB)*/
+#define MTS_CHATTER_FILTER "ChatterFilter"	/* minimum dwell time of the predicates in seconds, scalar or one per predicate (0 = no filter)*/
+#define MTS_MINOR_STEPS "MinorSteps"		/* whether or not the output is computed in the minor time steps of the solver*/
+#define MTS_ASYNC "Async"					/* whether or not the monitor is evaluated on a worker thread (see async_monitor.h)*/
+#define MTS_QUEUE_SIZE "QueueSize"			/* samples queued for the worker at most (default 4096)*/
+#define MTS_DROP_WHEN_FULL "DropWhenFull"	/* whether or not the samples are dropped when the queue is full (otherwise the simulation waits)*/
+
+static const double defaultMemoryBudget = 1 << 20;
+static const double defaultQueueSize = 4096;
 
 
 static inline Monitor*& getFormulaPtr(SimStruct *S)
@@ -334,6 +356,12 @@ static inline vector<boolean_T>*& getVectorPtr(SimStruct *S)
     vector<boolean_T>** tmp =  (vector<boolean_T>**)(ssGetPWork(S)+vectorPtrIdx);
     return *tmp;
 }
+/* the asynchronous evaluation of the monitor (NULL if the monitor is evaluated in mdlOutputs)*/
+static inline AsyncMonitorType*& getAsyncPtr(SimStruct *S)
+{
+    AsyncMonitorType** tmp =  (AsyncMonitorType**)(ssGetPWork(S)+asyncPtrIdx);
+    return *tmp;
+}
 
 static inline boolean_T& getOutputPortSig(SimStruct *S)
 {
@@ -343,6 +371,84 @@ static inline boolean_T& getOutputPortSig(SimStruct *S)
 static inline InputPtrsType getInputPortSig(SimStruct *S) {return ssGetInputPortSignalPtrs(S,0);}
 static inline int_T getInputPortWidth(SimStruct *S) {return ssGetInputPortWidth(S,0);}
 
+/* returns the value of a boolean field of the options parameter (false if the field is not defined)*/
+static bool getBooleanOption(SimStruct *S, const char *name)
+{
+	const mxArray *options = ssGetSFcnParam(S, optionsParamIdx);
+	if (options == NULL || !mxIsStruct(options) || !mxIsScalar(options))
+		return false;
+
+	const mxArray *value = mxGetField(options, 0, name);
+	if (value == NULL || !(mxIsNumeric(value) || mxIsLogical(value)) || !mxIsScalar(value))
+		return false;
+
+	return mxGetScalar(value) != 0;
+}
+
+/* returns the value of a real field of the options parameter (defaultValue if the field is not defined)*/
+static double getRealOption(SimStruct *S, const char *name, double defaultValue)
+{
+	const mxArray *options = ssGetSFcnParam(S, optionsParamIdx);
+	if (options == NULL || !mxIsStruct(options) || !mxIsScalar(options))
+		return defaultValue;
+
+	const mxArray *value = mxGetField(options, 0, name);
+	if (value == NULL || !mxIsNumeric(value) || !mxIsScalar(value))
+		return defaultValue;
+
+	return mxGetScalar(value);
+}
+
+/* returns the minimum dwell time of the chatter filter of each predicate (see PredicateValidatorNode), a scalar option applies to
+ * every predicate*/
+static vector<TimeType> getChatterFilter(SimStruct *S)
+{
+	vector<TimeType> dwell;
+	const mxArray *options = ssGetSFcnParam(S, optionsParamIdx);
+	if (options == NULL || !mxIsStruct(options) || !mxIsScalar(options))
+		return dwell;
+
+	const mxArray *value = mxGetField(options, 0, MTS_CHATTER_FILTER);
+	if (value == NULL || !mxIsDouble(value) || mxIsEmpty(value))
+		return dwell;
+
+	const double *seconds = mxGetPr(value);
+	if (mxIsScalar(value))
+		dwell.assign(getInputPortWidth(S), TimePolicy::fromSeconds(seconds[0]));
+	else
+		for (size_t i = 0; i < mxGetNumberOfElements(value); i++)
+			dwell.push_back(TimePolicy::fromSeconds(seconds[i]));
+	return dwell;
+}
+
+/*
+ * Resource analysis of the monitor (see Monitor::analyzeResources), if the options give the minimum dwell time of the
+ * predicates: the storage of the signals is preallocated if the bound is within the memory budget, otherwise a warning
+ * reports the bound and the storage grows during the simulation as usual.
+ */
+static void analyzeMonitorResources(SimStruct *S, Monitor *formulaPtr)
+{
+	static std::string warning; /* ssWarning needs persistent memory*/
+
+	const double dwell = getRealOption(S, MTS_MIN_DWELL, 0);
+	if (dwell <= 0)
+		return;
+
+	double step = getRealOption(S, MTS_MAX_STEP, 0);
+	if (step <= 0)
+		step = dwell;
+
+	const ResourceAssumptions assumptions(dwell, step, getBooleanOption(S, MTS_EARLY_VERDICT));
+	ResourceReport report = formulaPtr->analyzeResources(assumptions);
+	if (report.totalBytes() <= getRealOption(S, MTS_MEMORY_BUDGET, defaultMemoryBudget))
+		formulaPtr->analyzeResources(assumptions, true);
+	else
+	{
+		warning = "Monitor storage not preallocated (over the memory budget): " + report.summary();
+		ssWarning(S, warning.c_str());
+	}
+}
+
 
 /* Function: mdlInitializeSizes ===============================================
  * Abstract:
@@ -359,8 +465,9 @@ static void mdlInitializeSizes(SimStruct *S)
     int_T outputPortIdx = 0;
 
 
-    ssSetNumSFcnParams(S, 1);  /* Number of expected parameters */
+    ssSetNumSFcnParams(S, 2);  /* Number of expected parameters */
     int_T formulaIdx = 0;
+    int_T optionsIdx = 1;
 
     if (ssGetNumSFcnParams(S) != ssGetSFcnParamsCount(S)) {
         /*
@@ -373,6 +480,7 @@ static void mdlInitializeSizes(SimStruct *S)
     }
 
     ssSetSFcnParamTunable(S, formulaIdx, 0); /* First input parameter is not tunable*/
+    ssSetSFcnParamTunable(S, optionsIdx, 0); /* Second input parameter (monitor options) is not tunable*/
 
     /* Register the number and type of states the S-Function uses*/
     ssSetNumContStates( S, 0);   /* number of continuous states*/
@@ -446,13 +554,13 @@ static void mdlInitializeSizes(SimStruct *S)
     /* Set size of the work vectors.*/
     ssSetNumRWork( S, 0);  /* number of real work vector elements   */
     ssSetNumIWork( S, 0);  /* number of integer work vector elements*/
-    ssSetNumPWork( S, 2);  /* number of pointer work vector elements*/
+    ssSetNumPWork( S, 3);  /* number of pointer work vector elements*/
     ssSetNumModes( S, 0);  /* number of mode work vector elements   */
     ssSetNumNonsampledZCs( S, 0);   /* number of nonsampled zero crossings   */
 
-    /* Specify the sim state compliance to be same as a built-in block */
+    /* The state of the monitor is saved and restored by mdlGetSimState and mdlSetSimState */
     /* see sfun_simstate.c for example of other possible settings */
-    ssSetSimStateCompliance(S, DISALLOW_SIM_STATE);
+    ssSetSimStateCompliance(S, USE_CUSTOM_SIM_STATE);
 
     /*
      * All options have the form SS_OPTION_<name> and are documented in
@@ -482,7 +590,13 @@ static void mdlInitializeSizes(SimStruct *S)
 static void mdlInitializeSampleTimes(SimStruct *S)
 {
     ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME );   	/* continuos sample time*/
-    ssSetOffsetTime(S, 0, FIXED_IN_MINOR_STEP_OFFSET); 	/* fixed during minor timesteps*/
+
+    /* fixed during minor timesteps, unless the monitor is evaluated in the minor time steps (tentatively, see mdlOutputs); the
+     * asynchronous monitor is evaluated in the major time steps only*/
+    if (getBooleanOption(S, MTS_MINOR_STEPS) && !getBooleanOption(S, MTS_ASYNC))
+        ssSetOffsetTime(S, 0, 0.0);
+    else
+        ssSetOffsetTime(S, 0, FIXED_IN_MINOR_STEP_OFFSET);
 }
 
 
@@ -500,12 +614,33 @@ static void mdlInitializeSampleTimes(SimStruct *S)
 
 		 Monitor *&formulaPtr = getFormulaPtr(S);
 		 vector<boolean_T> *&vectorPtr = getVectorPtr(S);
+		 AsyncMonitorType *&asyncPtr = getAsyncPtr(S);
 
 	  formulaPtr = NULL;
 	  vectorPtr = NULL;
+	  asyncPtr = NULL;
 
 	  try{
-		  formulaPtr = new Monitor(formulaMex);
+		  /* the formula is either the compiled bytecode (uint8 array) or the syntax tree structure*/
+		  if (mxIsUint8(formulaMex))
+		  {
+			  const unsigned char *code = static_cast<const unsigned char*>(mxGetData(formulaMex));
+			  formulaPtr = new Monitor(code, mxGetNumberOfElements(formulaMex), getBooleanOption(S, MTS_EARLY_VERDICT),
+					  getChatterFilter(S));
+		  }
+		  else
+			  formulaPtr = new Monitor(formulaMex, getBooleanOption(S, MTS_EARLY_VERDICT), getChatterFilter(S));
+
+		  analyzeMonitorResources(S, formulaPtr);
+
+		  if (getBooleanOption(S, MTS_ASYNC))
+		  {
+			  const double size = getRealOption(S, MTS_QUEUE_SIZE, defaultQueueSize);
+			  if (size < 1)
+				  throw std::invalid_argument("The queue size of an asynchronous monitor must be at least 1.");
+			  asyncPtr = new AsyncMonitorType(*formulaPtr, static_cast<size_t>(size), ssGetInputPortWidth(S,0),
+					  getBooleanOption(S, MTS_DROP_WHEN_FULL) ? AsyncMonitorType::DROP : AsyncMonitorType::BLOCK);
+		  }
 	  }
 	  catch(exception &e)
 	  {
@@ -543,10 +678,27 @@ static void mdlOutputs(SimStruct *S, int_T tid)
 
 	 /* Updating the formula validator---------------------------------------------*/
 	 try{
+		 /* the asynchronous monitor queues the sample for the worker thread, and outputs the verdict of the samples evaluated so far*/
+		 AsyncMonitorType *asyncPtr = getAsyncPtr(S);
+		 if(asyncPtr != NULL)
+		 {
+			 if(!ssIsMinorTimeStep(S))
+				 asyncPtr->step(TimePolicy::fromSeconds(ssGetT(S)), *vectorPtr);
+			 getOutputPortSig(S) = !(asyncPtr->checkSafety());
+			 return;
+		 }
+
+		 /* the extension of the last minor time step is undone: only the major time steps are definitive, the trial instants of the
+		  * solver (which can be rejected, and followed by a smaller instant) are tentative*/
+		 if(formulaPtr->isSpeculating())
+			 formulaPtr->rollback();
+		 if(ssIsMinorTimeStep(S))
+			 formulaPtr->speculate();
+
 		 if(formulaPtr->isStarted())
-			 formulaPtr->extendTrace(ssGetT(S), *vectorPtr);
+			 formulaPtr->extendTrace(TimePolicy::fromSeconds(ssGetT(S)), *vectorPtr);
 		 else
-			 formulaPtr->initialConditions(ssGetT(S),*vectorPtr);
+			 formulaPtr->initialConditions(TimePolicy::fromSeconds(ssGetT(S)),*vectorPtr);
 
 		 /* Updating the output---------------------------------------------*/
 		 boolean_T &y  = getOutputPortSig(S);
@@ -558,6 +710,62 @@ static void mdlOutputs(SimStruct *S, int_T tid)
 	 }
 }
 
+#define MDL_SIM_STATE
+#if defined(MDL_SIM_STATE)
+  /* Function: mdlGetSimState =================================================
+   * Abstract:
+   *    Returns the state of the monitor as a uint8 row vector (see Monitor::saveState), so that
+   *    the simulation can be resumed (or branched into many simulations) from the saved operating point.
+   */
+  static mxArray* mdlGetSimState(SimStruct *S)
+  {
+	  Monitor *formulaPtr = getFormulaPtr(S);
+	  AsyncMonitorType *asyncPtr = getAsyncPtr(S);
+	  mxArray *simstate = NULL;
+
+	  try{
+		  /* the operating point is the last major time step*/
+		  if (formulaPtr->isSpeculating())
+			  formulaPtr->rollback();
+
+		  vector<unsigned char> state = asyncPtr != NULL ? asyncPtr->saveState() : formulaPtr->saveState();
+		  simstate = mxCreateNumericMatrix(1, state.size(), mxUINT8_CLASS, mxREAL);
+		  std::copy(state.begin(), state.end(), static_cast<unsigned char*>(mxGetData(simstate)));
+	  }
+	  catch(exception &e)
+	  {
+		  mexErrMsgTxt(e.what());
+	  }
+	  return simstate;
+  }
+
+  /* Function: mdlSetSimState =================================================
+   * Abstract:
+   *    Restores the state of the monitor returned by mdlGetSimState (called after mdlStart).
+   */
+  static void mdlSetSimState(SimStruct *S, const mxArray *simstate)
+  {
+	  Monitor *formulaPtr = getFormulaPtr(S);
+	  AsyncMonitorType *asyncPtr = getAsyncPtr(S);
+
+	  if (!mxIsUint8(simstate))
+		  mexErrMsgTxt("The simulation state of a monitor must be a uint8 array.");
+
+	  try{
+		  const unsigned char *data = static_cast<const unsigned char*>(mxGetData(simstate));
+		  if (asyncPtr != NULL)
+			  asyncPtr->restoreState(data, mxGetNumberOfElements(simstate));
+		  else
+			  formulaPtr->restoreState(data, mxGetNumberOfElements(simstate));
+	  }
+	  catch(exception &e)
+	  {
+		  mexErrMsgTxt(e.what());
+	  }
+  }
+#endif
+
+
 /* Function: mdlTerminate =====================================================
  * Abstract:
  *    In this function, you should perform any actions that are necessary
@@ -568,9 +776,37 @@ static void mdlTerminate(SimStruct *S)
 {
 	 Monitor *&formulaPtr = getFormulaPtr(S);
 	 vector<boolean_T> *&vectorPtr = getVectorPtr(S);
+	 AsyncMonitorType *&asyncPtr = getAsyncPtr(S);
+
+	/* the worker thread evaluates the queued samples and terminates, before the monitor is deleted*/
+	if (asyncPtr != NULL)
+	{
+		static std::string warning; /* ssWarning needs persistent memory*/
+		try{
+			asyncPtr->stop();
+		}
+		catch(exception &e)
+		{
+			warning = std::string("Asynchronous monitor stopped by an error: ") + e.what();
+			ssWarning(S, warning.c_str());
+		}
+#if defined(SS_STDIO_AVAILABLE)
+		AsyncStats queue = asyncPtr->statistics();
+		ssPrintf("Queue of the monitor %s: %lu samples, %lu dropped, %lu waits, depth at most %lu of %lu\n", ssGetPath(S),
+				queue.pushed, queue.dropped, queue.waits, (unsigned long)queue.maxdepth, (unsigned long)queue.capacity);
+#endif
+		delete asyncPtr;
+		asyncPtr = NULL;
+	}
 
 	if (formulaPtr != NULL)
 	{
+#if defined(MTS_INSTRUMENTATION) && defined(SS_STDIO_AVAILABLE)
+		/* statistics of the nodes collected during the simulation (see instrumentation.h)*/
+		std::ostringstream stats;
+		printStatistics(stats, formulaPtr->statistics());
+		ssPrintf("Statistics of the monitor %s:\n%s\n", ssGetPath(S), stats.str().c_str());
+#endif
 		delete formulaPtr;
 		formulaPtr = NULL;
 	}
@@ -0,0 +1,404 @@
+
+/*
+ * S-function of a monitor generated ahead of time (see bin.concpp and static_validators.h).
+ *
+ * The file is compiled once per formula, defining:
+ *   S_FUNCTION_NAME       name of the S-function.
+ *   MTS_FORMULA_TYPE      name of the monitor type declared in the generated header.
+ *   MTS_FORMULA_HEADER    name of the generated header.
+ *
+ * e.g. mex -DS_FUNCTION_NAME=mylib_sfun1 -DMTS_FORMULA_TYPE=mylib_monitor1 -DMTS_FORMULA_HEADER=mylib_monitor1.h ...
+ *
+ * The block interface is the one of monitor_sfun (see monitor_sfun.cpp for the documentation of the S-function methods), but
+ * the formula parameter is ignored: the syntax tree is part of the monitor type.
+ */
+#ifndef S_FUNCTION_NAME
+#error "S_FUNCTION_NAME must be defined as the name of the S-function."
+#endif
+
+#ifndef MTS_FORMULA_TYPE
+#error "MTS_FORMULA_TYPE must be defined as the name of the generated monitor type."
+#endif
+
+#ifndef MTS_FORMULA_HEADER
+#error "MTS_FORMULA_HEADER must be defined as the name of the generated header."
+#endif
+
+#define S_FUNCTION_LEVEL 2
+
+#include "simstruc.h"
+#include "static_validators.h"
+#include "async_monitor.h"
+
+#define MTS_STRINGIFY(x) #x
+#define MTS_HEADER_STRING(x) MTS_STRINGIFY(x)
+#include MTS_HEADER_STRING(MTS_FORMULA_HEADER)
+
+#include <algorithm>
+#include <vector>
+#include <stdexcept>
+#include <string>
+using std::vector;using std::exception;
+
+typedef MTS_FORMULA_TYPE FormulaMonitor;
+typedef AsyncMonitor<FormulaMonitor> AsyncMonitorType;
+
+/*=====================================*
+ * Configuration and execution methods *
+ *=====================================*/
+
+static const int_T formulaParamIdx = 0;
+static const int_T optionsParamIdx = 1;
+static const int_T formulaPtrIdx = 0;
+static const int_T vectorPtrIdx = 1;
+static const int_T asyncPtrIdx = 2;
+
+/* fields of the options parameter*/
+#define MTS_EARLY_VERDICT "EarlyVerdict"
+#define MTS_MIN_DWELL "MinDwell"			/* seconds a predicate keeps its value at least (0 = no resource analysis)*/
+#define MTS_MAX_STEP "MaxStep"				/* longest step of the solver in seconds (0 = MinDwell)*/
+#define MTS_MEMORY_BUDGET "MemoryBudget"	/* bytes of interval storage preallocated at most (default 1 MiB)*/
+#define MTS_MINOR_STEPS "MinorSteps"		/* whether or not the output is computed in the minor time steps of the solver*/
+#define MTS_ASYNC "Async"					/* whether or not the monitor is evaluated on a worker thread (see async_monitor.h)*/
+#define MTS_QUEUE_SIZE "QueueSize"			/* samples queued for the worker at most (default 4096)*/
+#define MTS_DROP_WHEN_FULL "DropWhenFull"	/* whether or not the samples are dropped when the queue is full (otherwise the simulation waits)*/
+
+static const double defaultMemoryBudget = 1 << 20;
+static const double defaultQueueSize = 4096;
+
+
+static inline FormulaMonitor*& getFormulaPtr(SimStruct *S)
+{
+    FormulaMonitor** tmp =  (FormulaMonitor**)(ssGetPWork(S)+formulaPtrIdx);
+    return *tmp;
+}
+static inline vector<boolean_T>*& getVectorPtr(SimStruct *S)
+{
+    vector<boolean_T>** tmp =  (vector<boolean_T>**)(ssGetPWork(S)+vectorPtrIdx);
+    return *tmp;
+}
+static inline AsyncMonitorType*& getAsyncPtr(SimStruct *S)
+{
+    AsyncMonitorType** tmp =  (AsyncMonitorType**)(ssGetPWork(S)+asyncPtrIdx);
+    return *tmp;
+}
+
+static inline boolean_T& getOutputPortSig(SimStruct *S)
+{
+	return static_cast<boolean_T*>(ssGetOutputPortSignal(S,0))[0];
+}
+
+static inline InputPtrsType getInputPortSig(SimStruct *S) {return ssGetInputPortSignalPtrs(S,0);}
+static inline int_T getInputPortWidth(SimStruct *S) {return ssGetInputPortWidth(S,0);}
+
+/* returns the value of a boolean field of the options parameter (false if the field is not defined)*/
+static bool getBooleanOption(SimStruct *S, const char *name)
+{
+	const mxArray *options = ssGetSFcnParam(S, optionsParamIdx);
+	if (options == NULL || !mxIsStruct(options) || !mxIsScalar(options))
+		return false;
+
+	const mxArray *value = mxGetField(options, 0, name);
+	if (value == NULL || !(mxIsNumeric(value) || mxIsLogical(value)) || !mxIsScalar(value))
+		return false;
+
+	return mxGetScalar(value) != 0;
+}
+
+/* returns the value of a real field of the options parameter (defaultValue if the field is not defined)*/
+static double getRealOption(SimStruct *S, const char *name, double defaultValue)
+{
+	const mxArray *options = ssGetSFcnParam(S, optionsParamIdx);
+	if (options == NULL || !mxIsStruct(options) || !mxIsScalar(options))
+		return defaultValue;
+
+	const mxArray *value = mxGetField(options, 0, name);
+	if (value == NULL || !mxIsNumeric(value) || !mxIsScalar(value))
+		return defaultValue;
+
+	return mxGetScalar(value);
+}
+
+/*
+ * Resource analysis of the monitor (see StaticMonitor::analyzeResources), as in monitor_sfun: the storage of the signals is
+ * preallocated if the bound is within the memory budget, otherwise a warning reports the bound.
+ */
+static void analyzeMonitorResources(SimStruct *S, FormulaMonitor *formulaPtr)
+{
+	static std::string warning; /* ssWarning needs persistent memory*/
+
+	const double dwell = getRealOption(S, MTS_MIN_DWELL, 0);
+	if (dwell <= 0)
+		return;
+
+	double step = getRealOption(S, MTS_MAX_STEP, 0);
+	if (step <= 0)
+		step = dwell;
+
+	const ResourceAssumptions assumptions(dwell, step);
+	ResourceReport report = formulaPtr->analyzeResources(assumptions);
+	if (report.totalBytes() <= getRealOption(S, MTS_MEMORY_BUDGET, defaultMemoryBudget))
+		formulaPtr->analyzeResources(assumptions, true);
+	else
+	{
+		warning = "Monitor storage not preallocated (over the memory budget): " + report.summary();
+		ssWarning(S, warning.c_str());
+	}
+}
+
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *    Same ports, parameters and work vectors of monitor_sfun.
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    int_T inputPortIdx  = 0;
+    int_T outputPortIdx = 0;
+
+    ssSetNumSFcnParams(S, 2);  /* Number of expected parameters */
+
+    if (ssGetNumSFcnParams(S) != ssGetSFcnParamsCount(S))
+        return;
+
+    ssSetSFcnParamTunable(S, formulaParamIdx, 0);
+    ssSetSFcnParamTunable(S, optionsParamIdx, 0);
+
+    ssSetNumContStates( S, 0);
+    ssSetNumDiscStates( S, 0);
+
+    if (!ssSetNumInputPorts(S, 1)) return;
+    if(!ssSetInputPortVectorDimension(S, inputPortIdx, DYNAMICALLY_SIZED)) return;
+    ssSetInputPortDataType(S,inputPortIdx,SS_BOOLEAN);
+    ssSetInputPortDirectFeedThrough(S, inputPortIdx, 1);
+
+    if (!ssSetNumOutputPorts(S, 1)) return;
+    if(!ssSetOutputPortVectorDimension(S, outputPortIdx, 1)) return;
+    ssSetOutputPortDataType(S,outputPortIdx,SS_BOOLEAN);
+
+    ssSetNumSampleTimes(S, 1);
+
+    ssSetNumRWork( S, 0);
+    ssSetNumIWork( S, 0);
+    ssSetNumPWork( S, 3);
+    ssSetNumModes( S, 0);
+    ssSetNumNonsampledZCs( S, 0);
+
+    ssSetSimStateCompliance(S, USE_CUSTOM_SIM_STATE);
+    ssSetOptions( S, 0);
+}
+
+
+/* Function: mdlInitializeSampleTimes =========================================
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME );   	/* continuos sample time*/
+
+    /* fixed during minor timesteps, unless the monitor is evaluated in the minor time steps (tentatively, see mdlOutputs)*/
+    if (getBooleanOption(S, MTS_MINOR_STEPS) && !getBooleanOption(S, MTS_ASYNC))
+        ssSetOffsetTime(S, 0, 0.0);
+    else
+        ssSetOffsetTime(S, 0, FIXED_IN_MINOR_STEP_OFFSET);
+}
+
+
+#define MDL_START
+#if defined(MDL_START)
+  /* Function: mdlStart =======================================================
+   * Abstract:
+   *    Creates the monitor (the formula needs no parsing).
+   */
+  static void mdlStart(SimStruct *S)
+  {
+	  FormulaMonitor *&formulaPtr = getFormulaPtr(S);
+	  vector<boolean_T> *&vectorPtr = getVectorPtr(S);
+	  AsyncMonitorType *&asyncPtr = getAsyncPtr(S);
+
+	  formulaPtr = NULL;
+	  vectorPtr = NULL;
+	  asyncPtr = NULL;
+
+	  if (getBooleanOption(S, MTS_EARLY_VERDICT))
+		  mexErrMsgTxt("Early verdicts are not supported by the monitors generated ahead of time.");
+
+	  try{
+		  formulaPtr = new FormulaMonitor();
+		  analyzeMonitorResources(S, formulaPtr);
+
+		  if (getBooleanOption(S, MTS_ASYNC))
+		  {
+			  const double size = getRealOption(S, MTS_QUEUE_SIZE, defaultQueueSize);
+			  if (size < 1)
+				  throw std::invalid_argument("The queue size of an asynchronous monitor must be at least 1.");
+			  asyncPtr = new AsyncMonitorType(*formulaPtr, static_cast<size_t>(size), ssGetInputPortWidth(S,0),
+					  getBooleanOption(S, MTS_DROP_WHEN_FULL) ? AsyncMonitorType::DROP : AsyncMonitorType::BLOCK);
+		  }
+	  }
+	  catch(exception &e)
+	  {
+		  mexErrMsgTxt(e.what());
+	  }
+	  vectorPtr = new vector<boolean_T>(ssGetInputPortWidth(S,0));
+  }
+#endif
+
+
+/* Function: mdlOutputs =======================================================
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+	 FormulaMonitor *&formulaPtr = getFormulaPtr(S);	/* get formula pointer*/
+	 vector<boolean_T> *&vectorPtr = getVectorPtr(S);	/* get predicate vector pointer*/
+
+	 InputPtrsType inputs = getInputPortSig(S);	/* input values*/
+
+	 /* Updating the vector -------------------------------------------------------*/
+	 vector<boolean_T>::iterator it = vectorPtr->begin(),end = vectorPtr->end();
+	 for(int_T i=0; i<getInputPortWidth(S); i++, it++)
+	 {
+		 mxAssert(it != end,"Error in mdlOutputs: Input width different than vector size");
+		 *it = *(static_cast<const boolean_T* const>(inputs[i]));
+	 }
+
+	 /* Updating the formula validator---------------------------------------------*/
+	 try{
+		 /* the asynchronous monitor queues the sample for the worker thread (see monitor_sfun.cpp)*/
+		 AsyncMonitorType *asyncPtr = getAsyncPtr(S);
+		 if(asyncPtr != NULL)
+		 {
+			 if(!ssIsMinorTimeStep(S))
+				 asyncPtr->step(TimePolicy::fromSeconds(ssGetT(S)), *vectorPtr);
+			 getOutputPortSig(S) = !(asyncPtr->checkSafety());
+			 return;
+		 }
+
+		 /* the extension of the last minor time step is undone: only the major time steps are definitive, the trial instants of the
+		  * solver (which can be rejected, and followed by a smaller instant) are tentative*/
+		 if(formulaPtr->isSpeculating())
+			 formulaPtr->rollback();
+		 if(ssIsMinorTimeStep(S))
+			 formulaPtr->speculate();
+
+		 if(formulaPtr->isStarted())
+			 formulaPtr->extendTrace(TimePolicy::fromSeconds(ssGetT(S)), *vectorPtr);
+		 else
+			 formulaPtr->initialConditions(TimePolicy::fromSeconds(ssGetT(S)),*vectorPtr);
+
+		 /* Updating the output---------------------------------------------*/
+		 boolean_T &y  = getOutputPortSig(S);
+		 y = !(formulaPtr->checkSafety());
+	 }
+	 catch(exception &e)
+	 {
+		 mexErrMsgTxt(e.what());
+	 }
+}
+
+#define MDL_SIM_STATE
+#if defined(MDL_SIM_STATE)
+  /* Function: mdlGetSimState =================================================
+   * Abstract:
+   *    Returns the state of the monitor as a uint8 row vector (see StaticMonitor::saveState), so that
+   *    the simulation can be resumed (or branched into many simulations) from the saved operating point.
+   */
+  static mxArray* mdlGetSimState(SimStruct *S)
+  {
+	  FormulaMonitor *formulaPtr = getFormulaPtr(S);
+	  AsyncMonitorType *asyncPtr = getAsyncPtr(S);
+	  mxArray *simstate = NULL;
+
+	  try{
+		  /* the operating point is the last major time step*/
+		  if (formulaPtr->isSpeculating())
+			  formulaPtr->rollback();
+
+		  vector<unsigned char> state = asyncPtr != NULL ? asyncPtr->saveState() : formulaPtr->saveState();
+		  simstate = mxCreateNumericMatrix(1, state.size(), mxUINT8_CLASS, mxREAL);
+		  std::copy(state.begin(), state.end(), static_cast<unsigned char*>(mxGetData(simstate)));
+	  }
+	  catch(exception &e)
+	  {
+		  mexErrMsgTxt(e.what());
+	  }
+	  return simstate;
+  }
+
+  /* Function: mdlSetSimState =================================================
+   * Abstract:
+   *    Restores the state of the monitor returned by mdlGetSimState (called after mdlStart).
+   */
+  static void mdlSetSimState(SimStruct *S, const mxArray *simstate)
+  {
+	  FormulaMonitor *formulaPtr = getFormulaPtr(S);
+	  AsyncMonitorType *asyncPtr = getAsyncPtr(S);
+
+	  if (!mxIsUint8(simstate))
+		  mexErrMsgTxt("The simulation state of a monitor must be a uint8 array.");
+
+	  try{
+		  const unsigned char *data = static_cast<const unsigned char*>(mxGetData(simstate));
+		  if (asyncPtr != NULL)
+			  asyncPtr->restoreState(data, mxGetNumberOfElements(simstate));
+		  else
+			  formulaPtr->restoreState(data, mxGetNumberOfElements(simstate));
+	  }
+	  catch(exception &e)
+	  {
+		  mexErrMsgTxt(e.what());
+	  }
+  }
+#endif
+
+
+/* Function: mdlTerminate =====================================================
+ */
+static void mdlTerminate(SimStruct *S)
+{
+	 FormulaMonitor *&formulaPtr = getFormulaPtr(S);
+	 vector<boolean_T> *&vectorPtr = getVectorPtr(S);
+	 AsyncMonitorType *&asyncPtr = getAsyncPtr(S);
+
+	if (asyncPtr != NULL)
+	{
+		static std::string warning; /* ssWarning needs persistent memory*/
+		try{
+			asyncPtr->stop();
+		}
+		catch(exception &e)
+		{
+			warning = std::string("Asynchronous monitor stopped by an error: ") + e.what();
+			ssWarning(S, warning.c_str());
+		}
+#if defined(SS_STDIO_AVAILABLE)
+		AsyncStats queue = asyncPtr->statistics();
+		ssPrintf("Queue of the monitor %s: %lu samples, %lu dropped, %lu waits, depth at most %lu of %lu\n", ssGetPath(S),
+				queue.pushed, queue.dropped, queue.waits, (unsigned long)queue.maxdepth, (unsigned long)queue.capacity);
+#endif
+		delete asyncPtr;
+		asyncPtr = NULL;
+	}
+
+	if (formulaPtr != NULL)
+	{
+		delete formulaPtr;
+		formulaPtr = NULL;
+	}
+
+	if (vectorPtr != NULL)
+	{
+		delete vectorPtr;
+		vectorPtr = NULL;
+	}
+}
+
+
+/*=============================*
+ * Required S-function trailer *
+ *=============================*/
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
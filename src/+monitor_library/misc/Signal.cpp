@@ -1,7 +1,7 @@
 
+#include <algorithm>
 #include <stdexcept>
 #include <iostream>
-#include <deque>
 
 #include "misc.h"
 
@@ -16,7 +16,7 @@ using std::invalid_argument;
 
 The created Signal has as domain the set *[first,last)* and is constantly equal to zero.
  */
-Signal::Signal(RealType first, RealType last)
+Signal::Signal(TimeType first, TimeType last): journal(NULL)
 {
 	if (first > last)
 			throw invalid_argument("Signal: The value of the first input must be less than or equal to the value of the second input.");
@@ -25,6 +25,31 @@ Signal::Signal(RealType first, RealType last)
 	this->first = first;
 }
 
+/**
+\brief Create a copy of a signal (the checkpoint of *other*, if any, is not copied).
+ */
+Signal::Signal(const Signal &other): first(other.first), last(other.last), intervals(other.intervals), journal(NULL) {}
+
+/**
+\brief Copy the domain and the intervals of a signal (the checkpoint of *other*, if any, is not copied).
+ */
+Signal& Signal::operator=(const Signal &other)
+{
+	if (this == &other)
+		return *this;
+
+	removeAll();
+	first = other.first;
+	last = other.last;
+	intervals = other.intervals;
+	return *this;
+}
+
+Signal::~Signal(void)
+{
+	delete journal;
+}
+
 
 /**
 \brief increase the right limit of the the caller signal's domain.
@@ -35,7 +60,7 @@ Let *first* and *last* be the left limit and the right limit of *this*'domain be
  - The domain of the *this* is the set *[first,newlast)*.
  - The values in the set *(last,newlast)* are all mapped to zero.
  */
-void Signal::increaseLast(RealType newlast)
+void Signal::increaseLast(TimeType newlast)
 {
 	if (newlast < last)
 			throw invalid_argument("increaseLast: The value in input must be greater than or equal to the last value of the domain of the caller signal.");
@@ -54,7 +79,7 @@ Let *first* and *last* be the left limit and the right limit of *this*'domain be
 - if \f$ newfirst \le last\f$ then the domain of the caller signal is the set *[newfirst,last)*.
 - if \f$ newfirst > last\f$ then the domain of the caller signal is the set *[newfirst, newfirst)*.
  */
-void Signal::increaseFirst(RealType newfirst)
+void Signal::increaseFirst(TimeType newfirst)
 {
 	if (newfirst < first)
 			throw invalid_argument("increaseFirst: The value of the input must be greater than or equal to the first value in the domain of the caller signal.");
@@ -62,7 +87,7 @@ void Signal::increaseFirst(RealType newfirst)
 	if(newfirst >= last){
 		first = newfirst;
 		last = first;
-		intervals.clear();
+		removeAll();
 	}
 	else if (intervals.empty())
 	{
@@ -77,13 +102,13 @@ void Signal::increaseFirst(RealType newfirst)
 			Interval &h = intervals.front();
 
 			// left is the left limit of h
-			RealType left = h.leftLimit;
+			TimeType left = h.leftLimit;
 
 			// right is the right limit of h
-			RealType right = h.rightLimit;
+			TimeType right = h.rightLimit;
 
 			// removing h form the intervals set
-			intervals.pop_front();
+			popFront();
 
 			// re-adding h (eventually cut) to the set and terminating loop
 			if (right > first)
@@ -92,6 +117,10 @@ void Signal::increaseFirst(RealType newfirst)
 					left = first;
 
 				intervals.push_front(Interval(left,right));
+
+				// the re-added interval is a copy (if h was a checkpoint interval, popFront has recorded it)
+				if (isJournaling())
+					journal->cutfront = true;
 				break;
 			}
 		}
@@ -99,6 +128,31 @@ void Signal::increaseFirst(RealType newfirst)
 }
 
 
+/**
+\brief return the iterator to the first interval in the preimage of *{1}* that ends after a given instant.
+\param t instant from which the intervals are needed.
+\returns the iterator to the first interval *[a,b)* with \f$ b > t \f$ (or getEnd() if such an interval does not exist).
+
+The search is logarithmic in the number of intervals, so it can be used to read a signal starting from an instant
+without iterating over all the intervals before it.
+ */
+Signal::const_iterator Signal::getIntervalFrom(const TimeType t) const
+{
+	const_iterator low = intervals.begin(), high = intervals.end();
+
+	while (low != high)
+	{
+		const_iterator mid = low + (high - low)/2;
+
+		if (mid->rightLimit > t)
+			high = mid;
+		else
+			low = mid + 1;
+	}
+	return low;
+}
+
+
 /**
 \brief add an interval to the preimage of *{1}* in the caller signal.
 \param a left limit of the interval to add
@@ -114,7 +168,7 @@ After method execution holds that:
 - All the elements in *[a,b)* are now mapped to 1
 - All the elements in the domain of the signal minus *[a,b)* are mapped to the value that they had before the execution of the method.
  */
-void Signal::addInterval(const RealType a, const RealType b)
+void Signal::addInterval(const TimeType a, const TimeType b)
 {
 	// input interval (which now is not empty) is not within the given boundaries
 	if (a < first || b > last)
@@ -153,13 +207,116 @@ After the method execution holds:
 - The domain of the calling signal is *[first,last)*
 - The calling signal constantly maps each element in the domain to 0.
  */
-void Signal::reset(RealType first,RealType last){
+void Signal::reset(TimeType first,TimeType last){
 	if (first > last)
 				throw invalid_argument("reset: The value of the first input must be less than or equal to the value of the second input.");
 
 		this->last = last;
 		this->first = first;
-		this->intervals.clear();
+		removeAll();
+}
+
+
+/**
+\brief start recording the changes of the signal.
+
+After the method execution, rollback restores the signal as it is now. The changes are recorded only for the intervals that they
+remove or shorten, hence the cost of the methods of the signal grows by a constant factor, and the cost of rollback is proportional
+to the number of intervals added or removed after the checkpoint. The storage of the record is reused by the next checkpoints.
+ */
+void Signal::checkpoint(void)
+{
+	if (journal == NULL)
+		journal = new SignalJournal();
+
+	journal->active = true;
+	journal->first = first;
+	journal->last = last;
+	journal->backright = intervals.empty() ? last : intervals.back().rightLimit;
+	journal->kept = intervals.size();
+	journal->cutfront = false;
+	journal->removed.clear();
+}
+
+
+/**
+\brief stop recording the changes of the signal: the changes after the last checkpoint are kept.
+ */
+void Signal::commit(void)
+{
+	if (journal == NULL)
+		return;
+
+	journal->active = false;
+	journal->removed.clear();
+}
+
+
+/**
+\brief restore the domain and the intervals of the signal at the last checkpoint, and stop recording the changes.
+\exception std::logic_error if the signal is not recording its changes (checkpoint was not invoked after the last commit or rollback).
+ */
+void Signal::rollback(void)
+{
+	if (!isJournaling())
+		throw std::logic_error("rollback: The signal has no checkpoint.");
+
+	// dropping the intervals added after the checkpoint and the cut copy of a checkpoint interval
+	IntervalQueue::size_type added = intervals.size() - journal->kept - (journal->cutfront ? 1 : 0);
+	for (; added > 0; added--)
+		intervals.pop_back();
+	if (journal->cutfront)
+		intervals.pop_front();
+
+	// re-adding the removed checkpoint intervals, from the last removed one
+	for (IntervalQueue::const_iterator it = journal->removed.end(); it != journal->removed.begin();)
+		intervals.push_front(*--it);
+
+	if (!intervals.empty())
+		intervals.back().rightLimit = journal->backright;
+
+	first = journal->first;
+	last = journal->last;
+	commit();
+}
+
+
+/*
+PRE-CONDITIONS:
+	the signal must have at least one interval.
+
+POST-CONDITIONS:
+	the front interval is removed, if it is a checkpoint interval and the signal is recording its changes, then it is moved to the
+	journal.
+ */
+void Signal::popFront(void)
+{
+	if (isJournaling())
+	{
+		if (journal->cutfront)
+			journal->cutfront = false;
+		else if (journal->kept > 0)
+		{
+			journal->removed.push_back(intervals.front());
+			journal->kept--;
+		}
+	}
+	intervals.pop_front();
+}
+
+
+/*
+POST-CONDITIONS:
+	every interval is removed, the checkpoint intervals are moved to the journal if the signal is recording its changes (the
+	intervals added after the checkpoint are just dropped).
+ */
+void Signal::removeAll(void)
+{
+	if (isJournaling())
+		while (journal->cutfront || journal->kept > 0)
+			popFront();
+
+	intervals.clear();
 }
 
 
@@ -199,3 +356,224 @@ void Signal::append(const Signal &appendvalues)
 
 
 
+
+
+
+// Signal operations-------------------------------------------------------------------------------------------
+
+/**
+\brief Compute the complement of a signal.
+\param signal signal to complement.
+\param complement signal that will contain the result.
+
+After the method execution *complement* has the same domain of *signal* and maps to *1* exactly the elements that *signal* maps to *0*.
+ */
+void computeComplement(const Signal &signal, Signal &complement)
+{
+	TimeType first = signal.getFirst();
+	TimeType last = signal.getLast();
+
+	complement.reset(first,last);
+
+	Signal::const_iterator it = signal.getBegin(), end = signal.getEnd();
+
+	// right limit of the last interval visited (initially the first element in the signal domain)
+	TimeType it_right = first;
+
+	while(it != end){
+		complement.addInterval(it_right,it->leftLimit);
+		it_right = it->rightLimit;
+		it++;
+	}
+	complement.addInterval(it_right,last);
+}
+
+
+/**
+\brief Concatenate the complement of a signal to a signal.
+\param values signal that is extended.
+\param appendvalues signal whose complement is appended, its domain should begin where the domain of *values* ends.
+\param tolerance length of the longest gap between two intervals of the result that is filled (zero to keep every gap).
+\exception std::invalid_argument if the domain of *appendvalues* begins before the domain of *values* or ends before it (as for
+Signal::append).
+
+After the method execution the domain of *values* ends where the one of *appendvalues* ends, and *values* maps to *1* also the
+elements of the domain of *appendvalues* that *appendvalues* maps to *0*, except that the gaps not longer than *tolerance* are
+filled (as done by appendCoalescing). It is the same as computeComplement followed by Signal::append, without storing the
+complement (see ValidatorNode::isNegated). The domains of two signals computed with different roundings (e.g. through windows
+with the same length) can overlap or leave a gap: the values of *values* are kept in the overlap, and the gap maps to *0*.
+ */
+void appendComplement(Signal &values, const Signal &appendvalues, TimeType tolerance)
+{
+	if (appendvalues.getFirst() < values.getFirst() || appendvalues.getLast() < values.getLast())
+		throw invalid_argument("appendComplement: The domain of the input signal must not begin or end before the domain of the caller signal.");
+
+	TimeType from = values.getLast();
+	values.increaseLast(appendvalues.getLast());
+
+	// right limit of the last interval visited (initially the first element in the appended domain)
+	TimeType it_right = appendvalues.getFirst();
+	Signal::const_iterator it = appendvalues.getBegin(), end = appendvalues.getEnd();
+
+	while (true)
+	{
+		TimeType left = std::max(it_right, from);
+		TimeType right = (it != end) ? it->leftLimit : appendvalues.getLast();
+
+		if (left < right)
+		{
+			// the gap [lastright,left) is short enough to be filled
+			if (values.getIntervalCount() > 0 && left - (values.getEnd() - 1)->rightLimit <= tolerance)
+				left = (values.getEnd() - 1)->rightLimit;
+			values.addInterval(left,right);
+		}
+
+		if (it == end)
+			return;
+		it_right = it->rightLimit;
+		it++;
+	}
+}
+
+
+/**
+\brief Compute the union between two signals.
+\param signal1 first operand.
+\param signal2 second operand.
+\param computedvalues signal that will contain the result.
+
+Let *[a,b)* and *[c,d)* be the domains of *signal1* and *signal2*, then after the method execution *computedvalues* has domain
+*[min(a,c),min(b,d))* and maps to *1* the elements that are mapped to *1* by at least one of the two signals.
+ */
+void computeUnion(const Signal &signal1,const Signal &signal2,Signal &computedvalues)
+{
+	Signal::const_iterator it1 = signal1.getBegin(), end1 = signal1.getEnd();
+	Signal::const_iterator it2= signal2.getBegin(), end2 = signal2.getEnd();
+
+	TimeType first = std::min(signal1.getFirst(), signal2.getFirst());
+	TimeType last = std::min(signal1.getLast(), signal2.getLast());
+	computedvalues.reset(first, last);
+
+	while(it1 != end1 || it2 != end2){
+		Interval add = (it1 != end1) ? *it1 : *it2;
+
+		// intervals are added by increasing left limit (as requested by addInterval)
+		if(it2 == end2 || (it1 != end1 && it1->leftLimit <= it2->leftLimit))
+			it1++;
+		else{
+			add = *it2;
+			it2++;
+		}
+
+		if (add.leftLimit >= last)
+			return;
+
+		if (add.rightLimit > last)
+			add.rightLimit = last;
+
+		computedvalues.addInterval(add.leftLimit,add.rightLimit);
+	}
+}
+
+
+/**
+\brief Compute the intersection between two signals.
+\param signal1 first operand.
+\param signal2 second operand.
+\param computedvalues signal that will contain the result.
+
+Let *[a,b)* and *[c,d)* be the domains of *signal1* and *signal2*, then after the method execution *computedvalues* has domain
+*[max(a,c),min(b,d))* (or an empty domain if such set is empty) and maps to *1* the elements that are mapped to *1* by both the signals.
+ */
+void computeIntersection(const Signal &signal1,const Signal &signal2,Signal &computedvalues)
+{
+	Signal::const_iterator it1 = signal1.getBegin(), end1 = signal1.getEnd();
+	Signal::const_iterator it2= signal2.getBegin(), end2 = signal2.getEnd();
+
+	TimeType first = std::max(signal1.getFirst(), signal2.getFirst());
+	TimeType last = std::max(first, std::min(signal1.getLast(), signal2.getLast()));
+	computedvalues.reset(first, last);
+
+	while(it1 != end1 && it2 != end2){
+		TimeType left = std::max(std::max(it1->leftLimit, it2->leftLimit), first);
+		TimeType right = std::min(std::min(it1->rightLimit, it2->rightLimit), last);
+
+		if (left < right)
+			computedvalues.addInterval(left,right);
+
+		// the interval that ends first can not intersect any other interval
+		if (it1->rightLimit <= it2->rightLimit)
+			it1++;
+		else
+			it2++;
+	}
+}
+
+
+/**
+\brief Compute the difference between two signals.
+\param signal1 first operand.
+\param signal2 second operand.
+\param computedvalues signal that will contain the result.
+
+Let *[a,b)* and *[c,d)* be the domains of *signal1* and *signal2*, then after the method execution *computedvalues* has domain
+*[max(a,c),min(b,d))* (or an empty domain if such set is empty) and maps to *1* the elements that are mapped to *1* by *signal1* and
+to *0* by *signal2* (i.e. the intersection between *signal1* and the complement of *signal2*, without computing the complement).
+ */
+void computeDifference(const Signal &signal1,const Signal &signal2,Signal &computedvalues)
+{
+	Signal::const_iterator it1 = signal1.getBegin(), end1 = signal1.getEnd();
+	Signal::const_iterator it2= signal2.getBegin(), end2 = signal2.getEnd();
+
+	TimeType first = std::max(signal1.getFirst(), signal2.getFirst());
+	TimeType last = std::max(first, std::min(signal1.getLast(), signal2.getLast()));
+	computedvalues.reset(first, last);
+
+	for (; it1 != end1; it1++)
+	{
+		TimeType left = std::max(it1->leftLimit, first);
+		TimeType right = std::min(it1->rightLimit, last);
+
+		// removing the intervals of signal2 from [left,right) (the ones that end before left can not intersect the next intervals)
+		while (left < right && it2 != end2 && it2->leftLimit < right)
+		{
+			if (it2->rightLimit <= left)
+			{
+				it2++;
+				continue;
+			}
+
+			if (left < it2->leftLimit)
+				computedvalues.addInterval(left,it2->leftLimit);
+			left = it2->rightLimit;
+
+			if (it2->rightLimit <= right)
+				it2++;
+		}
+
+		if (left < right)
+			computedvalues.addInterval(left,right);
+	}
+}
+
+
+/**
+\brief Compute the instants where the values of a node are known, given its buffered values and its partial evaluation.
+\param buffer values of the node already computed (but not yet used by the caller).
+\param partialtrue instants after the domain of *buffer* where the node is known to be true.
+\param partialfalse instants after the domain of *buffer* where the node is known to be false.
+\param knowntrue signal that will contain the instants where the node is known to be true.
+\param knownfalse signal that will contain the instants where the node is known to be false.
+
+The domain of *partialtrue* and *partialfalse* must begin where the domain of *buffer* ends. After the method execution the domain of
+*knowntrue* and *knownfalse* is the union between the domains of the inputs, *knowntrue* is *buffer* followed by *partialtrue*
+and *knownfalse* is the complement of *buffer* followed by *partialfalse*.
+ */
+void computeKnownValues(const Signal &buffer, const Signal &partialtrue, const Signal &partialfalse, Signal &knowntrue, Signal &knownfalse)
+{
+	knowntrue = buffer;
+	knowntrue.append(partialtrue);
+
+	computeComplement(buffer, knownfalse);
+	knownfalse.append(partialfalse);
+}
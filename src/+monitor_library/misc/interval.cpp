@@ -15,7 +15,7 @@ using std::min;using std::max; using std::invalid_argument;
 \param b right limit of the interval to create.
 \exception std::invalid_argument if a is greater than or equal to b
  */
-Interval::Interval(const RealType a, const RealType b ):leftLimit(a),rightLimit(b)
+Interval::Interval(const TimeType a, const TimeType b ):leftLimit(a),rightLimit(b)
 {
 	if(a >= b)
 		throw std::invalid_argument("Interval: The first input must be less than the second input.");
@@ -51,7 +51,7 @@ bool isMergeable(const Interval &h1, const Interval &h2)
 \param v real value
 \returns true if *v* is contained in *h*, otherwise false.
  */
-inline bool contains(const Interval &h, RealType v){return h.leftLimit <= v  && v < h.rightLimit;}
+inline bool contains(const Interval &h, TimeType v){return h.leftLimit <= v  && v < h.rightLimit;}
 
 
 
@@ -69,3 +69,87 @@ Interval merge(const Interval &h1, const Interval &h2)
 
 	return Interval(min(h1.leftLimit,h2.leftLimit ), max(h1.rightLimit,h2.rightLimit));
 }
+
+
+
+// IntervalQueue methods------------------------------------------------------------------------------------
+
+#ifdef MTS_INSTRUMENTATION
+unsigned long IntervalQueue::allocations = 0;
+#endif
+
+/**
+\brief Create an empty queue (no memory is allocated until the first insertion).
+ */
+IntervalQueue::IntervalQueue(void): data(NULL), capacity(0), head(0), count(0) {}
+
+/**
+\brief Create a copy of a queue.
+\param other queue to copy.
+ */
+IntervalQueue::IntervalQueue(const IntervalQueue &other): data(NULL), capacity(0), head(0), count(0)
+{
+	*this = other;
+}
+
+/**
+\brief Copy the intervals of a queue (the storage of the caller is reused if it is large enough).
+\param other queue to copy.
+ */
+IntervalQueue& IntervalQueue::operator=(const IntervalQueue &other)
+{
+	if (this == &other)
+		return *this;
+
+	clear();
+	if (capacity < other.count)
+		grow(other.count);
+
+	for (size_type i = 0; i < other.count; i++)
+		new (&data[i]) Interval(other.at(i));
+	count = other.count;
+
+	return *this;
+}
+
+IntervalQueue::~IntervalQueue(void)
+{
+	::operator delete(data);
+}
+
+/**
+\brief Allocate the storage for a given number of intervals.
+\param n number of intervals that the queue can hold without allocating memory.
+ */
+void IntervalQueue::reserve(size_type n)
+{
+	if (n > capacity)
+		grow(n);
+}
+
+/*
+PRE-CONDITIONS:
+	n must be greater than capacity.
+
+POST-CONDITIONS:
+	capacity is the smallest power of two not less than n (and than twice the old capacity), the intervals are moved at the
+	beginning of the new array.
+ */
+void IntervalQueue::grow(size_type n)
+{
+	size_type newcapacity = capacity == 0 ? 4 : 2*capacity;
+	while (newcapacity < n)
+		newcapacity *= 2;
+
+	Interval *newdata = static_cast<Interval*>(::operator new(newcapacity * sizeof(Interval)));
+#ifdef MTS_INSTRUMENTATION
+	allocations++;
+#endif
+	for (size_type i = 0; i < count; i++)
+		new (&newdata[i]) Interval(at(i));
+
+	::operator delete(data);
+	data = newdata;
+	capacity = newcapacity;
+	head = 0;
+}
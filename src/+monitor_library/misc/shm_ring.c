@@ -0,0 +1,265 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "shm_ring.h"
+
+#define MTS_RING_MAGIC 		"MTSR"
+#define MTS_RING_VERSION 	1
+#define MTS_RING_HEADER 	192 	/* bytes of the header, the slots follow*/
+
+/* header of the shared memory (see shm_ring.h): tail and head are on their own cache line, written by one side each*/
+struct mts_ring_header
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t predicates;
+	uint32_t stride; 	/* bytes of a slot*/
+	uint64_t slots; 	/* number of slots (a power of two)*/
+	uint32_t finished; 	/* MTS_RING_RUNNING, MTS_RING_FINISHED or MTS_RING_REPLACED*/
+	char pad1[64 - 28];
+	uint64_t tail; 		/* number of samples written (by the producer)*/
+	char pad2[64 - 8];
+	uint64_t head; 		/* number of samples released (by the consumer)*/
+	char pad3[64 - 8];
+};
+
+/* handle of a process on the ring*/
+struct mts_ring
+{
+	struct mts_ring_header *header;
+	unsigned char *slots;
+	size_t size; 		/* bytes mapped*/
+	uint64_t mask; 		/* slots - 1*/
+	uint64_t index; 	/* producer: tail written last, consumer: head released last (each side owns its index)*/
+	uint64_t limit; 	/* producer: head + slots read last, consumer: tail read last (refreshed only when exhausted)*/
+};
+
+typedef char mts_ring_header_size[sizeof(struct mts_ring_header) == MTS_RING_HEADER ? 1 : -1];
+
+static mts_ring* mapRing(int fd, size_t size)
+{
+	mts_ring *ring = (mts_ring*)malloc(sizeof(mts_ring));
+	void *memory;
+
+	if (ring == NULL)
+	{
+		close(fd);
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (memory == MAP_FAILED)
+	{
+		free(ring);
+		return NULL;
+	}
+
+	ring->header = (struct mts_ring_header*)memory;
+	ring->slots = (unsigned char*)memory + MTS_RING_HEADER;
+	ring->size = size;
+	return ring;
+}
+
+mts_ring* mts_ring_create(const char *name, unsigned predicates, unsigned slots)
+{
+	uint64_t count = 1;
+	uint32_t stride = (uint32_t)((sizeof(double) + (predicates + 7) / 8 + 7) / 8 * 8);
+	size_t size;
+	int fd;
+	mts_ring *ring;
+
+	if (slots == 0)
+	{
+		errno = EINVAL;
+		return NULL;
+	}
+	while (count < slots)
+		count *= 2;
+	size = MTS_RING_HEADER + (size_t)count * stride;
+
+	ring = mts_ring_open(name);
+	if (ring != NULL)
+	{
+		__atomic_store_n(&ring->header->finished, MTS_RING_REPLACED, __ATOMIC_RELEASE);
+		mts_ring_close(ring);
+	}
+	shm_unlink(name);
+	fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0)
+		return NULL;
+	if (ftruncate(fd, (off_t)size) != 0)
+	{
+		int error = errno;
+		close(fd);
+		shm_unlink(name);
+		errno = error;
+		return NULL;
+	}
+
+	ring = mapRing(fd, size);
+	if (ring == NULL)
+		return NULL;
+
+	/* the object is zero-filled by ftruncate: the magic is written last, so a consumer never opens a ring half initialized*/
+	ring->header->version = MTS_RING_VERSION;
+	ring->header->predicates = predicates;
+	ring->header->stride = stride;
+	ring->header->slots = count;
+	ring->mask = count - 1;
+	ring->index = 0;
+	ring->limit = count;
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(ring->header->magic, MTS_RING_MAGIC, 4);
+	return ring;
+}
+
+mts_ring* mts_ring_open(const char *name)
+{
+	struct stat info;
+	struct mts_ring_header *header;
+	mts_ring *ring;
+	int fd = shm_open(name, O_RDWR, 0);
+
+	if (fd < 0)
+		return NULL;
+	if (fstat(fd, &info) != 0 || (size_t)info.st_size < MTS_RING_HEADER)
+	{
+		close(fd);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	ring = mapRing(fd, (size_t)info.st_size);
+	if (ring == NULL)
+		return NULL;
+
+	header = ring->header;
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	if (memcmp(header->magic, MTS_RING_MAGIC, 4) != 0 || header->version != MTS_RING_VERSION || header->slots == 0 ||
+			(header->slots & (header->slots - 1)) != 0 ||
+			ring->size != MTS_RING_HEADER + (size_t)header->slots * header->stride)
+	{
+		mts_ring_close(ring);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	ring->mask = header->slots - 1;
+	ring->index = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+	ring->limit = ring->index;
+	return ring;
+}
+
+/*
+ PRE-CONDITIONS:
+ 	 Invoked by the producer.
+
+ POST-CONDITIONS:
+ 	 Returns the slot of the next sample, or NULL if the ring is full. The head of the consumer is read only when the slots known
+ 	 to be free are exhausted.
+ */
+static unsigned char* nextSlot(mts_ring *ring)
+{
+	if (ring->index == ring->limit)
+	{
+		ring->limit = __atomic_load_n(&ring->header->head, __ATOMIC_ACQUIRE) + ring->mask + 1;
+		if (ring->index == ring->limit)
+			return NULL;
+	}
+	return ring->slots + (size_t)(ring->index & ring->mask) * ring->header->stride;
+}
+
+static void publish(mts_ring *ring)
+{
+	ring->index++;
+	__atomic_store_n(&ring->header->tail, ring->index, __ATOMIC_RELEASE);
+}
+
+int mts_ring_push(mts_ring *ring, double t, const unsigned char *preds)
+{
+	unsigned char *slot = nextSlot(ring), *mask;
+	unsigned i, predicates = ring->header->predicates;
+
+	if (slot == NULL)
+		return MTS_RING_FULL;
+
+	memcpy(slot, &t, sizeof(double));
+	mask = slot + sizeof(double);
+	memset(mask, 0, (predicates + 7) / 8);
+	for (i = 0; i < predicates; i++)
+		if (preds[i])
+			mask[i / 8] |= (unsigned char)(1 << (i % 8));
+
+	publish(ring);
+	return MTS_RING_OK;
+}
+
+int mts_ring_push_mask(mts_ring *ring, double t, const unsigned char *mask)
+{
+	unsigned char *slot = nextSlot(ring);
+
+	if (slot == NULL)
+		return MTS_RING_FULL;
+
+	memcpy(slot, &t, sizeof(double));
+	memcpy(slot + sizeof(double), mask, (ring->header->predicates + 7) / 8);
+
+	publish(ring);
+	return MTS_RING_OK;
+}
+
+void mts_ring_finish(mts_ring *ring)
+{
+	__atomic_store_n(&ring->header->finished, MTS_RING_FINISHED, __ATOMIC_RELEASE);
+}
+
+size_t mts_ring_available(mts_ring *ring)
+{
+	if (ring->index == ring->limit)
+		ring->limit = __atomic_load_n(&ring->header->tail, __ATOMIC_ACQUIRE);
+	return (size_t)(ring->limit - ring->index);
+}
+
+const unsigned char* mts_ring_slot(const mts_ring *ring, size_t i)
+{
+	return ring->slots + (size_t)((ring->index + i) & ring->mask) * ring->header->stride;
+}
+
+void mts_ring_release(mts_ring *ring, size_t count)
+{
+	ring->index += count;
+	__atomic_store_n(&ring->header->head, ring->index, __ATOMIC_RELEASE);
+}
+
+int mts_ring_finished(mts_ring *ring)
+{
+	return (int)__atomic_load_n(&ring->header->finished, __ATOMIC_ACQUIRE);
+}
+
+unsigned mts_ring_predicates(const mts_ring *ring)
+{
+	return ring->header->predicates;
+}
+
+void mts_ring_close(mts_ring *ring)
+{
+	if (ring == NULL)
+		return;
+	munmap(ring->header, ring->size);
+	free(ring);
+}
+
+int mts_ring_unlink(const char *name)
+{
+	return shm_unlink(name);
+}
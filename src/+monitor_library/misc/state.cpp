@@ -0,0 +1,165 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "state.h"
+
+
+/**
+ \brief Create a writer appending to *out*, and write the header of the snapshot.
+ */
+StateWriter::StateWriter(std::vector<unsigned char> &out): bytes(out)
+{
+	writeBytes(MTS_STATE_MAGIC, 4);
+	bytes.push_back(MTS_STATE_VERSION);
+	bytes.push_back(static_cast<unsigned char>(sizeof(TimeType)));
+}
+
+void StateWriter::writeBytes(const void *data, size_t length)
+{
+	const unsigned char *begin = static_cast<const unsigned char*>(data);
+	bytes.insert(bytes.end(), begin, begin + length);
+}
+
+void StateWriter::writeTag(StateTag tag)
+{
+	bytes.push_back(static_cast<unsigned char>(tag));
+}
+
+void StateWriter::writeBool(bool value)
+{
+	bytes.push_back(value ? 1 : 0);
+}
+
+void StateWriter::writeSize(size_t value)
+{
+	UInt64Type size = value;
+	writeBytes(&size, sizeof(size));
+}
+
+void StateWriter::writeTime(TimeType value)
+{
+	writeBytes(&value, sizeof(value));
+}
+
+void StateWriter::writeTimes(const std::vector<TimeType> &values)
+{
+	writeSize(values.size());
+	for (std::vector<TimeType>::const_iterator it = values.begin(); it != values.end(); it++)
+		writeTime(*it);
+}
+
+void StateWriter::writeSignal(const Signal &signal)
+{
+	writeTime(signal.getFirst());
+	writeTime(signal.getLast());
+	writeSize(signal.getIntervalCount());
+	for (Signal::const_iterator it = signal.getBegin(); it != signal.getEnd(); it++)
+	{
+		writeTime(it->leftLimit);
+		writeTime(it->rightLimit);
+	}
+}
+
+
+/**
+ \brief Create a reader of the snapshot in [data, data+length), and check its header.
+ \exception std::invalid_argument if the snapshot has not a valid header, or it was written with a different time representation.
+ */
+StateReader::StateReader(const unsigned char *d, size_t l): data(d), length(l), pos(0)
+{
+	if (length < 6 || std::memcmp(data, MTS_STATE_MAGIC, 4) != 0)
+		throw std::invalid_argument("restoreState: The input is not a snapshot of a monitor.");
+
+	if (data[4] != MTS_STATE_VERSION)
+		throw std::invalid_argument("restoreState: Unsupported snapshot version.");
+
+	if (data[5] != sizeof(TimeType))
+		throw std::invalid_argument("restoreState: The snapshot was written with a different time representation.");
+
+	pos = 6;
+}
+
+void StateReader::readBytes(void *out, size_t count)
+{
+	if (count > length - pos)
+		throw std::invalid_argument("restoreState: The snapshot is truncated.");
+
+	std::memcpy(out, data + pos, count);
+	pos += count;
+}
+
+void StateReader::checkTag(StateTag tag)
+{
+	unsigned char value;
+	readBytes(&value, 1);
+	if (value != tag)
+		throw std::invalid_argument("restoreState: The snapshot does not match the formula of the monitor.");
+}
+
+void StateReader::checkSize(size_t expected)
+{
+	if (readSize() != expected)
+		throw std::invalid_argument("restoreState: The snapshot does not match the formula of the monitor.");
+}
+
+void StateReader::checkTime(TimeType expected)
+{
+	if (readTime() != expected)
+		throw std::invalid_argument("restoreState: The snapshot does not match the formula of the monitor.");
+}
+
+bool StateReader::readBool(void)
+{
+	unsigned char value;
+	readBytes(&value, 1);
+	return value != 0;
+}
+
+size_t StateReader::readSize(void)
+{
+	UInt64Type size;
+	readBytes(&size, sizeof(size));
+	return static_cast<size_t>(size);
+}
+
+TimeType StateReader::readTime(void)
+{
+	TimeType value;
+	readBytes(&value, sizeof(value));
+	return value;
+}
+
+void StateReader::readTimes(std::vector<TimeType> &values)
+{
+	checkSize(values.size());
+	for (std::vector<TimeType>::iterator it = values.begin(); it != values.end(); it++)
+		*it = readTime();
+}
+
+void StateReader::readSignal(Signal &signal)
+{
+	TimeType first = readTime();
+	TimeType last = readTime();
+	size_t count = readSize();
+
+	if (count > (length - pos) / (2 * sizeof(TimeType)))
+		throw std::invalid_argument("restoreState: The snapshot is truncated.");
+
+	signal.reset(first,last);
+	for (size_t i = 0; i < count; i++)
+	{
+		TimeType left = readTime();
+		TimeType right = readTime();
+		signal.addInterval(left,right);
+	}
+}
+
+/**
+ \brief Check that the whole snapshot was read.
+ \exception std::invalid_argument if the snapshot has bytes after the state of the monitor.
+ */
+void StateReader::finish(void) const
+{
+	if (pos != length)
+		throw std::invalid_argument("restoreState: The snapshot does not match the formula of the monitor.");
+}
@@ -0,0 +1,351 @@
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "trace_file.h"
+
+#define MTS_TRACE_MAGIC 		"MTST"
+#define MTS_TRACE_CHUNK_MAGIC 	"MTSC"
+#define MTS_TRACE_VERSION 		1
+#define MTS_TRACE_HEADER 		48 	/* bytes of the header of the file*/
+#define MTS_TRACE_CHUNK_HEADER 	32 	/* bytes of the header of a chunk*/
+#define MTS_TRACE_INDEX_ENTRY 	24 	/* bytes of an entry of the index*/
+
+/* the file stores the values in the byte order of the machine, which must be little-endian*/
+static bool littleEndian(void)
+{
+	const unsigned int one = 1;
+	return *reinterpret_cast<const unsigned char*>(&one) == 1;
+}
+
+static inline UInt64Type padding(UInt64Type bytes)
+{
+	return (8 - bytes % 8) % 8;
+}
+
+/* returns the bytes of the data of a chunk of *samples* samples (instants and columns)*/
+static UInt64Type chunkDataSize(const std::vector<TraceColumn> &columns, UInt64Type samples)
+{
+	UInt64Type bytes = samples * 8;
+	for (size_t c = 0; c < columns.size(); c++)
+		bytes += columns[c].type == MTS_TRACE_BOOLEAN ? (samples + 63) / 64 * 8 : samples * 8;
+	return bytes;
+}
+
+template <class T>
+static inline T readValue(const unsigned char *bytes)
+{
+	T value;
+	std::memcpy(&value, bytes, sizeof(T));
+	return value;
+}
+
+/* TraceWriter -----------------------------------------------------------------------------------------------------------------*/
+
+/**
+ \brief Create the file *path* (replacing an existing one) for a trace with the given columns, written in chunks of *chunkSamples*
+ samples (more when the samples of the last instant of a chunk do not fit).
+ \exception std::invalid_argument if a column has an unknown type or a name longer than 65535 bytes, or if chunkSamples is zero.
+ \exception std::runtime_error if the file cannot be written.
+ */
+TraceWriter::TraceWriter(const std::string &path, const std::vector<TraceColumn> &c, size_t n)
+:columns(c),chunkSamples(n),file(NULL),offset(0),samples(0),first(0),last(0),
+ time(),values(c.size()),chunkFirst(),chunkLast(),chunkOffset()
+{
+	if (!littleEndian())
+		throw std::runtime_error("TraceWriter: The trace files are supported only on little-endian machines.");
+	if (chunkSamples == 0 || chunkSamples > 0xFFFFFFFFu)
+		throw std::invalid_argument("TraceWriter: The samples of a chunk must be between 1 and 2^32-1.");
+	for (size_t i = 0; i < columns.size(); i++)
+		if ((columns[i].type != MTS_TRACE_BOOLEAN && columns[i].type != MTS_TRACE_REAL) || columns[i].name.size() > 0xFFFF)
+			throw std::invalid_argument("TraceWriter: Every column must be boolean or real, with a name of at most 65535 bytes.");
+
+	file = std::fopen(path.c_str(), "wb");
+	if (file == NULL)
+		throw std::runtime_error("TraceWriter: Unable to create " + path);
+
+	// the header is written again by close, with the index offset
+	writeHeader(0);
+	for (size_t i = 0; i < columns.size(); i++)
+	{
+		const unsigned char type[2] = {static_cast<unsigned char>(columns[i].type), 0};
+		const unsigned short length = static_cast<unsigned short>(columns[i].name.size());
+		write(type, 2);
+		write(&length, 2);
+		write(columns[i].name.data(), columns[i].name.size());
+	}
+	const UInt64Type zero = 0;
+	write(&zero, padding(offset));
+
+	time.reserve(chunkSamples);
+	for (size_t i = 0; i < columns.size(); i++)
+		values[i].reserve(chunkSamples);
+}
+
+TraceWriter::~TraceWriter(void)
+{
+	// a file not closed keeps a zero index offset, hence it is rejected by TraceFile
+	if (file != NULL)
+		std::fclose(file);
+}
+
+void TraceWriter::write(const void *data, size_t bytes)
+{
+	if (bytes > 0 && std::fwrite(data, 1, bytes, file) != bytes)
+		throw std::runtime_error("TraceWriter: Unable to write the trace file.");
+	offset += bytes;
+}
+
+void TraceWriter::writeHeader(UInt64Type indexOffset)
+{
+	unsigned char header[MTS_TRACE_HEADER];
+	const unsigned int version = MTS_TRACE_VERSION, count = static_cast<unsigned int>(columns.size());
+	const unsigned int chunks = static_cast<unsigned int>(chunkOffset.size());
+
+	std::memcpy(header, MTS_TRACE_MAGIC, 4);
+	std::memcpy(header + 4, &version, 4);
+	std::memcpy(header + 8, &count, 4);
+	std::memcpy(header + 12, &chunks, 4);
+	std::memcpy(header + 16, &samples, 8);
+	std::memcpy(header + 24, &indexOffset, 8);
+	std::memcpy(header + 32, &first, 8);
+	std::memcpy(header + 40, &last, 8);
+	write(header, MTS_TRACE_HEADER);
+}
+
+/*
+ POST-CONDITIONS:
+ 	 The samples of the current chunk are written and removed, the chunk is added to the index.
+ */
+void TraceWriter::writeChunk(void)
+{
+	const unsigned int n = static_cast<unsigned int>(time.size());
+	const UInt64Type bytes = MTS_TRACE_CHUNK_HEADER + chunkDataSize(columns, n);
+	unsigned char header[MTS_TRACE_CHUNK_HEADER];
+
+	chunkFirst.push_back(time.front());
+	chunkLast.push_back(time.back());
+	chunkOffset.push_back(offset);
+
+	std::memcpy(header, MTS_TRACE_CHUNK_MAGIC, 4);
+	std::memcpy(header + 4, &n, 4);
+	std::memcpy(header + 8, &time.front(), 8);
+	std::memcpy(header + 16, &time.back(), 8);
+	std::memcpy(header + 24, &bytes, 8);
+	write(header, MTS_TRACE_CHUNK_HEADER);
+	write(&time[0], n * sizeof(double));
+
+	std::vector<UInt64Type> words;
+	for (size_t c = 0; c < columns.size(); c++)
+	{
+		if (columns[c].type == MTS_TRACE_REAL)
+			write(&values[c][0], n * sizeof(double));
+		else
+		{
+			words.assign((n + 63) / 64, 0);
+			for (size_t i = 0; i < n; i++)
+				if (values[c][i] != 0)
+					words[i / 64] |= static_cast<UInt64Type>(1) << (i % 64);
+			write(&words[0], words.size() * sizeof(UInt64Type));
+		}
+		values[c].clear();
+	}
+	time.clear();
+}
+
+/**
+ \brief Append a sample: the instant *t* and the value of each column (a nonzero value is true for a boolean column).
+ \exception std::invalid_argument if *t* is less than the instant of the previous sample.
+ \exception std::logic_error if the writer was closed.
+ */
+void TraceWriter::append(double t, const double *row)
+{
+	if (file == NULL)
+		throw std::logic_error("TraceWriter: The trace file is closed.");
+	if (samples > 0 && !(t >= last))
+		throw std::invalid_argument("TraceWriter: The instants must be non decreasing.");
+
+	// a full chunk is written at the next instant, so that the samples of an instant are never split between two chunks
+	if (time.size() >= chunkSamples && t > last)
+		writeChunk();
+	if (time.size() == 0xFFFFFFFFu)
+		throw std::invalid_argument("TraceWriter: Too many samples with the same instant.");
+
+	if (samples == 0)
+		first = t;
+	last = t;
+	samples++;
+
+	time.push_back(t);
+	for (size_t c = 0; c < columns.size(); c++)
+		values[c].push_back(row[c]);
+}
+
+/**
+ \brief Write the last chunk and the index, and close the file (the destructor does not close the trace: a file not closed is
+ rejected by TraceFile).
+ */
+void TraceWriter::close(void)
+{
+	if (file == NULL)
+		return;
+	if (!time.empty())
+		writeChunk();
+
+	const UInt64Type indexOffset = offset;
+	for (size_t k = 0; k < chunkOffset.size(); k++)
+	{
+		write(&chunkFirst[k], 8);
+		write(&chunkLast[k], 8);
+		write(&chunkOffset[k], 8);
+	}
+
+	const bool positioned = std::fseek(file, 0, SEEK_SET) == 0;
+	if (positioned)
+		writeHeader(indexOffset);
+	const bool closed = std::fclose(file) == 0;
+	file = NULL;
+	if (!positioned || !closed)
+		throw std::runtime_error("TraceWriter: Unable to write the trace file.");
+}
+
+/* TraceFile -------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ \brief Open the trace file *path* through a read-only memory map.
+ \exception std::runtime_error if the file cannot be opened or mapped.
+ \exception std::invalid_argument if the file is not a complete trace file of this version.
+ */
+TraceFile::TraceFile(const std::string &path)
+:memory(NULL),size(0),columnList(),chunkList(),sampleCount(0),firstTime(0),lastTime(0)
+{
+	if (!littleEndian())
+		throw std::runtime_error("TraceFile: The trace files are supported only on little-endian machines.");
+
+	const int fd = open(path.c_str(), O_RDONLY);
+	struct stat info;
+	if (fd < 0)
+		throw std::runtime_error("TraceFile: Unable to open " + path);
+	if (fstat(fd, &info) != 0 || info.st_size < MTS_TRACE_HEADER)
+	{
+		::close(fd);
+		throw std::invalid_argument("TraceFile: The file is not a trace file: " + path);
+	}
+
+	size = static_cast<size_t>(info.st_size);
+	memory = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (memory == MAP_FAILED)
+	{
+		memory = NULL;
+		throw std::runtime_error("TraceFile: Unable to map " + path);
+	}
+
+	const unsigned char *bytes = static_cast<const unsigned char*>(memory);
+	try
+	{
+		const unsigned int columns = readValue<unsigned int>(bytes + 8), chunks = readValue<unsigned int>(bytes + 12);
+		const UInt64Type indexOffset = readValue<UInt64Type>(bytes + 24);
+
+		if (std::memcmp(bytes, MTS_TRACE_MAGIC, 4) != 0 || readValue<unsigned int>(bytes + 4) != MTS_TRACE_VERSION)
+			throw std::invalid_argument("TraceFile: The file is not a trace file of version 1: " + path);
+		if (indexOffset == 0)
+			throw std::invalid_argument("TraceFile: The trace file was not closed by its writer: " + path);
+		if (indexOffset % 8 != 0 || indexOffset > size || (size - indexOffset) / MTS_TRACE_INDEX_ENTRY < chunks)
+			throw std::invalid_argument("TraceFile: The index of the trace file is truncated: " + path);
+
+		sampleCount = readValue<UInt64Type>(bytes + 16);
+		firstTime = readValue<double>(bytes + 32);
+		lastTime = readValue<double>(bytes + 40);
+
+		size_t position = MTS_TRACE_HEADER;
+		for (unsigned int c = 0; c < columns; c++)
+		{
+			if (position + 4 > indexOffset)
+				throw std::invalid_argument("TraceFile: The columns of the trace file are truncated: " + path);
+			const unsigned short length = readValue<unsigned short>(bytes + position + 2);
+			if (position + 4 + length > indexOffset || bytes[position] > MTS_TRACE_REAL)
+				throw std::invalid_argument("TraceFile: The columns of the trace file are malformed: " + path);
+			columnList.push_back(TraceColumn(std::string(reinterpret_cast<const char*>(bytes + position + 4), length), bytes[position]));
+			position += 4 + length;
+		}
+
+		UInt64Type total = 0;
+		chunkList.resize(chunks);
+		for (unsigned int k = 0; k < chunks; k++)
+		{
+			const unsigned char *entry = bytes + indexOffset + k * MTS_TRACE_INDEX_ENTRY;
+			const UInt64Type chunkOffset = readValue<UInt64Type>(entry + 16);
+			if (chunkOffset % 8 != 0 || chunkOffset < position || chunkOffset + MTS_TRACE_CHUNK_HEADER > indexOffset)
+				throw std::invalid_argument("TraceFile: The index of the trace file is malformed: " + path);
+
+			const unsigned char *header = bytes + chunkOffset;
+			TraceChunk &chunk = chunkList[k];
+			chunk.samples = readValue<unsigned int>(header + 4);
+			chunk.first = readValue<double>(header + 8);
+			chunk.last = readValue<double>(header + 16);
+			if (std::memcmp(header, MTS_TRACE_CHUNK_MAGIC, 4) != 0 || chunk.samples == 0 ||
+					readValue<UInt64Type>(header + 24) != MTS_TRACE_CHUNK_HEADER + chunkDataSize(columnList, chunk.samples) ||
+					chunkOffset + readValue<UInt64Type>(header + 24) > indexOffset ||
+					chunk.first != readValue<double>(entry) || chunk.last != readValue<double>(entry + 8) ||
+					(k > 0 && !(chunk.first > chunkList[k - 1].last)))
+				throw std::invalid_argument("TraceFile: A chunk of the trace file is malformed: " + path);
+
+			const unsigned char *data = header + MTS_TRACE_CHUNK_HEADER;
+			chunk.time = reinterpret_cast<const double*>(data);
+			data += chunk.samples * 8;
+			chunk.columns.resize(columnList.size());
+			for (size_t c = 0; c < columnList.size(); c++)
+			{
+				chunk.columns[c] = data;
+				data += columnList[c].type == MTS_TRACE_BOOLEAN ? (chunk.samples + 63) / 64 * 8 : chunk.samples * 8;
+			}
+			total += chunk.samples;
+		}
+		if (total != sampleCount)
+			throw std::invalid_argument("TraceFile: The number of samples of the trace file is wrong: " + path);
+	}
+	catch (...)
+	{
+		munmap(memory, size);
+		throw;
+	}
+}
+
+TraceFile::~TraceFile(void)
+{
+	munmap(memory, size);
+}
+
+/**
+ \brief returns the index of the column named *name*, or columnCount() if there is no such column.
+ */
+size_t TraceFile::findColumn(const std::string &name) const
+{
+	for (size_t c = 0; c < columnList.size(); c++)
+		if (columnList[c].name == name)
+			return c;
+	return columnList.size();
+}
+
+/**
+ \brief returns the index of the first chunk whose last instant is not less than *t* (the first chunk with samples from *t* on), or
+ chunkCount() if there is no such chunk.
+ */
+size_t TraceFile::findChunk(double t) const
+{
+	size_t low = 0, high = chunkList.size();
+	while (low < high)
+	{
+		const size_t middle = low + (high - low) / 2;
+		if (chunkList[middle].last < t)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return low;
+}
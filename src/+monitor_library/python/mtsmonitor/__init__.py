@@ -0,0 +1,85 @@
+"""Monitors of MITL formulas over recorded traces, with the native engine of the monitor library.
+
+    import mtsmonitor
+
+    formulas = mtsmonitor.parse('overspeed: GLOBALLY[0,5](speed < 30 OR brake) | FUTURE[2] door = 0')
+    violations = mtsmonitor.check(formulas, time, {'speed': speed, 'brake': brake, 'door': door})
+
+The trace is a vector of instants (seconds, non decreasing) and one column per variable of the formulas, all NumPy arrays (or any
+one-dimensional buffer) of booleans, integers or reals. The columns are read in place, without copies, and the interpreter lock is
+released while the trace is evaluated, so several traces can be checked at once by a thread pool. Each variable holds its value
+from the instant of a sample until the next one. The result of each formula is a K-by-2 array of the intervals [start, end) where
+the formula is false.
+"""
+
+import numpy as np
+
+from . import _native
+from .formula import Formula, FormulaError, PredicateTable, parse, parse_file
+from .trace import TraceFile, check_file
+
+__all__ = ['Formula', 'FormulaError', 'Monitor', 'TraceFile', 'check', 'check_file', 'parse', 'parse_file']
+
+
+def _formulas(formulas):
+    if isinstance(formulas, (str, Formula)):
+        formulas = [formulas]
+    return [f if isinstance(f, Formula) else Formula(f) for f in formulas]
+
+
+def _intervals(limits):
+    return np.frombuffer(limits, dtype=np.float64).reshape(-1, 2)
+
+
+class Monitor(object):
+    """Monitor of one or more formulas on a trace given in chunks (see extend). The predicates shared by the formulas are evaluated
+    once per sample."""
+
+    def __init__(self, formulas, earlyverdict=False):
+        self.formulas = _formulas(formulas)
+        self._table = PredicateTable()
+        self._monitors = [_native.Monitor(f.compile(self._table), earlyverdict) for f in self.formulas]
+        self.variables = self._table.variables()
+        self._predicates = self._table.native(self.variables)
+
+    def extend(self, time, columns):
+        """Append the samples of a chunk of the trace: *time* is the vector of the instants (greater than the last instant of
+        the previous chunk), *columns* maps each variable to its column (e.g. a dict of arrays, or a pandas DataFrame)."""
+        missing = [v for v in self.variables if v not in columns]
+        if missing:
+            raise KeyError('missing columns: %s' % ', '.join(missing))
+        _native.evaluate(self._monitors, _buffer(time, np.float64), [_buffer(columns[v]) for v in self.variables],
+                         self._predicates)
+        return self
+
+    def violations(self):
+        """Intervals where each formula is false, as a list of K-by-2 arrays."""
+        return [_intervals(m.violations()) for m in self._monitors]
+
+    def partial(self):
+        """Intervals not yet evaluated where each formula is already false (with the early verdict)."""
+        return [_intervals(m.partial()) for m in self._monitors]
+
+    @property
+    def safe(self):
+        """Whether or not each formula was never found false."""
+        return [m.safe for m in self._monitors]
+
+    @property
+    def evaluated(self):
+        """Instant up to which each formula was evaluated (the formulas with a future window lag behind the trace)."""
+        return [m.evaluated for m in self._monitors]
+
+
+def _buffer(column, dtype=None):
+    # NumPy arrays and other buffers are passed as they are (the native module reads them in place); other sequences
+    # (e.g. pandas series) are converted to arrays, without copies when they are already backed by one
+    if isinstance(column, np.ndarray) or (dtype is None and isinstance(column, memoryview)):
+        return column
+    return np.asarray(column, dtype=dtype)
+
+
+def check(formulas, time, columns, earlyverdict=False):
+    """Evaluate the formulas (texts or Formula) on a whole trace: returns, for each formula, the K-by-2 array of the intervals
+    where the formula is false."""
+    return Monitor(formulas, earlyverdict).extend(time, columns).violations()
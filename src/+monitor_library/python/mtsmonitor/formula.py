@@ -0,0 +1,295 @@
+"""Parser of the formula files (see the README) and compiler of the formulas to the bytecode of the monitors.
+
+The syntax is the one of the formula files read by the Java parser of the launcher: formulas separated by '|', each optionally
+preceded by a name and ':', comments from '#' to the end of the line, keywords in any case. Every operator takes either one bound
+(OP[b], the window [0,b]) or two (OP[a,b]); ONCE, HISTORICALLY and SINCE take only the upper bound. A predicate is a linear
+constraint such as 5*x + 6*y >= 5, TRUE or FALSE; in addition a single variable (e.g. brake) stands for the predicate brake ~= 0,
+so that boolean columns can be used directly.
+
+The bytecode is the one of bin.conbytecode (version 1, see +monitor_library/matlab/buildval.cpp), so the formulas compiled here
+can also be given to the standalone tools.
+"""
+
+import re
+import struct
+
+# node types of the bytecode
+PREDICATE, NOT, AND, OR, FUTURE, GLOBALLY, UNTIL, ONCE, HISTORICALLY, SINCE = range(10)
+
+# relations of the predicates, as numbered by the native module
+RELATIONS = {'=': 0, '==': 0, '~=': 1, '<=': 2, '>=': 3, '<': 4, '>': 5}
+
+_KEYWORDS = {'TRUE', 'FALSE', 'NOT', 'AND', 'OR', 'UNTIL', 'GLOBALLY', 'FUTURE', 'ONCE', 'HISTORICALLY', 'SINCE'}
+_UNARY = {'GLOBALLY': GLOBALLY, 'FUTURE': FUTURE, 'ONCE': ONCE, 'HISTORICALLY': HISTORICALLY}
+_BINARY = {'UNTIL': UNTIL, 'SINCE': SINCE}
+_PAST = {ONCE, HISTORICALLY, SINCE}
+
+_TOKEN = re.compile(r'''
+    (?P<space>\s+|\#[^\n]*)
+  | (?P<real>(?:\d+\.?\d*|\.\d+)(?:[eE][+-]?\d+)?)
+  | (?P<identifier>[A-Za-z_][A-Za-z0-9_]*)
+  | (?P<relation>==|~=|<=|>=|=|<|>)
+  | (?P<symbol>[-+*()\[\],])
+''', re.VERBOSE)
+
+
+class FormulaError(ValueError):
+    """Syntax error in a formula."""
+
+
+class Predicate(object):
+    """Linear predicate: sum(coefficient * variable) relation constant (no terms for TRUE and FALSE)."""
+
+    def __init__(self, terms, relation, constant):
+        self.terms = tuple(terms)
+        self.relation = relation
+        self.constant = float(constant)
+
+    def key(self):
+        return (self.terms, RELATIONS[self.relation], self.constant)
+
+    def __str__(self):
+        if not self.terms:
+            return 'TRUE' if self.relation == '>=' else 'FALSE'
+        text = ' + '.join('%g*%s' % (coefficient, variable) for variable, coefficient in self.terms)
+        return '%s %s %g' % (text.replace('+ -', '- '), self.relation, self.constant)
+
+
+TRUE = Predicate((), '>=', 0)
+FALSE = Predicate((), '>', 0)
+
+
+class Node(object):
+    """Node of a syntax tree: a predicate, or an operator with its children and its window [lower, upper]."""
+
+    def __init__(self, nodetype, children=(), lower=0.0, upper=0.0, predicate=None):
+        self.nodetype = nodetype
+        self.children = tuple(children)
+        self.lower = float(lower)
+        self.upper = float(upper)
+        self.predicate = predicate
+
+
+class PredicateTable(object):
+    """Indexes of the distinct predicates of one or more formulas, in order of first appearance (equal predicates share the
+    index, like in bin.contree)."""
+
+    def __init__(self):
+        self.predicates = []
+        self._indexes = {}
+
+    def index(self, predicate):
+        key = predicate.key()
+        if key not in self._indexes:
+            self._indexes[key] = len(self.predicates)
+            self.predicates.append(predicate)
+        return self._indexes[key]
+
+    def variables(self):
+        """Names of the variables of the predicates, in order of first appearance."""
+        names = []
+        for predicate in self.predicates:
+            for variable, _ in predicate.terms:
+                if variable not in names:
+                    names.append(variable)
+        return names
+
+    def native(self, variables):
+        """Predicates in the form of the native module: (relation, constant, ((column, coefficient), ...)), the column of a
+        variable being its position in *variables*."""
+        columns = dict((name, i) for i, name in enumerate(variables))
+        return [(RELATIONS[p.relation], p.constant, tuple((columns[v], c) for v, c in p.terms)) for p in self.predicates]
+
+
+class Formula(object):
+    """Formula parsed from its text (see the module documentation)."""
+
+    def __init__(self, text, name=None):
+        self.text = text
+        self.name = name
+        self.tree = _Parser(text).parse()
+
+    def compile(self, table=None):
+        """Bytecode of the formula, with the indexes of the predicates taken from *table* (a new table if None)."""
+        table = PredicateTable() if table is None else table
+        return b'MTSB' + struct.pack('<B', 1) + _encode(self.tree, table)
+
+    @property
+    def bytecode(self):
+        """Bytecode of the formula alone, e.g. to be saved in a .mtsb file for the standalone tools."""
+        return self.compile()
+
+    @property
+    def predicates(self):
+        table = PredicateTable()
+        self.compile(table)
+        return list(table.predicates)
+
+    def __repr__(self):
+        return 'Formula(%r, name=%r)' % (self.text, self.name)
+
+
+def parse(text):
+    """Formulas of the text of a formula file, as a list of Formula (named monitor_1, monitor_2, ... when unnamed)."""
+    formulas = []
+    for i, part in enumerate(re.sub(r'#[^\n]*', '', text).split('|')):
+        name, separator, body = part.partition(':')
+        if not separator:
+            name, body = None, part
+        else:
+            name = ' '.join(name.split())
+        if not body.strip():
+            raise FormulaError('Formula %d is empty.' % (i + 1))
+        formulas.append(Formula(body, name or 'monitor_%d' % (i + 1)))
+    return formulas
+
+
+def parse_file(filename):
+    """Formulas of a formula file (ISO 8859-1)."""
+    with open(filename, encoding='latin-1') as stream:
+        return parse(stream.read())
+
+
+def _encode(node, table):
+    code = struct.pack('<B', node.nodetype)
+    if node.nodetype == PREDICATE:
+        return code + struct.pack('<I', table.index(node.predicate))
+    if node.nodetype in (FUTURE, GLOBALLY, UNTIL):
+        code += struct.pack('<dd', node.lower, node.upper)
+    elif node.nodetype in _PAST:
+        code += struct.pack('<d', node.upper)
+    for child in node.children:
+        code += _encode(child, table)
+    return code
+
+
+class _Parser(object):
+    """Recursive descent parser; precedence from the highest: NOT and the unary temporal operators, AND, OR, UNTIL and SINCE.
+    The binary operators are left associative."""
+
+    def __init__(self, text):
+        self.tokens = []
+        position = 0
+        while position < len(text):
+            match = _TOKEN.match(text, position)
+            if match is None:
+                raise FormulaError('Unexpected character %r in %r.' % (text[position], text.strip()))
+            kind = match.lastgroup
+            value = match.group(kind)
+            if kind == 'identifier' and value.upper() in _KEYWORDS:
+                kind, value = 'keyword', value.upper()
+            if kind != 'space':
+                self.tokens.append((kind, value))
+            position = match.end()
+        self.tokens.append(('end', ''))
+        self.position = 0
+        self.text = text.strip()
+
+    def peek(self, offset=0):
+        return self.tokens[min(self.position + offset, len(self.tokens) - 1)]
+
+    def take(self, kind=None, value=None):
+        token = self.peek()
+        if (kind is not None and token[0] != kind) or (value is not None and token[1] != value):
+            expected = value or kind
+            found = token[1] or 'the end of the formula'
+            raise FormulaError('Expected %s instead of %s in %r.' % (expected, found, self.text))
+        self.position += 1
+        return token
+
+    def parse(self):
+        tree = self.temporal()
+        self.take('end')
+        return tree
+
+    def window(self, operator):
+        self.take('symbol', '[')
+        bounds = [self.number()]
+        if self.peek() == ('symbol', ','):
+            self.take()
+            bounds.append(self.number())
+        self.take('symbol', ']')
+        lower, upper = (0.0, bounds[0]) if len(bounds) == 1 else bounds
+        if not upper > 0 or lower < 0 or lower > upper:
+            raise FormulaError('The window of %s must be [a,b] with 0 <= a <= b and b > 0 in %r.' % (operator, self.text))
+        if lower > 0 and operator in ('ONCE', 'HISTORICALLY', 'SINCE'):
+            raise FormulaError('%s takes only the upper bound in %r.' % (operator, self.text))
+        return lower, upper
+
+    def number(self):
+        sign = 1.0
+        if self.peek()[0] == 'symbol' and self.peek()[1] in '+-':
+            sign = -1.0 if self.take()[1] == '-' else 1.0
+        return sign * float(self.take('real')[1])
+
+    def temporal(self):
+        tree = self.disjunction()
+        while self.peek()[0] == 'keyword' and self.peek()[1] in _BINARY:
+            operator = self.take()[1]
+            lower, upper = self.window(operator)
+            tree = Node(_BINARY[operator], (tree, self.disjunction()), lower, upper)
+        return tree
+
+    def disjunction(self):
+        tree = self.conjunction()
+        while self.peek() == ('keyword', 'OR'):
+            self.take()
+            tree = Node(OR, (tree, self.conjunction()))
+        return tree
+
+    def conjunction(self):
+        tree = self.unary()
+        while self.peek() == ('keyword', 'AND'):
+            self.take()
+            tree = Node(AND, (tree, self.unary()))
+        return tree
+
+    def unary(self):
+        kind, value = self.peek()
+        if kind == 'keyword' and value == 'NOT':
+            self.take()
+            return Node(NOT, (self.unary(),))
+        if kind == 'keyword' and value in _UNARY:
+            self.take()
+            lower, upper = self.window(value)
+            return Node(_UNARY[value], (self.unary(),), lower, upper)
+        if kind == 'keyword' and value in ('TRUE', 'FALSE'):
+            self.take()
+            return Node(PREDICATE, predicate=TRUE if value == 'TRUE' else FALSE)
+        if (kind, value) == ('symbol', '('):
+            self.take()
+            tree = self.temporal()
+            self.take('symbol', ')')
+            return tree
+        return Node(PREDICATE, predicate=self.predicate())
+
+    def predicate(self):
+        terms = []
+        sign = 1.0
+        if self.peek()[0] == 'symbol' and self.peek()[1] in '+-':
+            sign = -1.0 if self.take()[1] == '-' else 1.0
+        terms.append(self.product(sign))
+        while self.peek()[0] == 'symbol' and self.peek()[1] in '+-':
+            terms.append(self.product(-1.0 if self.take()[1] == '-' else 1.0))
+
+        if self.peek()[0] != 'relation':
+            # a single variable is a boolean signal
+            if len(terms) == 1 and terms[0][1] == 1.0:
+                return Predicate(terms, '~=', 0)
+            self.take('relation')
+        relation = self.take()[1]
+        return Predicate(terms, '==' if relation == '=' else relation, self.number())
+
+    def product(self, sign):
+        if self.peek()[0] == 'identifier':
+            variable = self.take()[1]
+            coefficient = 1.0
+            if self.peek() == ('symbol', '*') or self.peek()[0] == 'real':
+                if self.peek()[0] == 'symbol':
+                    self.take()
+                coefficient = float(self.take('real')[1])
+            return variable, sign * coefficient
+        coefficient = float(self.take('real')[1])
+        if self.peek() == ('symbol', '*'):
+            self.take()
+        return self.take('identifier')[1], sign * coefficient
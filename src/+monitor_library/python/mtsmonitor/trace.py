@@ -0,0 +1,102 @@
+"""Reader of trace files (.mtst, the columnar format of headers/trace_file.h, written e.g. by tools/trace_convert.cpp).
+
+    trace = mtsmonitor.TraceFile('run.mtst')
+    violations = mtsmonitor.check_file(formulas, 'run.mtst', start=10.0, end=60.0)
+
+The file is memory-mapped: the instants and the real columns of a chunk are arrays over the map, without copies, and the boolean
+columns are unpacked from their bits one chunk at a time. The variables of the formulas are the names of the columns.
+"""
+
+import struct
+
+import numpy as np
+
+BOOLEAN = 0
+REAL = 1
+
+_HEADER = struct.Struct('<4sIIIQQdd')
+_CHUNK = struct.Struct('<4sIddQ')
+
+
+class TraceFile(object):
+    """Trace file opened through a read-only memory map."""
+
+    def __init__(self, path):
+        self._map = np.memmap(path, dtype=np.uint8, mode='r')
+        if len(self._map) < _HEADER.size:
+            raise ValueError('not a trace file: %s' % path)
+        magic, version, columns, chunks, self.samples, index, self.first, self.last = _HEADER.unpack_from(self._map, 0)
+        if magic != b'MTST' or version != 1:
+            raise ValueError('not a trace file of version 1: %s' % path)
+        if index == 0:
+            raise ValueError('the trace file was not closed by its writer: %s' % path)
+
+        self.columns = []
+        position = _HEADER.size
+        for _ in range(columns):
+            kind, length = struct.unpack_from('<BxH', self._map, position)
+            self.columns.append((bytes(self._map[position + 4:position + 4 + length]).decode('utf-8'), kind))
+            position += 4 + length
+
+        entries = np.frombuffer(self._map, dtype=np.float64, count=3 * chunks, offset=index).reshape(-1, 3)
+        self._first = entries[:, 0]
+        self._last = entries[:, 1]
+        self._offset = entries[:, 2].view(np.uint64)
+
+    @property
+    def names(self):
+        return [name for name, _ in self.columns]
+
+    def __len__(self):
+        """Number of chunks."""
+        return len(self._offset)
+
+    def find_chunk(self, t):
+        """Index of the first chunk whose last instant is not less than *t* (len(self) if there is none)."""
+        return int(np.searchsorted(self._last, t, side='left'))
+
+    def chunk(self, k):
+        """Instants and columns (a dict by name) of the chunk *k*."""
+        offset = int(self._offset[k])
+        magic, n, _, _, _ = _CHUNK.unpack_from(self._map, offset)
+        if magic != b'MTSC':
+            raise ValueError('malformed chunk %d' % k)
+        position = offset + _CHUNK.size
+        time = np.frombuffer(self._map, dtype=np.float64, count=n, offset=position)
+        position += 8 * n
+        columns = {}
+        for name, kind in self.columns:
+            if kind == BOOLEAN:
+                words = (n + 63) // 64
+                bits = np.frombuffer(self._map, dtype=np.uint8, count=8 * words, offset=position)
+                columns[name] = np.unpackbits(bits, count=n, bitorder='little').view(np.bool_)
+                position += 8 * words
+            else:
+                columns[name] = np.frombuffer(self._map, dtype=np.float64, count=n, offset=position)
+                position += 8 * n
+        return time, columns
+
+    def chunks(self, start=None, end=None):
+        """Instants and columns of each chunk with samples in [start, end], restricted to those samples. The chunks out of the range
+        are not read."""
+        k = 0 if start is None else self.find_chunk(start)
+        while k < len(self) and (end is None or self._first[k] <= end):
+            time, columns = self.chunk(k)
+            begin = 0 if start is None else int(np.searchsorted(time, start, side='left'))
+            stop = len(time) if end is None else int(np.searchsorted(time, end, side='right'))
+            if begin < stop:
+                if begin > 0 or stop < len(time):
+                    time = time[begin:stop]
+                    columns = dict((name, column[begin:stop]) for name, column in columns.items())
+                yield time, columns
+            k += 1
+
+
+def check_file(formulas, path, start=None, end=None, earlyverdict=False):
+    """Evaluate the formulas on the samples of a trace file with instants in [start, end]: returns, for each formula, the K-by-2
+    array of the intervals where the formula is false."""
+    from . import Monitor
+    monitor = Monitor(formulas, earlyverdict)
+    for time, columns in TraceFile(path).chunks(start, end):
+        monitor.extend(time, columns)
+    return monitor.violations()
@@ -0,0 +1,567 @@
+// Native part of the Python package mtsmonitor (see mtsmonitor/__init__.py): the monitors of the library and the evaluation of the
+// predicates on the columns of a trace. The columns are read in place through the buffer protocol (e.g. NumPy arrays, also not
+// contiguous), and the global interpreter lock is released while the trace is evaluated. Built by setup.py.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "validators.h"
+
+// relations of the predicates (see mtsmonitor/formula.py)
+enum Relation {REL_EQ, REL_NE, REL_LE, REL_GE, REL_LT, REL_GT};
+
+// linear predicate: the sum of coefficient * column over the terms, compared with the constant
+struct LinearPredicate
+{
+	int relation;
+	double constant;
+	std::vector<std::pair<size_t, double> > terms;
+};
+
+enum ColumnKind {SIGNED, UNSIGNED, REAL};
+
+// column of the trace, read in place
+struct Column
+{
+	const char *data;
+	Py_ssize_t stride;
+	Py_ssize_t itemsize;
+	ColumnKind kind;
+
+	inline double value(size_t i) const
+	{
+		const char *item = data + (Py_ssize_t)i * stride;
+		switch (kind)
+		{
+		case REAL:
+			return itemsize == 4 ? *(const float*)item : *(const double*)item;
+		case SIGNED:
+			switch (itemsize)
+			{
+			case 1: return *(const signed char*)item;
+			case 2: return *(const short*)item;
+			case 4: return *(const int*)item;
+			default: return (double)*(const long long*)item;
+			}
+		default:
+			switch (itemsize)
+			{
+			case 1: return *(const unsigned char*)item;
+			case 2: return *(const unsigned short*)item;
+			case 4: return *(const unsigned int*)item;
+			default: return (double)*(const unsigned long long*)item;
+			}
+		}
+	}
+};
+
+struct MonitorObject
+{
+	PyObject_HEAD
+	Monitor *monitor;
+	bool busy; /**< whether or not a thread is evaluating a trace on the monitor (without the interpreter lock)*/
+	double last; /**< last instant of the trace (meaningful if the monitor is started)*/
+};
+
+/* Monitor type ----------------------------------------------------------------------------------------------------------------*/
+
+static void monitorDealloc(MonitorObject *self)
+{
+	delete self->monitor;
+	Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int monitorInit(MonitorObject *self, PyObject *args, PyObject *kwds)
+{
+	static const char *keywords[] = {"bytecode", "earlyverdict", NULL};
+	Py_buffer code;
+	int earlyverdict = 0;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|p", (char**)keywords, &code, &earlyverdict))
+		return -1;
+	if (self->monitor != NULL)
+	{
+		PyBuffer_Release(&code);
+		PyErr_SetString(PyExc_RuntimeError, "The monitor is already initialized.");
+		return -1;
+	}
+
+	try
+	{
+		self->monitor = new Monitor((const unsigned char*)code.buf, (size_t)code.len, earlyverdict != 0);
+	}
+	catch (std::exception &e)
+	{
+		PyBuffer_Release(&code);
+		PyErr_SetString(PyExc_ValueError, e.what());
+		return -1;
+	}
+	PyBuffer_Release(&code);
+	return 0;
+}
+
+static bool checkUsable(MonitorObject *self)
+{
+	if (self->monitor == NULL)
+	{
+		PyErr_SetString(PyExc_RuntimeError, "The monitor is not initialized.");
+		return false;
+	}
+	if (self->busy)
+	{
+		PyErr_SetString(PyExc_RuntimeError, "The monitor is evaluating a trace in another thread.");
+		return false;
+	}
+	return true;
+}
+
+/* returns the intervals of a signal as a bytearray of doubles, the limits of each interval in a row*/
+static PyObject* intervalBytes(const Signal &values)
+{
+	std::vector<double> limits;
+	limits.reserve(2 * values.getIntervalCount());
+	for (Signal::const_iterator it = values.getBegin(); it != values.getEnd(); it++)
+	{
+		limits.push_back(TimePolicy::toSeconds(it->leftLimit));
+		limits.push_back(TimePolicy::toSeconds(it->rightLimit));
+	}
+	return PyByteArray_FromStringAndSize(limits.empty() ? "" : (const char*)&limits[0], limits.size() * sizeof(double));
+}
+
+static PyObject* monitorExtend(MonitorObject *self, PyObject *args)
+{
+	double t;
+	PyObject *values;
+
+	if (!PyArg_ParseTuple(args, "dO", &t, &values) || !checkUsable(self))
+		return NULL;
+
+	PyObject *sequence = PySequence_Fast(values, "The values of the predicates must be a sequence.");
+	if (sequence == NULL)
+		return NULL;
+
+	const Py_ssize_t count = PySequence_Fast_GET_SIZE(sequence);
+	std::vector<BooleanType> preds(count);
+	for (Py_ssize_t i = 0; i < count; i++)
+	{
+		const int truth = PyObject_IsTrue(PySequence_Fast_GET_ITEM(sequence, i));
+		if (truth < 0)
+		{
+			Py_DECREF(sequence);
+			return NULL;
+		}
+		preds[i] = truth ? 1 : 0;
+	}
+	Py_DECREF(sequence);
+
+	try
+	{
+		if (self->monitor->isStarted())
+		{
+			if (!(t > self->last))
+				throw std::invalid_argument("The instant must be greater than the last instant of the trace.");
+			self->monitor->extendTrace(TimePolicy::fromSeconds(t), preds);
+		}
+		else
+			self->monitor->initialConditions(TimePolicy::fromSeconds(t), preds);
+		self->last = t;
+	}
+	catch (std::exception &e)
+	{
+		PyErr_SetString(PyExc_ValueError, e.what());
+		return NULL;
+	}
+	Py_RETURN_NONE;
+}
+
+static PyObject* monitorViolations(MonitorObject *self, PyObject *)
+{
+	if (!checkUsable(self))
+		return NULL;
+	return intervalBytes(self->monitor->formulaEvaluation());
+}
+
+static PyObject* monitorPartial(MonitorObject *self, PyObject *)
+{
+	if (!checkUsable(self))
+		return NULL;
+	return intervalBytes(self->monitor->partialEvaluation());
+}
+
+static PyObject* monitorGetSafe(MonitorObject *self, void *)
+{
+	if (!checkUsable(self))
+		return NULL;
+	return PyBool_FromLong(self->monitor->checkSafety());
+}
+
+static PyObject* monitorGetStarted(MonitorObject *self, void *)
+{
+	if (!checkUsable(self))
+		return NULL;
+	return PyBool_FromLong(self->monitor->isStarted());
+}
+
+static PyObject* monitorGetEvaluated(MonitorObject *self, void *)
+{
+	if (!checkUsable(self))
+		return NULL;
+	if (!self->monitor->isStarted())
+		Py_RETURN_NONE;
+	return PyFloat_FromDouble(TimePolicy::toSeconds(self->monitor->formulaEvaluation().getLast()));
+}
+
+static PyObject* monitorGetLast(MonitorObject *self, void *)
+{
+	if (!checkUsable(self))
+		return NULL;
+	if (!self->monitor->isStarted())
+		Py_RETURN_NONE;
+	return PyFloat_FromDouble(self->last);
+}
+
+static PyMethodDef monitorMethods[] = {
+	{"extend", (PyCFunction)monitorExtend, METH_VARARGS,
+	 "extend(t, values): append the sample (t, values) to the trace, values[i] being the value of the predicate i."},
+	{"violations", (PyCFunction)monitorViolations, METH_NOARGS,
+	 "violations(): bytearray of the intervals where the formula is false (pairs of float64)."},
+	{"partial", (PyCFunction)monitorPartial, METH_NOARGS,
+	 "partial(): bytearray of the intervals not yet evaluated where the formula is already false (early verdict)."},
+	{NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef monitorProperties[] = {
+	{(char*)"safe", (getter)monitorGetSafe, NULL, (char*)"whether or not the formula was never found false", NULL},
+	{(char*)"started", (getter)monitorGetStarted, NULL, (char*)"whether or not the trace has a sample", NULL},
+	{(char*)"evaluated", (getter)monitorGetEvaluated, NULL, (char*)"instant up to which the formula was evaluated", NULL},
+	{(char*)"last", (getter)monitorGetLast, NULL, (char*)"last instant of the trace", NULL},
+	{NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyTypeObject MonitorType = {PyVarObject_HEAD_INIT(NULL, 0)};
+
+/* evaluate --------------------------------------------------------------------------------------------------------------------*/
+
+/*
+ POST-CONDITIONS:
+ 	 Returns true and sets *column* if *view* is a one-dimensional buffer of *length* numbers (booleans, integers or reals in the
+ 	 byte order of the machine), otherwise sets a Python error and returns false.
+ */
+static bool makeColumn(const Py_buffer &view, Py_ssize_t length, Column &column)
+{
+	const char *format = view.format == NULL ? "B" : view.format;
+	if (*format == '@' || *format == '=')
+		format++;
+
+	if (view.ndim != 1 || view.shape[0] != length)
+	{
+		PyErr_SetString(PyExc_ValueError, "Every column must be one-dimensional, with one element per instant.");
+		return false;
+	}
+	if (format[0] == 0 || format[1] != 0)
+	{
+		PyErr_Format(PyExc_ValueError, "Unsupported column format '%s'.", view.format);
+		return false;
+	}
+
+	if (std::strchr("bhilqn", format[0]) != NULL)
+		column.kind = SIGNED;
+	else if (std::strchr("?BHILQN", format[0]) != NULL)
+		column.kind = UNSIGNED;
+	else if ((format[0] == 'f' && view.itemsize == 4) || (format[0] == 'd' && view.itemsize == 8))
+		column.kind = REAL;
+	else
+	{
+		PyErr_Format(PyExc_ValueError, "Unsupported column format '%s'.", view.format);
+		return false;
+	}
+	if (column.kind != REAL && view.itemsize != 1 && view.itemsize != 2 && view.itemsize != 4 && view.itemsize != 8)
+	{
+		PyErr_Format(PyExc_ValueError, "Unsupported column format '%s'.", view.format);
+		return false;
+	}
+
+	column.data = (const char*)view.buf;
+	column.stride = view.strides == NULL ? view.itemsize : view.strides[0];
+	column.itemsize = view.itemsize;
+	return true;
+}
+
+static bool parsePredicates(PyObject *object, size_t columns, std::vector<LinearPredicate> &predicates)
+{
+	PyObject *sequence = PySequence_Fast(object, "The predicates must be a sequence.");
+	if (sequence == NULL)
+		return false;
+
+	predicates.resize(PySequence_Fast_GET_SIZE(sequence));
+	for (size_t p = 0; p < predicates.size(); p++)
+	{
+		PyObject *terms;
+		if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(sequence, p), "idO", &predicates[p].relation, &predicates[p].constant, &terms))
+		{
+			Py_DECREF(sequence);
+			return false;
+		}
+
+		PyObject *termSequence = PySequence_Fast(terms, "The terms of a predicate must be a sequence.");
+		if (termSequence == NULL)
+		{
+			Py_DECREF(sequence);
+			return false;
+		}
+		for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(termSequence); i++)
+		{
+			Py_ssize_t column;
+			double coefficient;
+			if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(termSequence, i), "nd", &column, &coefficient) ||
+					column < 0 || (size_t)column >= columns)
+			{
+				if (!PyErr_Occurred())
+					PyErr_SetString(PyExc_ValueError, "The column of a term is not a column of the trace.");
+				Py_DECREF(termSequence);
+				Py_DECREF(sequence);
+				return false;
+			}
+			predicates[p].terms.push_back(std::make_pair((size_t)column, coefficient));
+		}
+		Py_DECREF(termSequence);
+
+		if (predicates[p].relation < REL_EQ || predicates[p].relation > REL_GT)
+		{
+			PyErr_SetString(PyExc_ValueError, "Unknown relation of a predicate.");
+			Py_DECREF(sequence);
+			return false;
+		}
+	}
+	Py_DECREF(sequence);
+	return true;
+}
+
+static inline BooleanType evaluatePredicate(const LinearPredicate &predicate, const std::vector<Column> &columns, size_t i)
+{
+	double sum = 0;
+	for (size_t k = 0; k < predicate.terms.size(); k++)
+		sum += predicate.terms[k].second * columns[predicate.terms[k].first].value(i);
+
+	switch (predicate.relation)
+	{
+	case REL_EQ: return sum == predicate.constant;
+	case REL_NE: return sum != predicate.constant;
+	case REL_LE: return sum <= predicate.constant;
+	case REL_GE: return sum >= predicate.constant;
+	case REL_LT: return sum < predicate.constant;
+	default: return sum > predicate.constant;
+	}
+}
+
+/*
+ PRE-CONDITIONS:
+ 	 The instants of *time* are non decreasing, and greater than the last instant of every monitor started.
+
+ POST-CONDITIONS:
+ 	 The trace of every monitor is extended with the samples: the predicates are evaluated on the columns of each sample, and only
+ 	 the samples where some predicate changes (and the last one) are given to the monitors. Of several samples with the same
+ 	 instant, the last one counts. Runs without the interpreter lock.
+ */
+static void evaluateTrace(const std::vector<MonitorObject*> &monitors, const Column &time, size_t length,
+		const std::vector<Column> &columns, const std::vector<LinearPredicate> &predicates)
+{
+	std::vector<BooleanType> preds(predicates.size()), row(predicates.size());
+	bool given = false;
+
+	for (size_t i = 0; i < length; i++)
+	{
+		const double t = time.value(i);
+		const bool lastSample = i + 1 == length;
+		if (!lastSample && time.value(i + 1) == t)
+			continue;
+
+		for (size_t p = 0; p < predicates.size(); p++)
+			row[p] = evaluatePredicate(predicates[p], columns, i);
+		if (given && !lastSample && row == preds)
+			continue;
+		preds.swap(row);
+		given = true;
+
+		for (size_t m = 0; m < monitors.size(); m++)
+		{
+			Monitor &monitor = *monitors[m]->monitor;
+			if (monitor.isStarted())
+				monitor.extendTrace(TimePolicy::fromSeconds(t), preds);
+			else
+				monitor.initialConditions(TimePolicy::fromSeconds(t), preds);
+			monitors[m]->last = t;
+		}
+	}
+}
+
+static PyObject* evaluate(PyObject *, PyObject *args)
+{
+	PyObject *monitorList, *timeObject, *columnList, *predicateList;
+	if (!PyArg_ParseTuple(args, "OOOO", &monitorList, &timeObject, &columnList, &predicateList))
+		return NULL;
+
+	std::vector<MonitorObject*> monitors;
+	std::vector<Py_buffer> views;
+	std::vector<Column> columns;
+	std::vector<LinearPredicate> predicates;
+	Column time;
+	size_t length = 0;
+	bool valid = false;
+
+	PyObject *monitorSequence = PySequence_Fast(monitorList, "The monitors must be a sequence.");
+	PyObject *columnSequence = monitorSequence == NULL ? NULL : PySequence_Fast(columnList, "The columns must be a sequence.");
+	if (columnSequence == NULL)
+	{
+		Py_XDECREF(monitorSequence);
+		return NULL;
+	}
+
+	// the buffers stay exported (so that their memory cannot be released or resized) until the evaluation ends
+	views.reserve(1 + PySequence_Fast_GET_SIZE(columnSequence));
+	do
+	{
+		for (Py_ssize_t m = 0; m < PySequence_Fast_GET_SIZE(monitorSequence); m++)
+		{
+			PyObject *item = PySequence_Fast_GET_ITEM(monitorSequence, m);
+			if (!PyObject_TypeCheck(item, &MonitorType))
+			{
+				PyErr_SetString(PyExc_TypeError, "Every monitor must be a mtsmonitor._native.Monitor.");
+				break;
+			}
+			if (!checkUsable((MonitorObject*)item))
+				break;
+			monitors.push_back((MonitorObject*)item);
+		}
+		if (PyErr_Occurred())
+			break;
+
+		Py_buffer view;
+		if (PyObject_GetBuffer(timeObject, &view, PyBUF_STRIDES | PyBUF_FORMAT) != 0)
+			break;
+		views.push_back(view);
+		length = view.ndim == 1 ? (size_t)view.shape[0] : 0;
+		if (!makeColumn(view, (Py_ssize_t)length, time))
+			break;
+		if (time.kind != REAL)
+		{
+			PyErr_SetString(PyExc_ValueError, "The instants must be real numbers.");
+			break;
+		}
+
+		for (Py_ssize_t c = 0; c < PySequence_Fast_GET_SIZE(columnSequence); c++)
+		{
+			if (PyObject_GetBuffer(PySequence_Fast_GET_ITEM(columnSequence, c), &view, PyBUF_STRIDES | PyBUF_FORMAT) != 0)
+				break;
+			views.push_back(view);
+			columns.push_back(Column());
+			if (!makeColumn(view, (Py_ssize_t)length, columns.back()))
+				break;
+		}
+		if (PyErr_Occurred() || !parsePredicates(predicateList, columns.size(), predicates))
+			break;
+
+		for (size_t i = 1; i < length && !PyErr_Occurred(); i++)
+			if (!(time.value(i) >= time.value(i - 1)))
+				PyErr_SetString(PyExc_ValueError, "The instants must be non decreasing.");
+		for (size_t m = 0; m < monitors.size() && !PyErr_Occurred(); m++)
+			if (length > 0 && monitors[m]->monitor->isStarted() && !(time.value(0) > monitors[m]->last))
+				PyErr_SetString(PyExc_ValueError, "The instants must be greater than the last instant of the monitors.");
+		valid = !PyErr_Occurred();
+	}
+	while (false);
+
+	std::string error;
+	if (valid)
+	{
+		// the same monitor cannot be extended by two threads: the flags are set and cleared with the interpreter lock
+		for (size_t m = 0; m < monitors.size(); m++)
+		{
+			if (monitors[m]->busy)
+			{
+				PyErr_SetString(PyExc_ValueError, "The same monitor is given more than once.");
+				valid = false;
+			}
+			monitors[m]->busy = true;
+		}
+		if (valid)
+		{
+			Py_BEGIN_ALLOW_THREADS
+			try
+			{
+				evaluateTrace(monitors, time, length, columns, predicates);
+			}
+			catch (std::exception &e)
+			{
+				error = e.what();
+				if (error.empty())
+					error = "Error during the evaluation of the trace.";
+			}
+			Py_END_ALLOW_THREADS
+		}
+		for (size_t m = 0; m < monitors.size(); m++)
+			monitors[m]->busy = false;
+	}
+
+	for (size_t v = 0; v < views.size(); v++)
+		PyBuffer_Release(&views[v]);
+	Py_DECREF(columnSequence);
+	Py_DECREF(monitorSequence);
+
+	if (!valid)
+		return NULL;
+	if (!error.empty())
+	{
+		PyErr_SetString(PyExc_ValueError, error.c_str());
+		return NULL;
+	}
+	Py_RETURN_NONE;
+}
+
+/* Module ----------------------------------------------------------------------------------------------------------------------*/
+
+static PyMethodDef moduleMethods[] = {
+	{"evaluate", evaluate, METH_VARARGS,
+	 "evaluate(monitors, time, columns, predicates): extend the monitors with the samples of a trace, without the interpreter lock.\n"
+	 "time and the columns are one-dimensional buffers of the same length; each predicate is a tuple (relation, constant, terms),\n"
+	 "terms being a sequence of pairs (column index, coefficient)."},
+	{NULL, NULL, 0, NULL}
+};
+
+static PyModuleDef moduleDefinition = {
+	PyModuleDef_HEAD_INIT, "mtsmonitor._native", "Native monitors of MITL formulas (see mtsmonitor).", -1, moduleMethods,
+	NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit__native(void)
+{
+	MonitorType.tp_name = "mtsmonitor._native.Monitor";
+	MonitorType.tp_basicsize = sizeof(MonitorObject);
+	MonitorType.tp_flags = Py_TPFLAGS_DEFAULT;
+	MonitorType.tp_doc = "Monitor(bytecode, earlyverdict=False): monitor of a formula compiled to bytecode (see mtsmonitor.Formula).";
+	MonitorType.tp_new = PyType_GenericNew;
+	MonitorType.tp_init = (initproc)monitorInit;
+	MonitorType.tp_dealloc = (destructor)monitorDealloc;
+	MonitorType.tp_methods = monitorMethods;
+	MonitorType.tp_getset = monitorProperties;
+	if (PyType_Ready(&MonitorType) < 0)
+		return NULL;
+
+	PyObject *module = PyModule_Create(&moduleDefinition);
+	if (module == NULL)
+		return NULL;
+
+	Py_INCREF(&MonitorType);
+	if (PyModule_AddObject(module, "Monitor", (PyObject*)&MonitorType) < 0)
+	{
+		Py_DECREF(&MonitorType);
+		Py_DECREF(module);
+		return NULL;
+	}
+	return module;
+}
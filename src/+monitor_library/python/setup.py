@@ -0,0 +1,25 @@
+# Build of the Python package mtsmonitor (see mtsmonitor/__init__.py), e.g. from this folder:
+#
+#	pip install .
+#
+# The native module is compiled from the sources of the library; NumPy is needed only at run time.
+
+import glob
+import os
+
+from setuptools import Extension, setup
+
+LIBRARY = os.path.relpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+SOURCES = (['native.cpp', os.path.join(LIBRARY, 'matlab', 'buildval.cpp')] +
+           sorted(glob.glob(os.path.join(LIBRARY, 'misc', '*.cpp'))) +
+           sorted(glob.glob(os.path.join(LIBRARY, 'validators', '*.cpp'))))
+
+setup(
+    name='mtsmonitor',
+    version='1.0',
+    description='Monitors of MITL formulas over recorded traces',
+    packages=['mtsmonitor'],
+    ext_modules=[Extension('mtsmonitor._native', SOURCES, include_dirs=[os.path.join(LIBRARY, 'headers')],
+                           language='c++')],
+    install_requires=['numpy'],
+)
@@ -0,0 +1,442 @@
+// Randomized comparison of the monitors with a brute-force reference: random formulas (with [a,b] windows, past operators and
+// repeated subformulas) are written as bytecode and monitored on random traces, and the violations found by the monitor are
+// compared with the ones of a direct evaluation of the formula on a grid.
+//
+// The traces change only at the instants of a grid and the bounds of the formulas are multiples of its cell, so every value of the
+// formula is constant in each cell of the grid: the reference evaluates one instant per cell (its middle), and the monitor is
+// compared with it in the same instants. The values are compared on a grid exact in binary (EXACT_CELL). Each formula is also
+// monitored on a grid not exact in binary (ROUNDED_CELL), where the limits of the intervals are rounded as in a real trace: there
+// a window as long as a run of its operand can hold in an instant or in none depending on the rounding, so only the domain of
+// the evaluation is compared (and the monitor must not fail).
+//
+// The monitor is given the samples at a random subset of the instants of the grid (the steps are not integer and not constant),
+// sometimes preceded by a sample with random values at the same instant (which the next one overrides). Some predicates are
+// filtered with a minimum dwell time, and half of the monitors report early verdicts, which are checked against the reference
+// too. The operands with short gaps exercise the coalescing of the buffers of F and G.
+//
+// The program is a plain C++ program (no MATLAB needed), e.g. from the +monitor_library folder:
+//
+//	g++ -O2 -Iheaders tests/reference_check.cpp matlab/buildval.cpp misc/*.cpp validators/*.cpp -o reference_check
+//	./reference_check [formulas [seed]]
+//
+// The exit status is 1 if the monitor differs from the reference for a formula (on either grid).
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "validators.h"
+#include "bytecode.h"
+
+#define EXACT_CELL 	0.25	/*seconds of a cell of the grid for the comparison of the values*/
+#define ROUNDED_CELL 	0.1	/*seconds of a cell of the grid for the check of the rounding*/
+#define CELLS 		48	/*cells of a trace*/
+#define PREDICATES 	3
+#define MAX_DEPTH 	3
+#define MAX_BOUND 	8	/*cells*/
+
+// node of a random formula (the children are indices of the nodes of the formula, a child can be shared by more nodes)
+struct Node
+{
+	int type;
+	unsigned long predicate;
+	int lower, upper;	/*window, in cells*/
+	size_t first, second;
+};
+
+// values of a signal in each cell of the grid: 1 true, 0 false, -1 unknown
+typedef std::vector<int> Values;
+
+static int randomInt(int n)
+{
+	return std::rand() % n;
+}
+
+static bool isPast(int type)
+{
+	return type == MTS_ONCE || type == MTS_HISTORICALLY || type == MTS_SINCE;
+}
+
+static bool isBinary(int type)
+{
+	return type == MTS_AND || type == MTS_OR || type == MTS_UNTIL || type == MTS_SINCE;
+}
+
+/*
+ POST-CONDITIONS:
+ 	 returns the index of the root of a random formula of at most depth operators, added to nodes after its children.
+ */
+static size_t randomFormula(std::vector<Node> &nodes, int depth)
+{
+	Node node;
+	node.type = MTS_PREDICATE;
+	node.predicate = randomInt(PREDICATES);
+	node.lower = 0;
+	node.upper = 0;
+	node.first = 0;
+	node.second = 0;
+
+	if (depth > 0 && randomInt(4) != 0)
+	{
+		node.type = MTS_NOT + randomInt(MTS_SINCE);
+		node.upper = 1 + randomInt(MAX_BOUND);
+		node.lower = isPast(node.type) ? 0 : randomInt(node.upper + 1);
+		node.first = randomFormula(nodes, depth - 1);
+
+		// a repeated operand is shared by the monitor
+		if (isBinary(node.type))
+			node.second = randomInt(4) == 0 ? node.first : randomFormula(nodes, depth - 1);
+	}
+
+	nodes.push_back(node);
+	return nodes.size() - 1;
+}
+
+static void writeFormula(const std::vector<Node> &nodes, size_t i, double cell, std::vector<unsigned char> &code)
+{
+	const Node &node = nodes[i];
+	if (node.type == MTS_PREDICATE)
+	{
+		writePredicateNode(code, node.predicate);
+		return;
+	}
+
+	if (node.type == MTS_NOT || node.type == MTS_AND || node.type == MTS_OR)
+		writeOperatorNode(code, node.type);
+	else if (isPast(node.type))
+		writePastNode(code, node.type, node.upper * cell);
+	else
+		writeFutureNode(code, node.type, node.lower * cell, node.upper * cell);
+
+	writeFormula(nodes, node.first, cell, code);
+	if (isBinary(node.type))
+		writeFormula(nodes, node.second, cell, code);
+}
+
+static std::string formulaText(const std::vector<Node> &nodes, size_t i, double cell)
+{
+	static const char *names[] = {"", "NOT", "AND", "OR", "FUTURE", "GLOBALLY", "UNTIL", "ONCE", "HISTORICALLY", "SINCE"};
+	const Node &node = nodes[i];
+	std::ostringstream text;
+
+	if (node.type == MTS_PREDICATE)
+		text << "p" << node.predicate;
+	else if (node.type == MTS_NOT)
+		text << "NOT " << formulaText(nodes, node.first, cell);
+	else
+	{
+		text << "(";
+		if (isBinary(node.type))
+			text << formulaText(nodes, node.first, cell) << " ";
+		text << names[node.type];
+		if (node.type != MTS_AND && node.type != MTS_OR)
+			text << "[" << node.lower * cell << "," << node.upper * cell << "]";
+		text << " " << formulaText(nodes, isBinary(node.type) ? node.second : node.first, cell) << ")";
+	}
+	return text.str();
+}
+
+/*
+ PRE-CONDITIONS:
+ 	 dwell >= 0.
+
+ POST-CONDITIONS:
+ 	 returns the input filtered with a minimum dwell time of dwell cells: the filtered value changes to v at the beginning of a run
+ 	 of v of the input only if the run lasts at least dwell cells. The last dwell cells are unknown.
+ */
+static Values filter(const Values &input, int dwell)
+{
+	const int cells = input.size();
+	Values output(cells, -1);
+	int value = input[0];
+
+	for (int start = 0, end = 0; start < cells; start = end)
+	{
+		while (end < cells && input[end] == input[start])
+			end++;
+		if (input[start] != value && end - start >= dwell)
+			value = input[start];
+		for (int k = start; k < end && k < cells - dwell; k++)
+			output[k] = value;
+	}
+	return output;
+}
+
+/*
+ POST-CONDITIONS:
+ 	 returns true if the value of the operands is known in every cell of [from,to].
+ */
+static bool known(const Values &x, const Values &y, int from, int to)
+{
+	for (int k = from; k <= to; k++)
+		if (k >= (int)x.size() || x[k] < 0 || y[k] < 0)
+			return false;
+	return true;
+}
+
+/*
+ POST-CONDITIONS:
+ 	 returns true if x is true in every cell of [from,to).
+ */
+static bool holds(const Values &x, int from, int to)
+{
+	for (int k = from; k < to; k++)
+		if (!x[k])
+			return false;
+	return true;
+}
+
+/*
+ PRE-CONDITIONS:
+ 	 inputs contains the (filtered) values of the predicates.
+
+ POST-CONDITIONS:
+ 	 returns the values of the subformula rooted in nodes[i], evaluated in the middle of each cell.
+ */
+static Values evaluate(const std::vector<Node> &nodes, size_t i, const std::vector<Values> &inputs)
+{
+	const Node &node = nodes[i];
+	if (node.type == MTS_PREDICATE)
+		return inputs[node.predicate];
+
+	const int cells = inputs[0].size();
+	Values result(cells, -1);
+	Values x = evaluate(nodes, node.first, inputs), y;
+
+	if (node.type == MTS_NOT)
+	{
+		for (int k = 0; k < cells; k++)
+			result[k] = x[k] < 0 ? -1 : !x[k];
+		return result;
+	}
+
+	// the unary temporal operators are the binary ones with the first operand true (and GLOBALLY, HISTORICALLY complemented)
+	bool complemented = node.type == MTS_GLOBALLY || node.type == MTS_HISTORICALLY;
+	if (isBinary(node.type))
+		y = evaluate(nodes, node.second, inputs);
+	else
+	{
+		y = x;
+		x.assign(cells, 1);
+		if (complemented)
+			for (int k = 0; k < cells; k++)
+				y[k] = y[k] < 0 ? -1 : !y[k];
+	}
+
+	for (int k = 0; k < cells; k++)
+	{
+		int value = 0;
+		if (node.type == MTS_AND || node.type == MTS_OR)
+		{
+			if (!known(x, y, k, k))
+				continue;
+			value = node.type == MTS_AND ? (x[k] && y[k]) : (x[k] || y[k]);
+		}
+		else if (isPast(node.type))
+		{
+			// y in a cell j of [k - upper, k], and x from j (if j < k) to k
+			if (!known(x, y, k, k))
+				continue;
+			for (int j = k; j >= 0 && j >= k - node.upper && !value; j--)
+				value = y[j] && (j == k || holds(x, j, k + 1));
+		}
+		else
+		{
+			// y in a cell j of [k + lower, k + upper], and x from k to j (in the middle of j if j = k + lower > k)
+			if (!known(x, y, k, k + node.upper))
+				continue;
+			for (int j = k + node.lower; j <= k + node.upper && !value; j++)
+				value = y[j] && holds(x, k, (j == k + node.lower && node.lower > 0) ? j + 1 : j);
+		}
+		result[k] = complemented ? !value : value;
+	}
+	return result;
+}
+
+static TimeType middle(int k, double cell)
+{
+	return TimePolicy::fromSeconds((k + 0.5) * cell);
+}
+
+static bool contains(const Signal &signal, TimeType t)
+{
+	for (Signal::const_iterator it = signal.getBegin(); it != signal.getEnd(); it++)
+		if (it->leftLimit <= t && t < it->rightLimit)
+			return true;
+	return false;
+}
+
+// the values in the middle of each cell of the domain of evaluation, where evaluation contains the instants where the formula is
+// false
+static Values sample(const Signal &evaluation, double cell)
+{
+	Values values(CELLS, -1);
+	for (int k = 0; k < CELLS && middle(k, cell) < evaluation.getLast(); k++)
+		values[k] = !contains(evaluation, middle(k, cell));
+	return values;
+}
+
+// the end of the known values
+static std::string domain(const Values &values, double cell)
+{
+	std::ostringstream text;
+	int k = 0;
+	while (k < (int)values.size() && values[k] >= 0)
+		k++;
+	text << "up to " << k * cell;
+	return text.str();
+}
+
+// the cells where values is false, followed by the end of the known values
+static std::string intervals(const Values &values, double cell)
+{
+	std::ostringstream text;
+	for (int k = 0; k < (int)values.size() && values[k] >= 0; k++)
+	{
+		if (values[k] || (k > 0 && !values[k - 1]))
+			continue;
+		int end = k;
+		while (end < (int)values.size() && values[end] == 0)
+			end++;
+		text << "[" << k * cell << "," << end * cell << ")";
+	}
+	text << " " << domain(values, cell);
+	return text.str();
+}
+
+/*
+ POST-CONDITIONS:
+ 	 returns an empty string if the early verdicts of monitor (the instants where the formula is false for every extension of the
+ 	 trace) are false in the reference, otherwise the first instant where they are not.
+ */
+static std::string checkEarly(const Monitor &monitor, const Values &reference, double cell)
+{
+	for (int k = 0; k < CELLS; k++)
+		if (reference[k] == 1 && contains(monitor.partialEvaluation(), middle(k, cell)))
+		{
+			std::ostringstream text;
+			text << "early verdict false in " << (k + 0.5) * cell << ", where the formula is true";
+			return text.str();
+		}
+	return std::string();
+}
+
+static void feed(Monitor &monitor, bool &started, double t, const std::vector<BooleanType> &preds)
+{
+	if (started)
+		monitor.extendTrace(TimePolicy::fromSeconds(t), preds);
+	else
+		monitor.initialConditions(TimePolicy::fromSeconds(t), preds);
+	started = true;
+}
+
+/*
+ POST-CONDITIONS:
+ 	 returns true if the monitor of the random formula and trace of seed, on the grid with the given cell, agrees with the reference
+ 	 (only in the domain of the evaluation if rounded), otherwise the differences are printed.
+ */
+static bool compare(unsigned seed, double cell, bool rounded)
+{
+	std::srand(seed);
+
+	std::vector<Node> nodes;
+	size_t root = randomFormula(nodes, MAX_DEPTH);
+	std::vector<unsigned char> code;
+	writeBytecodeHeader(code);
+	writeFormula(nodes, root, cell, code);
+
+	// the predicates change with probability 1/3 in every cell; a filtered predicate has a dwell time of 1.75 or 2.75 cells (a run
+	// of the input is never as long as the dwell time, and the runs of 2 or 3 cells are long enough)
+	std::vector<Values> inputs(PREDICATES, Values(CELLS)), filtered(PREDICATES);
+	std::vector<TimeType> dwell(PREDICATES);
+	for (int p = 0; p < PREDICATES; p++)
+	{
+		int value = randomInt(2), cells = randomInt(4) < 3 ? 0 : 2 + randomInt(2);
+		for (int k = 0; k < CELLS; k++)
+		{
+			if (randomInt(3) == 0)
+				value = !value;
+			inputs[p][k] = value;
+		}
+		dwell[p] = TimePolicy::fromSeconds(cells > 0 ? (cells - 0.25) * cell : 0);
+		filtered[p] = filter(inputs[p], cells);
+	}
+	Values reference = evaluate(nodes, root, filtered);
+	bool early = randomInt(2) == 0;
+
+	std::string found, expected = rounded ? domain(reference, cell) : intervals(reference, cell), error;
+	try
+	{
+		Monitor monitor(&code[0], code.size(), early, dwell);
+		bool started = false;
+		std::vector<BooleanType> preds(PREDICATES), overridden(PREDICATES);
+
+		// the samples at the instants where no predicate changes are given with probability 1/3 (the values at the end of the
+		// trace are random)
+		for (int k = 0; k <= CELLS && error.empty(); k++)
+		{
+			bool changes = k == 0 || k == CELLS;
+			for (int p = 0; p < PREDICATES; p++)
+			{
+				preds[p] = k < CELLS ? inputs[p][k] : randomInt(2);
+				changes = changes || preds[p] != inputs[p][k - 1];
+				overridden[p] = randomInt(2);
+			}
+			if (!changes && randomInt(3) != 0)
+				continue;
+
+			if (randomInt(4) == 0)
+			{
+				feed(monitor, started, k * cell, overridden);
+				if (early && !rounded)
+					error = checkEarly(monitor, reference, cell);
+			}
+			feed(monitor, started, k * cell, preds);
+			if (early && !rounded && error.empty())
+				error = checkEarly(monitor, reference, cell);
+		}
+		Values values = sample(monitor.formulaEvaluation(), cell);
+		found = rounded ? domain(values, cell) : intervals(values, cell);
+	}
+	catch (std::exception &e)
+	{
+		found = std::string("exception: ") + e.what();
+	}
+
+	if (found == expected && error.empty())
+		return true;
+
+	std::printf("FAILED  seed %u, cell %g s%s: %s\n", seed, cell, early ? " (early verdicts)" : "", formulaText(nodes, root, cell).c_str());
+	for (int p = 0; p < PREDICATES; p++)
+	{
+		std::printf("        p%d (dwell %g): ", p, TimePolicy::toSeconds(dwell[p]));
+		for (int k = 0; k < CELLS; k++)
+			std::printf("%d", inputs[p][k]);
+		std::printf("\n");
+	}
+	if (!error.empty())
+		std::printf("        %s\n", error.c_str());
+	std::printf("        violations %s, expected %s\n", found.c_str(), expected.c_str());
+	return false;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned formulas = argc > 1 ? std::strtoul(argv[1], NULL, 10) : 10000;
+	unsigned seed = argc > 2 ? std::strtoul(argv[2], NULL, 10) : 1;
+
+	unsigned failed = 0;
+	for (unsigned i = 0; i < formulas; i++)
+	{
+		bool exact = compare(seed + i, EXACT_CELL, false);
+		bool rounded = compare(seed + i, ROUNDED_CELL, true);
+		if (!exact || !rounded)
+			failed++;
+	}
+
+	std::printf("%u formulas, %u different from the reference\n", formulas, failed);
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+// Regression checks of the monitors: each check replays a short trace that exposed a bug and compares the violations found by
+// the monitor (the intervals of Monitor::formulaEvaluation) with the expected ones.
+//
+// The program is a plain C++ program (no MATLAB needed), e.g. from the +monitor_library folder:
+//
+//	g++ -O2 -Iheaders tests/regression_check.cpp matlab/buildval.cpp misc/*.cpp validators/*.cpp -o regression_check
+//	./regression_check
+//
+// The exit status is 1 if a check fails.
+
+#include <cstdio>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "validators.h"
+#include "bytecode.h"
+
+// sample of a trace: the instant and the values of the predicates ("0" or "1" for each predicate)
+struct Sample
+{
+	double time;
+	const char *values;
+};
+
+static std::string intervals(const Signal &signal)
+{
+	std::ostringstream text;
+	for (Signal::const_iterator it = signal.getBegin(); it != signal.getEnd(); it++)
+		text << "[" << TimePolicy::toSeconds(it->leftLimit) << "," << TimePolicy::toSeconds(it->rightLimit) << ")";
+	return text.str();
+}
+
+/*
+ PRE-CONDITIONS:
+ 	 the values of every sample have one character per predicate of the formula.
+
+ POST-CONDITIONS:
+ 	 returns true if the violations of the monitor of code on the samples are expected (as written by intervals), otherwise (or if
+ 	 the monitor throws) the differences are printed.
+ */
+static bool check(const char *name, const std::vector<unsigned char> &code, const Sample *samples, size_t count,
+		const char *expected, bool early = false, const std::vector<TimeType> &dwell = std::vector<TimeType>())
+{
+	std::string found;
+	try
+	{
+		Monitor monitor(&code[0], code.size(), early, dwell);
+		for (size_t i = 0; i < count; i++)
+		{
+			std::vector<BooleanType> preds;
+			for (const char *c = samples[i].values; *c != '\0'; c++)
+				preds.push_back(*c == '1');
+
+			if (i == 0)
+				monitor.initialConditions(TimePolicy::fromSeconds(samples[i].time), preds);
+			else
+				monitor.extendTrace(TimePolicy::fromSeconds(samples[i].time), preds);
+		}
+		found = intervals(monitor.formulaEvaluation());
+	}
+	catch (std::exception &e)
+	{
+		found = std::string("exception: ") + e.what();
+	}
+
+	if (found == expected)
+	{
+		std::printf("ok      %s\n", name);
+		return true;
+	}
+	std::printf("FAILED  %s: violations %s, expected %s\n", name, found.c_str(), expected);
+	return false;
+}
+
+// ONCE[0,2] p0 with a repeated instant: the second update at 2 must not drop the extension of p0 (true on [0,1)) up to 3
+static bool onceRepeatedInstant(void)
+{
+	std::vector<unsigned char> code;
+	writeBytecodeHeader(code);
+	writePastNode(code, MTS_ONCE, 2);
+	writePredicateNode(code, 0);
+
+	const Sample samples[] = {{0, "1"}, {1, "0"}, {2, "1"}, {2, "0"}, {6, "0"}};
+	return check("ONCE with a repeated instant", code, samples, sizeof(samples)/sizeof(samples[0]), "[3,6)");
+}
+
+// (G[0,1] p0) U[0,1] (G[0,0.7] p0) with early verdicts and steps shorter than the windows: the known values of the two operands
+// end at different instants, and the partial evaluation must extend each one from its own end
+static bool untilEarlyShortSteps(void)
+{
+	std::vector<unsigned char> code;
+	writeBytecodeHeader(code);
+	writeFutureNode(code, MTS_UNTIL, 0, 1);
+	writeFutureNode(code, MTS_GLOBALLY, 0, 1);
+	writePredicateNode(code, 0);
+	writeFutureNode(code, MTS_GLOBALLY, 0, 0.7);
+	writePredicateNode(code, 0);
+
+	const Sample samples[] = {{0, "0"}, {0.1, "0"}, {0.35, "1"}, {0.5, "1"}, {1.75, "1"}, {2, "0"}, {2.25, "1"}, {3.5, "1"}};
+	return check("UNTIL with early verdicts and short steps", code, samples, sizeof(samples)/sizeof(samples[0]), "[0,0.35)[1.3,1.5)", true);
+}
+
+// p0 filtered with dwell 2 and a glitch of no duration at 2: the run of p0 true started in 1 must not restart in 2
+static bool filterRepeatedInstant(void)
+{
+	std::vector<unsigned char> code;
+	writeBytecodeHeader(code);
+	writePredicateNode(code, 0);
+
+	const Sample samples[] = {{0, "0"}, {1, "1"}, {2, "0"}, {2, "1"}, {6, "1"}};
+	return check("filtered predicate with a repeated instant", code, samples, sizeof(samples)/sizeof(samples[0]), "[0,1)", false,
+			std::vector<TimeType>(1, TimePolicy::fromSeconds(2)));
+}
+
+// p0 filtered with dwell 2, and a second update at the first instant: the filtered value starts as the value of the second one
+static bool filterFirstInstant(void)
+{
+	std::vector<unsigned char> code;
+	writeBytecodeHeader(code);
+	writePredicateNode(code, 0);
+
+	const Sample samples[] = {{0, "1"}, {0, "0"}, {1, "1"}, {2, "0"}, {5, "0"}};
+	return check("filtered predicate overridden at the first instant", code, samples, sizeof(samples)/sizeof(samples[0]), "[0,3)", false,
+			std::vector<TimeType>(1, TimePolicy::fromSeconds(2)));
+}
+
+// p0 filtered with dwell 0.5 and a run of p0 false from 0.1 that lasts exactly the dwell at 0.6: the end of the filtered values
+// (0.6 - 0.5) is rounded before the start of the run, which must not change the filtered value yet
+static bool filterRoundedDwell(void)
+{
+	std::vector<unsigned char> code;
+	writeBytecodeHeader(code);
+	writePredicateNode(code, 0);
+
+	const Sample samples[] = {{0, "1"}, {0.1, "0"}, {0.6, "0"}, {1, "0"}};
+	return check("filtered predicate with a run as long as the dwell", code, samples, sizeof(samples)/sizeof(samples[0]), "[0.1,0.5)",
+			false, std::vector<TimeType>(1, TimePolicy::fromSeconds(0.5)));
+}
+
+// (G[0.1,0.3] p0) AND (F[0.1,0.1] G[0,0.2] p0) with steps of 0.1: the operands of the and have the same latency, but the end of the
+// second one is rounded after the end of the first one
+static bool andEqualLatencies(void)
+{
+	std::vector<unsigned char> code;
+	writeBytecodeHeader(code);
+	writeOperatorNode(code, MTS_AND);
+	writeFutureNode(code, MTS_GLOBALLY, 0.1, 0.3);
+	writePredicateNode(code, 0);
+	writeFutureNode(code, MTS_FUTURE, 0.1, 0.1);
+	writeFutureNode(code, MTS_GLOBALLY, 0, 0.2);
+	writePredicateNode(code, 0);
+
+	const Sample samples[] = {{0, "1"}, {0.1, "1"}, {0.2, "0"}, {0.3, "1"}, {0.4, "1"}, {0.5, "1"}, {0.6, "0"}, {0.7, "1"}, {0.8, "1"},
+			{0.9, "1"}, {1, "0"}, {1.1, "1"}, {1.2, "1"}};
+	return check("AND of operands with equal latencies", code, samples, sizeof(samples)/sizeof(samples[0]), "[0,0.2)[0.3,0.6)[0.7,0.9)");
+}
+
+// bytecode of p0 under the given number of negations
+static std::vector<unsigned char> notChain(int negations)
+{
+	std::vector<unsigned char> code;
+	writeBytecodeHeader(code);
+	for (int i = 0; i < negations; i++)
+		writeOperatorNode(code, MTS_NOT);
+	writePredicateNode(code, 0);
+	return code;
+}
+
+// NOT chains with MTS_BYTECODE_MAX_DEPTH nodes (accepted) and with one node more (rejected by the parser)
+static bool deepBytecode(void)
+{
+	const Sample samples[] = {{0, "0"}, {1, "1"}, {2, "1"}};
+	const char *expected = (MTS_BYTECODE_MAX_DEPTH - 1) % 2 == 0 ? "[0,1)" : "[1,2)";
+
+	bool ok = check("NOT chain as deep as the bytecode allows", notChain(MTS_BYTECODE_MAX_DEPTH - 1), samples,
+			sizeof(samples)/sizeof(samples[0]), expected);
+	ok = check("NOT chain deeper than the bytecode allows", notChain(MTS_BYTECODE_MAX_DEPTH), samples, sizeof(samples)/sizeof(samples[0]),
+			"exception: The bytecode nests the nodes too deeply (see MTS_BYTECODE_MAX_DEPTH).") && ok;
+	return ok;
+}
+
+int main(void)
+{
+	bool ok = true;
+	ok = onceRepeatedInstant() && ok;
+	ok = untilEarlyShortSteps() && ok;
+	ok = filterRepeatedInstant() && ok;
+	ok = filterFirstInstant() && ok;
+	ok = filterRoundedDwell() && ok;
+	ok = andEqualLatencies() && ok;
+	ok = deepBytecode() && ok;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,736 @@
+// Streaming monitor daemon: monitors the traces sent by many concurrent clients (e.g. hardware-in-the-loop rigs or simulators that
+// are not Simulink) with the formulas of a library, and sends the violations back to each client.
+//
+// The daemon is a plain C++11 program for Linux (no MATLAB needed), e.g. from the +monitor_library folder:
+//
+//	g++ -std=c++11 -O2 -pthread -Iheaders tools/monitor_daemon.cpp matlab/buildval.cpp misc/*.cpp validators/*.cpp -o monitor_daemon
+//	./monitor_daemon [-u socket path] [-t [host:]port] [-j workers] [-e] formula1.mtsb [formula2.mtsb ...]
+//
+// The formulas are bytecode files (the output of bin.conbytecode, see resource_report.cpp). The daemon listens on a Unix-domain
+// socket (-u), on a TCP port (-t, on every interface unless a host is given) or on both. Each connection is a session with a
+// monitor per formula, fed with the samples of the client, and the violations are sent back on the same connection (see
+// stream_protocol.h for the framing). -j gives the number of worker threads (the number of cores by default), -e enables the
+// early verdict of the monitors.
+//
+// An event loop (epoll) accepts the connections and reads the frames, and a pool of worker threads runs the monitors: each session is
+// processed by one worker at a time, in the order of its frames, so the sessions are independent and scale with the workers. When a
+// session has more than maxPending bytes not yet processed, the loop stops reading its connection until a worker catches up, so
+// a client faster than the monitors is slowed down by the flow control of the socket. SIGINT and SIGTERM stop the daemon.
+
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "validators.h"
+#include "stream_protocol.h"
+
+static const size_t maxPending = 1 << 20; // bytes received and not yet processed, after which a session is not read
+static const size_t readSize = 1 << 16;
+
+static int wakeFd = -1; // eventfd of the event loop (written by the workers and by the signal handler)
+static volatile std::sig_atomic_t stopRequested = 0;
+
+// a connection and its monitors
+struct Session
+{
+	int fd;
+
+	// shared by the event loop and the workers (guarded by mutex)
+	std::mutex mutex;
+	std::vector<unsigned char> input;	// bytes received, not yet taken by a worker
+	std::vector<unsigned char> output;	// frames not yet sent
+	bool scheduled;	// whether or not the session is queued or processed by a worker
+	bool paused;	// whether or not the loop stopped reading the connection (too many bytes pending)
+	bool eof;		// whether or not the client closed the connection (or it failed)
+	bool closing;	// whether or not the session ends once its output is sent (after END or ERROR)
+	bool finished;	// whether or not the session was handed to the loop to be closed
+
+	// owned by the worker processing the session
+	std::vector<unsigned char> frames;	// bytes of the incomplete frame
+	std::vector<std::unique_ptr<Monitor> > monitors;
+	std::vector<bool> reported;
+	std::vector<BooleanType> preds;
+	size_t predicates;
+	bool ready;
+	unsigned long long samples;
+
+	explicit Session(int f): fd(f), scheduled(false), paused(false), eof(false), closing(false), finished(false),
+			predicates(0), ready(false), samples(0) {}
+};
+
+typedef std::shared_ptr<Session> SessionPtr;
+
+class Daemon
+{
+private:
+	std::vector<std::vector<unsigned char> > formulas;
+	bool earlyverdict;
+	int epollFd;
+	std::vector<int> listeners;
+	std::map<int, SessionPtr> sessions; // owned by the event loop
+
+	std::mutex queueMutex;
+	std::condition_variable queueReady;
+	std::deque<SessionPtr> queue; // sessions with frames to process
+	std::vector<SessionPtr> done; // sessions to be closed by the loop (guarded by queueMutex)
+	bool stopping;
+	std::vector<std::thread> workers;
+
+	void updateEvents(Session &session);
+	void flush(Session &session);
+	void finish(const SessionPtr &session);
+	void schedule(const SessionPtr &session);
+	void acceptConnections(int listener);
+	void readConnection(const SessionPtr &session);
+	void writeConnection(const SessionPtr &session);
+	void closeFinished(void);
+	void work(void);
+	void process(const SessionPtr &session);
+	void processFrames(Session &session, std::vector<unsigned char> &out);
+	void processSample(Session &session, const unsigned char *frame, std::vector<unsigned char> &out);
+
+public:
+	Daemon(const std::vector<std::vector<unsigned char> > &formulas, bool earlyverdict);
+	~Daemon(void);
+
+	void listenUnix(const std::string &path);
+	void listenTcp(const std::string &address);
+	void run(size_t workers);
+};
+
+static void throwSystemError(const std::string &what)
+{
+	throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+static void setNonBlocking(int fd)
+{
+	int flags = fcntl(fd, F_GETFL, 0);
+	if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+		throwSystemError("fcntl");
+}
+
+static void handleSignal(int)
+{
+	stopRequested = 1;
+	uint64_t one = 1;
+	ssize_t written = write(wakeFd, &one, sizeof(one));
+	(void)written;
+}
+
+Daemon::Daemon(const std::vector<std::vector<unsigned char> > &f, bool e)
+: formulas(f), earlyverdict(e), epollFd(-1), listeners(), sessions(), queueMutex(), queueReady(), queue(), done(),
+  stopping(false), workers()
+{
+	if (formulas.empty() || formulas.size() > 0xFFFF)
+		throw std::invalid_argument("The daemon monitors from 1 to 65535 formulas.");
+
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (epollFd < 0)
+		throwSystemError("epoll_create1");
+
+	wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (wakeFd < 0)
+		throwSystemError("eventfd");
+
+	epoll_event event;
+	event.events = EPOLLIN;
+	event.data.fd = wakeFd;
+	if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) < 0)
+		throwSystemError("epoll_ctl");
+}
+
+Daemon::~Daemon(void)
+{
+	for (std::map<int, SessionPtr>::iterator it = sessions.begin(); it != sessions.end(); it++)
+		close(it->first);
+	for (size_t i = 0; i < listeners.size(); i++)
+		close(listeners[i]);
+	close(wakeFd);
+	close(epollFd);
+}
+
+void Daemon::listenUnix(const std::string &path)
+{
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(address.sun_path))
+		throw std::invalid_argument("The socket path is too long: " + path);
+	std::strcpy(address.sun_path, path.c_str());
+
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		throwSystemError("socket");
+
+	unlink(path.c_str());
+	if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0)
+	{
+		int error = errno;
+		close(fd);
+		errno = error;
+		throwSystemError("unable to listen on " + path);
+	}
+
+	setNonBlocking(fd);
+	listeners.push_back(fd);
+}
+
+void Daemon::listenTcp(const std::string &address)
+{
+	std::string host, port = address;
+	size_t colon = address.rfind(':');
+	if (colon != std::string::npos)
+	{
+		host = address.substr(0, colon);
+		port = address.substr(colon + 1);
+	}
+
+	addrinfo hints, *result = NULL;
+	std::memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = AI_PASSIVE;
+	if (getaddrinfo(host.empty() ? NULL : host.c_str(), port.c_str(), &hints, &result) != 0 || result == NULL)
+		throw std::invalid_argument("Invalid TCP address: " + address);
+
+	int fd = socket(result->ai_family, result->ai_socktype | SOCK_CLOEXEC, result->ai_protocol);
+	int reuse = 1;
+	if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0 ||
+			bind(fd, result->ai_addr, result->ai_addrlen) < 0 || listen(fd, SOMAXCONN) < 0)
+	{
+		int error = errno;
+		freeaddrinfo(result);
+		if (fd >= 0)
+			close(fd);
+		errno = error;
+		throwSystemError("unable to listen on " + address);
+	}
+	freeaddrinfo(result);
+
+	setNonBlocking(fd);
+	listeners.push_back(fd);
+}
+
+/*
+ PRE-CONDITIONS:
+ 	 The caller holds the mutex of the session, and the connection is still registered in the epoll instance (not eof).
+
+ POST-CONDITIONS:
+ 	 The connection is polled for reading unless the session is paused or closing, and for writing if it has output pending.
+ */
+void Daemon::updateEvents(Session &session)
+{
+	epoll_event event;
+	event.events = (session.paused || session.closing ? 0u : uint32_t(EPOLLIN)) | (session.output.empty() ? 0u : uint32_t(EPOLLOUT));
+	event.data.fd = session.fd;
+	epoll_ctl(epollFd, EPOLL_CTL_MOD, session.fd, &event);
+}
+
+/*
+ PRE-CONDITIONS:
+ 	 The caller holds the mutex of the session.
+
+ POST-CONDITIONS:
+ 	 The output of the session is sent as far as the socket accepts it without blocking. If the connection failed, the output is
+ 	 discarded and the session is marked eof.
+ */
+void Daemon::flush(Session &session)
+{
+	size_t sent = 0;
+	while (sent < session.output.size())
+	{
+		ssize_t n = send(session.fd, &session.output[sent], session.output.size() - sent, MSG_NOSIGNAL);
+		if (n > 0)
+			sent += n;
+		else if (n < 0 && errno == EINTR)
+			continue;
+		else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		else
+		{
+			session.output.clear();
+			session.eof = true;
+			return;
+		}
+	}
+	session.output.erase(session.output.begin(), session.output.begin() + sent);
+}
+
+/*
+ PRE-CONDITIONS:
+ 	 The caller holds the mutex of the session.
+
+ POST-CONDITIONS:
+ 	 If the session ended (the client closed the connection, or the session is closing and its output was sent) and no worker
+ 	 processes it, the session is handed to the event loop to close the connection (once).
+ */
+void Daemon::finish(const SessionPtr &session)
+{
+	if (session->finished || session->scheduled)
+		return;
+	if (!session->eof && !(session->closing && session->output.empty()))
+		return;
+
+	session->finished = true;
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		done.push_back(session);
+	}
+	uint64_t one = 1;
+	ssize_t written = write(wakeFd, &one, sizeof(one));
+	(void)written;
+}
+
+/*
+ PRE-CONDITIONS:
+ 	 The caller holds the mutex of the session.
+ */
+void Daemon::schedule(const SessionPtr &session)
+{
+	if (session->scheduled)
+		return;
+
+	session->scheduled = true;
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		queue.push_back(session);
+	}
+	queueReady.notify_one();
+}
+
+void Daemon::acceptConnections(int listener)
+{
+	while (true)
+	{
+		int fd = accept4(listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0)
+		{
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			return; // EAGAIN, or out of descriptors (the connection waits in the backlog)
+		}
+
+		// the frames are small: they are sent as soon as they are written (no effect on Unix-domain sockets)
+		int nodelay = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+		{
+			close(fd);
+			continue;
+		}
+		sessions[fd] = SessionPtr(new Session(fd));
+	}
+}
+
+void Daemon::readConnection(const SessionPtr &session)
+{
+	unsigned char buffer[readSize];
+	std::lock_guard<std::mutex> lock(session->mutex);
+
+	while (session->input.size() < maxPending)
+	{
+		ssize_t n = recv(session->fd, buffer, sizeof(buffer), 0);
+		if (n > 0)
+		{
+			session->input.insert(session->input.end(), buffer, buffer + n);
+			continue;
+		}
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+
+		// closed by the client (or failed): the frames received are still processed, the output is discarded
+		session->eof = true;
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, session->fd, NULL);
+		break;
+	}
+
+	if (!session->eof && session->input.size() >= maxPending && !session->paused)
+	{
+		session->paused = true;
+		updateEvents(*session);
+	}
+
+	if (!session->input.empty())
+		schedule(session);
+	finish(session);
+}
+
+void Daemon::writeConnection(const SessionPtr &session)
+{
+	std::lock_guard<std::mutex> lock(session->mutex);
+	if (session->eof)
+		return;
+
+	flush(*session);
+	if (session->eof)
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, session->fd, NULL);
+	else
+		updateEvents(*session);
+	finish(session);
+}
+
+void Daemon::closeFinished(void)
+{
+	std::vector<SessionPtr> finished;
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		finished.swap(done);
+	}
+
+	for (size_t i = 0; i < finished.size(); i++)
+	{
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, finished[i]->fd, NULL);
+		close(finished[i]->fd);
+		sessions.erase(finished[i]->fd);
+	}
+}
+
+void Daemon::work(void)
+{
+	while (true)
+	{
+		SessionPtr session;
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			while (queue.empty() && !stopping)
+				queueReady.wait(lock);
+			if (queue.empty())
+				return;
+			session = queue.front();
+			queue.pop_front();
+		}
+		process(session);
+	}
+}
+
+void Daemon::process(const SessionPtr &session)
+{
+	std::vector<unsigned char> out;
+
+	while (true)
+	{
+		bool resume = false;
+		{
+			std::lock_guard<std::mutex> lock(session->mutex);
+			if (session->input.empty() || session->closing)
+			{
+				session->input.clear();
+				session->scheduled = false;
+				finish(session);
+				return;
+			}
+
+			session->frames.insert(session->frames.end(), session->input.begin(), session->input.end());
+			session->input.clear();
+			if (session->paused)
+			{
+				session->paused = false;
+				resume = true;
+			}
+			if (resume && !session->eof)
+				updateEvents(*session);
+		}
+
+		processFrames(*session, out);
+
+		if (!out.empty())
+		{
+			std::lock_guard<std::mutex> lock(session->mutex);
+			if (!session->eof)
+			{
+				session->output.insert(session->output.end(), out.begin(), out.end());
+				flush(*session);
+				if (session->eof)
+					epoll_ctl(epollFd, EPOLL_CTL_DEL, session->fd, NULL);
+				else
+					updateEvents(*session);
+			}
+			out.clear();
+		}
+	}
+}
+
+/*
+ POST-CONDITIONS:
+ 	 The complete frames in session.frames are processed and removed, their replies are appended to *out*. After an END frame or a
+ 	 malformed frame the session is closing, and the following bytes are discarded.
+ */
+void Daemon::processFrames(Session &session, std::vector<unsigned char> &out)
+{
+	const unsigned char *begin = session.frames.empty() ? NULL : &session.frames[0];
+	size_t size = session.frames.size(), pos = 0;
+	bool closing = false;
+
+	while (pos < size && !closing)
+	{
+		const unsigned char *frame = begin + pos;
+		size_t available = size - pos;
+
+		if (frame[0] == MTS_STREAM_SAMPLE && session.ready)
+		{
+			size_t length = streamSampleSize(session.predicates);
+			if (available < length)
+				break;
+			try {
+				processSample(session, frame, out);
+			}
+			catch (std::exception &e)
+			{
+				streamPutError(out, e.what());
+				closing = true;
+			}
+			pos += length;
+		}
+		else if (frame[0] == MTS_STREAM_HELLO && !session.ready)
+		{
+			if (available < 3)
+				break;
+			session.predicates = streamGetInteger(frame + 1, 2);
+			session.preds.assign(session.predicates, 0);
+			for (size_t i = 0; i < formulas.size(); i++)
+				session.monitors.push_back(std::unique_ptr<Monitor>(new Monitor(&formulas[i][0], formulas[i].size(), earlyverdict)));
+			session.reported.assign(formulas.size(), false);
+			session.ready = true;
+
+			out.push_back(MTS_STREAM_READY);
+			streamPutInteger(out, formulas.size(), 2);
+			pos += 3;
+		}
+		else if (frame[0] == MTS_STREAM_END)
+		{
+			out.push_back(MTS_STREAM_DONE);
+			streamPutInteger(out, session.samples, 8);
+			closing = true;
+			pos += 1;
+		}
+		else
+		{
+			streamPutError(out, session.ready ? "Invalid frame." : "The first frame of a session must be HELLO.");
+			closing = true;
+		}
+	}
+
+	if (closing)
+	{
+		session.frames.clear();
+		std::lock_guard<std::mutex> lock(session.mutex);
+		session.closing = true;
+	}
+	else
+		session.frames.erase(session.frames.begin(), session.frames.begin() + pos);
+}
+
+/*
+ PRE-CONDITIONS:
+ 	 *frame* is a complete SAMPLE frame of the session, after HELLO.
+
+ POST-CONDITIONS:
+ 	 The monitors of the session are extended with the sample, and a VIOLATION frame is appended to *out* for each formula found false
+ 	 for the first time.
+ */
+void Daemon::processSample(Session &session, const unsigned char *frame, std::vector<unsigned char> &out)
+{
+	const double seconds = streamGetReal(frame + 1);
+	const TimeType t = TimePolicy::fromSeconds(seconds);
+	const unsigned char *mask = frame + 9;
+	for (size_t i = 0; i < session.predicates; i++)
+		session.preds[i] = (mask[i / 8] >> (i % 8)) & 1;
+
+	for (size_t i = 0; i < session.monitors.size(); i++)
+	{
+		Monitor &monitor = *session.monitors[i];
+		if (monitor.isStarted())
+			monitor.extendTrace(t, session.preds);
+		else
+			monitor.initialConditions(t, session.preds);
+
+		if (!session.reported[i] && !monitor.checkSafety())
+		{
+			// first instant where the formula is false (the early verdicts follow the evaluated instants)
+			const Signal &evaluation = monitor.formulaEvaluation().getIntervalCount() > 0 ? monitor.formulaEvaluation()
+					: monitor.partialEvaluation();
+			double first = evaluation.getIntervalCount() > 0 ? TimePolicy::toSeconds(evaluation.getBegin()->leftLimit) : seconds;
+
+			out.push_back(MTS_STREAM_VIOLATION);
+			streamPutInteger(out, i, 2);
+			streamPutReal(out, seconds);
+			streamPutReal(out, first);
+			session.reported[i] = true;
+		}
+	}
+	session.samples++;
+}
+
+void Daemon::run(size_t count)
+{
+	for (size_t i = 0; i < listeners.size(); i++)
+	{
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.fd = listeners[i];
+		if (epoll_ctl(epollFd, EPOLL_CTL_ADD, listeners[i], &event) < 0)
+			throwSystemError("epoll_ctl");
+	}
+
+	for (size_t i = 0; i < count; i++)
+		workers.push_back(std::thread(&Daemon::work, this));
+
+	const int maxEvents = 256;
+	epoll_event events[maxEvents];
+	while (!stopRequested)
+	{
+		int n = epoll_wait(epollFd, events, maxEvents, -1);
+		if (n < 0 && errno != EINTR)
+			throwSystemError("epoll_wait");
+
+		for (int i = 0; i < n; i++)
+		{
+			int fd = events[i].data.fd;
+			if (fd == wakeFd)
+			{
+				uint64_t value;
+				ssize_t got = read(wakeFd, &value, sizeof(value));
+				(void)got;
+				closeFinished();
+				continue;
+			}
+
+			bool listener = false;
+			for (size_t j = 0; j < listeners.size(); j++)
+				if (listeners[j] == fd)
+					listener = true;
+			if (listener)
+			{
+				acceptConnections(fd);
+				continue;
+			}
+
+			std::map<int, SessionPtr>::iterator it = sessions.find(fd);
+			if (it == sessions.end())
+				continue;
+			SessionPtr session = it->second;
+			if (events[i].events & EPOLLOUT)
+				writeConnection(session);
+			if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+				readConnection(session);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		stopping = true;
+	}
+	queueReady.notify_all();
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+	workers.clear();
+}
+
+int main(int argc, char **argv)
+{
+	std::vector<std::string> unixPaths, tcpAddresses, files;
+	size_t count = std::thread::hardware_concurrency();
+	bool earlyverdict = false, usage = false;
+
+	for (int i = 1; i < argc && !usage; i++)
+	{
+		std::string arg = argv[i];
+		if ((arg == "-u" || arg == "-t" || arg == "-j") && i + 1 < argc)
+		{
+			std::string value = argv[++i];
+			if (arg == "-u")
+				unixPaths.push_back(value);
+			else if (arg == "-t")
+				tcpAddresses.push_back(value);
+			else
+				count = std::atoi(value.c_str());
+		}
+		else if (arg == "-e")
+			earlyverdict = true;
+		else if (!arg.empty() && arg[0] != '-')
+			files.push_back(arg);
+		else
+			usage = true;
+	}
+
+	if (usage || files.empty() || (unixPaths.empty() && tcpAddresses.empty()))
+	{
+		std::cerr << "usage: monitor_daemon [-u socket path] [-t [host:]port] [-j workers] [-e] <bytecode file> ..." << std::endl;
+		return 1;
+	}
+	if (count == 0)
+		count = 1;
+
+	try
+	{
+		std::vector<std::vector<unsigned char> > formulas;
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			std::ifstream file(files[i].c_str(), std::ios::binary);
+			if (!file)
+				throw std::invalid_argument("unable to open " + files[i]);
+			std::vector<unsigned char> code((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			if (code.empty())
+				throw std::invalid_argument("The bytecode file is empty: " + files[i]);
+
+			Monitor check(&code[0], code.size(), earlyverdict); // the bytecode is checked before the first session
+			formulas.push_back(code);
+		}
+
+		Daemon daemon(formulas, earlyverdict);
+		for (size_t i = 0; i < unixPaths.size(); i++)
+			daemon.listenUnix(unixPaths[i]);
+		for (size_t i = 0; i < tcpAddresses.size(); i++)
+			daemon.listenTcp(tcpAddresses[i]);
+
+		std::signal(SIGPIPE, SIG_IGN);
+		std::signal(SIGINT, handleSignal);
+		std::signal(SIGTERM, handleSignal);
+
+		std::cerr << "monitoring " << formulas.size() << " formulas with " << count << " workers" << std::endl;
+		daemon.run(count);
+
+		for (size_t i = 0; i < unixPaths.size(); i++)
+			unlink(unixPaths[i].c_str());
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << "error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,136 @@
+// Parametric evaluation of a formula on a trace file (see parametric.h and trace_file.h): prints the upper bounds of one temporal
+// operator of the formula for which the formula is never false on the trace, and the tightest one, in a single pass over the trace
+// instead of an evaluation per bound.
+//
+// The program is a plain C++ program for Linux or any POSIX system (no MATLAB needed), e.g. from the +monitor_library folder:
+//
+//	g++ -O2 -Iheaders tools/parametric_bound.cpp matlab/buildval.cpp misc/*.cpp validators/*.cpp -o parametric_bound
+//	./parametric_bound [-o operator] [-e end] [-p name1,name2,...] trace.mtst formula.mtsb
+//
+// The formula is a bytecode file (see resource_report.cpp). -o gives the designated operator, as the index of the temporal operators
+// of the formula in the order of its text (0, the first one, by default): its upper bound in the formula is ignored. The predicate
+// with index i is the i-th boolean column of the trace, or the i-th column named by -p. -e restricts the check to the instants of
+// the formula before end. The exit status is 2 if no bound satisfies the formula.
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "parametric.h"
+#include "trace_file.h"
+
+int main(int argc, char **argv)
+{
+	size_t designated = 0;
+	double end = 0;
+	bool bounded = false;
+	std::string names;
+
+	int first = 1;
+	for (; first + 1 < argc && argv[first][0] == '-'; first += 2)
+	{
+		if (std::strcmp(argv[first], "-o") == 0)
+			designated = std::strtoul(argv[first + 1], NULL, 10);
+		else if (std::strcmp(argv[first], "-e") == 0)
+		{
+			end = std::atof(argv[first + 1]);
+			bounded = true;
+		}
+		else if (std::strcmp(argv[first], "-p") == 0)
+			names = argv[first + 1];
+		else
+			break;
+	}
+
+	if (argc - first != 2)
+	{
+		std::cerr << "usage: parametric_bound [-o operator] [-e end] [-p name1,name2,...] <trace file> <bytecode file>" << std::endl;
+		return 1;
+	}
+
+	ParametricResult result;
+	try
+	{
+		TraceFile trace(argv[first]);
+
+		std::vector<size_t> predicates;
+		if (names.empty())
+		{
+			for (size_t c = 0; c < trace.columnCount(); c++)
+				if (trace.column(c).type == MTS_TRACE_BOOLEAN)
+					predicates.push_back(c);
+		}
+		else
+		{
+			std::istringstream list(names);
+			std::string name;
+			while (std::getline(list, name, ','))
+			{
+				const size_t c = trace.findColumn(name);
+				if (c == trace.columnCount() || trace.column(c).type != MTS_TRACE_BOOLEAN)
+					throw std::invalid_argument("the trace has no boolean column " + name);
+				predicates.push_back(c);
+			}
+		}
+
+		std::ifstream file(argv[first + 1], std::ios::binary);
+		if (!file)
+			throw std::invalid_argument(std::string("unable to open ") + argv[first + 1]);
+		std::vector<unsigned char> code((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		if (code.empty())
+			throw std::invalid_argument("The bytecode file is empty.");
+
+		ParametricMonitor monitor(&code[0], code.size(), designated);
+
+		// of several samples with the same instant the last one counts
+		std::vector<BooleanType> preds(predicates.size());
+		for (size_t k = 0; k < trace.chunkCount(); k++)
+		{
+			const TraceChunk &chunk = trace.chunk(k);
+			for (size_t i = 0; i < chunk.samples; i++)
+			{
+				if (i + 1 < chunk.samples && chunk.time[i + 1] == chunk.time[i])
+					continue;
+				for (size_t p = 0; p < predicates.size(); p++)
+					preds[p] = chunk.value(predicates[p], i);
+
+				const TimeType t = TimePolicy::fromSeconds(chunk.time[i]);
+				if (monitor.isStarted())
+					monitor.extendTrace(t, preds);
+				else
+					monitor.initialConditions(t, preds);
+			}
+		}
+		if (!monitor.isStarted())
+			throw std::invalid_argument("The trace is empty.");
+
+		result = bounded ? monitor.evaluate(TimePolicy::fromSeconds(end)) : monitor.evaluate();
+
+		if (!result.satisfiable)
+			std::cout << "no bound satisfies the formula" << std::endl;
+		else
+		{
+			if (result.increasing)
+				std::cout << "the formula holds for the bounds from " << result.lower << " s on";
+			else if (result.lower == result.upper)
+				std::cout << "the formula holds only for the bound " << result.lower << " s";
+			else
+				std::cout << "the formula holds for the bounds from " << result.lower << " s up to " << result.upper << " s";
+			std::cout << " (tightest bound " << result.tightest() << " s)" << std::endl;
+		}
+		if (!result.decided)
+			std::cout << "the end of the trace does not decide the bound yet: a longer trace can make it worse" << std::endl;
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << "error: " << e.what() << std::endl;
+		return 1;
+	}
+	return result.satisfiable ? 0 : 2;
+}
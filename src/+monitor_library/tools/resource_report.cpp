@@ -0,0 +1,64 @@
+// Static resource analysis of a monitor (see Monitor::analyzeResources): prints, for each node of the monitor of a formula, the
+// worst-case number of intervals stored and visited per step, and the totals (memory and verdict latency).
+//
+// The program is a plain C++ program (no MATLAB needed), e.g. from the +monitor_library folder:
+//
+//	g++ -O2 -Iheaders tools/resource_report.cpp matlab/buildval.cpp misc/*.cpp validators/*.cpp -o resource_report
+//	./resource_report formula.mtsb 0.1 [0.01] [-e]
+//
+// The arguments are the bytecode of the formula (a file containing the output of bin.conbytecode, e.g. written in MATLAB with
+// fwrite(fopen('formula.mtsb','w'), bin.conbytecode(syntaxtree))), the minimum time (seconds) a predicate keeps its value, the
+// longest simulation step (seconds, the dwell time if not given) and -e to account the early verdict.
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "validators.h"
+
+int main(int argc, char **argv)
+{
+	bool earlyverdict = argc > 1 && std::strcmp(argv[argc - 1], "-e") == 0;
+	int args = earlyverdict ? argc - 1 : argc;
+
+	if (args < 3 || args > 4)
+	{
+		std::cerr << "usage: resource_report <bytecode file> <min dwell time> [max step] [-e]" << std::endl;
+		return 1;
+	}
+
+	std::ifstream file(argv[1], std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "unable to open " << argv[1] << std::endl;
+		return 1;
+	}
+	std::vector<unsigned char> code((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	const double dwell = std::atof(argv[2]);
+	const double step = args > 3 ? std::atof(argv[3]) : dwell;
+
+	try
+	{
+		if (code.empty())
+			throw std::invalid_argument("The bytecode file is empty.");
+
+		Monitor monitor(&code[0], code.size(), earlyverdict);
+		ResourceReport report = monitor.analyzeResources(ResourceAssumptions(dwell, step));
+
+		std::cout << "min dwell time: " << dwell << " s, max step: " << step << " s"
+				  << (earlyverdict ? ", early verdict" : "") << std::endl << std::endl;
+		report.print(std::cout);
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << "error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
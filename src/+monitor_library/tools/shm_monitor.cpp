@@ -0,0 +1,167 @@
+// Monitor of a trace written in shared memory by a co-located process (see shm_ring.h): prints the violations of the formulas of a
+// library while the producer runs, without copies of the samples or system calls in steady state.
+//
+// The program is a plain C++ program for Linux or any POSIX system (no MATLAB needed), e.g. from the +monitor_library folder:
+//
+//	gcc -c -O2 -Iheaders misc/shm_ring.c -o shm_ring.o
+//	g++ -O2 -Iheaders tools/shm_monitor.cpp shm_ring.o matlab/buildval.cpp misc/*.cpp validators/*.cpp -o shm_monitor
+//	./shm_monitor [-e] /mts_rig1 formula1.mtsb [formula2.mtsb ...]
+//
+// The arguments are the name of the shared memory object created by the producer with mts_ring_create (the monitor waits for it
+// up to 10 seconds), the bytecode files of the formulas (see resource_report.cpp) and -e to enable the early verdict. The samples
+// are read in batches: every sample written since the last batch is given to the monitors in place, then the whole batch is
+// released to the producer at once. When the ring is empty the monitor spins, then yields, then sleeps 50 microseconds at a
+// time, so that an idle producer costs little. A stale ring left by a crashed producer is replaced by the next producer, and the
+// monitor follows the new ring. At the end of the trace (mts_ring_finish) the monitor removes the shared memory
+// object and prints, for each formula, whether it was violated; the exit status is 2 if a formula was violated.
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include <sched.h>
+
+#include "validators.h"
+#include "shm_ring.h"
+
+static const int idleSpins = 1000; // empty polls before yielding
+static const int idleYields = 100; // yields before sleeping
+
+static void sleepMicroseconds(long microseconds)
+{
+	timespec duration;
+	duration.tv_sec = 0;
+	duration.tv_nsec = microseconds * 1000;
+	nanosleep(&duration, NULL);
+}
+
+static mts_ring* waitRing(const char *name)
+{
+	for (int attempt = 0; attempt < 1000; attempt++)
+	{
+		mts_ring *ring = mts_ring_open(name);
+		if (ring != NULL)
+			return ring;
+		sleepMicroseconds(10000);
+	}
+	throw std::runtime_error(std::string("unable to open the ring ") + name);
+}
+
+int main(int argc, char **argv)
+{
+	bool earlyverdict = argc > 1 && std::strcmp(argv[1], "-e") == 0;
+	int first = earlyverdict ? 2 : 1;
+
+	if (argc - first < 2)
+	{
+		std::cerr << "usage: shm_monitor [-e] <shared memory name> <bytecode file> ..." << std::endl;
+		return 1;
+	}
+
+	mts_ring *ring = NULL;
+	std::vector<Monitor*> monitors;
+	bool violated = false;
+
+	try
+	{
+		for (int i = first + 1; i < argc; i++)
+		{
+			std::ifstream file(argv[i], std::ios::binary);
+			if (!file)
+				throw std::invalid_argument(std::string("unable to open ") + argv[i]);
+			std::vector<unsigned char> code((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			if (code.empty())
+				throw std::invalid_argument(std::string("The bytecode file is empty: ") + argv[i]);
+			monitors.push_back(new Monitor(&code[0], code.size(), earlyverdict));
+		}
+
+		const char *name = argv[first];
+		ring = waitRing(name);
+
+		std::vector<BooleanType> preds(mts_ring_predicates(ring));
+		std::vector<bool> reported(monitors.size(), false);
+		unsigned long long samples = 0;
+		int idle = 0;
+
+		while (true)
+		{
+			size_t batch = mts_ring_available(ring);
+			if (batch == 0)
+			{
+				// the end flag is written after the last sample: the ring is checked again once the flag is seen
+				const int state = mts_ring_finished(ring);
+				if (state != MTS_RING_RUNNING && mts_ring_available(ring) == 0)
+				{
+					if (state == MTS_RING_FINISHED)
+						break;
+
+					// a stale ring (e.g. of a crashed producer) is replaced by the new producer before its first sample
+					if (samples > 0)
+						throw std::runtime_error("The ring was replaced by a new producer before the end of the trace.");
+					mts_ring_close(ring);
+					ring = waitRing(name);
+					preds.resize(mts_ring_predicates(ring));
+					continue;
+				}
+
+				idle++;
+				if (idle > idleSpins + idleYields)
+					sleepMicroseconds(50);
+				else if (idle > idleSpins)
+					sched_yield();
+				continue;
+			}
+			idle = 0;
+
+			for (size_t s = 0; s < batch; s++)
+			{
+				const unsigned char *slot = mts_ring_slot(ring, s);
+				const double seconds = mts_ring_slot_time(slot);
+				for (unsigned p = 0; p < preds.size(); p++)
+					preds[p] = mts_ring_slot_value(slot, p);
+
+				for (size_t i = 0; i < monitors.size(); i++)
+				{
+					if (monitors[i]->isStarted())
+						monitors[i]->extendTrace(TimePolicy::fromSeconds(seconds), preds);
+					else
+						monitors[i]->initialConditions(TimePolicy::fromSeconds(seconds), preds);
+
+					if (!reported[i] && !monitors[i]->checkSafety())
+					{
+						std::cout << "formula " << i << " violated (sample at " << seconds << " s)" << std::endl;
+						reported[i] = true;
+						violated = true;
+					}
+				}
+			}
+			mts_ring_release(ring, batch);
+			samples += batch;
+		}
+
+		mts_ring_close(ring);
+		ring = NULL;
+		mts_ring_unlink(name);
+
+		std::cout << samples << " samples" << std::endl;
+		for (size_t i = 0; i < monitors.size(); i++)
+			std::cout << "formula " << i << ": " << (reported[i] ? "violated" : "satisfied") << std::endl;
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << "error: " << e.what() << std::endl;
+		mts_ring_close(ring);
+		for (size_t i = 0; i < monitors.size(); i++)
+			delete monitors[i];
+		return 1;
+	}
+
+	for (size_t i = 0; i < monitors.size(); i++)
+		delete monitors[i];
+	return violated ? 2 : 0;
+}
@@ -0,0 +1,231 @@
+// Converter of recorded traces to trace files (see trace_file.h), the columnar format read in place by trace_monitor.cpp and by
+// the Python package (see python/mtsmonitor/trace.py).
+//
+// The program is a plain C++11 program for Linux or any POSIX system (no MATLAB needed), e.g. from the +monitor_library folder:
+//
+//	g++ -std=c++11 -O2 -Iheaders tools/trace_convert.cpp misc/trace_file.cpp -o trace_convert
+//	./trace_convert [-c chunk samples] [-f csv|stream] input output.mtst
+//
+// Two inputs are read:
+//	* csv: a text file with a header row of column names, then one row per sample. The first column is the instant (seconds, non
+//	  decreasing). A column whose values are all 0, 1, true or false is stored as a boolean column (e.g. a predicate), any other
+//	  column as a real column.
+//	* stream: the capture of a session of the monitor daemon, i.e. the bytes sent by a client (HELLO, SAMPLE frames and END, see
+//	  stream_protocol.h), e.g. recorded from a rig with socat or tee. The predicates become the boolean columns p0, p1, ...
+// The input is csv if its name ends with .csv, stream otherwise, unless -f is given. -c gives the samples per chunk (65536 by
+// default): smaller chunks make the seeks finer and the parallel decode more balanced.
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "stream_protocol.h"
+#include "trace_file.h"
+
+static std::vector<std::string> splitRow(const std::string &line)
+{
+	std::vector<std::string> fields;
+	std::string field;
+	std::istringstream row(line);
+	while (std::getline(row, field, ','))
+	{
+		const size_t begin = field.find_first_not_of(" \t\r\"");
+		const size_t end = field.find_last_not_of(" \t\r\"");
+		fields.push_back(begin == std::string::npos ? std::string() : field.substr(begin, end - begin + 1));
+	}
+	if (!line.empty() && line[line.size() - 1] == ',')
+		fields.push_back(std::string());
+	return fields;
+}
+
+// returns 0 or 1 for a boolean value (0, 1, true or false, in any case), -1 otherwise
+static int booleanValue(const std::string &text)
+{
+	std::string lower(text);
+	for (size_t i = 0; i < lower.size(); i++)
+		lower[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(lower[i])));
+	if (lower == "0" || lower == "false")
+		return 0;
+	if (lower == "1" || lower == "true")
+		return 1;
+	return -1;
+}
+
+static double realValue(const std::string &text, size_t line)
+{
+	char *end = NULL;
+	errno = 0;
+	const double value = std::strtod(text.c_str(), &end);
+	if (text.empty() || *end != '\0' || errno == ERANGE)
+		throw std::invalid_argument("line " + std::to_string(line) + ": not a number: '" + text + "'");
+	return value;
+}
+
+static bool blank(const std::string &line)
+{
+	return line.find_first_not_of(" \t\r") == std::string::npos;
+}
+
+// converts a CSV file in two passes: the first one checks the rows and finds the type of each column, the second one writes them
+static unsigned long long convertCsv(const char *input, const char *output, size_t chunkSamples)
+{
+	std::ifstream file(input);
+	if (!file)
+		throw std::runtime_error(std::string("unable to open ") + input);
+
+	std::string line;
+	size_t number = 0;
+	while (std::getline(file, line) && blank(line))
+		number++;
+	number++;
+	const std::vector<std::string> names = splitRow(line);
+	if (names.size() < 2)
+		throw std::invalid_argument("the header must name the time column and at least one other column");
+
+	std::vector<TraceColumn> columns;
+	for (size_t c = 1; c < names.size(); c++)
+		columns.push_back(TraceColumn(names[c], MTS_TRACE_BOOLEAN));
+
+	const size_t header = number;
+	while (std::getline(file, line))
+	{
+		number++;
+		if (blank(line))
+			continue;
+		const std::vector<std::string> fields = splitRow(line);
+		if (fields.size() != names.size())
+			throw std::invalid_argument("line " + std::to_string(number) + ": expected " + std::to_string(names.size()) + " values");
+		for (size_t c = 1; c < fields.size(); c++)
+			if (columns[c - 1].type == MTS_TRACE_BOOLEAN && booleanValue(fields[c]) < 0)
+			{
+				realValue(fields[c], number);
+				columns[c - 1].type = MTS_TRACE_REAL;
+			}
+	}
+
+	file.clear();
+	file.seekg(0);
+	for (number = 0; number < header; number++)
+		std::getline(file, line);
+
+	TraceWriter writer(output, columns, chunkSamples);
+	std::vector<double> values(columns.size());
+	unsigned long long samples = 0;
+	double last = 0;
+	while (std::getline(file, line))
+	{
+		number++;
+		if (blank(line))
+			continue;
+		const std::vector<std::string> fields = splitRow(line);
+		const double t = realValue(fields[0], number);
+		if (samples > 0 && !(t >= last))
+			throw std::invalid_argument("line " + std::to_string(number) + ": the instants must be non decreasing");
+		for (size_t c = 1; c < fields.size(); c++)
+			values[c - 1] = columns[c - 1].type == MTS_TRACE_BOOLEAN ? booleanValue(fields[c]) : realValue(fields[c], number);
+		writer.append(t, &values[0]);
+		last = t;
+		samples++;
+	}
+	writer.close();
+	return samples;
+}
+
+// converts the capture of a client stream of the monitor daemon (the frames after END are ignored)
+static unsigned long long convertStream(const char *input, const char *output, size_t chunkSamples)
+{
+	std::ifstream file(input, std::ios::binary);
+	if (!file)
+		throw std::runtime_error(std::string("unable to open ") + input);
+	const std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	if (bytes.size() < 3 || bytes[0] != MTS_STREAM_HELLO)
+		throw std::invalid_argument("the capture does not begin with a HELLO frame");
+	const size_t predicates = streamGetInteger(&bytes[1], 2);
+	const size_t sampleSize = streamSampleSize(predicates);
+
+	std::vector<TraceColumn> columns;
+	for (size_t p = 0; p < predicates; p++)
+		columns.push_back(TraceColumn("p" + std::to_string(p), MTS_TRACE_BOOLEAN));
+
+	TraceWriter writer(output, columns, chunkSamples);
+	std::vector<double> values(predicates);
+	unsigned long long samples = 0;
+	double last = 0;
+	size_t position = 3;
+	while (position < bytes.size() && bytes[position] != MTS_STREAM_END)
+	{
+		if (bytes[position] != MTS_STREAM_SAMPLE)
+			throw std::invalid_argument("unexpected frame at byte " + std::to_string(position) + " of the capture");
+		if (bytes.size() - position < sampleSize)
+			throw std::invalid_argument("the capture ends within a SAMPLE frame");
+
+		const unsigned char *frame = &bytes[position];
+		const double t = streamGetReal(frame + 1);
+		if (samples > 0 && !(t > last))
+			throw std::invalid_argument("the instants of the capture must be increasing");
+		for (size_t p = 0; p < predicates; p++)
+			values[p] = (frame[9 + p / 8] >> (p % 8)) & 1;
+		writer.append(t, predicates > 0 ? &values[0] : NULL);
+		last = t;
+		samples++;
+		position += sampleSize;
+	}
+	if (position == bytes.size())
+		std::cerr << "warning: the capture has no END frame (the session was interrupted)" << std::endl;
+	writer.close();
+	return samples;
+}
+
+int main(int argc, char **argv)
+{
+	size_t chunkSamples = 65536;
+	std::string format;
+	int first = 1;
+	for (; first + 1 < argc && argv[first][0] == '-'; first += 2)
+	{
+		if (std::strcmp(argv[first], "-c") == 0)
+			chunkSamples = std::strtoul(argv[first + 1], NULL, 10);
+		else if (std::strcmp(argv[first], "-f") == 0)
+			format = argv[first + 1];
+		else
+			break;
+	}
+
+	if (argc - first != 2 || (!format.empty() && format != "csv" && format != "stream"))
+	{
+		std::cerr << "usage: trace_convert [-c chunk samples] [-f csv|stream] <input> <output trace file>" << std::endl;
+		return 1;
+	}
+
+	const std::string input = argv[first];
+	if (format.empty())
+		format = input.size() >= 4 && input.compare(input.size() - 4, 4, ".csv") == 0 ? "csv" : "stream";
+
+	try
+	{
+		const unsigned long long samples = format == "csv" ? convertCsv(argv[first], argv[first + 1], chunkSamples) :
+				convertStream(argv[first], argv[first + 1], chunkSamples);
+
+		TraceFile trace(argv[first + 1]);
+		std::cout << samples << " samples, " << trace.columnCount() << " columns (";
+		for (size_t c = 0; c < trace.columnCount(); c++)
+			std::cout << (c > 0 ? ", " : "") << trace.column(c).name
+					  << (trace.column(c).type == MTS_TRACE_BOOLEAN ? " boolean" : " real");
+		std::cout << "), " << trace.chunkCount() << " chunks" << std::endl;
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << "error: " << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
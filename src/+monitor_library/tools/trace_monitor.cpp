@@ -0,0 +1,328 @@
+// Monitor of a trace file (see trace_file.h, written e.g. by trace_convert.cpp): prints the intervals where the formulas of a
+// library are false on the whole trace or on a range of instants.
+//
+// The program is a plain C++11 program for Linux or any POSIX system (no MATLAB needed), e.g. from the +monitor_library folder:
+//
+//	g++ -std=c++11 -O2 -pthread -Iheaders tools/trace_monitor.cpp matlab/buildval.cpp misc/*.cpp validators/*.cpp -o trace_monitor
+//	./trace_monitor [-s start] [-e end] [-p name1,name2,...] [-j workers] [-v] trace.mtst formula1.mtsb [formula2.mtsb ...]
+//
+// The formulas are bytecode files (see resource_report.cpp). The predicate with index i is the i-th boolean column of the trace,
+// or the i-th column named by -p. -s and -e restrict the trace to the samples with instants in [start, end]: the chunks out of the
+// range are found with the index of the file and never read. -v enables the early verdict of the monitors.
+//
+// The file is read in place through a memory map. The chunks are decoded in parallel by -j worker threads (the number of cores by
+// default): a worker finds the samples where some predicate changes, a word of 64 samples at a time, and the main thread gives
+// only those samples (and the last one) to the monitors, in the order of the trace. Of several samples with the same instant, the
+// last one counts. The exit status is 2 if a formula was violated.
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "trace_file.h"
+#include "validators.h"
+
+// samples of a chunk given to the monitors: their instants and the values of the predicates, one row per sample
+struct DecodedChunk
+{
+	size_t index;
+	bool ready;
+	std::vector<double> time;
+	std::vector<BooleanType> values;
+
+	DecodedChunk(void): index(0), ready(false) {}
+};
+
+// decodes the chunks of a range with a pool of workers, at most slots.size() chunks ahead of the consumer
+class ChunkDecoder
+{
+private:
+	const TraceFile &trace;
+	const std::vector<size_t> &predicates; // column of each predicate
+	const double start, end;
+	size_t last; // first chunk out of the range
+	size_t next, consumed;
+	std::vector<DecodedChunk> slots;
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable changed;
+
+	void decode(size_t k, DecodedChunk &out) const;
+	void work(void);
+
+public:
+	ChunkDecoder(const TraceFile &, const std::vector<size_t> &, double, double, unsigned);
+	~ChunkDecoder(void);
+
+	bool pop(DecodedChunk &);
+};
+
+ChunkDecoder::ChunkDecoder(const TraceFile &t, const std::vector<size_t> &p, double s, double e, unsigned threads)
+:trace(t),predicates(p),start(s),end(e),last(t.chunkCount()),next(t.findChunk(s)),consumed(next),slots(2 * threads)
+{
+	// the range ends before the first chunk whose first instant is greater than end
+	last = trace.findChunk(end);
+	if (last < trace.chunkCount() && trace.chunk(last).first <= end)
+		last++;
+	if (next > last)
+		next = consumed = last;
+	for (unsigned i = 0; i < threads; i++)
+		workers.push_back(std::thread(&ChunkDecoder::work, this));
+}
+
+ChunkDecoder::~ChunkDecoder(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		next = last; // no more chunks are taken
+	}
+	changed.notify_all();
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+}
+
+// returns the first sample from *from* marked in the words *change*, or *stop* if there is none before stop
+static size_t nextChange(const std::vector<UInt64Type> &change, size_t from, size_t stop)
+{
+	size_t w = from / 64;
+	if (w >= change.size())
+		return stop;
+	UInt64Type mask = change[w] & (~static_cast<UInt64Type>(0) << (from % 64));
+	while (mask == 0)
+	{
+		if (++w >= change.size())
+			return stop;
+		mask = change[w];
+	}
+	const size_t i = w * 64 + __builtin_ctzll(mask);
+	return i < stop ? i : stop;
+}
+
+/*
+ POST-CONDITIONS:
+ 	 out holds the samples of the chunk k in [start, end] that are the last of their instant and where some predicate changed since
+ 	 the previous sample given (the first sample of the chunk counts as changed), and the last sample of the chunk in the range.
+ */
+void ChunkDecoder::decode(size_t k, DecodedChunk &out) const
+{
+	const TraceChunk &chunk = trace.chunk(k);
+	const size_t n = chunk.samples, words = (n + 63) / 64;
+
+	size_t begin = 0, stop = n;
+	while (begin < n && chunk.time[begin] < start)
+		begin++;
+	while (stop > begin && chunk.time[stop - 1] > end)
+		stop--;
+
+	out.time.clear();
+	out.values.clear();
+	if (begin == stop)
+		return;
+
+	std::vector<UInt64Type> change(words, 0);
+	for (size_t p = 0; p < predicates.size(); p++)
+	{
+		const UInt64Type *bits = chunk.bits(predicates[p]);
+		UInt64Type carry = bits[0] & 1;
+		for (size_t w = 0; w < words; w++)
+		{
+			change[w] |= bits[w] ^ ((bits[w] << 1) | carry);
+			carry = bits[w] >> 63;
+		}
+	}
+	change[begin / 64] |= static_cast<UInt64Type>(1) << (begin % 64);
+
+	for (size_t i = nextChange(change, begin, stop); i < stop; i = nextChange(change, i + 1, stop))
+	{
+		// the last sample of the instant of i
+		while (i + 1 < stop && chunk.time[i + 1] == chunk.time[i])
+			i++;
+		out.time.push_back(chunk.time[i]);
+		for (size_t p = 0; p < predicates.size(); p++)
+			out.values.push_back(chunk.value(predicates[p], i));
+	}
+
+	if (out.time.back() != chunk.time[stop - 1])
+	{
+		out.time.push_back(chunk.time[stop - 1]);
+		for (size_t p = 0; p < predicates.size(); p++)
+			out.values.push_back(chunk.value(predicates[p], stop - 1));
+	}
+}
+
+void ChunkDecoder::work(void)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		changed.wait(lock, [this] {return next >= last || next - consumed < slots.size();});
+		if (next >= last)
+			return;
+
+		const size_t k = next++;
+		DecodedChunk decoded;
+		decoded.index = k;
+		lock.unlock();
+		decode(k, decoded);
+		lock.lock();
+
+		DecodedChunk &slot = slots[k % slots.size()];
+		slot.time.swap(decoded.time);
+		slot.values.swap(decoded.values);
+		slot.index = k;
+		slot.ready = true;
+		changed.notify_all();
+	}
+}
+
+// takes the next chunk of the range, in order: returns false after the last one
+bool ChunkDecoder::pop(DecodedChunk &out)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (consumed >= last)
+		return false;
+
+	DecodedChunk &slot = slots[consumed % slots.size()];
+	changed.wait(lock, [&] {return slot.ready && slot.index == consumed;});
+	out.time.swap(slot.time);
+	out.values.swap(slot.values);
+	slot.ready = false;
+	consumed++;
+	changed.notify_all();
+	return true;
+}
+
+static void extend(std::vector<Monitor*> &monitors, double seconds, const std::vector<BooleanType> &preds)
+{
+	const TimeType t = TimePolicy::fromSeconds(seconds);
+	for (size_t i = 0; i < monitors.size(); i++)
+	{
+		if (monitors[i]->isStarted())
+			monitors[i]->extendTrace(t, preds);
+		else
+			monitors[i]->initialConditions(t, preds);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	double start = -std::numeric_limits<double>::infinity(), end = std::numeric_limits<double>::infinity();
+	std::string names;
+	unsigned threads = std::thread::hardware_concurrency();
+	bool earlyverdict = false;
+
+	int first = 1;
+	for (; first < argc && argv[first][0] == '-'; first++)
+	{
+		if (std::strcmp(argv[first], "-v") == 0)
+			earlyverdict = true;
+		else if (first + 1 < argc && std::strcmp(argv[first], "-s") == 0)
+			start = std::atof(argv[++first]);
+		else if (first + 1 < argc && std::strcmp(argv[first], "-e") == 0)
+			end = std::atof(argv[++first]);
+		else if (first + 1 < argc && std::strcmp(argv[first], "-p") == 0)
+			names = argv[++first];
+		else if (first + 1 < argc && std::strcmp(argv[first], "-j") == 0)
+			threads = std::atoi(argv[++first]);
+		else
+			break;
+	}
+
+	if (argc - first < 2 || (first < argc && argv[first][0] == '-'))
+	{
+		std::cerr << "usage: trace_monitor [-s start] [-e end] [-p name1,name2,...] [-j workers] [-v] <trace file> <bytecode file> ..."
+				  << std::endl;
+		return 1;
+	}
+	if (threads == 0)
+		threads = 1;
+
+	std::vector<Monitor*> monitors;
+	bool violated = false;
+
+	try
+	{
+		TraceFile trace(argv[first]);
+
+		std::vector<size_t> predicates;
+		if (names.empty())
+		{
+			for (size_t c = 0; c < trace.columnCount(); c++)
+				if (trace.column(c).type == MTS_TRACE_BOOLEAN)
+					predicates.push_back(c);
+		}
+		else
+		{
+			std::istringstream list(names);
+			std::string name;
+			while (std::getline(list, name, ','))
+			{
+				const size_t c = trace.findColumn(name);
+				if (c == trace.columnCount())
+					throw std::invalid_argument("the trace has no column " + name);
+				if (trace.column(c).type != MTS_TRACE_BOOLEAN)
+					throw std::invalid_argument("the column " + name + " is not boolean");
+				predicates.push_back(c);
+			}
+		}
+
+		for (int i = first + 1; i < argc; i++)
+		{
+			std::ifstream file(argv[i], std::ios::binary);
+			if (!file)
+				throw std::invalid_argument(std::string("unable to open ") + argv[i]);
+			std::vector<unsigned char> code((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			if (code.empty())
+				throw std::invalid_argument(std::string("The bytecode file is empty: ") + argv[i]);
+			monitors.push_back(new Monitor(&code[0], code.size(), earlyverdict));
+		}
+
+		ChunkDecoder decoder(trace, predicates, start, end, threads);
+		DecodedChunk chunk;
+		std::vector<BooleanType> preds(predicates.size());
+		unsigned long long samples = 0;
+
+		while (decoder.pop(chunk))
+			for (size_t s = 0; s < chunk.time.size(); s++, samples++)
+			{
+				std::copy(chunk.values.begin() + s * preds.size(), chunk.values.begin() + (s + 1) * preds.size(), preds.begin());
+				extend(monitors, chunk.time[s], preds);
+			}
+
+		std::cout << samples << " samples given to the monitors" << std::endl;
+		for (size_t i = 0; i < monitors.size(); i++)
+		{
+			const Signal &evaluation = monitors[i]->formulaEvaluation();
+			violated = violated || !monitors[i]->checkSafety();
+			std::cout << "formula " << i << ": " << (monitors[i]->checkSafety() ? "satisfied" : "violated");
+			if (monitors[i]->isStarted())
+				std::cout << " (evaluated up to " << TimePolicy::toSeconds(evaluation.getLast()) << " s)";
+			std::cout << std::endl;
+			for (Signal::const_iterator it = evaluation.getBegin(); it != evaluation.getEnd(); it++)
+				std::cout << "\tfalse in [" << TimePolicy::toSeconds(it->leftLimit) << ", "
+						  << TimePolicy::toSeconds(it->rightLimit) << ")" << std::endl;
+		}
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << "error: " << e.what() << std::endl;
+		for (size_t i = 0; i < monitors.size(); i++)
+			delete monitors[i];
+		return 1;
+	}
+
+	for (size_t i = 0; i < monitors.size(); i++)
+		delete monitors[i];
+	return violated ? 2 : 0;
+}
@@ -6,25 +6,108 @@
 
 BooleanValidatorNode::BooleanValidatorNode(bool value)
 :state(value), lastUpdateTime(),
- currentUpdateTime(),computedValues(0.0,0.0)
+ currentUpdateTime(),computedValues(0.0,0.0),
+ partialValues(0.0,0.0),
+ savedLastUpdateTime(), savedCurrentUpdateTime()
  {}
 
-void BooleanValidatorNode::start(RealType ts, const std::vector<BooleanType> &preds)
+void BooleanValidatorNode::start(TimeType ts, const std::vector<BooleanType> &preds)
 {
 	currentUpdateTime = ts;
 	lastUpdateTime = ts;
 	computedValues.reset(ts,ts);
+	partialValues.reset(ts,ts);
 }
 
-void BooleanValidatorNode::update(RealType t, const std::vector<BooleanType> &preds)
+void BooleanValidatorNode::update(TimeType t, const std::vector<BooleanType> &preds)
 {
 	if(t < currentUpdateTime)
 		throw std::invalid_argument("Input time-step must be greater then or equal to the last input time-step.");
 
+	UpdateProbe probe(*this);
 	lastUpdateTime = currentUpdateTime;
 	currentUpdateTime = t;
 
 	computedValues.reset(lastUpdateTime,currentUpdateTime);
 	if (state)
 		computedValues.addInterval(lastUpdateTime,currentUpdateTime);
+
+	countOutput(computedValues);
+	countStored(computedValues.getIntervalCount());
+}
+
+void BooleanValidatorNode::evaluatePartial(void)
+{
+	// every instant before the last update time has already been evaluated
+	partialValues.reset(currentUpdateTime,currentUpdateTime);
+}
+
+double BooleanValidatorNode::analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate)
+{
+	// the values of a step are a single interval (or none)
+	NodeResources node(label(), depth);
+	node.span = assumptions.step;
+	node.intervals = assumptions.partial ? 2 : 1;
+	node.operations = 1;
+	report.nodes.push_back(node);
+
+	if (preallocate)
+	{
+		computedValues.reserve(1);
+		partialValues.reserve(1);
+	}
+	return 0;
+}
+
+std::string BooleanValidatorNode::label(void) const
+{
+	return state ? "TRUE" : "FALSE";
+}
+
+void BooleanValidatorNode::collectStats(std::vector<NodeStats> &stats, unsigned depth)
+{
+	stats.push_back(NodeStats(label(), depth));
+	exportStats(stats.back());
+}
+
+void BooleanValidatorNode::saveState(StateWriter &writer)
+{
+	writer.writeTag(STATE_BOOLEAN);
+	writer.writeSize(state);
+	writer.writeTime(lastUpdateTime);
+	writer.writeTime(currentUpdateTime);
+	writer.writeSignal(computedValues);
+	writer.writeSignal(partialValues);
+}
+
+void BooleanValidatorNode::restoreState(StateReader &reader)
+{
+	reader.checkTag(STATE_BOOLEAN);
+	reader.checkSize(state);
+	lastUpdateTime = reader.readTime();
+	currentUpdateTime = reader.readTime();
+	reader.readSignal(computedValues);
+	reader.readSignal(partialValues);
+}
+
+void BooleanValidatorNode::checkpoint(void)
+{
+	savedLastUpdateTime = lastUpdateTime;
+	savedCurrentUpdateTime = currentUpdateTime;
+	computedValues.checkpoint();
+	partialValues.checkpoint();
+}
+
+void BooleanValidatorNode::commit(void)
+{
+	computedValues.commit();
+	partialValues.commit();
+}
+
+void BooleanValidatorNode::rollback(void)
+{
+	lastUpdateTime = savedLastUpdateTime;
+	currentUpdateTime = savedCurrentUpdateTime;
+	computedValues.rollback();
+	partialValues.rollback();
 }
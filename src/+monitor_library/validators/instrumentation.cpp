@@ -0,0 +1,62 @@
+#include <iomanip>
+
+#include "instrumentation.h"
+
+#ifdef MTS_INSTRUMENTATION
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/**
+ \brief returns the time (seconds) of a monotonic clock, used to measure the updates of the nodes.
+ */
+double instrumentationClock(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return double(counter.QuadPart) / double(frequency.QuadPart);
+#else
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+}
+
+/**
+ \brief copies the counters into the statistics of the node.
+ */
+void NodeCounters::exportStats(NodeStats &stats) const
+{
+	stats.updates = updates;
+	stats.intervalsIn = intervalsIn;
+	stats.intervalsOut = intervalsOut;
+	stats.peakIntervals = peakIntervals;
+	stats.updateSeconds = updateSeconds;
+	stats.allocations = allocations;
+}
+#endif
+
+/**
+ \brief prints a table with the statistics of each node (indented by depth), e.g. the ones returned by Monitor::statistics.
+ */
+void printStatistics(std::ostream &out, const std::vector<NodeStats> &stats)
+{
+	out << std::left << std::setw(48) << "node" << std::right
+		<< std::setw(10) << "updates" << std::setw(12) << "in" << std::setw(12) << "out"
+		<< std::setw(8) << "peak" << std::setw(12) << "time (ms)" << std::setw(8) << "allocs" << std::endl;
+
+	for (std::vector<NodeStats>::const_iterator it = stats.begin(); it != stats.end(); it++)
+	{
+		std::string label = std::string(2 * it->depth, ' ') + it->label;
+		out << std::left << std::setw(48) << label << std::right
+			<< std::setw(10) << it->updates << std::setw(12) << it->intervalsIn << std::setw(12) << it->intervalsOut
+			<< std::setw(8) << it->peakIntervals << std::setw(12) << std::fixed << std::setprecision(3) << it->updateSeconds * 1e3
+			<< std::setw(8) << it->allocations << std::endl;
+	}
+	out.unsetf(std::ios::fixed);
+	out << std::setprecision(6);
+}
@@ -1,10 +1,25 @@
+#include <stdexcept>
+
 #include "validators.h"
-#include "mex.h"
 
 
-Monitor::Monitor(const mxArray *formulatree):formula(NULL),evaluation(0,0),isstarted(false)
+#ifdef MATLAB_MEX_FILE
+Monitor::Monitor(const mxArray *formulatree, bool early, const std::vector<TimeType> &dwell)
+:formula(NULL),evaluation(0,0),isstarted(false),
+ earlyverdict(early),earlyviolation(false),
+ speculating(false),savedstarted(false),savedearlyviolation(false)
+{
+	ValidatorNode *f_ptr = buildValidator(formulatree, dwell);
+	formula = new NotValidatorNode(*f_ptr);
+}
+#endif
+
+Monitor::Monitor(const unsigned char *code, size_t length, bool early, const std::vector<TimeType> &dwell)
+:formula(NULL),evaluation(0,0),isstarted(false),
+ earlyverdict(early),earlyviolation(false),
+ speculating(false),savedstarted(false),savedearlyviolation(false)
 {
-	ValidatorNode *f_ptr = buildValidator(formulatree);
+	ValidatorNode *f_ptr = buildValidator(code, length, dwell);
 	formula = new NotValidatorNode(*f_ptr);
 }
 
@@ -13,15 +28,161 @@ Monitor::~Monitor()
 	delete formula;
 }
 
-void Monitor::initialConditions(RealType ts, const std::vector<BooleanType> &preds)
+void Monitor::initialConditions(TimeType ts, const std::vector<BooleanType> &preds)
 {
 	formula->start(ts,preds);
 	evaluation.reset(ts,ts);
+	earlyviolation = false;
 	isstarted = true;
 }
 
-void Monitor::extendTrace(RealType ts, const std::vector<BooleanType> &preds)
+void Monitor::extendTrace(TimeType ts, const std::vector<BooleanType> &preds)
 {
 	formula->update(ts,preds);
-	evaluation.append(formula->getValues());
+
+	// evaluation keeps the instants where the formula is false, i.e. where its negation (formula) is true
+	if (formula->isNegated())
+		appendComplement(evaluation, formula->getValues(), RT_ZERO);
+	else
+		evaluation.append(formula->getValues());
+
+	// checking the instants that can not be evaluated yet (formula is the negation of the monitored formula)
+	if (earlyverdict)
+	{
+		formula->evaluatePartial();
+		if (formula->getPartialTrue().getIntervalCount() > 0)
+			earlyviolation = true;
+	}
+}
+
+/**
+ \brief Bound the resources used by the monitor (see ValidatorNode::analyzeResources).
+ \param assumptions minimum dwell time of the predicates and longest step of the trace (the partial evaluation is accounted if
+ the monitor was created with *earlyverdict* equal to true).
+ \param preallocate if true, the signals of the nodes reserve the storage for their worst-case number of intervals.
+ \returns the worst-case resources of each node, and the verdict latency of the formula.
+ \exception std::invalid_argument if the dwell time or the step is not greater than zero.
+
+ The values of the formula kept by formulaEvaluation are not accounted: they grow with the number of violations.
+ */
+ResourceReport Monitor::analyzeResources(const ResourceAssumptions &assumptions, bool preallocate)
+{
+	if (!(assumptions.dwell > 0) || !(assumptions.step > 0))
+		throw std::invalid_argument("analyzeResources: The dwell time and the step must be greater than zero.");
+
+	ResourceReport report;
+	formula->analyzeResources(ResourceAssumptions(assumptions.dwell, assumptions.step, earlyverdict), report, 0, preallocate);
+	report.latency = TimePolicy::toSeconds(formula->minTime());
+	return report;
+}
+
+/**
+ \brief returns the statistics of the nodes of the monitor (see NodeStats), in pre-order.
+ The first entry is the negation added by the monitor to the formula. Without the macro MTS_INSTRUMENTATION (see isInstrumented)
+ the entries only describe the tree of the monitor, and their counters are zero.
+ */
+std::vector<NodeStats> Monitor::statistics(void)
+{
+	std::vector<NodeStats> stats;
+	formula->collectStats(stats, 0);
+	return stats;
+}
+
+/**
+ \brief returns a snapshot of the state of the monitor (see state.h).
+ The snapshot can be restored by restoreState on any monitor of the same formula (e.g. a fresh one), to continue the trace from
+ the instant of the snapshot.
+ \exception std::logic_error if the monitor is extended tentatively (see speculate).
+ */
+std::vector<unsigned char> Monitor::saveState(void)
+{
+	if (speculating)
+		throw std::logic_error("saveState: The monitor has a tentative extension, commit or rollback it first.");
+
+	std::vector<unsigned char> bytes;
+	StateWriter writer(bytes);
+
+	writer.writeBool(isstarted);
+	writer.writeBool(earlyviolation);
+	writer.writeSignal(evaluation);
+	formula->saveState(writer);
+	return bytes;
+}
+
+/**
+ \brief restores the state of the monitor from a snapshot returned by saveState.
+ \param data, length the bytes of the snapshot.
+ \exception std::invalid_argument if the snapshot is not valid or it was taken from a monitor of another formula. In that case
+ the state of the monitor is undefined, and the monitor must not be used.
+
+ A tentative extension of the trace (see speculate) is discarded.
+ */
+void Monitor::restoreState(const unsigned char *data, size_t length)
+{
+	if (speculating)
+		rollback();
+
+	StateReader reader(data, length);
+
+	isstarted = reader.readBool();
+	earlyviolation = reader.readBool();
+	reader.readSignal(evaluation);
+	formula->restoreState(reader);
+	reader.finish();
+}
+
+/**
+ \brief Begin a tentative extension of the trace.
+
+ The state of the monitor is recorded: the following calls of initialConditions and extendTrace (and the violations they find) are
+ undone by rollback, or made definitive by commit. A rollback costs as much as the intervals changed by the tentative calls, and
+ it also undoes a call that failed with an exception. This allows to extend the trace to trial instants of a variable-step solver,
+ which are not necessarily increasing: after the rollback the trace can be extended again from the last definitive instant.
+ \exception std::logic_error if the monitor is already extended tentatively.
+ */
+void Monitor::speculate(void)
+{
+	if (speculating)
+		throw std::logic_error("speculate: The monitor has already a tentative extension.");
+
+	savedstarted = isstarted;
+	savedearlyviolation = earlyviolation;
+	evaluation.checkpoint();
+	formula->checkpoint();
+	speculating = true;
+}
+
+/**
+ \brief Make definitive the extension of the trace after the last call of speculate.
+ \exception std::logic_error if the monitor is not extended tentatively.
+ */
+void Monitor::commit(void)
+{
+	if (!speculating)
+		throw std::logic_error("commit: The monitor has no tentative extension.");
+
+	evaluation.commit();
+	formula->commit();
+	speculating = false;
+}
+
+/**
+ \brief Undo the extension of the trace after the last call of speculate.
+ \exception std::logic_error if the monitor is not extended tentatively.
+ */
+void Monitor::rollback(void)
+{
+	if (!speculating)
+		throw std::logic_error("rollback: The monitor has no tentative extension.");
+
+	isstarted = savedstarted;
+	earlyviolation = savedearlyviolation;
+	evaluation.rollback();
+	formula->rollback();
+	speculating = false;
+}
+
+const Signal& Monitor::partialEvaluation(void) const
+{
+	return formula->getPartialTrue();
 }
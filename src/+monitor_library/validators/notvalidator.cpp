@@ -5,46 +5,86 @@
 #include "validators.h"
 
 
-NotValidatorNode::NotValidatorNode(ValidatorNode &c):child(&c), computedValues(0.0,0.0)
+NotValidatorNode::NotValidatorNode(ValidatorNode &c):child(&c)
 {
 	mintime = child->minTime();
 }
 
-void NotValidatorNode::start(RealType ts, const std::vector<BooleanType> &preds)
+void NotValidatorNode::start(TimeType ts, const std::vector<BooleanType> &preds)
 {
-	computedValues.reset(ts,ts);
 	child->start(ts,preds);
 }
 
-void NotValidatorNode::update(RealType t, const std::vector<BooleanType> &preds)
+void NotValidatorNode::update(TimeType t, const std::vector<BooleanType> &preds)
 {
+	// the values of *this* are the values of the child, with the opposite polarity (see isNegated)
 	child->update(t,preds);
-	const Signal &s=child->getValues();
+}
+
+void NotValidatorNode::evaluatePartial(void)
+{
+	// the known values of *this* are the known values of the child, swapped (see getPartialTrue and getPartialFalse)
+	child->evaluatePartial();
+}
+
+double NotValidatorNode::analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate)
+{
+	std::vector<NodeResources>::size_type entry = report.nodes.size();
+	report.nodes.push_back(NodeResources(label(), depth));
 
-	RealType first = s.getFirst();
-	RealType last = s.getLast();
+	// the negation has the same changes of the child, and it stores nothing (the values and the partial values are the ones of
+	// the child)
+	double rate = child->analyzeResources(assumptions, report, depth + 1, preallocate);
+
+	NodeResources &node = report.nodes[entry];
+	node.rate = rate;
+	node.span = 0;
+	node.intervals = 0;
+	node.operations = 0;
+	return rate;
+}
+
+
+
+std::string NotValidatorNode::label(void) const
+{
+	return "NOT";
+}
 
-	computedValues.reset(first,last);
+void NotValidatorNode::collectStats(std::vector<NodeStats> &stats, unsigned depth)
+{
+	stats.push_back(NodeStats(label(), depth));
+	exportStats(stats.back());
 
-	// get iterator on first and last elements (which behaviors are not undefined since there are elements in the signal)
-	Signal::const_iterator it = s.getBegin(), end = s.getEnd();
+	child->collectStats(stats, depth + 1);
+}
 
-	// first element in the signal domain
-	RealType it_right = first;
+void NotValidatorNode::saveState(StateWriter &writer)
+{
+	writer.writeTag(STATE_NOT);
+	child->saveState(writer);
+}
 
-	// first element in the first interval
-	RealType it_left = first;
+void NotValidatorNode::restoreState(StateReader &reader)
+{
+	reader.checkTag(STATE_NOT);
+	child->restoreState(reader);
+}
 
-	while(it != end){
-		it_left = it->leftLimit;
-		computedValues.addInterval(it_right,it_left);
-		it_right = it->rightLimit;
-		it++;
-	}
-	computedValues.addInterval(it_right,last);
+void NotValidatorNode::checkpoint(void)
+{
+	child->checkpoint();
 }
 
+void NotValidatorNode::commit(void)
+{
+	child->commit();
+}
 
+void NotValidatorNode::rollback(void)
+{
+	child->rollback();
+}
 
 NotValidatorNode::~NotValidatorNode(void)
 {
@@ -4,70 +4,11 @@
 #include "misc.h"
 #include "validators.h"
 
-static void computeUnion(const Signal &signal1,const Signal &signal2,Signal &computedvalues)
-{
-	Signal::const_iterator it1 = signal1.getBegin(), end1 = signal1.getEnd();
-	Signal::const_iterator it2= signal2.getBegin(), end2 = signal2.getEnd();
-
-	RealType first = std::min(signal1.getFirst(), signal2.getFirst());
-	RealType last = std::min(signal1.getLast(), signal2.getLast());
-	computedvalues.reset(first, last);
-
-	while(it1 != end1 && it2 != end2){
-		Interval i1 = *it1;
-		Interval i2 = *it2;
-		Interval add = i1;
-
-		if(i1.rightLimit <= i2.rightLimit){
-			add = i1;
-			it1++;
-		}
-		else{
-			add = i2;
-			it2++;
-		}
-
-		if (add.leftLimit > last)
-			return;
-
-		if (add.rightLimit > last)
-			add.rightLimit = last;
-
-		computedvalues.addInterval(add.leftLimit,add.rightLimit);
-	}
-
-	while(it1!=end1){
-		Interval add = *it1;
-
-		if (add.leftLimit > last)
-			return;
-
-		if (add.rightLimit > last)
-			add.rightLimit = last;
-
-		computedvalues.addInterval(add.leftLimit,add.rightLimit);
-		it1++;
-	}
-
-	while(it2!=end2){
-		Interval add = *it2;
-
-		if (add.leftLimit > last)
-			return;
-
-		if (add.rightLimit > last)
-			add.rightLimit = last;
-
-		computedvalues.addInterval(add.leftLimit,add.rightLimit);
-		it2++;
-	}
-}
-
-
-
-OrValidatorNode::OrValidatorNode (ValidatorNode &child1, ValidatorNode &child2): buffer(0.0,0.0), computedValues(0.0,0.0)
+OrValidatorNode::OrValidatorNode (ValidatorNode &child1, ValidatorNode &child2)
+: buffer(0.0,0.0), horizon(0.0), savedhorizon(0.0), negated(child1.isNegated() || child2.isNegated()), computedValues(0.0,0.0),
+  partialTrue(0.0,0.0), partialFalse(0.0,0.0)
 	{
-		RealType fmt = child1.minTime(), smt = child2.minTime();
+		TimeType fmt = child1.minTime(), smt = child2.minTime();
 
 		if (fmt <= smt)
 		{
@@ -83,10 +24,11 @@ OrValidatorNode::OrValidatorNode (ValidatorNode &child1, ValidatorNode &child2):
 		}
 	}
 
-void OrValidatorNode::start(RealType ts, const std::vector<BooleanType> &preds)
+void OrValidatorNode::start(TimeType ts, const std::vector<BooleanType> &preds)
 {
 	 // setting  the state of the object
 	 buffer.reset(ts,ts);
+	 horizon = ts;
 	 computedValues.reset(ts,ts);
 
 	 // calls on the recursive structure (starting the whole sub-tree)
@@ -94,27 +36,196 @@ void OrValidatorNode::start(RealType ts, const std::vector<BooleanType> &preds)
 	 secondchild->start(ts,preds);
 }
 
-void OrValidatorNode::update(RealType t, const std::vector<BooleanType> &preds)
+void OrValidatorNode::update(TimeType t, const std::vector<BooleanType> &preds)
 {
-	// function calls on the recursive structure (updating the whole sub-tree)
+	// function calls on the recursive structure (updating the whole sub-tree): the first child is updated first, so that the
+	// second one can skip the instants where the first one is already true (the or is true there, whatever the second child is)
 	firstchild->update(t,preds);
+	buffer.append(firstchild -> getValues());
+
+	TimeType needed = std::max(horizon, computedValues.getLast());
+	Signal::const_iterator it = buffer.getIntervalFrom(needed);
+	if (!firstchild->isNegated())
+	{
+		if (it != buffer.getEnd() && it->leftLimit <= needed)
+			needed = it->rightLimit;
+	}
+	else if (needed < buffer.getLast() && (it == buffer.getEnd() || it->leftLimit > needed))
+	{
+		// the buffer holds the false instants of the first child: it is true up to the next one
+		needed = (it == buffer.getEnd()) ? buffer.getLast() : it->leftLimit;
+	}
+	secondchild->skipBefore(needed);
 	secondchild->update(t,preds);
 
+	UpdateProbe probe(*this);
 	const Signal &s1 = firstchild -> getValues();
-	const Signal &s2 = secondchild -> getValues();
-
-	// update of the buffer's values
-	buffer.append(s1);
+	const Signal *s2 = &secondchild -> getValues();
+	countInput(s1);
+	countInput(*s2);
+
+	// the latency of the second child is not less than the one of the first child, but with equal latencies the second child can
+	// end after the buffer by a rounding error: its values after the buffer are not combined, so its next values begin after the
+	// buffer and the instants in between (mapped to 0) are added, to keep the values of the or contiguous
+	Signal widened(0.0,0.0);
+	if (s2->getFirst() > buffer.getFirst())
+	{
+		widened.reset(buffer.getFirst(), s2->getFirst());
+		widened.append(*s2);
+		s2 = &widened;
+	}
 
-	// computing union between buffer and the second child computed signal
-	computeUnion(buffer, s2, computedValues);
+	// combining the buffer with the values of the second child: the union of the true instants if no child is negated, otherwise
+	// the false instants of the or, i.e. the instants where both children are false (see isNegated)
+	if (!firstchild->isNegated() && !secondchild->isNegated())
+		computeUnion(buffer, *s2, computedValues);
+	else if (firstchild->isNegated() && secondchild->isNegated())
+		computeIntersection(buffer, *s2, computedValues);
+	else if (firstchild->isNegated())
+		computeDifference(buffer, *s2, computedValues);
+	else
+		computeDifference(*s2, buffer, computedValues);
 
 	// increasing the buffer first domain (decreasing the buffer actual size)
-	RealType buffstart = computedValues.getLast();
+	TimeType buffstart = computedValues.getLast();
 	buffer.increaseFirst(buffstart);
+
+	countOutput(computedValues);
+	countStored(buffer.getIntervalCount() + computedValues.getIntervalCount());
 }
 
+void OrValidatorNode::evaluatePartial(void)
+{
+	firstchild->evaluatePartial();
+	secondchild->evaluatePartial();
+
+	// known values of the first child: the buffer followed by its partial evaluation (the buffer holds the false instants if the
+	// first child is negated)
+	Signal true1(0.0,0.0), false1(0.0,0.0);
+	if (firstchild->isNegated())
+		computeKnownValues(buffer, firstchild->getPartialFalse(), firstchild->getPartialTrue(), false1, true1);
+	else
+		computeKnownValues(buffer, firstchild->getPartialTrue(), firstchild->getPartialFalse(), true1, false1);
+
+	// the or is known to be true if at least one child is, and known to be false if both are
+	computeUnion(true1, secondchild->getPartialTrue(), partialTrue);
+	computeIntersection(false1, secondchild->getPartialFalse(), partialFalse);
+}
 
+void OrValidatorNode::skipBefore(TimeType t)
+{
+	horizon = std::max(horizon, t);
+	firstchild->skipBefore(horizon);
+}
+
+double OrValidatorNode::analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate)
+{
+	std::vector<NodeResources>::size_type entry = report.nodes.size();
+	report.nodes.push_back(NodeResources(label(), depth));
+
+	double rate1 = firstchild->analyzeResources(assumptions, report, depth + 1, preallocate);
+	double rate2 = secondchild->analyzeResources(assumptions, report, depth + 1, preallocate);
+	double rate = rate1 + rate2;
+
+	// the buffer keeps the values of the first child (the one with the smaller delay) not yet available for the second one
+	double bufferlength = TimePolicy::toSeconds(mintime - firstchild->minTime()) + assumptions.step;
+	double partiallength = TimePolicy::toSeconds(mintime) + assumptions.step;
+
+	size_t bufferintervals = worstCaseIntervals(rate1, bufferlength);
+	size_t computedintervals = worstCaseIntervals(rate, assumptions.step);
+	size_t partialintervals = assumptions.partial ? worstCaseIntervals(rate, partiallength) : 0;
+
+	NodeResources &node = report.nodes[entry];
+	node.rate = rate;
+	node.span = assumptions.partial ? std::max(bufferlength, partiallength) : bufferlength;
+	node.intervals = bufferintervals + computedintervals + 2 * partialintervals;
+	node.operations = bufferintervals + worstCaseIntervals(rate2, assumptions.step) + computedintervals;
+
+	if (preallocate)
+	{
+		buffer.reserve(bufferintervals);
+		computedValues.reserve(computedintervals);
+		partialTrue.reserve(partialintervals);
+		partialFalse.reserve(partialintervals);
+	}
+	return rate;
+}
+
+
+std::string OrValidatorNode::label(void) const
+{
+	return "OR";
+}
+
+void OrValidatorNode::collectStats(std::vector<NodeStats> &stats, unsigned depth)
+{
+	stats.push_back(NodeStats(label(), depth));
+	exportStats(stats.back());
+
+	firstchild->collectStats(stats, depth + 1);
+	secondchild->collectStats(stats, depth + 1);
+}
+
+void OrValidatorNode::saveState(StateWriter &writer)
+{
+	writer.writeTag(STATE_OR);
+	writer.writeSignal(buffer);
+	writer.writeTime(horizon);
+	writer.writeSignal(computedValues);
+	writer.writeSignal(partialTrue);
+	writer.writeSignal(partialFalse);
+
+	firstchild->saveState(writer);
+	secondchild->saveState(writer);
+}
+
+void OrValidatorNode::restoreState(StateReader &reader)
+{
+	reader.checkTag(STATE_OR);
+	reader.readSignal(buffer);
+	horizon = reader.readTime();
+	reader.readSignal(computedValues);
+	reader.readSignal(partialTrue);
+	reader.readSignal(partialFalse);
+
+	firstchild->restoreState(reader);
+	secondchild->restoreState(reader);
+}
+
+void OrValidatorNode::checkpoint(void)
+{
+	savedhorizon = horizon;
+	buffer.checkpoint();
+	computedValues.checkpoint();
+	partialTrue.checkpoint();
+	partialFalse.checkpoint();
+
+	firstchild->checkpoint();
+	secondchild->checkpoint();
+}
+
+void OrValidatorNode::commit(void)
+{
+	buffer.commit();
+	computedValues.commit();
+	partialTrue.commit();
+	partialFalse.commit();
+
+	firstchild->commit();
+	secondchild->commit();
+}
+
+void OrValidatorNode::rollback(void)
+{
+	horizon = savedhorizon;
+	buffer.rollback();
+	computedValues.rollback();
+	partialTrue.rollback();
+	partialFalse.rollback();
+
+	firstchild->rollback();
+	secondchild->rollback();
+}
 
 OrValidatorNode::~OrValidatorNode(void)
 {
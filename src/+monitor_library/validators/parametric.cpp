@@ -0,0 +1,374 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "parametric.h"
+#include "bytecode.h"
+
+// kinds of the steps of the path to the designated operator, besides MTS_NOT, MTS_AND and MTS_OR
+#define MTS_FUTURE_WINDOW 	MTS_GLOBALLY 	// the operand is required in [t+lower, t+upper]
+#define MTS_PAST_WINDOW 	MTS_HISTORICALLY 	// the operand is required in [t-upper, t]
+
+static bool isTemporal(int nodetype)
+{
+	return nodetype == MTS_FUTURE || nodetype == MTS_GLOBALLY || nodetype == MTS_UNTIL ||
+			nodetype == MTS_ONCE || nodetype == MTS_HISTORICALLY || nodetype == MTS_SINCE;
+}
+
+/*
+ POST-CONDITIONS:
+ 	 Returns true if the temporal operator with index *designated* (counting from *count*, in pre-order) is in the tree of *node*, in
+ 	 which case path holds the nodes from *node* to it. count is increased by the temporal operators visited.
+ */
+static bool findDesignated(const BytecodeNode *node, size_t designated, size_t &count, std::vector<const BytecodeNode*> &path)
+{
+	path.push_back(node);
+	if (isTemporal(node->nodetype) && count++ == designated)
+		return true;
+	if ((node->firstchild != NULL && findDesignated(node->firstchild, designated, count, path)) ||
+			(node->secondchild != NULL && findDesignated(node->secondchild, designated, count, path)))
+		return true;
+	path.pop_back();
+	return false;
+}
+
+// builds the node of the sub-formula of *node*, from its own bytecode
+static ValidatorNode* buildSubformula(const BytecodeNode *node, const std::vector<TimeType> &dwell)
+{
+	std::vector<unsigned char> code(MTS_BYTECODE_MAGIC, MTS_BYTECODE_MAGIC + 4);
+	code.push_back(MTS_BYTECODE_VERSION);
+	code.insert(code.end(), node->begin, node->end);
+	return buildValidator(&code[0], code.size(), dwell);
+}
+
+// appends the instants of the last update of *node* where it is true to values (see ValidatorNode::isNegated)
+static void appendValues(Signal &values, const ValidatorNode &node)
+{
+	if (node.isNegated())
+		appendComplement(values, node.getValues(), RT_ZERO);
+	else
+		values.append(node.getValues());
+}
+
+/*
+ POST-CONDITIONS:
+ 	 out holds the instants u such that some instant t of *in* has u in [t+lower, t+upper], u not less than origin. The domain of out
+ 	 is the domain of *in* moved in the same way (the instants of out near its end may be missing, as the ones of *in* after its domain).
+ */
+static void computeWindow(const Signal &in, TimeType lower, TimeType upper, TimeType origin, Signal &out)
+{
+	const TimeType first = std::max(in.getFirst() + lower, origin);
+	out.reset(first, std::max(first, in.getLast() + upper));
+	for (Signal::const_iterator it = in.getBegin(); it != in.getEnd(); it++)
+		out.addInterval(std::max(it->leftLimit + lower, first), it->rightLimit + upper);
+}
+
+/**
+ \brief Build the parametric monitor of the temporal operator with index *designated* (in pre-order) of the formula of a bytecode.
+ \param dwell minimum dwell time of each predicate (see Monitor).
+ \exception std::invalid_argument if the bytecode is not valid, if the formula has less than designated+1 temporal operators, or if
+ the designated operator or the path to it are not supported (see ParametricMonitor).
+ */
+ParametricMonitor::ParametricMonitor(const unsigned char *code, size_t length, size_t index, const std::vector<TimeType> &dwell)
+:steps(),operand(NULL),operandValues(0,0),designated(0),lowerbound(0),required(true),isstarted(false),startTime(0),lastTime(0)
+{
+	std::deque<BytecodeNode> nodes;
+	std::vector<const BytecodeNode*> path;
+	size_t count = 0;
+
+	const BytecodeNode *root = parseBytecode(code, length, nodes);
+	if (!findDesignated(root, index, count, path))
+		throw std::invalid_argument("ParametricMonitor: The formula does not have the designated temporal operator.");
+
+	const BytecodeNode *target = path.back();
+	designated = target->nodetype;
+	if (designated != MTS_FUTURE && designated != MTS_GLOBALLY && designated != MTS_ONCE && designated != MTS_HISTORICALLY)
+		throw std::invalid_argument("ParametricMonitor: The designated operator must be FUTURE, GLOBALLY, ONCE or HISTORICALLY.");
+
+	try
+	{
+		for (size_t i = 0; i + 1 < path.size(); i++)
+		{
+			const BytecodeNode *node = path[i];
+			Step *step = NULL;
+
+			if (node->nodetype == MTS_NOT)
+			{
+				step = new Step(MTS_NOT);
+				required = !required;
+			}
+			else if (node->nodetype == MTS_AND || node->nodetype == MTS_OR)
+			{
+				step = new Step(node->nodetype);
+				steps.push_back(step);
+				step->side = buildSubformula(node->firstchild == path[i + 1] ? node->secondchild : node->firstchild, dwell);
+				step->holds = required;
+				continue;
+			}
+			else if ((node->nodetype == MTS_GLOBALLY && required) || (node->nodetype == MTS_FUTURE && !required))
+			{
+				step = new Step(MTS_FUTURE_WINDOW);
+				step->lower = TimePolicy::fromSeconds(node->lowerbound);
+				step->upper = TimePolicy::fromSeconds(node->alpha);
+			}
+			else if ((node->nodetype == MTS_HISTORICALLY && required) || (node->nodetype == MTS_ONCE && !required))
+			{
+				step = new Step(MTS_PAST_WINDOW);
+				step->upper = TimePolicy::fromSeconds(node->alpha);
+			}
+			else
+				throw std::invalid_argument("ParametricMonitor: The operators above the designated one must be NOT, AND, OR, GLOBALLY or "
+						"HISTORICALLY (FUTURE or ONCE under a negation).");
+			steps.push_back(step);
+		}
+
+		lowerbound = TimePolicy::fromSeconds(target->lowerbound);
+		operand = buildSubformula(target->firstchild, dwell);
+	}
+	catch (...)
+	{
+		for (size_t i = 0; i < steps.size(); i++)
+		{
+			delete steps[i]->side;
+			delete steps[i];
+		}
+		throw;
+	}
+}
+
+ParametricMonitor::~ParametricMonitor(void)
+{
+	for (size_t i = 0; i < steps.size(); i++)
+	{
+		delete steps[i]->side;
+		delete steps[i];
+	}
+	delete operand;
+}
+
+void ParametricMonitor::initialConditions(TimeType ts, const std::vector<BooleanType> &preds)
+{
+	for (size_t i = 0; i < steps.size(); i++)
+		if (steps[i]->side != NULL)
+		{
+			steps[i]->side->start(ts, preds);
+			steps[i]->values.reset(ts, ts);
+		}
+	operand->start(ts, preds);
+	operandValues.reset(ts, ts);
+
+	startTime = lastTime = ts;
+	isstarted = true;
+}
+
+void ParametricMonitor::extendTrace(TimeType t, const std::vector<BooleanType> &preds)
+{
+	if (!isstarted)
+		throw std::logic_error("ParametricMonitor: initialConditions must be invoked before extendTrace.");
+
+	for (size_t i = 0; i < steps.size(); i++)
+		if (steps[i]->side != NULL)
+		{
+			steps[i]->side->update(t, preds);
+			appendValues(steps[i]->values, *steps[i]->side);
+		}
+	operand->update(t, preds);
+	appendValues(operandValues, *operand);
+	lastTime = t;
+}
+
+/**
+ \brief returns the set of bounds of the designated operator for which the formula is never false on the trace so far.
+ \exception std::logic_error if the monitor is not started.
+
+ As for Monitor, the instants of the formula whose value depends on instants after the end of the trace are not checked, and the
+ result is not decided (see ParametricResult::decided) if the operand of the designated operator is not known yet after such an
+ instant.
+ */
+ParametricResult ParametricMonitor::evaluate(void) const
+{
+	return evaluate(lastTime);
+}
+
+/**
+ \brief returns the set of bounds of the designated operator for which the formula is never false on the trace so far, in the
+ instants before *end*.
+ \exception std::logic_error if the monitor is not started.
+ */
+ParametricResult ParametricMonitor::evaluate(TimeType end) const
+{
+	if (!isstarted)
+		throw std::logic_error("ParametricMonitor: initialConditions must be invoked before evaluate.");
+
+	// instants where the operand of each step (from the root) must be true (or false, under a negation)
+	const TimeType last = std::max(startTime, std::min(lastTime, end));
+	Signal instants(startTime, last), buffer(0, 0), complement(0, 0);
+	instants.addInterval(startTime, last);
+
+	ParametricResult result;
+	for (size_t i = 0; i < steps.size(); i++)
+	{
+		const Step &step = *steps[i];
+		switch (step.kind)
+		{
+		case MTS_AND:
+		case MTS_OR:
+			// where the formula must hold, a conjunction needs both operands and a disjunction needs the operand on the path where
+			// the other one is false (dually where it must be false): elsewhere the other operand alone decides the formula
+			computeComplement(step.values, complement);
+			computeIntersection(instants, step.holds ? complement : step.values, buffer);
+			if ((step.kind == MTS_AND) == step.holds)
+			{
+				if (buffer.getIntervalCount() > 0)
+					result.satisfiable = false;
+			}
+			else
+				instants = buffer;
+			break;
+
+		case MTS_FUTURE_WINDOW:
+			computeWindow(instants, step.lower, step.upper, startTime, buffer);
+			instants = buffer;
+			break;
+
+		case MTS_PAST_WINDOW:
+			computeWindow(instants, -step.upper, RT_ZERO, startTime, buffer);
+			instants = buffer;
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	scan(instants, operandValues, result);
+	return result;
+}
+
+/*
+ POST-CONDITIONS:
+ 	 result holds the bounds of the designated operator that satisfy it (or falsify it, if *required* is false) in every instant of
+ 	 *instants*, given the values of its operand.
+
+ 	 For an instant t let next(t) be the first instant from t+lowerbound where the operand is true (F), or false (G), and let last(t)
+ 	 be the last instant up to t where the operand is true (O) or false (H). The operator in t is decided by the bound alpha as
+ 	 follows (every bound decides the instants where next or last exist):
+ 	 	 * F[a,alpha] is true and G[a,alpha] is false if and only if alpha >= next(t) - t.
+ 	 	 * O[alpha] is true and H[alpha] is false if and only if alpha >= t - last(t).
+ 	 Hence the operator is satisfied by the bounds from threshold(t) = next(t) - t (t - last(t)) on, or by the bounds below it,
+ 	 and the set of bounds is found from the greatest, or the least, threshold of the instants. The least threshold is reached only
+ 	 in the instants where the event happens (t + lowerbound for F and G, t for O and H), which no bound avoids; elsewhere it is the
+ 	 limit of thresholds greater than it, or one that the bound must exceed (O and H, last(t) being the right-open end of an event),
+ 	 so that the bounds avoiding every event are the ones up to it, included.
+ */
+void ParametricMonitor::scan(const Signal &instants, const Signal &values, ParametricResult &result) const
+{
+	const bool future = designated == MTS_FUTURE || designated == MTS_GLOBALLY;
+	const bool onTrue = designated == MTS_FUTURE || designated == MTS_ONCE;
+	const TimeType shift = future ? lowerbound : RT_ZERO;
+	const TimeType minimum = future ? lowerbound : RT_ZERO; // smallest bound of the operator
+
+	// instants where the event looked for (the operand true, or false) happens
+	Signal events(0, 0);
+	if (onTrue)
+		events = values;
+	else
+		computeComplement(values, events);
+	const TimeType known = events.getLast();
+
+	bool any = false, infinite = false, pending = false, inevent = false;
+	TimeType low = RT_ZERO, high = RT_ZERO, pendingbound = RT_ZERO;
+
+	// the instants are visited in order, with the first event not before them and the end of the event before it
+	Signal::const_iterator event = events.getBegin();
+	bool previous = false;
+	TimeType previousend = RT_ZERO;
+
+	for (Signal::const_iterator it = instants.getBegin(); it != instants.getEnd(); it++)
+	{
+		// instants u = t + shift whose threshold is looked for, those after the end of the values are not known yet
+		const TimeType right = it->rightLimit + shift, stop = std::min(right, known);
+		if (right > known)
+			pending = true;
+
+		for (TimeType u = it->leftLimit + shift; u < stop;)
+		{
+			while (event != events.getEnd() && event->rightLimit <= u)
+			{
+				previousend = event->rightLimit;
+				previous = true;
+				event++;
+			}
+
+			TimeType next, least, greatest;
+			bool bounded = true;
+
+			if (event != events.getEnd() && event->leftLimit <= u)
+			{
+				// u is in an event: the threshold is the smallest bound, and every bound reaches the event
+				next = std::min(event->rightLimit, stop);
+				least = greatest = minimum;
+				inevent = true;
+			}
+			else
+			{
+				next = event != events.getEnd() ? std::min(event->leftLimit, stop) : stop;
+				if (future && event == events.getEnd())
+				{
+					// no event up to the end of the values: the threshold is at least known - t
+					pending = true;
+					pendingbound = std::max(pendingbound, known - (u - shift));
+					bounded = false;
+				}
+				else if (future)
+				{
+					// the threshold next - t decreases along the gap before the event
+					greatest = event->leftLimit - (u - shift);
+					least = event->leftLimit - (next - shift);
+				}
+				else if (!previous)
+				{
+					// no event since the start of the trace: no bound reaches one
+					infinite = true;
+					bounded = false;
+				}
+				else
+				{
+					// the threshold t - last increases along the gap after the previous event
+					least = u - previousend;
+					greatest = next - previousend;
+				}
+			}
+
+			if (bounded)
+			{
+				low = any ? std::min(low, least) : least;
+				high = any ? std::max(high, greatest) : greatest;
+				any = true;
+			}
+			u = next;
+		}
+	}
+
+	const double infinity = std::numeric_limits<double>::infinity();
+	result.increasing = onTrue == required;
+	result.decided = !pending;
+	if (result.increasing)
+	{
+		// every threshold must be reached
+		TimeType bound = std::max(minimum, any ? high : minimum);
+		if (pending)
+			bound = std::max(bound, pendingbound);
+		result.lower = TimePolicy::toSeconds(bound);
+		result.upper = infinity;
+		result.satisfiable = result.satisfiable && !infinite;
+	}
+	else
+	{
+		// no threshold must be reached: only the instants in an event are reached by every bound, the least threshold of the others
+		// is a limit that the bounds up to it do not reach (a single bound if it is the smallest one)
+		result.lower = TimePolicy::toSeconds(minimum);
+		result.upper = any ? TimePolicy::toSeconds(low) : infinity;
+		result.satisfiable = result.satisfiable && !inevent;
+	}
+}
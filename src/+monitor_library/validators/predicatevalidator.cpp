@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <sstream>
 #include <stdexcept>
 
 #include "misc.h"
@@ -6,17 +7,30 @@
 
 
 
-PredicateValidatorNode::PredicateValidatorNode(predicate_index i)
+PredicateValidatorNode::PredicateValidatorNode(predicate_index i, TimeType d)
 :index(i),
  lastUpdateTime(),
  currentUpdateTime(),
  lastvalue(),
  currentValue(),
- computedValues(0.0,0.0)
+ dwell(d),
+ filteredValue(),
+ runStart(),
+ previousRunStart(),
+ computedValues(0.0,0.0),
+ partialTrue(0.0,0.0),
+ partialFalse(0.0,0.0),
+ savedLastUpdateTime(),
+ savedCurrentUpdateTime(),
+ savedLastValue(),
+ savedCurrentValue(),
+ savedFilteredValue(),
+ savedRunStart(),
+ savedPreviousRunStart()
 {}
 
 
-void PredicateValidatorNode::start(RealType ts, const std::vector<BooleanType> &preds)
+void PredicateValidatorNode::start(TimeType ts, const std::vector<BooleanType> &preds)
 {
 	if(index >= preds.size())
 		throw std::invalid_argument("start: Index of the predicate must be less then the input predicate vector's size.");
@@ -25,10 +39,15 @@ void PredicateValidatorNode::start(RealType ts, const std::vector<BooleanType> &
 	lastUpdateTime = ts;
 	currentValue = preds[index];
 	lastvalue = currentValue;
+	filteredValue = currentValue;
+	runStart = ts;
+	previousRunStart = ts;
 	computedValues.reset(ts,ts);
+	partialTrue.reset(ts,ts);
+	partialFalse.reset(ts,ts);
 }
 
-void PredicateValidatorNode::update(RealType t, const std::vector<BooleanType> &preds)
+void PredicateValidatorNode::update(TimeType t, const std::vector<BooleanType> &preds)
 {
 	if(index >= preds.size())
 			throw std::invalid_argument("Index of the predicate is must be less then the input predicate vector's size.");
@@ -36,12 +55,190 @@ void PredicateValidatorNode::update(RealType t, const std::vector<BooleanType> &
 	if(t < currentUpdateTime)
 		throw std::invalid_argument("Input time-step must be greater then or equal to the last input time-step.");
 
+	UpdateProbe probe(*this);
 	lastUpdateTime = currentUpdateTime;
 	currentUpdateTime = t;
 	lastvalue = currentValue;
 	currentValue = preds[index];
 
-	computedValues.reset(lastUpdateTime,currentUpdateTime);
-	if (lastvalue)
-		computedValues.addInterval(lastUpdateTime,currentUpdateTime);
+	if (dwell > RT_ZERO)
+		filterUpdate();
+	else
+	{
+		computedValues.reset(lastUpdateTime,currentUpdateTime);
+		if (lastvalue)
+			computedValues.addInterval(lastUpdateTime,currentUpdateTime);
+	}
+
+	countOutput(computedValues);
+	countStored(computedValues.getIntervalCount());
+}
+
+/*
+ PRE-CONDITIONS filterUpdate:
+	dwell must be positive, the input must have the value lastvalue in [lastUpdateTime,currentUpdateTime) and currentValue from
+	currentUpdateTime on.
+
+POST-CONDITIONS filterUpdate:
+	computedValues contains the filtered values in [max(ts,lastUpdateTime - dwell), max(ts,currentUpdateTime - dwell)).
+ */
+void PredicateValidatorNode::filterUpdate(void)
+{
+	TimeType first = computedValues.getLast();
+	TimeType last = std::max(first, currentUpdateTime - dwell);
+	computedValues.reset(first,last);
+
+	// the run of lastvalue started in runStart lasts at least until currentUpdateTime: if it is long enough, then the filtered value
+	// changes in runStart (runStart >= first since the run was shorter than dwell at the previous update). The length is compared
+	// through last, as currentUpdateTime - runStart >= dwell does not imply runStart <= currentUpdateTime - dwell once rounded
+	bool changes = lastvalue != filteredValue && runStart <= last;
+	TimeType change = changes ? runStart : last;
+
+	if (filteredValue && change > first)
+		computedValues.addInterval(first,change);
+	else if (!filteredValue && change < last)
+		computedValues.addInterval(change,last);
+
+	if (changes)
+		filteredValue = lastvalue;
+	// a run of lastvalue that lasts no time (a second update at the same instant) is ignored: the run of currentValue resumes
+	if (currentValue != lastvalue)
+	{
+		if (runStart == currentUpdateTime)
+			runStart = previousRunStart;
+		else
+		{
+			previousRunStart = runStart;
+			runStart = currentUpdateTime;
+		}
+	}
+
+	// at the first instant of the trace (the only one where the previous run starts at the update time, see start) the filtered
+	// value is the input value
+	if (previousRunStart == currentUpdateTime)
+		filteredValue = currentValue;
+}
+
+void PredicateValidatorNode::evaluatePartial(void)
+{
+	TimeType first = computedValues.getLast();
+	partialTrue.reset(first,currentUpdateTime);
+	partialFalse.reset(first,currentUpdateTime);
+
+	// the filtered value is known until the start of the current run of the input, or until the last update time if the run has the
+	// filtered value (without filter every instant before the last update time has already been evaluated); if the run starts at
+	// the last update time, an update at the same instant can still resume the previous run
+	TimeType known = currentUpdateTime;
+	if (currentValue != filteredValue)
+		known = runStart;
+	else if (runStart == currentUpdateTime)
+		known = previousRunStart;
+	if (known > first)
+		(filteredValue ? partialTrue : partialFalse).addInterval(first,known);
+}
+
+double PredicateValidatorNode::analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate)
+{
+	// the predicate changes at most once every dwell seconds, or once every filter dwell seconds (see the constructor); without filter
+	// the values of a step are a single interval (or none), with the filter they may change several times in a step
+	NodeResources node(label(), depth);
+	double filter = TimePolicy::toSeconds(dwell);
+	node.rate = 1 / (2 * std::max(assumptions.dwell, filter));
+	node.span = assumptions.step;
+	size_t intervals = dwell > RT_ZERO ? worstCaseIntervals(node.rate, node.span) : 1;
+	node.intervals = assumptions.partial ? intervals + 2 : intervals;
+	node.operations = intervals;
+	report.nodes.push_back(node);
+
+	if (preallocate)
+	{
+		computedValues.reserve(intervals);
+		partialTrue.reserve(1);
+		partialFalse.reserve(1);
+	}
+	return node.rate;
+}
+
+std::string PredicateValidatorNode::label(void) const
+{
+	std::ostringstream out;
+	out << "PREDICATE " << index;
+	if (dwell > RT_ZERO)
+		out << " (dwell " << TimePolicy::toSeconds(dwell) << ")";
+	return out.str();
+}
+
+void PredicateValidatorNode::collectStats(std::vector<NodeStats> &stats, unsigned depth)
+{
+	stats.push_back(NodeStats(label(), depth));
+	exportStats(stats.back());
+}
+
+void PredicateValidatorNode::saveState(StateWriter &writer)
+{
+	writer.writeTag(STATE_PREDICATE);
+	writer.writeSize(index);
+	writer.writeTime(dwell);
+	writer.writeTime(lastUpdateTime);
+	writer.writeTime(currentUpdateTime);
+	writer.writeBool(lastvalue);
+	writer.writeBool(currentValue);
+	writer.writeBool(filteredValue);
+	writer.writeTime(runStart);
+	writer.writeTime(previousRunStart);
+	writer.writeSignal(computedValues);
+	writer.writeSignal(partialTrue);
+	writer.writeSignal(partialFalse);
+}
+
+void PredicateValidatorNode::restoreState(StateReader &reader)
+{
+	reader.checkTag(STATE_PREDICATE);
+	reader.checkSize(index);
+	reader.checkTime(dwell);
+	lastUpdateTime = reader.readTime();
+	currentUpdateTime = reader.readTime();
+	lastvalue = reader.readBool();
+	currentValue = reader.readBool();
+	filteredValue = reader.readBool();
+	runStart = reader.readTime();
+	previousRunStart = reader.readTime();
+	reader.readSignal(computedValues);
+	reader.readSignal(partialTrue);
+	reader.readSignal(partialFalse);
+}
+
+void PredicateValidatorNode::checkpoint(void)
+{
+	savedLastUpdateTime = lastUpdateTime;
+	savedCurrentUpdateTime = currentUpdateTime;
+	savedLastValue = lastvalue;
+	savedCurrentValue = currentValue;
+	savedFilteredValue = filteredValue;
+	savedRunStart = runStart;
+	savedPreviousRunStart = previousRunStart;
+	computedValues.checkpoint();
+	partialTrue.checkpoint();
+	partialFalse.checkpoint();
+}
+
+void PredicateValidatorNode::commit(void)
+{
+	computedValues.commit();
+	partialTrue.commit();
+	partialFalse.commit();
+}
+
+void PredicateValidatorNode::rollback(void)
+{
+	lastUpdateTime = savedLastUpdateTime;
+	currentUpdateTime = savedCurrentUpdateTime;
+	lastvalue = savedLastValue;
+	currentValue = savedCurrentValue;
+	filteredValue = savedFilteredValue;
+	runStart = savedRunStart;
+	previousRunStart = savedPreviousRunStart;
+	computedValues.rollback();
+	partialTrue.rollback();
+	partialFalse.rollback();
 }
@@ -0,0 +1,72 @@
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include "misc.h"
+#include "resources.h"
+
+
+/**
+ \brief Bound of the number of intervals of a signal.
+ \param rate maximum number of intervals per second of the signal.
+ \param length length (seconds) of the domain of the signal.
+ \returns the maximum number of intervals of a signal with the given rate, over a domain of the given length.
+
+ Each interval of the signal, but the ones cut by the limits of the domain, starts at least 1/rate seconds after the previous one.
+ */
+size_t worstCaseIntervals(double rate, double length)
+{
+	return static_cast<size_t>(std::ceil(rate * length)) + 2;
+}
+
+size_t ResourceReport::totalIntervals(void) const
+{
+	size_t total = 0;
+	for (std::vector<NodeResources>::const_iterator it = nodes.begin(); it != nodes.end(); it++)
+		total += it->intervals;
+	return total;
+}
+
+size_t ResourceReport::totalBytes(void) const
+{
+	return totalIntervals() * sizeof(Interval);
+}
+
+size_t ResourceReport::totalOperations(void) const
+{
+	size_t total = 0;
+	for (std::vector<NodeResources>::const_iterator it = nodes.begin(); it != nodes.end(); it++)
+		total += it->operations;
+	return total;
+}
+
+/**
+ \brief returns the totals of the report in a single line.
+ */
+std::string ResourceReport::summary(void) const
+{
+	std::ostringstream out;
+	out << "at most " << totalIntervals() << " intervals (" << totalBytes() << " bytes), verdict latency " << latency
+		<< " s, at most " << totalOperations() << " interval operations per step";
+	return out.str();
+}
+
+/**
+ \brief prints a table with the entry of each node (indented by depth) followed by the totals.
+ */
+void ResourceReport::print(std::ostream &out) const
+{
+	out << std::left << std::setw(48) << "node" << std::right
+		<< std::setw(14) << "rate (1/s)" << std::setw(12) << "span (s)"
+		<< std::setw(12) << "intervals" << std::setw(12) << "ops/step" << std::endl;
+
+	for (std::vector<NodeResources>::const_iterator it = nodes.begin(); it != nodes.end(); it++)
+	{
+		std::string label = std::string(2 * it->depth, ' ') + it->label;
+		out << std::left << std::setw(48) << label << std::right
+			<< std::setw(14) << it->rate << std::setw(12) << it->span
+			<< std::setw(12) << it->intervals << std::setw(12) << it->operations << std::endl;
+	}
+
+	out << "total: " << summary() << std::endl;
+}
@@ -0,0 +1,363 @@
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include "misc.h"
+#include "validators.h"
+
+
+
+/*
+PRE-CONDITIONS:
+	* the domain of appendvalues must begin where the domain of values ends.
+	* tolerance must be greater than or equal to zero.
+
+POST-CONDITIONS:
+	values contains the values of appendvalues appended to its old values, except that each gap not longer than tolerance between
+	the last interval of values and an interval of appendvalues (or between two intervals of appendvalues) is filled.
+ */
+void appendCoalescing(Signal &values, const Signal &appendvalues, TimeType tolerance)
+{
+	values.increaseLast(appendvalues.getLast());
+
+	for (Signal::const_iterator it = appendvalues.getBegin(); it != appendvalues.getEnd(); it++)
+	{
+		TimeType left = it->leftLimit;
+
+		if (values.getIntervalCount() > 0)
+		{
+			TimeType lastright = (values.getEnd() - 1)->rightLimit;
+
+			// the gap [lastright,left) is short enough to be filled
+			if (left - lastright <= tolerance)
+				left = lastright;
+		}
+		values.addInterval(left, it->rightLimit);
+	}
+}
+
+
+
+/**
+ \brief Create a buffer of the values of a node.
+ \param c node whose values are buffered, the buffer becomes its owner.
+
+ The buffer is created without references and without readers (see acquire and addReader).
+ */
+SignalBuffer::SignalBuffer(ValidatorNode &c)
+: child(&c), values(0.0,0.0), cursors(), horizons(),
+  tolerance(0), references(0), startcalls(0), updatecalls(0), partialcalls(0),
+  analysiscalls(0), analysisentry(0), statscalls(0), statecalls(0),
+  journalcalls(0), savedcursors(), savedhorizons()
+{}
+
+/**
+ \brief Obtain a reference to the buffer.
+ \returns *this*.
+ */
+SignalBuffer* SignalBuffer::acquire(void)
+{
+	references++;
+	return this;
+}
+
+/**
+ \brief Give back a reference obtained with acquire.
+ When no reference is left the buffer and its node are deleted, hence *this* must not be used after the call.
+ */
+void SignalBuffer::release(void)
+{
+	if (references == 0)
+		throw std::logic_error("release: The buffer has no references.");
+
+	references--;
+	if (references == 0)
+		delete this;
+}
+
+/**
+ \brief Register a new reader of the buffer.
+ \param tol length of the longest gap between two intervals of the operand that does not change the values computed by the reader
+ (zero if every value of the operand is needed).
+ \returns the identifier of the reader, to be used with consume and getCursor.
+ \exception std::logic_error if the buffer was already started.
+ \exception std::invalid_argument if *tol* is less than zero.
+ */
+SignalBuffer::reader_id SignalBuffer::addReader(TimeType tol)
+{
+	if (startcalls != 0 || updatecalls != 0 || partialcalls != 0)
+		throw std::logic_error("addReader: Readers must be added before the buffer is used.");
+
+	if (tol < 0)
+		throw std::invalid_argument("addReader: The tolerance must be greater than or equal to zero.");
+
+	// the buffer can fill only the gaps that no reader can distinguish
+	tolerance = cursors.empty() ? tol : std::min(tolerance, tol);
+
+	cursors.push_back(values.getFirst());
+	horizons.push_back(values.getFirst());
+	return cursors.size() - 1;
+}
+
+/**
+ \brief Start the node of the buffer (only on the first call of each step).
+ \param ts start time.
+ \param preds initial values of the predicates.
+
+ Every cursor is moved to *ts*.
+ */
+void SignalBuffer::start(TimeType ts, const std::vector<BooleanType> &preds)
+{
+	if (startcalls == 0)
+	{
+		values.reset(ts,ts);
+		std::fill(cursors.begin(), cursors.end(), ts);
+		std::fill(horizons.begin(), horizons.end(), ts);
+		child->start(ts,preds);
+	}
+
+	// a new start also begins a new step for the other operations
+	updatecalls = 0;
+	partialcalls = 0;
+	startcalls = (startcalls + 1) % cursors.size();
+}
+
+/**
+ \brief Update the node of the buffer and append its values (only on the first call of each step).
+ The values of a negated node are complemented. The gaps of the appended values not longer than the tolerance of the buffer are filled. The node skips the instants before the
+ smallest horizon of the readers (see skipBefore).
+ \param t update time.
+ \param preds values of the predicates in *t*.
+ */
+void SignalBuffer::update(TimeType t, const std::vector<BooleanType> &preds)
+{
+	if (updatecalls == 0)
+	{
+		child->skipBefore(*std::min_element(horizons.begin(), horizons.end()));
+		child->update(t,preds);
+
+		UpdateProbe probe(*this);
+		Signal::size_type stored = values.getIntervalCount();
+		countInput(child->getValues());
+
+		if (child->isNegated())
+			appendComplement(values, child->getValues(), tolerance);
+		else if (tolerance > 0)
+			appendCoalescing(values, child->getValues(), tolerance);
+		else
+			values.append(child->getValues());
+
+		countOutput(values.getIntervalCount() - stored);
+		countStored(values.getIntervalCount());
+	}
+
+	partialcalls = 0;
+	updatecalls = (updatecalls + 1) % cursors.size();
+}
+
+/**
+ \brief Compute the partial evaluation of the node of the buffer (only on the first call of each step).
+ */
+void SignalBuffer::evaluatePartial(void)
+{
+	if (partialcalls == 0)
+		child->evaluatePartial();
+
+	partialcalls = (partialcalls + 1) % cursors.size();
+}
+
+/**
+ \brief Declare that a reader does not need the values before a given instant.
+ \param reader identifier of the reader.
+ \param t first instant whose value is still needed by *reader*.
+ \exception std::invalid_argument if *t* is less than the current cursor of *reader*.
+
+ The values before the smallest cursor are removed from the buffer.
+ */
+void SignalBuffer::consume(reader_id reader, TimeType t)
+{
+	if (t < cursors[reader])
+		throw std::invalid_argument("consume: The cursor of a reader can not be moved backward.");
+
+	cursors[reader] = t;
+
+	TimeType first = *std::min_element(cursors.begin(), cursors.end());
+	if (first > values.getFirst())
+		values.increaseFirst(first);
+}
+
+/**
+ \brief Declare that the values before a given instant can not change the values of a reader.
+ \param reader identifier of the reader.
+ \param t first instant whose value can change the values of *reader* (a value less than the one of a previous call has no effect).
+
+ Unlike consume, the values are still kept by the buffer: the node of the buffer is only allowed to compute arbitrary values
+ before the smallest horizon of the readers, from the next update on.
+ */
+void SignalBuffer::skipBefore(reader_id reader, TimeType t)
+{
+	horizons[reader] = std::max(horizons[reader], t);
+}
+
+
+SignalBuffer::~SignalBuffer(void)
+{
+	delete child;
+}
+
+/**
+ \brief Bound the resources of the buffer and of its node (the node is analyzed on the first call of each analysis).
+ \param assumptions, report, depth, preallocate as in ValidatorNode::analyzeResources.
+ \param length length (seconds) of the values of the operand needed by the reader.
+ \returns the maximum number of intervals per second in the values of the buffer.
+
+ Each reader must call the method exactly once per analysis: the entry of the buffer accounts for the longest length requested.
+ */
+double SignalBuffer::analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate, double length)
+{
+	if (analysiscalls == 0)
+	{
+		analysisentry = report.nodes.size();
+		report.nodes.push_back(NodeResources(label(), depth));
+		double rate = child->analyzeResources(assumptions, report, depth + 1, preallocate);
+
+		// after coalescing, every gap between two intervals is longer than the tolerance
+		if (tolerance > 0)
+			rate = std::min(rate, 1 / TimePolicy::toSeconds(tolerance));
+		report.nodes[analysisentry].rate = rate;
+	}
+
+	NodeResources &node = report.nodes[analysisentry];
+	node.span = std::max(node.span, length);
+	node.intervals = worstCaseIntervals(node.rate, node.span);
+	node.operations = worstCaseIntervals(node.rate, assumptions.step);
+
+	if (preallocate)
+		values.reserve(node.intervals);
+
+	analysiscalls = (analysiscalls + 1) % cursors.size();
+	return node.rate;
+}
+
+std::string SignalBuffer::label(void) const
+{
+	std::ostringstream out;
+	out << "BUFFER (" << cursors.size() << " readers)";
+	return out.str();
+}
+
+/**
+ \brief Append the statistics of the buffer and of its node (only on the first call of each collection).
+ \param stats, depth as in ValidatorNode::collectStats.
+
+ Each reader must call the method exactly once per collection.
+ */
+void SignalBuffer::collectStats(std::vector<NodeStats> &stats, unsigned depth)
+{
+	if (statscalls == 0)
+	{
+		stats.push_back(NodeStats(label(), depth));
+		exportStats(stats.back());
+		child->collectStats(stats, depth + 1);
+	}
+
+	statscalls = (statscalls + 1) % cursors.size();
+}
+
+/**
+ \brief Append the state of the buffer and of its node to a snapshot (only on the first call of each snapshot).
+ \param writer as in ValidatorNode::saveState.
+
+ Each reader must call the method exactly once per snapshot.
+ */
+void SignalBuffer::saveState(StateWriter &writer)
+{
+	if (statecalls == 0)
+	{
+		writer.writeTag(STATE_BUFFER);
+		writer.writeSize(cursors.size());
+		writer.writeTime(tolerance);
+		writer.writeSignal(values);
+		writer.writeTimes(cursors);
+		writer.writeTimes(horizons);
+		child->saveState(writer);
+	}
+
+	statecalls = (statecalls + 1) % cursors.size();
+}
+
+/**
+ \brief Restore the state of the buffer and of its node from a snapshot (only on the first call of each snapshot).
+ \param reader as in ValidatorNode::restoreState.
+
+ Each reader must call the method exactly once per snapshot.
+ */
+void SignalBuffer::restoreState(StateReader &reader)
+{
+	if (statecalls == 0)
+	{
+		reader.checkTag(STATE_BUFFER);
+		reader.checkSize(cursors.size());
+		reader.checkTime(tolerance);
+		reader.readSignal(values);
+		reader.readTimes(cursors);
+		reader.readTimes(horizons);
+		child->restoreState(reader);
+	}
+
+	statecalls = (statecalls + 1) % cursors.size();
+}
+
+/**
+ \brief Record the state of the buffer and of its node (only on the first call of each checkpoint, see ValidatorNode::checkpoint).
+ Each reader must call the method exactly once per checkpoint, between two steps.
+ */
+void SignalBuffer::checkpoint(void)
+{
+	if (journalcalls == 0)
+	{
+		savedcursors = cursors;
+		savedhorizons = horizons;
+		values.checkpoint();
+		child->checkpoint();
+	}
+
+	journalcalls = (journalcalls + 1) % cursors.size();
+}
+
+/**
+ \brief Make definitive the calls after the last checkpoint (only on the first call of each commit).
+ Each reader must call the method exactly once per commit.
+ */
+void SignalBuffer::commit(void)
+{
+	if (journalcalls == 0)
+	{
+		values.commit();
+		child->commit();
+	}
+
+	journalcalls = (journalcalls + 1) % cursors.size();
+}
+
+/**
+ \brief Restore the state of the buffer and of its node at the last checkpoint (only on the first call of each rollback).
+ Each reader must call the method exactly once per rollback. The steps interrupted by an exception are undone as well.
+ */
+void SignalBuffer::rollback(void)
+{
+	if (journalcalls == 0)
+	{
+		cursors = savedcursors;
+		horizons = savedhorizons;
+		values.rollback();
+		child->rollback();
+
+		// the checkpoint was taken between two steps
+		startcalls = 0;
+		updatecalls = 0;
+		partialcalls = 0;
+	}
+
+	journalcalls = (journalcalls + 1) % cursors.size();
+}
@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include "misc.h"
+#include "validators.h"
+
+
+
+using std::max;
+using std::min;
+
+
+
+/*
+PRE-CONDITIONS:
+	* alpha must be non-negative.
+	* first must be greater than or equal to the first domain value of both the input signals.
+	* deadline must be the value computed by the previous invocation (or a value less than or equal to first if there was no
+	  previous invocation).
+
+POST-CONDITIONS:
+	sincevalues correctly contains the signal representing the since evaluation for each t in [first,last), with:
+		last = min between the last value of signal1 and signal2.
+
+	the intervals of the input signals that end before first are not read (the input signals can be shared buffers whose
+	values before first are needed by other readers).
+
+	the since is defined as follow:
+		phi1 S[0,alpha] phi2 is true in t if and only if exists t' in [t-alpha,t] such that phi2 is true in t'
+		and phi1 is true in (t',t].
+
+	hence, given an interval [c,d) of signal2, the since is true in [c,d) and, if an interval [a,b) of signal1
+	with a < d < b exists, in [d, min(b, d+alpha)).
+
+	deadline is used to carry the latter extension between two consecutive invocations: after the function execution
+	it contains the value d+alpha of the last interval [c,d) of signal2 whose extension could continue after last (if no
+	such interval exists, then deadline is less than or equal to last). If [first,last) is empty deadline is not changed.
+ */
+void computeSince(const Signal &signal1, const Signal &signal2, TimeType first, Signal &sincevalues, TimeType alpha, TimeType &deadline)
+{
+	if (alpha < 0)
+		throw std::invalid_argument("computeSince: The alpha parameter must be non-negative.");
+
+	if (first < signal1.getFirst() || first < signal2.getFirst())
+		throw std::invalid_argument("computeSince: The first parameter must be inside the domain of the input signals.");
+
+	TimeType newfirst = first;
+	TimeType newlast = min(signal1.getLast(), signal2.getLast());
+	TimeType newdeadline = newfirst;
+
+	sincevalues.reset(newfirst,newlast);
+
+	// an empty step (e.g. a second update at the same instant) carries the extension unchanged
+	if (newfirst >= newlast)
+		return;
+
+	Signal::const_iterator it1 = signal1.getIntervalFrom(newfirst), end1 = signal1.getEnd();
+	Signal::const_iterator it2 = signal2.getIntervalFrom(newfirst), end2 = signal2.getEnd();
+
+	// extension of an interval of signal2 that ended before newfirst (phi1 must still be true in newfirst)
+	if (deadline > newfirst && it1 != end1 && it1->leftLimit <= newfirst)
+	{
+		sincevalues.addInterval(newfirst, min(min(it1->rightLimit, deadline), newlast));
+
+		if (it1->rightLimit >= newlast)
+			newdeadline = deadline;
+	}
+
+	while(it2 != end2 && it2->leftLimit < newlast)
+	{
+		const TimeType c = it2->leftLimit, d = it2->rightLimit;
+		it2++;
+
+		// phi2 holds in [c,d), then the since holds there too (the intervals starting before first are cut)
+		sincevalues.addInterval(max(c,newfirst), min(d,newlast));
+
+		// the extension of [c,d) begins in d, which must not be after the end of the domain
+		const TimeType end = min(d,newlast);
+
+		// searching for the interval of signal1 that contains the end of [c,d)
+		while(it1 != end1 && it1->rightLimit < end)
+			it1++;
+
+		// phi1 must be true just before the end of [c,d) and, if it is inside the domain, in the end itself
+		if (it1 == end1 || it1->leftLimit >= end || (it1->rightLimit == end && end < newlast))
+			continue;
+
+		if (end < newlast)
+			sincevalues.addInterval(end, min(min(it1->rightLimit, end + alpha), newlast));
+
+		// phi1 is still true at the end of the domain, so the extension could continue in the next invocation
+		if (it1->rightLimit >= newlast)
+			newdeadline = max(newdeadline, end + alpha);
+	}
+
+	deadline = newdeadline;
+}
+
+
+
+// METHODS--------------------------------------------------------------------------------------------------
+
+SinceValidatorNode::SinceValidatorNode (SignalBuffer &b1, SignalBuffer &b2, TimeType a, bool firstistrue)
+: firstbuffer(&b1),		secondbuffer(&b2),
+  firstreader(),		secondreader(),
+  alpha(a),				deadline(0.0),
+  horizon(0.0),
+  saveddeadline(0.0),	savedhorizon(0.0),
+  computedValues(0.0,0.0),	partialTrue(0.0,0.0),
+  partialFalse(0.0,0.0)
+{
+	if (alpha <= 0)
+		throw std::invalid_argument("SinceValidator: alpha parameter must be greater than zero.");
+
+	TimeType fmt = b1.minTime(), smt = b2.minTime();
+	max = (fmt < smt? smt:fmt);
+
+	// if the first operand is always true, the since is not changed by filling the gaps of the second one not longer than alpha
+	firstreader = firstbuffer->addReader();
+	secondreader = secondbuffer->addReader(firstistrue ? alpha : 0);
+}
+
+void SinceValidatorNode::start(TimeType ts, const std::vector<BooleanType> &preds)
+{
+	 // setting  the state of the object
+	 deadline = ts;
+	 horizon = ts;
+
+	 computedValues.reset(ts,ts);
+
+	 // calls on the recursive structure (starting the whole sub-tree)
+	 firstbuffer->start(ts,preds);
+	 secondbuffer->start(ts,preds);
+}
+
+void SinceValidatorNode::update(TimeType t, const std::vector<BooleanType> &preds)
+{
+	// function calls on the recursive structure (updating the whole sub-tree, the buffers are updated only once per step): the
+	// since in t depends only on the operands in [t-alpha,t], hence the operands are not needed before the horizon minus alpha
+	firstbuffer->skipBefore(firstreader,horizon - alpha);
+	secondbuffer->skipBefore(secondreader,horizon - alpha);
+	firstbuffer->update(t,preds);
+	secondbuffer->update(t,preds);
+
+	UpdateProbe probe(*this);
+	countInput(firstbuffer->getValues());
+	countInput(secondbuffer->getValues());
+
+	// computing since, starting from the first instant not computed yet, and saving values in computedvalues. The values of a step
+	// that ends alpha before the horizon are not computed: they can not change the needed ones, as if the second operand was
+	// false in the step (no extension carried by the deadline)
+	TimeType first = computedValues.getLast();
+	TimeType last = std::min(firstbuffer->getValues().getLast(), secondbuffer->getValues().getLast());
+	if (last <= horizon - alpha)
+	{
+		computedValues.reset(first,last);
+		deadline = last;
+	}
+	else
+		computeSince(firstbuffer->getValues(),secondbuffer->getValues(),first,computedValues,alpha,deadline);
+
+	// moving the cursors of *this* (the since does not need the values before the ones just computed)
+	TimeType buffstart = computedValues.getLast();
+	firstbuffer->consume(firstreader,buffstart);
+	secondbuffer->consume(secondreader,buffstart);
+
+	countOutput(computedValues);
+	countStored(computedValues.getIntervalCount());
+}
+
+void SinceValidatorNode::evaluatePartial(void)
+{
+	firstbuffer->evaluatePartial();
+	secondbuffer->evaluatePartial();
+
+	// known values of the children: the buffers followed by their partial evaluation (up to the last update time)
+	Signal true1(0.0,0.0), false1(0.0,0.0), true2(0.0,0.0), false2(0.0,0.0);
+	computeKnownValues(firstbuffer->getValues(), firstbuffer->getPartialTrue(), firstbuffer->getPartialFalse(), true1, false1);
+	computeKnownValues(secondbuffer->getValues(), secondbuffer->getPartialTrue(), secondbuffer->getPartialFalse(), true2, false2);
+
+	TimeType first = computedValues.getLast();
+
+	// the since is known to be true where it is true even if every unknown value is false (the state of *this* must not change)
+	TimeType tmpdeadline = deadline;
+	computeSince(true1, true2, first, partialTrue, alpha, tmpdeadline);
+
+	// the since is known to be false where it is false even if every unknown value is true
+	Signal possible1(0.0,0.0), possible2(0.0,0.0), possiblesince(0.0,0.0);
+	computeComplement(false1, possible1);
+	computeComplement(false2, possible2);
+
+	tmpdeadline = deadline;
+	computeSince(possible1, possible2, first, possiblesince, alpha, tmpdeadline);
+	computeComplement(possiblesince, partialFalse);
+}
+
+void SinceValidatorNode::skipBefore(TimeType t)
+{
+	horizon = std::max(horizon, t);
+}
+
+double SinceValidatorNode::analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate)
+{
+	std::vector<NodeResources>::size_type entry = report.nodes.size();
+	report.nodes.push_back(NodeResources(label(), depth));
+
+	// the past is summarized by the deadline: each buffer only keeps the values not yet available for the other operand
+	const double step = assumptions.step;
+	double length1 = TimePolicy::toSeconds(max - firstbuffer->minTime()) + step;
+	double length2 = TimePolicy::toSeconds(max - secondbuffer->minTime()) + step;
+	double rate1 = firstbuffer->analyzeResources(assumptions, report, depth + 1, preallocate, length1);
+	double rate2 = secondbuffer->analyzeResources(assumptions, report, depth + 1, preallocate, length2);
+
+	// every change of the since is a change of an operand, possibly shifted by alpha
+	double rate = rate1 + rate2;
+	double partiallength = TimePolicy::toSeconds(minTime()) + step;
+
+	size_t computedintervals = worstCaseIntervals(rate, step);
+	size_t partialintervals = assumptions.partial ? worstCaseIntervals(rate, partiallength) : 0;
+
+	NodeResources &node = report.nodes[entry];
+	node.rate = rate;
+	node.span = assumptions.partial ? partiallength : std::max(length1, length2);
+	node.intervals = computedintervals + 2 * partialintervals;
+	node.operations = worstCaseIntervals(rate1, length1) + worstCaseIntervals(rate2, length2) + computedintervals;
+
+	if (preallocate)
+	{
+		computedValues.reserve(computedintervals);
+		partialTrue.reserve(partialintervals);
+		partialFalse.reserve(partialintervals);
+	}
+	return rate;
+}
+
+
+
+
+std::string SinceValidatorNode::label(void) const
+{
+	std::ostringstream out;
+	out << "SINCE[0," << TimePolicy::toSeconds(alpha) << "]";
+	return out.str();
+}
+
+void SinceValidatorNode::collectStats(std::vector<NodeStats> &stats, unsigned depth)
+{
+	stats.push_back(NodeStats(label(), depth));
+	exportStats(stats.back());
+
+	firstbuffer->collectStats(stats, depth + 1);
+	secondbuffer->collectStats(stats, depth + 1);
+}
+
+void SinceValidatorNode::saveState(StateWriter &writer)
+{
+	writer.writeTag(STATE_SINCE);
+	writer.writeTime(alpha);
+	writer.writeTime(deadline);
+	writer.writeTime(horizon);
+	writer.writeSignal(computedValues);
+	writer.writeSignal(partialTrue);
+	writer.writeSignal(partialFalse);
+
+	firstbuffer->saveState(writer);
+	secondbuffer->saveState(writer);
+}
+
+void SinceValidatorNode::restoreState(StateReader &reader)
+{
+	reader.checkTag(STATE_SINCE);
+	reader.checkTime(alpha);
+	deadline = reader.readTime();
+	horizon = reader.readTime();
+	reader.readSignal(computedValues);
+	reader.readSignal(partialTrue);
+	reader.readSignal(partialFalse);
+
+	firstbuffer->restoreState(reader);
+	secondbuffer->restoreState(reader);
+}
+
+void SinceValidatorNode::checkpoint(void)
+{
+	saveddeadline = deadline;
+	savedhorizon = horizon;
+	computedValues.checkpoint();
+	partialTrue.checkpoint();
+	partialFalse.checkpoint();
+
+	firstbuffer->checkpoint();
+	secondbuffer->checkpoint();
+}
+
+void SinceValidatorNode::commit(void)
+{
+	computedValues.commit();
+	partialTrue.commit();
+	partialFalse.commit();
+
+	firstbuffer->commit();
+	secondbuffer->commit();
+}
+
+void SinceValidatorNode::rollback(void)
+{
+	deadline = saveddeadline;
+	horizon = savedhorizon;
+	computedValues.rollback();
+	partialTrue.rollback();
+	partialFalse.rollback();
+
+	firstbuffer->rollback();
+	secondbuffer->rollback();
+}
+
+SinceValidatorNode::~SinceValidatorNode(void)
+{
+	firstbuffer->release();
+	secondbuffer->release();
+}
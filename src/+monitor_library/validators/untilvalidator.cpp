@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <sstream>
 #include <stdexcept>
 
 #include "misc.h"
@@ -13,7 +14,7 @@ using std::min;
 
 /*
 PRE-CONDITIONS:
- 	 alpha must be greater than zero.
+ 	 alpha must be non-negative.
 
 POST-CONDITIONS:
 	the output interval h correctly represent the unitary Until with h1 and h2 as input and as parameter the value alpha.
@@ -25,42 +26,76 @@ POST-CONDITIONS:
 		* if b >= c and a < c then return  [a,b)U[c,d) intersect [c-alpha,d)
 		* otherwise return [c,d)
  */
-static Interval unitaryUntil(const Interval &h1, const Interval &h2, RealType alpha){
+static Interval unitaryUntil(const Interval &h1, const Interval &h2, TimeType alpha){
 
 	if (alpha < 0)
-		throw std::invalid_argument("unitaryUntil: The third parameter must be greater than zero.");
+		throw std::invalid_argument("unitaryUntil: The third parameter must be non-negative.");
 
-	const RealType &a = h1.leftLimit, &b=h1.rightLimit;
-	const RealType &c = h2.leftLimit, &d=h2.rightLimit;
+	const TimeType &a = h1.leftLimit, &b=h1.rightLimit;
+	const TimeType &c = h2.leftLimit, &d=h2.rightLimit;
 
 
 	if(b >= c && a < c)
 	{
-		RealType leftlimit = max(c - alpha, a);
+		TimeType leftlimit = max(c - alpha, a);
 		return Interval(leftlimit, d);
 	}
 	else
 		return h2;
 }
 
+/*
+PRE-CONDITIONS:
+	* lowerbound must be greater than zero and less than or equal to alpha.
+	* h1 = [a,b) and h2 = [c,d) must be two non-empty intervals with b >= c (b == c included).
+
+POST-CONDITIONS:
+	[left,right) correctly represent the unitary Until with h1 and h2 as input and window [lowerbound,alpha],
+	that is the set of the instants t such that exists t' in [t+lowerbound, t+alpha] with t' in [c,d) and [t,t') contained in [a,b):
+
+		left = max(a, c-alpha)
+		right = min(b,d) - lowerbound
+
+	(the result could be empty, in that case right is less than or equal to left). Since lowerbound is greater than zero, the instant t'
+	is always after t: unlike the unitary until with window [0,alpha], the interval [c,d) itself is not part of the result. The first
+	operand is not required in t' itself: if b == c, then t' = c = b is accepted although t' is not in [a,b).
+ */
+static void shiftedUntil(const Interval &h1, const Interval &h2, TimeType lowerbound, TimeType alpha, TimeType &left, TimeType &right){
+
+	if (lowerbound <= 0 || lowerbound > alpha)
+		throw std::invalid_argument("shiftedUntil: The lower bound must be greater than zero and less than or equal to alpha.");
+
+	const TimeType &a = h1.leftLimit, &b=h1.rightLimit;
+	const TimeType &c = h2.leftLimit, &d=h2.rightLimit;
+
+	left = max(c - alpha, a);
+	right = min(b,d) - lowerbound;
+}
+
 
 /*
 PRE-CONDITIONS:
-	* alpha must be greater than zero.
-	* the two input signal must have the same first domain value (not controller because of double imprecision).
+	* alpha must be non-negative.
+	* lowerbound must be greater than or equal to zero and less than or equal to alpha.
+	* first must be greater than or equal to the first domain value of both the input signals.
 
 POST-CONDITIONS:
- 	 untilvalues correctly contains the signal representing the until evaluation for each t in [first,last), with:
- 	 	 first = first value of the domain of signal1 (or equivalently, signal2).
- 	 	 last = max between the last value of signal1 and signal2, minus alpha.
+ 	 untilvalues correctly contains the signal representing the until (with window [lowerbound,alpha]) evaluation for each t in [first,last), with:
+ 	 	 last = min between the last value of signal1 and signal2, minus alpha.
+
+ 	 the intervals of the input signals that end before first are not read (the input signals can be shared buffers whose
+ 	 values before first are needed by other readers).
  */
-static void computeUntil(const Signal &signal1, const Signal &signal2, Signal &untilvalues, RealType alpha)
+void computeUntil(const Signal &signal1, const Signal &signal2, TimeType first, Signal &untilvalues, TimeType alpha, TimeType lowerbound)
 {
 	if (alpha < 0)
-			throw std::invalid_argument("computeUntil: The alpha parameter must be greater than zero.");
+			throw std::invalid_argument("computeUntil: The alpha parameter must be non-negative.");
 
-	RealType newfirst = min(signal1.getFirst(), signal2.getFirst());
-	RealType newlast = min(signal1.getLast(), signal2.getLast()) - alpha;
+	if (first < signal1.getFirst() || first < signal2.getFirst())
+			throw std::invalid_argument("computeUntil: The first parameter must be inside the domain of the input signals.");
+
+	TimeType newfirst = first;
+	TimeType newlast = min(signal1.getLast(), signal2.getLast()) - alpha;
 
 	// the two input signal are not long enough to be able to compute the until
 	if (newfirst > newlast)
@@ -68,91 +103,289 @@ static void computeUntil(const Signal &signal1, const Signal &signal2, Signal &u
 
 	untilvalues.reset(newfirst,newlast);
 
-	Signal::const_iterator it1 = signal1.getBegin(), end1 = signal1.getEnd();
-	Signal::const_iterator it2 = signal2.getBegin(), end2 = signal2.getEnd();
+	Signal::const_iterator it1 = signal1.getIntervalFrom(newfirst), end1 = signal1.getEnd();
+	Signal::const_iterator it2 = signal2.getIntervalFrom(newfirst), end2 = signal2.getEnd();
 
 	while(it2 != end2)
 	{
-		Interval add = *it2;
-		while(it1 != end1 && !isMergeable(*it1,*it2))
+		const Interval &h2 = *it2;
+
+		// skipping the intervals that end before the beginning of *it2 (the following ones could still be merged with the next intervals)
+		while(it1 != end1 && it1->rightLimit < h2.leftLimit)
 			it1++;
 
 		it2++;
 
-		// iterator's interval is valid
-		if (it1 != end1)
-			 add = unitaryUntil(*it1,add,alpha);
+		if (lowerbound == 0)
+		{
+			Interval add = h2;
 
-		// if the interval to be added is out of the interested domain (all the interval after this are going to be greater so we can safely return from the function).
-		if (add.leftLimit >= newlast)
-			return;
+			// iterator's interval is valid
+			if (it1 != end1 && isMergeable(*it1,add))
+				 add = unitaryUntil(*it1,add,alpha);
 
-		// if the interval to be added is at the boundary of the interested domain ( note that the interval is always inside the left boundary, but not necessarily it is inside the right boundary, hence the control).
-		if (add.rightLimit >= newlast)
-			untilvalues.addInterval(add.leftLimit, newlast);
+			// if the interval to be added is out of the interested domain (all the interval after this are going to be greater so we can safely return from the function).
+			if (add.leftLimit >= newlast)
+				return;
+
+			// if the interval to be added is at the boundary of the interested domain (the intervals starting before first are cut, hence the control on both the boundaries).
+			untilvalues.addInterval(max(add.leftLimit, newfirst), min(add.rightLimit, newlast));
+		}
 		else
-			untilvalues.addInterval(add.leftLimit,add.rightLimit);
+		{
+			// every interval of signal1 overlapping *it2 contributes to the result (their left limits are increasing, so are the ones of the results)
+			for (Signal::const_iterator it = it1; it != end1 && it->leftLimit < h2.rightLimit; it++)
+			{
+				TimeType left, right;
+				shiftedUntil(*it,h2,lowerbound,alpha,left,right);
+				left = max(left, newfirst);
+
+				if (left >= newlast)
+					return;
+
+				if (left < right)
+					untilvalues.addInterval(left, min(right, newlast));
+			}
+		}
 	}
 }
 
 
+/*
+ POST-CONDITIONS:
+ 	 the domain of signal ends in the maximum between its old end and end; the instants added (the unknown values) are mapped to
+ 	 value.
+ */
+static void extendUnknown(Signal &signal, TimeType end, bool value)
+{
+	TimeType known = signal.getLast();
+	if (known >= end)
+		return;
+
+	signal.increaseLast(end);
+	if (value)
+		signal.addInterval(known, end);
+}
+
+
 
 // METHODS--------------------------------------------------------------------------------------------------
 
-UntilValidatorNode::UntilValidatorNode (ValidatorNode &child1, ValidatorNode &child2, RealType a)
-: firstchild(&child1),	secondchild(&child2),
-  alpha(a),				buffer1(0.0,0.0),
-  buffer2(0.0,0.0),		computedValues(0.0,0.0)
+UntilValidatorNode::UntilValidatorNode (SignalBuffer &b1, SignalBuffer &b2, TimeType a, TimeType lb, bool firstistrue)
+: firstbuffer(&b1),		secondbuffer(&b2),
+  firstreader(),		secondreader(),
+  alpha(a),				lowerbound(lb),
+  horizon(0.0),			savedhorizon(0.0),
+  computedValues(0.0,0.0),
+  partialTrue(0.0,0.0),	partialFalse(0.0,0.0)
 {
 	if (alpha <= 0)
 		throw std::invalid_argument("UntilValidator: alpha parameter must be greater than zero.");
 
-	RealType fmt = child1.minTime(), smt = child2.minTime();
+	if (lowerbound < 0 || lowerbound > alpha)
+		throw std::invalid_argument("UntilValidator: lower bound parameter must be non-negative and not greater than alpha.");
+
+	TimeType fmt = b1.minTime(), smt = b2.minTime();
 	max = (fmt < smt? smt:fmt);
+
+	// if the first operand is always true, the until is not changed by filling the gaps of the second one not longer than alpha-lowerbound
+	firstreader = firstbuffer->addReader();
+	secondreader = secondbuffer->addReader(firstistrue ? alpha - lowerbound : 0);
 }
 
-void UntilValidatorNode::start(RealType ts, const std::vector<BooleanType> &preds)
+void UntilValidatorNode::start(TimeType ts, const std::vector<BooleanType> &preds)
 {
 	 // setting  the state of the object
-	 buffer1.reset(ts,ts);
-	 buffer2.reset(ts,ts);
-
+	 horizon = ts;
 	 computedValues.reset(ts,ts);
 
 	 // calls on the recursive structure (starting the whole sub-tree)
-	 firstchild->start(ts,preds);
-	 secondchild->start(ts,preds);
+	 firstbuffer->start(ts,preds);
+	 secondbuffer->start(ts,preds);
+}
+
+void UntilValidatorNode::update(TimeType t, const std::vector<BooleanType> &preds)
+{
+	// function calls on the recursive structure (updating the whole sub-tree, the buffers are updated only once per step): the
+	// until in t depends only on the operands in [t,t+alpha], hence the operands are not needed before the horizon either
+	firstbuffer->skipBefore(firstreader,horizon);
+	secondbuffer->skipBefore(secondreader,horizon);
+	firstbuffer->update(t,preds);
+	secondbuffer->update(t,preds);
+
+	UpdateProbe probe(*this);
+	countInput(firstbuffer->getValues());
+	countInput(secondbuffer->getValues());
+
+	// computing until, starting from the first instant not computed yet, and saving values in computedvalues (the values of a
+	// step that ends before the horizon are not computed)
+	TimeType first = computedValues.getLast();
+	TimeType last = std::max(first, std::min(firstbuffer->getValues().getLast(), secondbuffer->getValues().getLast()) - alpha);
+	if (last <= horizon)
+		computedValues.reset(first,last);
+	else
+		computeUntil(firstbuffer->getValues(),secondbuffer->getValues(),first,computedValues,alpha,lowerbound);
+
+	// moving the cursors of *this* (the buffers discard the values that are not needed by any reader)
+	TimeType buffstart = computedValues.getLast();
+	firstbuffer->consume(firstreader,buffstart);
+	secondbuffer->consume(secondreader,buffstart);
+
+	countOutput(computedValues);
+	countStored(computedValues.getIntervalCount());
+}
+
+void UntilValidatorNode::evaluatePartial(void)
+{
+	firstbuffer->evaluatePartial();
+	secondbuffer->evaluatePartial();
+
+	// known values of the children: the buffers followed by their partial evaluation (up to the last update time)
+	Signal true1(0.0,0.0), false1(0.0,0.0), true2(0.0,0.0), false2(0.0,0.0);
+	computeKnownValues(firstbuffer->getValues(), firstbuffer->getPartialTrue(), firstbuffer->getPartialFalse(), true1, false1);
+	computeKnownValues(secondbuffer->getValues(), secondbuffer->getPartialTrue(), secondbuffer->getPartialFalse(), true2, false2);
+
+	TimeType first = computedValues.getLast();
+	TimeType last = min(true1.getLast(), true2.getLast());
+
+	// the until is known to be true where it is true even if every unknown value (also after the last update time) is false; the
+	// known values of the two children can end at different instants, so each one is extended from its own end
+	extendUnknown(true1, last + alpha, false);
+	extendUnknown(true2, last + alpha, false);
+	computeUntil(true1, true2, first, partialTrue, alpha, lowerbound);
+
+	// the until is known to be false where it is false even if every unknown value is true
+	Signal possible1(0.0,0.0), possible2(0.0,0.0), possibleuntil(0.0,0.0);
+	computeComplement(false1, possible1);
+	computeComplement(false2, possible2);
+
+	extendUnknown(possible1, last + alpha, true);
+	extendUnknown(possible2, last + alpha, true);
+
+	computeUntil(possible1, possible2, first, possibleuntil, alpha, lowerbound);
+	computeComplement(possibleuntil, partialFalse);
 }
 
-void UntilValidatorNode::update(RealType t, const std::vector<BooleanType> &preds)
+void UntilValidatorNode::skipBefore(TimeType t)
 {
-	// function calls on the recursive structure (updating the whole sub-tree)
-	firstchild->update(t,preds);
-	secondchild->update(t,preds);
+	horizon = std::max(horizon, t);
+}
 
-	const Signal &tmp1 = firstchild->getValues();
-	const Signal &tmp2 = secondchild->getValues();
+double UntilValidatorNode::analyzeResources(const ResourceAssumptions &assumptions, ResourceReport &report, unsigned depth, bool preallocate)
+{
+	std::vector<NodeResources>::size_type entry = report.nodes.size();
+	report.nodes.push_back(NodeResources(label(), depth));
+
+	// each buffer keeps the values of a window of length alpha, plus the values not yet available for the other operand
+	const double window = TimePolicy::toSeconds(alpha), step = assumptions.step;
+	double length1 = TimePolicy::toSeconds(max - firstbuffer->minTime()) + window + step;
+	double length2 = TimePolicy::toSeconds(max - secondbuffer->minTime()) + window + step;
+	double rate1 = firstbuffer->analyzeResources(assumptions, report, depth + 1, preallocate, length1);
+	double rate2 = secondbuffer->analyzeResources(assumptions, report, depth + 1, preallocate, length2);
+
+	// every change of the until is a change of an operand, shifted by a time bound
+	double rate = rate1 + rate2;
+	double partiallength = TimePolicy::toSeconds(minTime()) + step;
+
+	size_t computedintervals = worstCaseIntervals(rate, step);
+	size_t partialintervals = assumptions.partial ? worstCaseIntervals(rate, partiallength) : 0;
+
+	NodeResources &node = report.nodes[entry];
+	node.rate = rate;
+	node.span = assumptions.partial ? partiallength : std::max(length1, length2);
+	node.intervals = computedintervals + 2 * partialintervals;
+	node.operations = worstCaseIntervals(rate1, length1) + worstCaseIntervals(rate2, length2) + computedintervals;
+
+	if (preallocate)
+	{
+		computedValues.reserve(computedintervals);
+		partialTrue.reserve(partialintervals);
+		partialFalse.reserve(partialintervals);
+	}
+	return rate;
+}
 
-	// update of the buffers' values
-	buffer1.append(tmp1);
-	buffer2.append(tmp2);
 
-	// computing until and saving values in computedvalues
-	computeUntil(buffer1,buffer2,computedValues,alpha);
 
-	// defining the new starts of the buffers
-	RealType buffstart = computedValues.getLast();
 
-	// increasing the buffer first domain value
-	buffer1.increaseFirst(buffstart);
-	buffer2.increaseFirst(buffstart);
+std::string UntilValidatorNode::label(void) const
+{
+	std::ostringstream out;
+	out << "UNTIL[" << TimePolicy::toSeconds(lowerbound) << "," << TimePolicy::toSeconds(alpha) << "]";
+	return out.str();
 }
 
+void UntilValidatorNode::collectStats(std::vector<NodeStats> &stats, unsigned depth)
+{
+	stats.push_back(NodeStats(label(), depth));
+	exportStats(stats.back());
 
+	firstbuffer->collectStats(stats, depth + 1);
+	secondbuffer->collectStats(stats, depth + 1);
+}
 
+void UntilValidatorNode::saveState(StateWriter &writer)
+{
+	writer.writeTag(STATE_UNTIL);
+	writer.writeTime(lowerbound);
+	writer.writeTime(alpha);
+	writer.writeTime(horizon);
+	writer.writeSignal(computedValues);
+	writer.writeSignal(partialTrue);
+	writer.writeSignal(partialFalse);
+
+	firstbuffer->saveState(writer);
+	secondbuffer->saveState(writer);
+}
+
+void UntilValidatorNode::restoreState(StateReader &reader)
+{
+	reader.checkTag(STATE_UNTIL);
+	reader.checkTime(lowerbound);
+	reader.checkTime(alpha);
+	horizon = reader.readTime();
+	reader.readSignal(computedValues);
+	reader.readSignal(partialTrue);
+	reader.readSignal(partialFalse);
+
+	firstbuffer->restoreState(reader);
+	secondbuffer->restoreState(reader);
+}
+
+void UntilValidatorNode::checkpoint(void)
+{
+	savedhorizon = horizon;
+	computedValues.checkpoint();
+	partialTrue.checkpoint();
+	partialFalse.checkpoint();
+
+	firstbuffer->checkpoint();
+	secondbuffer->checkpoint();
+}
+
+void UntilValidatorNode::commit(void)
+{
+	computedValues.commit();
+	partialTrue.commit();
+	partialFalse.commit();
+
+	firstbuffer->commit();
+	secondbuffer->commit();
+}
+
+void UntilValidatorNode::rollback(void)
+{
+	horizon = savedhorizon;
+	computedValues.rollback();
+	partialTrue.rollback();
+	partialFalse.rollback();
+
+	firstbuffer->rollback();
+	secondbuffer->rollback();
+}
 
 UntilValidatorNode::~UntilValidatorNode(void)
 {
-	delete firstchild;
-	delete secondchild;
+	firstbuffer->release();
+	secondbuffer->release();
 }